@@ -0,0 +1,182 @@
+#include "artifact_cache.h"
+
+#include <tvm/node/structural_hash.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+#include "compiler/model_artifact.h"
+#include "compiler/model_builder.h"
+#include "onnx.proto3.pb.h"
+#include "utils/onnx_utils.h"
+#include "utils/relay_utils.h"
+#include "utils/utils.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+/**
+ * @brief Serialize the path with the size and the modification time of the file, or of each file in the directory.
+ * The tuning records are appended to the stores in place, so the path alone does not identify their content
+ *
+ */
+std::string serialize_path_state(const std::string& path) {
+    std::ostringstream oss;
+    oss << path;
+    if (path.empty()) {
+        return oss.str();
+    }
+
+    std::error_code ec;
+    std::vector<std::filesystem::path> files;
+    if (std::filesystem::is_directory(path, ec)) {
+        std::filesystem::recursive_directory_iterator it(path, ec);
+        for (; !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+            if (it->is_regular_file(ec)) {
+                files.emplace_back(it->path());
+            }
+        }
+        std::sort(files.begin(), files.end());
+    } else if (std::filesystem::is_regular_file(path, ec)) {
+        files.emplace_back(path);
+    }
+
+    for (const auto& file : files) {
+        uintmax_t size = std::filesystem::file_size(file, ec);
+        auto mtime = std::filesystem::last_write_time(file, ec).time_since_epoch().count();
+        oss << ":" << file.string() << "," << size << "," << mtime;
+    }
+    return oss.str();
+}
+
+/**
+ * @brief Serialize the build options which change the compiled artifact
+ *
+ */
+std::string serialize_build_options(const BuildOptions& options) {
+    std::ostringstream oss;
+    oss << options.target << "|" << options.opt_level << "|" << options.module_name << "|"
+        << executor_kind_to_string(options.executor) << "|" << options.link_params << "|" << options.usmp << "|"
+        << options.usmp_algorithm << "|" << conv_layout_to_string(options.conv_layout) << "|" << options.nchwc_block
+        << "|" << options.mixed_precision << "|";
+    for (const auto* ops : {&options.mixed_precision_allow_ops, &options.mixed_precision_deny_ops}) {
+        for (const auto& op : *ops) {
+            oss << op << ",";
+        }
+        oss << "|";
+    }
+    oss << options.sparse_threshold << "|" << options.sparse_block_size << "|" << options.blas_offload << "|"
+        << options.blas_min_flops << "|" << options.te_kernels << "|" << options.aot_c_interface << "|"
+        << serialize_path_state(options.impl_selection_file) << "|" << serialize_path_state(options.meta_schedule_dir)
+        << "|" << serialize_path_state(options.tuning_store_dir);
+    return oss.str();
+}
+
+}    // namespace
+
+Status get_artifact_cache_key(const std::string& model_path, const BuildOptions& options, std::string& key) {
+    std::ifstream ifs(model_path, std::ios::binary);
+    if (!ifs) {
+        std::ostringstream oss;
+        oss << "File does NOT exist: " << model_path;
+        return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+    }
+
+    std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    uint64_t hash = tvm_cpp::utils::fnv1a_hash(content);
+    hash ^= tvm_cpp::utils::fnv1a_hash(serialize_build_options(options)) * 31;
+
+    std::ostringstream oss;
+    oss << std::filesystem::path(model_path).stem().string() << "_" << std::hex << std::setw(16) << std::setfill('0')
+        << hash;
+    key = oss.str();
+    return Status::ok();
+}
+
+Status get_module_cache_key(const tvm::IRModule& module, const BuildOptions& options, std::string& key) {
+    uint64_t hash = 0;
+    try {
+        hash = static_cast<uint64_t>(tvm::StructuralHash()(module));
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+    hash ^= tvm_cpp::utils::fnv1a_hash(serialize_build_options(options)) * 31;
+
+    std::ostringstream oss;
+    oss << std::hex << std::setw(16) << std::setfill('0') << hash;
+    key = oss.str();
+    return Status::ok();
+}
+
+bool has_cached_artifact(const std::string& artifact_dir) {
+    // the manifest is the last file written by export_model_artifact
+    return tvm_cpp::utils::file_exist((std::filesystem::path(artifact_dir) / kArtifactManifestFile).string());
+}
+
+Status compile_cached_artifact(const std::string& model_path, const BuildOptions& options,
+                               const std::string& cache_dir, const ExportOptions& export_options,
+                               std::string& artifact_dir, bool& cache_hit) {
+    std::string key;
+    auto status = get_artifact_cache_key(model_path, options, key);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    artifact_dir = (std::filesystem::path(cache_dir) / key).string();
+    cache_hit = has_cached_artifact(artifact_dir);
+    if (cache_hit) {
+        return Status::ok();
+    }
+
+    onnx::ModelProto onnx_model;
+    status = tvm_cpp::onnx_utils::load_onnx_model(model_path, onnx_model);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    tvm::IRModule module;
+    status = tvm_cpp::relay_utils::parse_graph_to_irmodule(onnx_model.graph(), module);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    BuildResult result;
+    status = build_irmodule(module, options, result);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    std::ostringstream tmp_dir;
+    tmp_dir << artifact_dir << ".tmp." << getpid();
+    std::error_code ec;
+    std::filesystem::remove_all(tmp_dir.str(), ec);
+    status = export_model_artifact(result, tmp_dir.str(), export_options);
+    if (!status.is_ok()) {
+        std::filesystem::remove_all(tmp_dir.str(), ec);
+        return status;
+    }
+
+    std::filesystem::rename(tmp_dir.str(), artifact_dir, ec);
+    if (ec) {
+        // another build of the same model finished first
+        std::filesystem::remove_all(tmp_dir.str(), ec);
+        if (!has_cached_artifact(artifact_dir)) {
+            std::ostringstream oss;
+            oss << "Move the artifact to the cache failed: " << artifact_dir;
+            return Status(StatusCode::RUNTIME_ERROR, oss.str());
+        }
+    }
+
+    return Status::ok();
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
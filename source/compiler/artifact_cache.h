@@ -0,0 +1,66 @@
+#ifndef _H_TVM_CPP_COMPILER_ARTIFACT_CACHE_H_
+#define _H_TVM_CPP_COMPILER_ARTIFACT_CACHE_H_
+
+#include <tvm/ir/module.h>
+
+#include <string>
+
+#include "compiler/build_options.h"
+#include "compiler/library_exporter.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief Get the cache key of the model artifact, the hash of the ONNX file content and the build options
+ *
+ * @param model_path the ONNX model file
+ * @param options the build options
+ * @param key output parameter. the cache key, e.g. "resnet50_0123456789abcdef"
+ * @return Status
+ */
+Status get_artifact_cache_key(const std::string& model_path, const BuildOptions& options, std::string& key);
+
+/**
+ * @brief Get the cache key of an IRModule, the structural hash of the module, including its constants, and the hash
+ * of the build options
+ *
+ * @param module the relay IRModule
+ * @param options the build options
+ * @param key output parameter. the cache key, e.g. "0123456789abcdef"
+ * @return Status
+ */
+Status get_module_cache_key(const tvm::IRModule& module, const BuildOptions& options, std::string& key);
+
+/**
+ * @brief Check whether the artifact directory holds a complete model artifact
+ *
+ * @param artifact_dir the artifact directory
+ * @return true
+ * @return false
+ */
+bool has_cached_artifact(const std::string& artifact_dir);
+
+/**
+ * @brief Import and build the ONNX model, and export it to the artifact cache. Nothing is built if the cache already
+ * has the artifact. The artifact is exported to a temporary directory and renamed, so concurrent builds of the same
+ * model never expose a partial artifact
+ *
+ * @param model_path the ONNX model file
+ * @param options the build options
+ * @param cache_dir the artifact cache directory
+ * @param export_options the options to export the shared library
+ * @param artifact_dir output parameter. the artifact directory in the cache, it can be loaded by
+ * `load_model_artifact`
+ * @param cache_hit output parameter. whether the artifact was already cached
+ * @return Status
+ */
+Status compile_cached_artifact(const std::string& model_path, const BuildOptions& options,
+                               const std::string& cache_dir, const ExportOptions& export_options,
+                               std::string& artifact_dir, bool& cache_hit);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
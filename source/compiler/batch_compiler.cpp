@@ -0,0 +1,299 @@
+#include "batch_compiler.h"
+
+#include <picojson.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "compiler/artifact_cache.h"
+#include "utils/utils.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+// the max size of the result message written by a worker, far below the pipe capacity so the worker never blocks
+constexpr size_t kMaxResultMessage = 4000;
+
+/**
+ * @brief A running worker process
+ *
+ */
+struct Worker {
+    size_t job_index{0};
+    // the read end of the result pipe
+    int result_fd{-1};
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * @brief Get the available memory from /proc/meminfo
+ *
+ * @return int64_t the available memory in MB, -1 if it is unknown
+ */
+int64_t get_available_memory_mb() {
+    std::ifstream ifs("/proc/meminfo");
+    for (std::string line; std::getline(ifs, line);) {
+        if (line.rfind("MemAvailable:", 0) == 0) {
+            std::istringstream iss(line.substr(std::string("MemAvailable:").size()));
+            int64_t kb = 0;
+            iss >> kb;
+            return kb / 1024;
+        }
+    }
+
+    return -1;
+}
+
+Status parse_manifest_job(const picojson::value& value, const std::filesystem::path& base_dir, BatchCompileJob& job) {
+    if (!value.is<picojson::object>()) {
+        return Status(StatusCode::INVALID_PARAM, "the model entry of the manifest is not an object");
+    }
+
+    const picojson::object& entry = value.get<picojson::object>();
+    auto get_string = [&entry](const std::string& key, std::string& str) {
+        auto iter = entry.find(key);
+        if (iter != entry.end() && iter->second.is<std::string>()) {
+            str = iter->second.get<std::string>();
+            return true;
+        }
+        return false;
+    };
+
+    std::string model;
+    if (!get_string("model", model)) {
+        return Status(StatusCode::INVALID_PARAM, "the model entry of the manifest has no \"model\"");
+    }
+
+    std::filesystem::path model_path(model);
+    job.model_path = model_path.is_absolute() ? model_path.string() : (base_dir / model_path).string();
+    if (!get_string("name", job.name)) {
+        job.name = model_path.stem().string();
+    }
+
+    get_string("target", job.options.target);
+    get_string("tuning_store_dir", job.options.tuning_store_dir);
+    get_string("meta_schedule_dir", job.options.meta_schedule_dir);
+    get_string("mixed_precision", job.options.mixed_precision);
+    get_string("cc", job.export_options.cc);
+
+    std::string str;
+    if (get_string("executor", str) && !executor_kind_from_string(str, job.options.executor)) {
+        return Status(StatusCode::INVALID_PARAM, "Invalid executor in the manifest: " + str);
+    }
+    if (get_string("conv_layout", str) && !conv_layout_from_string(str, job.options.conv_layout)) {
+        return Status(StatusCode::INVALID_PARAM, "Invalid conv layout in the manifest: " + str);
+    }
+
+    auto opt_level_iter = entry.find("opt_level");
+    if (opt_level_iter != entry.end() && opt_level_iter->second.is<double>()) {
+        job.options.opt_level = static_cast<int>(opt_level_iter->second.get<double>());
+    }
+
+    auto link_params_iter = entry.find("link_params");
+    if (link_params_iter != entry.end() && link_params_iter->second.is<bool>()) {
+        job.options.link_params = link_params_iter->second.get<bool>();
+    }
+
+    return Status::ok();
+}
+
+/**
+ * @brief Compile the model in the worker process and write the result to the pipe, it never returns
+ *
+ */
+[[noreturn]] void run_worker(const BatchCompileJob& job, const std::string& cache_dir, int threads, int result_fd) {
+    // the workers share the cores, so each TVM thread pool gets its part of them
+    setenv("TVM_NUM_THREADS", std::to_string(threads).c_str(), 1);
+
+    std::string artifact_dir;
+    bool cache_hit = false;
+    Status status = compile_cached_artifact(job.model_path, job.options, cache_dir, job.export_options,
+                                            artifact_dir, cache_hit);
+
+    // the result message: cache hit, artifact directory, error
+    std::ostringstream oss;
+    oss << (cache_hit ? 1 : 0) << "\n" << artifact_dir << "\n" << (status.is_ok() ? "" : status.to_string());
+    std::string message = oss.str().substr(0, kMaxResultMessage);
+    ssize_t written = write(result_fd, message.data(), message.size());
+    close(result_fd);
+
+    // skip the destructors of the state copied from the parent
+    _exit(status.is_ok() && written >= 0 ? 0 : 1);
+}
+
+void read_worker_result(int result_fd, BatchCompileResult& result) {
+    std::string message;
+    char buffer[1024];
+    for (ssize_t n = 0; (n = read(result_fd, buffer, sizeof(buffer))) > 0;) {
+        message.append(buffer, static_cast<size_t>(n));
+    }
+    close(result_fd);
+
+    std::istringstream iss(message);
+    std::string cache_hit;
+    std::getline(iss, cache_hit);
+    std::getline(iss, result.artifact_dir);
+    std::string error((std::istreambuf_iterator<char>(iss)), std::istreambuf_iterator<char>());
+
+    result.cache_hit = cache_hit == "1";
+    if (!error.empty()) {
+        result.error = error;
+    }
+}
+
+/**
+ * @brief Wait for the running workers before an early return, so that no worker is left a zombie or still writes
+ * the cache after the caller has moved on
+ *
+ */
+void wait_workers(std::unordered_map<pid_t, Worker>& running) {
+    for (const auto& kv : running) {
+        int wait_status = 0;
+        while (waitpid(kv.first, &wait_status, 0) < 0 && errno == EINTR) {
+        }
+        close(kv.second.result_fd);
+    }
+    running.clear();
+}
+
+}    // namespace
+
+Status load_batch_manifest(const std::string& manifest_path, std::vector<BatchCompileJob>& jobs) {
+    std::ifstream ifs(manifest_path);
+    if (!ifs) {
+        std::ostringstream oss;
+        oss << "File does NOT exist: " << manifest_path;
+        return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+    }
+
+    picojson::value manifest;
+    std::string err = picojson::parse(manifest, ifs);
+    if (!err.empty() || !manifest.is<picojson::object>() || !manifest.contains("models") ||
+        !manifest.get("models").is<picojson::array>()) {
+        std::ostringstream oss;
+        oss << "Invalid batch compile manifest: " << manifest_path << ", " << err;
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    std::filesystem::path base_dir = std::filesystem::path(manifest_path).parent_path();
+    jobs.clear();
+    for (const auto& value : manifest.get("models").get<picojson::array>()) {
+        BatchCompileJob job;
+        auto status = parse_manifest_job(value, base_dir, job);
+        if (!status.is_ok()) {
+            return status;
+        }
+        jobs.emplace_back(job);
+    }
+
+    return Status::ok();
+}
+
+int get_batch_compile_workers(size_t job_count, int64_t worker_memory_mb) {
+    int64_t workers = std::max(1U, std::thread::hardware_concurrency());
+    workers = std::min<int64_t>(workers, static_cast<int64_t>(job_count));
+
+    int64_t available_mb = get_available_memory_mb();
+    if (available_mb > 0 && worker_memory_mb > 0) {
+        workers = std::min(workers, available_mb / worker_memory_mb);
+    }
+
+    return static_cast<int>(std::max<int64_t>(workers, 1));
+}
+
+Status run_batch_compile(const std::vector<BatchCompileJob>& jobs, const std::string& cache_dir, int workers,
+                         std::vector<BatchCompileResult>& results) {
+    std::error_code ec;
+    std::filesystem::create_directories(cache_dir, ec);
+    if (ec) {
+        std::ostringstream oss;
+        oss << "Create cache directory failed: " << cache_dir << ", " << ec.message();
+        return Status(StatusCode::RUNTIME_ERROR, oss.str());
+    }
+
+    workers = std::max(workers, 1);
+    int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / workers);
+
+    results.assign(jobs.size(), BatchCompileResult());
+    std::unordered_map<pid_t, Worker> running;
+    size_t next_job = 0;
+    while (next_job < jobs.size() || !running.empty()) {
+        // start the workers up to the limit
+        while (next_job < jobs.size() && static_cast<int>(running.size()) < workers) {
+            int fds[2];
+            if (pipe(fds) != 0) {
+                wait_workers(running);
+                return Status(StatusCode::THREAD_ERROR, "Create the result pipe of the worker failed");
+            }
+
+            results[next_job].name = jobs[next_job].name;
+            auto start = std::chrono::steady_clock::now();
+            pid_t pid = fork();
+            if (pid < 0) {
+                close(fds[0]);
+                close(fds[1]);
+                wait_workers(running);
+                return Status(StatusCode::THREAD_ERROR, "Fork the worker process failed");
+            }
+
+            if (pid == 0) {
+                close(fds[0]);
+                run_worker(jobs[next_job], cache_dir, threads, fds[1]);
+            }
+
+            close(fds[1]);
+            running.emplace(pid, Worker{next_job, fds[0], start});
+            ++next_job;
+        }
+
+        // wait for any worker
+        int wait_status = 0;
+        struct rusage usage {};
+        pid_t pid = wait4(-1, &wait_status, 0, &usage);
+        if (pid < 0) {
+            wait_workers(running);
+            return Status(StatusCode::THREAD_ERROR, "Wait for the worker processes failed");
+        }
+
+        auto iter = running.find(pid);
+        if (iter == running.end()) {
+            continue;
+        }
+
+        BatchCompileResult& result = results[iter->second.job_index];
+        result.seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - iter->second.start).count();
+        result.max_rss_kb = usage.ru_maxrss;
+        read_worker_result(iter->second.result_fd, result);
+        result.success = WIFEXITED(wait_status) && WEXITSTATUS(wait_status) == 0;
+        if (!result.success && result.error.empty()) {
+            std::ostringstream oss;
+            if (WIFSIGNALED(wait_status)) {
+                oss << "the worker is killed by signal " << WTERMSIG(wait_status);
+            } else {
+                oss << "the worker exits with " << WEXITSTATUS(wait_status);
+            }
+            result.error = oss.str();
+        }
+
+        running.erase(iter);
+    }
+
+    return Status::ok();
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
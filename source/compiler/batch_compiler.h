@@ -0,0 +1,88 @@
+#ifndef _H_TVM_CPP_COMPILER_BATCH_COMPILER_H_
+#define _H_TVM_CPP_COMPILER_BATCH_COMPILER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "compiler/library_exporter.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief A model of the batch compilation
+ *
+ */
+struct BatchCompileJob {
+    // the name in the report, the file name of the model by default
+    std::string name;
+    // the ONNX model file
+    std::string model_path;
+    // the build options, e.g. the target
+    BuildOptions options;
+    // the options to export the shared library, e.g. the cross toolchain
+    ExportOptions export_options;
+};
+
+/**
+ * @brief The result of a model of the batch compilation
+ *
+ */
+struct BatchCompileResult {
+    std::string name;
+    // the artifact directory in the cache
+    std::string artifact_dir;
+    bool success{false};
+    // the artifact was already in the cache
+    bool cache_hit{false};
+    // the error message if the compilation failed
+    std::string error;
+    // the wall time of the worker process
+    double seconds{0};
+    // the peak resident memory of the worker process
+    int64_t max_rss_kb{0};
+};
+
+/**
+ * @brief Load the batch compile manifest, a JSON object like
+ * {"models": [{"model": "resnet50.onnx", "target": "llvm -mcpu=skylake-avx512", "name": "resnet50",
+ *              "executor": "graph", "opt_level": 3, "conv_layout": "NCHWc", "link_params": false,
+ *              "tuning_store_dir": "./tuning_store", "cc": "aarch64-linux-gnu-g++"}]}
+ * Only "model" is required. The relative model paths are relative to the manifest. "cc" links the shared library,
+ * e.g. with a cross toolchain for the targets with another -mtriple
+ *
+ * @param manifest_path the manifest file
+ * @param jobs output parameter. the models to compile
+ * @return Status
+ */
+Status load_batch_manifest(const std::string& manifest_path, std::vector<BatchCompileJob>& jobs);
+
+/**
+ * @brief Get the number of the worker processes from the cores and the available memory
+ *
+ * @param job_count the number of the models
+ * @param worker_memory_mb the memory budget of a worker process
+ * @return int at least 1, at most the cores, the models and the available memory divided by the budget
+ */
+int get_batch_compile_workers(size_t job_count, int64_t worker_memory_mb);
+
+/**
+ * @brief Compile the models in forked worker processes, at most `workers` at a time, into the artifact cache.
+ * It must be called before TVM creates any thread in the calling process, since the workers are forked
+ *
+ * @param jobs the models to compile
+ * @param cache_dir the artifact cache directory
+ * @param workers the max number of the concurrent worker processes
+ * @param results output parameter. the results in the order of the jobs
+ * @return Status error if the workers can not be created, the failures of the models are in the results
+ */
+Status run_batch_compile(const std::vector<BatchCompileJob>& jobs, const std::string& cache_dir, int workers,
+                         std::vector<BatchCompileResult>& results);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
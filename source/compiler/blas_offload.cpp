@@ -0,0 +1,317 @@
+#include "blas_offload.h"
+
+#include <tvm/ir/op.h>
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/transform.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <unordered_map>
+
+#include "compiler/model_builder.h"
+#include "compiler/model_evaluator.h"
+#include "utils/sample_utils.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+// the min flops of the calls offloaded to CBLAS by the lower call hook, 0 allows every call
+std::atomic<int64_t> g_blas_min_flops{0};
+
+/**
+ * @brief Get the static float32 shape of the tensor type
+ *
+ */
+bool get_static_shape(const tvm::Type& type, std::vector<int64_t>& shape) {
+    const auto* tensor_type = type.as<tvm::relay::TensorTypeNode>();
+    if (!tensor_type || tensor_type->dtype != tvm::DataType::Float(32)) {
+        return false;
+    }
+
+    shape.clear();
+    for (const auto& dim : tensor_type->shape) {
+        const auto* imm = dim.as<tvm::IntImmNode>();
+        if (!imm) {
+            return false;
+        }
+        shape.emplace_back(imm->value);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get the matmul shape of a nn.dense or nn.batch_matmul call
+ *
+ * @return true
+ * @return false if the call is not a matmul or the shapes are not static
+ */
+bool get_call_matmul_shape(const tvm::relay::CallNode* call, MatmulShape& shape) {
+    static const tvm::Op& dense_op = tvm::Op::Get("nn.dense");
+    static const tvm::Op& batch_matmul_op = tvm::Op::Get("nn.batch_matmul");
+
+    if (call->args.size() != 2) {
+        return false;
+    }
+
+    std::vector<int64_t> lhs;
+    std::vector<int64_t> rhs;
+    if (!get_static_shape(call->args[0]->checked_type(), lhs) ||
+        !get_static_shape(call->args[1]->checked_type(), rhs)) {
+        return false;
+    }
+
+    if (call->op.same_as(dense_op)) {
+        // the data is [..., k], the weight is [n, k]
+        if (lhs.empty() || rhs.size() != 2) {
+            return false;
+        }
+
+        shape.batch = 0;
+        shape.m = 1;
+        for (size_t i = 0; i + 1 < lhs.size(); ++i) {
+            shape.m *= lhs[i];
+        }
+        shape.k = lhs.back();
+        shape.n = rhs[0];
+        return true;
+    }
+
+    if (call->op.same_as(batch_matmul_op)) {
+        const auto* attrs = call->attrs.as<tvm::relay::BatchMatmulAttrs>();
+        if (!attrs || lhs.size() != 3 || rhs.size() != 3) {
+            return false;
+        }
+
+        shape.batch = std::max(lhs[0], rhs[0]);
+        shape.m = attrs->transpose_a ? lhs[2] : lhs[1];
+        shape.k = attrs->transpose_a ? lhs[1] : lhs[2];
+        shape.n = attrs->transpose_b ? rhs[1] : rhs[2];
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Collect the distinct matmul shapes
+ *
+ */
+class MatmulShapeCollector : public tvm::relay::ExprVisitor {
+public:
+    MatmulShapeCollector() = default;
+    virtual ~MatmulShapeCollector() = default;
+
+    void VisitExpr_(const tvm::relay::CallNode* call) override {
+        MatmulShape shape;
+        if (get_call_matmul_shape(call, shape) &&
+            std::find(m_shapes.begin(), m_shapes.end(), shape) == m_shapes.end()) {
+            m_shapes.emplace_back(shape);
+        }
+
+        tvm::relay::ExprVisitor::VisitExpr_(call);
+    }
+
+    const std::vector<MatmulShape>& shapes() const { return m_shapes; }
+
+private:
+    std::vector<MatmulShape> m_shapes;
+};
+
+/**
+ * @brief Create the single op module of the matmul shape. nn.dense has a constant weight like the Gemm parser output,
+ * nn.batch_matmul has two inputs like the MatMul parser output
+ *
+ */
+Status create_matmul_module(const MatmulShape& shape, tvm::IRModule& module, sample_utils::TensorMap& inputs) {
+    const tvm::runtime::PackedFunc* var_gen = tvm::runtime::Registry::Get("relay.ir.Var");
+    const tvm::runtime::PackedFunc* function = tvm::runtime::Registry::Get("relay.ir.Function");
+    const tvm::runtime::PackedFunc* dense = tvm::runtime::Registry::Get("relay.op.nn._make.dense");
+    const tvm::runtime::PackedFunc* batch_matmul = tvm::runtime::Registry::Get("relay.op.nn._make.batch_matmul");
+    if (!var_gen || !function || !dense || !batch_matmul) {
+        return Status(StatusCode::RUNTIME_ERROR, "the relay var, function or matmul generators are not found");
+    }
+
+    std::unordered_map<std::string, std::vector<int64_t>> shapes;
+    if (shape.batch > 0) {
+        shapes.emplace("lhs", std::vector<int64_t>{shape.batch, shape.m, shape.k});
+        shapes.emplace("rhs", std::vector<int64_t>{shape.batch, shape.k, shape.n});
+    } else {
+        shapes.emplace("lhs", std::vector<int64_t>{shape.m, shape.k});
+        shapes.emplace("rhs", std::vector<int64_t>{shape.n, shape.k});
+    }
+
+    std::vector<sample_utils::TensorMap> samples;
+    sample_utils::create_random_samples(shapes, 1, 0, samples);
+
+    auto create_var = [&](const std::string& name) -> tvm::relay::Var {
+        tvm::runtime::Array<tvm::PrimExpr> var_shape;
+        for (int64_t dim : shapes[name]) {
+            var_shape.push_back(tvm::Integer(dim));
+        }
+        return (*var_gen)(name, tvm::relay::TensorType(var_shape, tvm::DataType::Float(32)), tvm::relay::Span());
+    };
+
+    tvm::runtime::Array<tvm::relay::Var> params;
+    tvm::relay::Var lhs = create_var("lhs");
+    params.push_back(lhs);
+    inputs.clear();
+    inputs.emplace("lhs", samples[0]["lhs"]);
+
+    tvm::relay::Expr body;
+    if (shape.batch > 0) {
+        tvm::relay::Var rhs = create_var("rhs");
+        params.push_back(rhs);
+        inputs.emplace("rhs", samples[0]["rhs"]);
+        body = (*batch_matmul)(lhs, rhs, tvm::DataType(), false, false);
+    } else {
+        body = (*dense)(lhs, tvm::relay::Constant(samples[0]["rhs"]), tvm::Integer(shape.n), tvm::DataType());
+    }
+
+    tvm::relay::Expr func = (*function)(params, body, tvm::relay::Type(), tvm::runtime::Array<tvm::relay::TypeVar>(),
+                                        tvm::DictAttrs(), tvm::relay::Span());
+    module = tvm::IRModule::FromExpr(func);
+    return Status::ok();
+}
+
+}    // namespace
+
+std::string get_blas_target(const BuildOptions& options) {
+    if (!options.blas_offload || options.target.find("cblas") != std::string::npos) {
+        return options.target;
+    }
+
+    std::string target = options.target;
+    size_t libs_pos = target.find("-libs=");
+    if (libs_pos != std::string::npos) {
+        return target.insert(libs_pos + std::string("-libs=").size(), "cblas,");
+    }
+
+    return target + " -libs=cblas";
+}
+
+Status set_blas_offload_config(const BuildOptions& options) {
+    if (options.blas_offload && !tvm::runtime::Registry::Get("tvm.contrib.cblas.matmul")) {
+        return Status(StatusCode::NOT_IMPLEMENTED, "tvm.contrib.cblas.matmul not found, TVM is built without USE_BLAS");
+    }
+
+    g_blas_min_flops = options.blas_offload ? options.blas_min_flops : 0;
+    return Status::ok();
+}
+
+bool is_blas_implementation_allowed(const tvm::relay::Call& call, const tvm::relay::OpImplementation& impl) {
+    int64_t min_flops = g_blas_min_flops;
+    if (min_flops <= 0 || std::string(impl->name).find("cblas") == std::string::npos) {
+        return true;
+    }
+
+    // the dynamic shapes keep the default choice of the strategy
+    MatmulShape shape;
+    if (!get_call_matmul_shape(call.get(), shape)) {
+        return true;
+    }
+
+    return shape.flops() >= min_flops;
+}
+
+Status get_matmul_shapes(const tvm::IRModule& module, std::vector<MatmulShape>& shapes) {
+    if (!module->ContainGlobalVar("main")) {
+        return Status(StatusCode::INVALID_PARAM, "main function not found in the module");
+    }
+
+    // type infer
+    const tvm::runtime::PackedFunc* type_infer = tvm::runtime::Registry::Get("relay._transform.InferType");
+    if (!type_infer) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._transform.InferType expression not found");
+    }
+
+    // pass run
+    const tvm::runtime::PackedFunc* pass_run = tvm::runtime::Registry::Get("transform.RunPass");
+    if (!pass_run) {
+        return Status(StatusCode::RUNTIME_ERROR, "transform.pass_run expression not found");
+    }
+
+    try {
+        tvm::IRModule typed_module = (*pass_run)((*type_infer)(), module);
+
+        MatmulShapeCollector collector;
+        collector(typed_module->Lookup("main"));
+        shapes = collector.shapes();
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status benchmark_blas_offload(const BuildOptions& options, const std::vector<MatmulShape>& shapes, int iterations,
+                              std::vector<BlasBenchmark>& benchmarks) {
+    BuildOptions tvm_options = options;
+    tvm_options.blas_offload = false;
+
+    BuildOptions blas_options = options;
+    blas_options.blas_offload = true;
+    blas_options.blas_min_flops = 0;
+
+    benchmarks.clear();
+    for (const auto& shape : shapes) {
+        tvm::IRModule module;
+        sample_utils::TensorMap inputs;
+        auto status = create_matmul_module(shape, module, inputs);
+        if (!status.is_ok()) {
+            return status;
+        }
+
+        BlasBenchmark benchmark;
+        benchmark.shape = shape;
+        for (const auto* item : {&tvm_options, &blas_options}) {
+            BuildResult result;
+            status = build_irmodule(module, *item, result);
+            if (!status.is_ok()) {
+                return status;
+            }
+
+            tvm::runtime::Module executor;
+            status = create_executor(result, executor);
+            if (!status.is_ok()) {
+                return status;
+            }
+
+            double& latency_ms = item->blas_offload ? benchmark.blas_ms : benchmark.tvm_ms;
+            status = measure_executor_latency(executor, inputs, 5, iterations, latency_ms);
+            if (!status.is_ok()) {
+                return status;
+            }
+        }
+
+        benchmarks.emplace_back(benchmark);
+    }
+
+    return Status::ok();
+}
+
+int64_t choose_blas_min_flops(const std::vector<BlasBenchmark>& benchmarks) {
+    std::vector<BlasBenchmark> sorted = benchmarks;
+    std::sort(sorted.begin(), sorted.end(), [](const BlasBenchmark& lhs, const BlasBenchmark& rhs) {
+        return lhs.shape.flops() < rhs.shape.flops();
+    });
+
+    // scan from the largest shape while CBLAS keeps winning
+    int64_t min_flops = std::numeric_limits<int64_t>::max();
+    for (auto iter = sorted.rbegin(); iter != sorted.rend(); ++iter) {
+        if (iter->blas_ms >= iter->tvm_ms) {
+            break;
+        }
+        min_flops = iter->shape.flops();
+    }
+
+    return min_flops;
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
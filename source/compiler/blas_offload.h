@@ -0,0 +1,105 @@
+#ifndef _H_TVM_CPP_COMPILER_BLAS_OFFLOAD_H_
+#define _H_TVM_CPP_COMPILER_BLAS_OFFLOAD_H_
+
+#include <tvm/ir/module.h>
+#include <tvm/relay/expr.h>
+#include <tvm/relay/op_strategy.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief The shape of a nn.dense or nn.batch_matmul, [batch, m, k] x [batch, k, n]
+ *
+ */
+struct MatmulShape {
+    // the batch size of nn.batch_matmul, 0 for nn.dense
+    int64_t batch{0};
+    int64_t m{0};
+    int64_t n{0};
+    int64_t k{0};
+
+    int64_t flops() const { return 2 * (batch > 0 ? batch : 1) * m * n * k; }
+
+    bool operator==(const MatmulShape& other) const {
+        return batch == other.batch && m == other.m && n == other.n && k == other.k;
+    }
+};
+
+/**
+ * @brief The latencies of a matmul shape with the TVM schedule and with CBLAS
+ *
+ */
+struct BlasBenchmark {
+    MatmulShape shape;
+    double tvm_ms{0};
+    double blas_ms{0};
+};
+
+/**
+ * @brief Get the target string of the build. `-libs=cblas` is added if `options.blas_offload` is set
+ *
+ * @param options the build options
+ * @return std::string
+ */
+std::string get_blas_target(const BuildOptions& options);
+
+/**
+ * @brief Set the offload threshold used by the lower call hook of the following builds
+ *
+ * @param options the build options, every CBLAS implementation is allowed if `options.blas_offload` is not set
+ * @return Status error if `options.blas_offload` is set but TVM is built without CBLAS
+ */
+Status set_blas_offload_config(const BuildOptions& options);
+
+/**
+ * @brief Check whether the lower call hook may select the implementation for the call. The CBLAS implementations of
+ * nn.dense and nn.batch_matmul are only allowed if the flops of the call reach the offload threshold
+ *
+ * @param call the relay call
+ * @param impl the op implementation
+ * @return true
+ * @return false if the implementation is a CBLAS one and the call is too small
+ */
+bool is_blas_implementation_allowed(const tvm::relay::Call& call, const tvm::relay::OpImplementation& impl);
+
+/**
+ * @brief Collect the distinct static shapes of the float32 nn.dense and nn.batch_matmul ops in the IRModule
+ *
+ * @param module the relay IRModule
+ * @param shapes output parameter. the matmul shapes
+ * @return Status
+ */
+Status get_matmul_shapes(const tvm::IRModule& module, std::vector<MatmulShape>& shapes);
+
+/**
+ * @brief Benchmark each matmul shape as a single op module with the TVM schedule and with CBLAS
+ *
+ * @param options the build options, e.g. the target
+ * @param shapes the matmul shapes
+ * @param iterations the benchmark iterations of each build
+ * @param benchmarks output parameter. the latencies of the shapes
+ * @return Status
+ */
+Status benchmark_blas_offload(const BuildOptions& options, const std::vector<MatmulShape>& shapes, int iterations,
+                              std::vector<BlasBenchmark>& benchmarks);
+
+/**
+ * @brief Choose the smallest flops threshold above which CBLAS is faster for every benchmarked shape
+ *
+ * @param benchmarks the benchmarks
+ * @return int64_t the threshold for `BuildOptions::blas_min_flops`, INT64_MAX if CBLAS never wins
+ */
+int64_t choose_blas_min_flops(const std::vector<BlasBenchmark>& benchmarks);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef _H_TVM_CPP_COMPILER_BUILD_OPTIONS_H_
+#define _H_TVM_CPP_COMPILER_BUILD_OPTIONS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief The data layout of the convolutions in the compiled module
+ *
+ */
+enum class ConvLayout : uint8_t {
+    // keep the layout of the imported model
+    NCHW,
+    // channels last
+    NHWC,
+    // blocked channels, e.g. NCHW16c, the weights are pre-packed to OIHW16i16o
+    NCHWc
+};
+
+constexpr const char* conv_layout_to_string(ConvLayout layout) {
+    switch (layout) {
+        case ConvLayout::NCHW:
+            return "NCHW";
+        case ConvLayout::NHWC:
+            return "NHWC";
+        case ConvLayout::NCHWc:
+            return "NCHWc";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+/**
+ * @brief Parse the conv layout from string
+ *
+ * @param str the layout string, "NCHW", "NHWC" or "NCHWc"
+ * @param layout output parameter. the conv layout
+ * @return true
+ * @return false if the string is not a valid layout
+ */
+inline bool conv_layout_from_string(const std::string& str, ConvLayout& layout) {
+    if (str == "NCHW") {
+        layout = ConvLayout::NCHW;
+    } else if (str == "NHWC") {
+        layout = ConvLayout::NHWC;
+    } else if (str == "NCHWc") {
+        layout = ConvLayout::NCHWc;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief The executor of the compiled module
+ *
+ */
+enum class ExecutorKind : uint8_t {
+    // interpret the graph json, the intermediate tensors are allocated by the graph memory planner
+    Graph,
+    // ahead of time, the main function is compiled and the workspace is planned statically
+    AOT
+};
+
+constexpr const char* executor_kind_to_string(ExecutorKind kind) {
+    switch (kind) {
+        case ExecutorKind::Graph:
+            return "graph";
+        case ExecutorKind::AOT:
+            return "aot";
+        default:
+            return "unknown";
+    }
+}
+
+/**
+ * @brief Parse the executor kind from string
+ *
+ * @param str the executor string, "graph" or "aot"
+ * @param kind output parameter. the executor kind
+ * @return true
+ * @return false if the string is not a valid executor
+ */
+inline bool executor_kind_from_string(const std::string& str, ExecutorKind& kind) {
+    if (str == "graph") {
+        kind = ExecutorKind::Graph;
+    } else if (str == "aot") {
+        kind = ExecutorKind::AOT;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief The options to compile a relay IRModule
+ *
+ */
+struct BuildOptions {
+    // the compilation target, e.g. "llvm -mcpu=skylake-avx512"
+    std::string target{"llvm"};
+    // the optimization level of the pass context
+    int opt_level{3};
+    // the module name of the compiled library
+    std::string module_name{"default"};
+    // the executor
+    ExecutorKind executor{ExecutorKind::Graph};
+    // embed the params in the .rodata of the library instead of returning them, the graph executor binds them when
+    // it is created. the AOT executor always links the params
+    bool link_params{false};
+
+    // generate the AOT entry point with the C interface and the unpacked api for the crt runtime, e.g.
+    // `tvmgen_default_run(inputs, outputs)`. the module can NOT be run by the c++ runtime, it is for the C packages
+    bool aot_c_interface{false};
+
+    // plan the AOT workspace and constants into single preallocated pools with the unified static memory planner
+    bool usmp{true};
+    // the USMP algorithm, "greedy_by_size", "greedy_by_conflicts" or "hill_climb"
+    std::string usmp_algorithm{"greedy_by_conflicts"};
+
+    // the convolution layout
+    ConvLayout conv_layout{ConvLayout::NCHW};
+    // the channel block size for ConvLayout::NCHWc. 0 means choosing it from the target vector width
+    int nchwc_block{0};
+
+    // the mixed precision type of the compute heavy ops, "float16" or "bfloat16". empty means float32
+    std::string mixed_precision;
+    // the ops converted to the mixed precision type. empty means the default list, e.g. nn.conv2d and nn.dense
+    std::vector<std::string> mixed_precision_allow_ops;
+    // the ops kept in float32, they override the allow list and the default ops which follow their inputs
+    std::vector<std::string> mixed_precision_deny_ops;
+
+    // convert nn.dense with constant weights whose block sparsity reaches the threshold to nn.sparse_dense with BSR
+    // weights, e.g. 0.8. 0 disables the conversion
+    double sparse_threshold{0};
+    // the row block size of the BSR weights. 0 means the largest of 16, 8, 4, 2 and 1 which reaches the threshold
+    int sparse_block_size{0};
+
+    // offload nn.dense and nn.batch_matmul to CBLAS, `-libs=cblas` is added to the target. TVM must be built with
+    // USE_BLAS
+    bool blas_offload{false};
+    // the min flops of the ops offloaded to CBLAS, the smaller ops use the TVM schedules. 0 offloads all of them
+    int64_t blas_min_flops{0};
+    // add the hand-scheduled TE kernels of the float32 nn.dense and the 3x3 stride 1 nn.conv2d to the op strategies,
+    // they are preferred to the TOPI schedules but not to CBLAS
+    bool te_kernels{false};
+    // the JSON file of the cost-based op implementation choices. if it is set, the valid implementations of each new
+    // workload are benchmarked and the fastest is recorded, the recorded choices are reused by the later builds
+    std::string impl_selection_file;
+
+    // the MetaSchedule JSON database directory. if it is set, the tuning records are applied by the build
+    std::string meta_schedule_dir;
+    // the tuning record store shared by all the models, the records are stored per target. if it is set and
+    // `meta_schedule_dir` is not, the records of the target are applied by the build
+    std::string tuning_store_dir;
+};
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
@@ -0,0 +1,350 @@
+#include "c_source_package.h"
+
+#include <tvm/relay/expr.h>
+#include <tvm/relay/function.h>
+#include <tvm/runtime/registry.h>
+
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "compiler/library_exporter.h"
+#include "compiler/model_builder.h"
+#include "utils/utils.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+// the backend api which the generated code may call, the workspace is normally planned statically by USMP
+constexpr const char* kMinimalRuntimeSource = R"(/* the minimal TVM backend runtime of the standalone C package */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <string.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/c_runtime_api.h>
+
+static char g_last_error[256];
+
+void TVMAPISetLastError(const char* msg) {
+    strncpy(g_last_error, msg, sizeof(g_last_error) - 1);
+    g_last_error[sizeof(g_last_error) - 1] = '\0';
+}
+
+const char* TVMGetLastError(void) { return g_last_error; }
+
+void* TVMBackendAllocWorkspace(int device_type, int device_id, uint64_t nbytes, int dtype_code_hint,
+                               int dtype_bits_hint) {
+    void* ptr = NULL;
+    (void)device_type;
+    (void)device_id;
+    (void)dtype_code_hint;
+    (void)dtype_bits_hint;
+    if (posix_memalign(&ptr, 64, nbytes > 0 ? nbytes : 1) != 0) {
+        TVMAPISetLastError("TVMBackendAllocWorkspace: out of memory");
+        return NULL;
+    }
+    return ptr;
+}
+
+int TVMBackendFreeWorkspace(int device_type, int device_id, void* ptr) {
+    (void)device_type;
+    (void)device_id;
+    free(ptr);
+    return 0;
+}
+
+/* the parallel loops run on the calling thread */
+int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+    TVMParallelGroupEnv env;
+    (void)num_task;
+    env.sync_handle = NULL;
+    env.num_task = 1;
+    return flambda(0, &env, cdata);
+}
+
+int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv) {
+    (void)task_id;
+    (void)penv;
+    return 0;
+}
+)";
+
+// the same rule as the C interface of the AOT executor, the characters which are not alphanumeric become '_'
+std::string sanitize_name(const std::string& name) {
+    std::string sanitized = name;
+    for (char& c : sanitized) {
+        if (!std::isalnum(static_cast<unsigned char>(c))) {
+            c = '_';
+        }
+    }
+    return sanitized;
+}
+
+std::string tensor_type_to_string(const tvm::Type& type) {
+    const auto* tensor_type = type.as<tvm::relay::TensorTypeNode>();
+    if (!tensor_type) {
+        return "unknown";
+    }
+
+    std::ostringstream oss;
+    oss << tensor_type->dtype << " [";
+    for (size_t i = 0; i < tensor_type->shape.size(); ++i) {
+        oss << (i > 0 ? ", " : "") << tensor_type->shape[i];
+    }
+    oss << "]";
+    return oss.str();
+}
+
+int64_t get_tensor_bytes(const tvm::Type& type) {
+    const auto* tensor_type = type.as<tvm::relay::TensorTypeNode>();
+    if (!tensor_type) {
+        return -1;
+    }
+
+    int64_t bytes = (tensor_type->dtype.bits() * tensor_type->dtype.lanes() + 7) / 8;
+    for (const auto& dim : tensor_type->shape) {
+        const auto* imm = dim.as<tvm::IntImmNode>();
+        if (!imm) {
+            return -1;
+        }
+        bytes *= imm->value;
+    }
+    return bytes;
+}
+
+Status write_text_file(const std::filesystem::path& path, const std::string& content) {
+    std::ofstream ofs(path);
+    if (!ofs) {
+        std::ostringstream oss;
+        oss << "Open file failed: " << path.string();
+        return Status(StatusCode::RUNTIME_ERROR, oss.str());
+    }
+
+    ofs << content;
+    return Status::ok();
+}
+
+/**
+ * @brief Generate the interface header with the input/output structs and the entry point
+ *
+ */
+std::string generate_interface_header(const std::string& module_name, const tvm::relay::FunctionNode* func,
+                                      CPackageInfo& info) {
+    std::string prefix = "tvmgen_" + sanitize_name(module_name);
+    std::string guard = prefix + "_H_";
+    for (char& c : guard) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+
+    std::vector<std::string> output_types;
+    info.output_bytes.clear();
+    if (const auto* tuple_type = func->body->checked_type().as<tvm::TupleTypeNode>()) {
+        for (const auto& field : tuple_type->fields) {
+            output_types.emplace_back(tensor_type_to_string(field));
+            info.output_bytes.emplace_back(get_tensor_bytes(field));
+        }
+    } else {
+        output_types.emplace_back(tensor_type_to_string(func->body->checked_type()));
+        info.output_bytes.emplace_back(get_tensor_bytes(func->body->checked_type()));
+    }
+
+    std::ostringstream oss;
+    oss << "#ifndef " << guard << "\n#define " << guard << "\n\n#include <stdint.h>\n\n";
+    oss << "#ifdef __cplusplus\nextern \"C\" {\n#endif\n\n";
+
+    oss << "/* the input buffers, dense row-major tensors */\nstruct " << prefix << "_inputs {\n";
+    info.inputs.clear();
+    info.input_bytes.clear();
+    for (const auto& param : func->params) {
+        std::string name = sanitize_name(param->name_hint());
+        info.inputs.emplace_back(name);
+        info.input_bytes.emplace_back(get_tensor_bytes(param->checked_type()));
+        oss << "    void* " << name << ";    /* " << tensor_type_to_string(param->checked_type()) << " */\n";
+    }
+    oss << "};\n\n";
+
+    oss << "/* the output buffers, allocated by the caller */\nstruct " << prefix << "_outputs {\n";
+    info.outputs.clear();
+    for (size_t i = 0; i < output_types.size(); ++i) {
+        std::string name = output_types.size() == 1 ? "output" : "output" + std::to_string(i);
+        info.outputs.emplace_back(name);
+        oss << "    void* " << name << ";    /* " << output_types[i] << " */\n";
+    }
+    oss << "};\n\n";
+
+    oss << "/* run the model, 0 on success */\n";
+    oss << "int32_t " << prefix << "_run(struct " << prefix << "_inputs* inputs, struct " << prefix
+        << "_outputs* outputs);\n\n";
+    oss << "#ifdef __cplusplus\n}\n#endif\n\n#endif\n";
+    return oss.str();
+}
+
+Status copy_runtime_headers(const std::filesystem::path& tvm_home, const std::filesystem::path& include_dir) {
+    const std::vector<std::pair<std::filesystem::path, std::filesystem::path>> headers{
+        {tvm_home / "include/tvm/runtime/c_runtime_api.h", include_dir / "tvm/runtime/c_runtime_api.h"},
+        {tvm_home / "include/tvm/runtime/c_backend_api.h", include_dir / "tvm/runtime/c_backend_api.h"},
+        {tvm_home / "3rdparty/dlpack/include/dlpack/dlpack.h", include_dir / "dlpack/dlpack.h"}};
+
+    for (const auto& header : headers) {
+        std::error_code ec;
+        std::filesystem::create_directories(header.second.parent_path(), ec);
+        std::filesystem::copy_file(header.first, header.second, std::filesystem::copy_options::overwrite_existing,
+                                   ec);
+        if (ec) {
+            std::ostringstream oss;
+            oss << "Copy the runtime header failed: " << header.first.string() << ", " << ec.message();
+            return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+        }
+    }
+
+    return Status::ok();
+}
+
+std::string generate_makefile(const std::string& library_name) {
+    std::ostringstream oss;
+    oss << "CC ?= gcc\nAR ?= ar\nCFLAGS ?= -O2 -fPIC\n\n";
+    oss << "SRCS := $(wildcard src/*.c)\nOBJS := $(SRCS:.c=.o)\n\n";
+    oss << library_name << ": $(OBJS)\n\t$(AR) rcs $@ $^\n\n";
+    oss << "%.o: %.c\n\t$(CC) $(CFLAGS) -Iinclude -c $< -o $@\n\n";
+    oss << "clean:\n\trm -f $(OBJS) " << library_name << "\n\n.PHONY: clean\n";
+    return oss.str();
+}
+
+Status build_static_library(const std::filesystem::path& dir, const CPackageOptions& package_options,
+                            CPackageInfo& info, const std::string& library_name) {
+    std::vector<std::string> objects;
+    for (const auto& source : info.sources) {
+        std::string object = std::filesystem::path(source).replace_extension(".o").string();
+        std::ostringstream cmd;
+        cmd << tvm_cpp::utils::shell_quote(package_options.cc);
+        for (const auto& option : package_options.cc_options) {
+            cmd << " " << tvm_cpp::utils::shell_quote(option);
+        }
+        cmd << " -I" << tvm_cpp::utils::shell_quote((dir / "include").string()) << " -c "
+            << tvm_cpp::utils::shell_quote(source) << " -o " << tvm_cpp::utils::shell_quote(object);
+
+        if (std::system(cmd.str().c_str()) != 0) {
+            std::ostringstream oss;
+            oss << "Compile the C source failed: " << cmd.str();
+            return Status(StatusCode::RUNTIME_ERROR, oss.str());
+        }
+        objects.emplace_back(object);
+    }
+
+    std::string library = (dir / library_name).string();
+    std::ostringstream cmd;
+    cmd << tvm_cpp::utils::shell_quote(package_options.ar) << " rcs " << tvm_cpp::utils::shell_quote(library);
+    for (const auto& object : objects) {
+        cmd << " " << tvm_cpp::utils::shell_quote(object);
+    }
+
+    if (std::system(cmd.str().c_str()) != 0) {
+        std::ostringstream oss;
+        oss << "Archive the static library failed: " << cmd.str();
+        return Status(StatusCode::RUNTIME_ERROR, oss.str());
+    }
+
+    info.static_library = library;
+    return Status::ok();
+}
+
+}    // namespace
+
+Status export_c_package(const tvm::IRModule& module, const BuildOptions& options, const std::string& dir,
+                        const CPackageOptions& package_options, CPackageInfo& info) {
+    // type infer
+    const tvm::runtime::PackedFunc* type_infer = tvm::runtime::Registry::Get("relay._transform.InferType");
+    if (!type_infer) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._transform.InferType expression not found");
+    }
+
+    // pass run
+    const tvm::runtime::PackedFunc* pass_run = tvm::runtime::Registry::Get("transform.RunPass");
+    if (!pass_run) {
+        return Status(StatusCode::RUNTIME_ERROR, "transform.pass_run expression not found");
+    }
+
+    BuildOptions package_build_options = options;
+    if (package_build_options.target.rfind("c", 0) != 0 || package_build_options.target.rfind("cuda", 0) == 0) {
+        package_build_options.target = "c";
+    }
+    package_build_options.executor = ExecutorKind::AOT;
+    package_build_options.aot_c_interface = true;
+
+    BuildResult result;
+    auto status = build_irmodule(module, package_build_options, result);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    std::filesystem::path dir_path(dir);
+    std::filesystem::path src_dir = dir_path / "src";
+    std::filesystem::path include_dir = dir_path / "include";
+    std::error_code ec;
+    std::filesystem::create_directories(src_dir, ec);
+    std::filesystem::create_directories(include_dir, ec);
+    if (ec) {
+        std::ostringstream oss;
+        oss << "Create package directory failed: " << dir << ", " << ec.message();
+        return Status(StatusCode::RUNTIME_ERROR, oss.str());
+    }
+
+    info = CPackageInfo();
+    try {
+        std::vector<tvm::runtime::Module> dso_modules;
+        get_dso_modules(result.lib, dso_modules);
+        for (size_t i = 0; i < dso_modules.size(); ++i) {
+            if (std::string(dso_modules[i]->type_key()) != "c") {
+                std::ostringstream oss;
+                oss << "Only the c modules can be packaged, got: " << dso_modules[i]->type_key();
+                return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+            }
+
+            std::string source = (src_dir / ("lib" + std::to_string(i) + ".c")).string();
+            dso_modules[i]->SaveToFile(source, "c");
+            info.sources.emplace_back(source);
+        }
+
+        tvm::IRModule typed_module = (*pass_run)((*type_infer)(), module);
+        const auto* func = typed_module->Lookup("main").as<tvm::relay::FunctionNode>();
+        if (!func) {
+            return Status(StatusCode::INVALID_PARAM, "the module has no relay main function");
+        }
+
+        info.header = (include_dir / ("tvmgen_" + sanitize_name(result.module_name) + ".h")).string();
+        status = write_text_file(info.header, generate_interface_header(result.module_name, func, info));
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    std::string runtime_source = (src_dir / "tvm_runtime_minimal.c").string();
+    status = write_text_file(runtime_source, kMinimalRuntimeSource);
+    if (!status.is_ok()) {
+        return status;
+    }
+    info.sources.emplace_back(runtime_source);
+
+    status = copy_runtime_headers(package_options.tvm_home, include_dir);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    std::string library_name = "lib" + sanitize_name(result.module_name) + ".a";
+    status = write_text_file(dir_path / "Makefile", generate_makefile(library_name));
+    if (!status.is_ok() || package_options.cc.empty()) {
+        return status;
+    }
+
+    return build_static_library(dir_path, package_options, info, library_name);
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
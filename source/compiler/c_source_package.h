@@ -0,0 +1,73 @@
+#ifndef _H_TVM_CPP_COMPILER_C_SOURCE_PACKAGE_H_
+#define _H_TVM_CPP_COMPILER_C_SOURCE_PACKAGE_H_
+
+#include <tvm/ir/module.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief The options of the standalone C source package
+ *
+ */
+struct CPackageOptions {
+    // the TVM source directory, the C runtime api headers and dlpack.h are copied from it
+    std::string tvm_home{"third_party/tvm"};
+    // the C compiler which builds the static library. empty means only the sources are exported
+    std::string cc{"gcc"};
+    // the archiver of the static library
+    std::string ar{"ar"};
+    // the C compiler options
+    std::vector<std::string> cc_options{"-O2", "-fPIC"};
+};
+
+/**
+ * @brief The files and the interface of the exported C source package
+ *
+ */
+struct CPackageInfo {
+    // the interface header, include/tvmgen_<module_name>.h
+    std::string header;
+    // the C sources of the model and the minimal runtime
+    std::vector<std::string> sources;
+    // the static library, lib<module_name>.a. empty if it is not built
+    std::string static_library;
+    // the members of the input and output structs, in order
+    std::vector<std::string> inputs;
+    std::vector<std::string> outputs;
+    // the buffer sizes of the inputs and outputs in bytes, -1 for the dynamic shapes
+    std::vector<int64_t> input_bytes;
+    std::vector<int64_t> output_bytes;
+};
+
+/**
+ * @brief Export the model as a self-contained C source package which needs no TVM runtime library:
+ * - src/*.c: the fused kernels, the AOT entry point and the linked constants, generated by the "c" target with the
+ *   C interface and the unpacked api. USMP plans the workspace and the constants into static arrays
+ * - src/tvm_runtime_minimal.c: the backend api the generated code may call, e.g. TVMBackendAllocWorkspace
+ * - include/tvmgen_<module_name>.h: the input/output structs and `tvmgen_<module_name>_run`
+ * - include/tvm, include/dlpack: the C runtime api headers included by the generated code
+ * - Makefile: builds lib<module_name>.a with any C compiler
+ * The static library is built with `package_options.cc` if it is set
+ *
+ * @param module the relay IRModule
+ * @param options the build options, the target is "c" and the executor is AOT with the C interface
+ * @param dir the package directory, created if it is missing
+ * @param package_options the package options
+ * @param info output parameter. the package files and interface
+ * @return Status
+ */
+Status export_c_package(const tvm::IRModule& module, const BuildOptions& options, const std::string& dir,
+                        const CPackageOptions& package_options, CPackageInfo& info);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
@@ -0,0 +1,136 @@
+#include "cross_compiler.h"
+
+#include <elf.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "compiler/model_artifact.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+bool starts_with(const std::string& str, const std::string& prefix) { return str.rfind(prefix, 0) == 0; }
+
+/**
+ * @brief Read the ELF header
+ *
+ * @return Status error if the file is not a little endian ELF file
+ */
+Status read_elf_header(const std::string& path, uint16_t& type, uint16_t& machine) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) {
+        std::ostringstream oss;
+        oss << "File does NOT exist: " << path;
+        return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+    }
+
+    // e_type and e_machine follow e_ident in both the 32-bit and the 64-bit headers
+    unsigned char header[EI_NIDENT + 2 * sizeof(uint16_t)];
+    if (!ifs.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        std::memcmp(header, ELFMAG, SELFMAG) != 0) {
+        std::ostringstream oss;
+        oss << "Not an ELF file: " << path;
+        return Status(StatusCode::INVALID_MODEL, oss.str());
+    }
+
+    if (header[EI_DATA] != ELFDATA2LSB) {
+        std::ostringstream oss;
+        oss << "Only the little endian ELF files are supported: " << path;
+        return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+    }
+
+    type = static_cast<uint16_t>(header[EI_NIDENT] | (header[EI_NIDENT + 1] << 8));
+    machine = static_cast<uint16_t>(header[EI_NIDENT + 2] | (header[EI_NIDENT + 3] << 8));
+    return Status::ok();
+}
+
+}    // namespace
+
+std::string get_cross_target(const CrossCompileOptions& options) {
+    std::ostringstream oss;
+    oss << "llvm -mtriple=" << options.triple;
+    if (!options.mcpu.empty()) {
+        oss << " -mcpu=" << options.mcpu;
+    }
+
+    if (get_triple_elf_machine(options.triple) == EM_AARCH64) {
+        oss << " -mattr=+neon";
+        if (options.sve) {
+            oss << ",+sve";
+        }
+    }
+
+    return oss.str();
+}
+
+ExportOptions get_cross_export_options(const CrossCompileOptions& options) {
+    ExportOptions export_options;
+    export_options.cc = options.toolchain_prefix + "g++";
+    if (!options.sysroot.empty()) {
+        export_options.cc_options.emplace_back("--sysroot=" + options.sysroot);
+    }
+
+    return export_options;
+}
+
+uint16_t get_triple_elf_machine(const std::string& triple) {
+    if (starts_with(triple, "aarch64") || starts_with(triple, "arm64")) {
+        return EM_AARCH64;
+    }
+    if (starts_with(triple, "x86_64")) {
+        return EM_X86_64;
+    }
+    if (starts_with(triple, "arm") || starts_with(triple, "thumb")) {
+        return EM_ARM;
+    }
+    if (starts_with(triple, "riscv")) {
+        return EM_RISCV;
+    }
+
+    return 0;
+}
+
+Status get_elf_machine(const std::string& path, uint16_t& machine) {
+    uint16_t type = 0;
+    return read_elf_header(path, type, machine);
+}
+
+Status verify_cross_artifact(const std::string& artifact_dir, const CrossCompileOptions& options) {
+    uint16_t expected_machine = get_triple_elf_machine(options.triple);
+    if (expected_machine == 0) {
+        std::ostringstream oss;
+        oss << "Unknown architecture of the triple: " << options.triple;
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    std::string lib_path = (std::filesystem::path(artifact_dir) / kArtifactLibraryFile).string();
+    uint16_t type = 0;
+    uint16_t machine = 0;
+    auto status = read_elf_header(lib_path, type, machine);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    if (type != ET_DYN) {
+        std::ostringstream oss;
+        oss << "The library is not an ELF shared library: " << lib_path << ", e_type: " << type;
+        return Status(StatusCode::INVALID_MODEL, oss.str());
+    }
+
+    if (machine != expected_machine) {
+        std::ostringstream oss;
+        oss << "The library is built for ELF machine " << machine << " instead of " << expected_machine << " ("
+            << options.triple << "): " << lib_path;
+        return Status(StatusCode::INVALID_MODEL, oss.str());
+    }
+
+    return Status::ok();
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
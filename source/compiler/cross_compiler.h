@@ -0,0 +1,76 @@
+#ifndef _H_TVM_CPP_COMPILER_CROSS_COMPILER_H_
+#define _H_TVM_CPP_COMPILER_CROSS_COMPILER_H_
+
+#include <cstdint>
+#include <string>
+
+#include "compiler/library_exporter.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief The options to compile the artifacts for another architecture, aarch64 linux by default
+ *
+ */
+struct CrossCompileOptions {
+    // the target triple of the generated code
+    std::string triple{"aarch64-linux-gnu"};
+    // the target cpu, e.g. "cortex-a76" or "neoverse-v1". empty means the generic cpu of the triple
+    std::string mcpu;
+    // generate the scalable vector extension instructions, e.g. for neoverse-v1. NEON is always enabled on aarch64
+    bool sve{false};
+    // the prefix of the cross toolchain which links the shared library, the linker is `<prefix>g++`
+    std::string toolchain_prefix{"aarch64-linux-gnu-"};
+    // the sysroot of the cross toolchain. empty means the default sysroot of the toolchain
+    std::string sysroot;
+};
+
+/**
+ * @brief Get the llvm target string, e.g. "llvm -mtriple=aarch64-linux-gnu -mattr=+neon,+sve"
+ *
+ * @param options the cross compile options
+ * @return std::string
+ */
+std::string get_cross_target(const CrossCompileOptions& options);
+
+/**
+ * @brief Get the options to export the shared library with the cross toolchain
+ *
+ * @param options the cross compile options
+ * @return ExportOptions
+ */
+ExportOptions get_cross_export_options(const CrossCompileOptions& options);
+
+/**
+ * @brief Get the ELF machine of the target triple
+ *
+ * @param triple the target triple, e.g. "aarch64-linux-gnu"
+ * @return uint16_t the ELF e_machine, e.g. EM_AARCH64. 0 if the architecture is unknown
+ */
+uint16_t get_triple_elf_machine(const std::string& triple);
+
+/**
+ * @brief Read the machine of an ELF object or shared library
+ *
+ * @param path the ELF file
+ * @param machine output parameter. the ELF e_machine
+ * @return Status error if the file is not an ELF file
+ */
+Status get_elf_machine(const std::string& path, uint16_t& machine);
+
+/**
+ * @brief Verify that the library of the artifact directory is an ELF shared library of the target triple, so the
+ * artifact is loadable on the target hosts although it can not be loaded on the build host
+ *
+ * @param artifact_dir the artifact directory exported by `export_model_artifact`
+ * @param options the cross compile options
+ * @return Status
+ */
+Status verify_cross_artifact(const std::string& artifact_dir, const CrossCompileOptions& options);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
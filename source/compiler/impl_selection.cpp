@@ -0,0 +1,343 @@
+#include "impl_selection.h"
+
+#include <picojson.h>
+#include <tvm/driver/driver_api.h>
+#include <tvm/ir/global_var_supply.h>
+#include <tvm/node/serialization.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/te/operation.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+
+#include "compiler/tuning_record_store.h"
+#include "utils/utils.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+// the runs of each implementation, the latency is the best mean of the repeats
+constexpr int kBenchmarkWarmup = 1;
+constexpr int kBenchmarkRepeat = 3;
+constexpr int kBenchmarkNumber = 5;
+
+// serializes the selections, the records are keyed by "<target>|<workload>"
+std::mutex g_selection_mutex;
+std::string g_selection_file;
+std::map<std::string, ImplSelectionRecord> g_selection_records;
+
+/**
+ * @brief Get the workload of the call, i.e. the op name, the input types and the hash of the attributes
+ *
+ * @return true
+ * @return false if any input shape is dynamic
+ */
+bool get_workload(const tvm::relay::Call& call, const tvm::runtime::Array<tvm::te::Tensor>& inputs,
+                  std::string& workload) {
+    const auto* op = call->op.as<tvm::OpNode>();
+    if (!op) {
+        return false;
+    }
+
+    std::ostringstream oss;
+    oss << op->name << "(";
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        oss << (i > 0 ? "," : "") << inputs[i]->dtype << "[";
+        for (size_t j = 0; j < inputs[i]->shape.size(); ++j) {
+            const auto* dim = inputs[i]->shape[j].as<tvm::IntImmNode>();
+            if (!dim) {
+                return false;
+            }
+            oss << (j > 0 ? "," : "") << dim->value;
+        }
+        oss << "]";
+    }
+    oss << ")";
+
+    std::string attrs = call->attrs.defined() ? tvm::SaveJSON(call->attrs) : "";
+    oss << "#" << std::hex << std::setw(16) << std::setfill('0') << tvm_cpp::utils::fnv1a_hash(attrs);
+    workload = oss.str();
+    return true;
+}
+
+/**
+ * @brief Create an argument of the benchmark on the device, the float32 data are random and the others are zeros,
+ * which are always in range as indices
+ *
+ */
+tvm::runtime::NDArray create_benchmark_array(const tvm::te::Tensor& tensor, const DLDevice& device,
+                                             std::mt19937& engine) {
+    std::vector<int64_t> shape;
+    for (const auto& dim : tensor->shape) {
+        shape.emplace_back(dim.as<tvm::IntImmNode>()->value);
+    }
+
+    tvm::runtime::NDArray host = tvm::runtime::NDArray::Empty(shape, tensor->dtype, {DLDeviceType::kDLCPU, 0});
+    size_t size = tvm::runtime::GetDataSize(*host.operator->());
+    if (tensor->dtype == tvm::DataType::Float(32)) {
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        float* data = static_cast<float*>(host->data);
+        for (size_t i = 0; i < size / sizeof(float); ++i) {
+            data[i] = dist(engine);
+        }
+    } else {
+        std::memset(host->data, 0, size);
+    }
+
+    if (device.device_type == DLDeviceType::kDLCPU) {
+        return host;
+    }
+
+    tvm::runtime::NDArray array = tvm::runtime::NDArray::Empty(shape, tensor->dtype, device);
+    array.CopyFrom(host);
+    return array;
+}
+
+/**
+ * @brief Build the implementation alone for the concrete input shapes and measure its latency on the target device
+ *
+ */
+Status benchmark_implementation(const tvm::relay::Call& call, const tvm::runtime::Array<tvm::te::Tensor>& inputs,
+                                const tvm::Target& target, const tvm::relay::OpImplementation& impl,
+                                double& latency_ms) {
+    try {
+        // the inputs of the fused function may be computed by other ops, so the op is rebuilt on placeholders
+        tvm::runtime::Array<tvm::te::Tensor> args;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            args.push_back(tvm::te::placeholder(inputs[i]->shape, inputs[i]->dtype, "input" + std::to_string(i)));
+        }
+
+        tvm::runtime::Array<tvm::te::Tensor> outputs = impl.Compute(call->attrs, args, call->checked_type());
+        tvm::te::Schedule schedule = impl.Schedule(call->attrs, outputs, target);
+        for (const auto& output : outputs) {
+            args.push_back(output);
+        }
+
+        tvm::IRModule mod = tvm::LowerSchedule(schedule, args, "main", {}, tvm::GlobalVarSupply(tvm::NameSupply("")));
+        tvm::runtime::Module module = tvm::build(mod, target, tvm::Target());
+        tvm::runtime::PackedFunc func = module.GetFunction("main", true);
+        if (func == nullptr) {
+            return Status(StatusCode::RUNTIME_ERROR, "the benchmark function not found");
+        }
+
+        DLDevice device{static_cast<DLDeviceType>(target->GetTargetDeviceType()), 0};
+        std::mt19937 engine(0);
+        std::vector<tvm::runtime::NDArray> arrays;
+        for (const auto& arg : args) {
+            arrays.emplace_back(create_benchmark_array(arg, device, engine));
+        }
+
+        std::vector<TVMValue> values(arrays.size());
+        std::vector<int> type_codes(arrays.size());
+        tvm::runtime::TVMArgsSetter setter(values.data(), type_codes.data());
+        for (size_t i = 0; i < arrays.size(); ++i) {
+            setter(i, arrays[i]);
+        }
+        tvm::runtime::TVMArgs func_args(values.data(), type_codes.data(), static_cast<int>(arrays.size()));
+        tvm::runtime::TVMRetValue ret;
+        tvm::runtime::DeviceAPI* device_api = tvm::runtime::DeviceAPI::Get(device);
+
+        for (int i = 0; i < kBenchmarkWarmup; ++i) {
+            func.CallPacked(func_args, &ret);
+        }
+        device_api->StreamSync(device, nullptr);
+
+        latency_ms = std::numeric_limits<double>::max();
+        for (int repeat = 0; repeat < kBenchmarkRepeat; ++repeat) {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < kBenchmarkNumber; ++i) {
+                func.CallPacked(func_args, &ret);
+            }
+            device_api->StreamSync(device, nullptr);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            latency_ms = std::min(latency_ms, elapsed.count() / kBenchmarkNumber);
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+/**
+ * @brief Write the records to the selection file, the file is replaced atomically
+ *
+ */
+Status save_selection_records(const std::string& path, const std::map<std::string, ImplSelectionRecord>& records) {
+    picojson::array values;
+    for (const auto& item : records) {
+        const ImplSelectionRecord& record = item.second;
+        picojson::object timings;
+        for (const auto& timing : record.timings) {
+            timings[timing.first] = picojson::value(timing.second);
+        }
+
+        picojson::object value;
+        value["target"] = picojson::value(record.target);
+        value["workload"] = picojson::value(record.workload);
+        value["impl"] = picojson::value(record.impl);
+        value["timings"] = picojson::value(timings);
+        values.emplace_back(value);
+    }
+
+    picojson::object root;
+    root["records"] = picojson::value(values);
+
+    std::string tmp_path = path + ".tmp." + std::to_string(getpid());
+    {
+        std::ofstream ofs(tmp_path, std::ios::binary);
+        if (!ofs) {
+            std::ostringstream oss;
+            oss << "Open file failed: " << tmp_path;
+            return Status(StatusCode::RUNTIME_ERROR, oss.str());
+        }
+        ofs << picojson::value(root).serialize(true);
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_path, ec);
+        std::ostringstream oss;
+        oss << "Write the implementation selection file failed: " << path;
+        return Status(StatusCode::RUNTIME_ERROR, oss.str());
+    }
+
+    return Status::ok();
+}
+
+}    // namespace
+
+Status load_impl_selection_records(const std::string& path, std::vector<ImplSelectionRecord>& records) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) {
+        std::ostringstream oss;
+        oss << "File does NOT exist: " << path;
+        return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+    }
+
+    picojson::value root;
+    std::string err = picojson::parse(root, ifs);
+    if (!err.empty() || !root.is<picojson::object>() || !root.contains("records") ||
+        !root.get("records").is<picojson::array>()) {
+        std::ostringstream oss;
+        oss << "Invalid implementation selection file: " << path << " " << err;
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    records.clear();
+    for (const auto& value : root.get("records").get<picojson::array>()) {
+        if (!value.is<picojson::object>() || !value.get("target").is<std::string>() ||
+            !value.get("workload").is<std::string>() || !value.get("impl").is<std::string>()) {
+            std::ostringstream oss;
+            oss << "Invalid record in the implementation selection file: " << value.serialize();
+            return Status(StatusCode::INVALID_PARAM, oss.str());
+        }
+
+        ImplSelectionRecord record;
+        record.target = value.get("target").get<std::string>();
+        record.workload = value.get("workload").get<std::string>();
+        record.impl = value.get("impl").get<std::string>();
+        if (value.get("timings").is<picojson::object>()) {
+            for (const auto& timing : value.get("timings").get<picojson::object>()) {
+                if (timing.second.is<double>()) {
+                    record.timings.emplace_back(timing.first, timing.second.get<double>());
+                }
+            }
+        }
+        records.emplace_back(record);
+    }
+
+    return Status::ok();
+}
+
+Status set_impl_selection_config(const BuildOptions& options) {
+    std::lock_guard<std::mutex> lock(g_selection_mutex);
+    g_selection_file = options.impl_selection_file;
+    g_selection_records.clear();
+    if (options.impl_selection_file.empty() || !tvm_cpp::utils::file_exist(options.impl_selection_file)) {
+        return Status::ok();
+    }
+
+    std::vector<ImplSelectionRecord> records;
+    auto status = load_impl_selection_records(options.impl_selection_file, records);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    for (const auto& record : records) {
+        g_selection_records[record.target + "|" + record.workload] = record;
+    }
+    return Status::ok();
+}
+
+Status select_fastest_implementation(const tvm::relay::Call& call, const tvm::runtime::Array<tvm::te::Tensor>& inputs,
+                                     const tvm::Target& target, const std::vector<tvm::relay::OpImplementation>& impls,
+                                     tvm::relay::OpImplementation& impl, bool& selected) {
+    selected = false;
+
+    // the benchmarks of a workload run once even if the TE compiler lowers it from several threads
+    std::lock_guard<std::mutex> lock(g_selection_mutex);
+    std::string workload;
+    if (g_selection_file.empty() || impls.size() <= 1 || !get_workload(call, inputs, workload)) {
+        return Status::ok();
+    }
+
+    std::string target_key = get_target_key(target);
+    std::string key = target_key + "|" + workload;
+    auto iter = g_selection_records.find(key);
+    if (iter != g_selection_records.end()) {
+        for (const auto& candidate : impls) {
+            if (candidate->name == iter->second.impl) {
+                impl = candidate;
+                selected = true;
+                return Status::ok();
+            }
+        }
+        // the recorded implementation is not valid anymore, e.g. the CBLAS offload is disabled
+    }
+
+    ImplSelectionRecord record;
+    record.target = target_key;
+    record.workload = workload;
+    double best_ms = std::numeric_limits<double>::max();
+    for (const auto& candidate : impls) {
+        double latency_ms = 0;
+        auto status = benchmark_implementation(call, inputs, target, candidate, latency_ms);
+        if (!status.is_ok()) {
+            LOG(WARNING) << "benchmark " << candidate->name << " of " << workload << " failed: " << status;
+            continue;
+        }
+
+        record.timings.emplace_back(candidate->name, latency_ms);
+        if (latency_ms < best_ms) {
+            best_ms = latency_ms;
+            record.impl = candidate->name;
+            impl = candidate;
+        }
+    }
+
+    // all the benchmarks failed, the default choice is not recorded
+    if (record.impl.empty()) {
+        return Status::ok();
+    }
+
+    selected = true;
+    g_selection_records[key] = record;
+    return save_selection_records(g_selection_file, g_selection_records);
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
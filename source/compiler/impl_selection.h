@@ -0,0 +1,73 @@
+#ifndef _H_TVM_CPP_COMPILER_IMPL_SELECTION_H_
+#define _H_TVM_CPP_COMPILER_IMPL_SELECTION_H_
+
+#include <tvm/relay/expr.h>
+#include <tvm/relay/op_strategy.h>
+#include <tvm/target/target.h>
+#include <tvm/te/tensor.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief The implementation choice of a workload, i.e. an op call with concrete input shapes and attributes
+ *
+ */
+struct ImplSelectionRecord {
+    // the key of the target, see get_target_key
+    std::string target;
+    // e.g. "nn.dense(float32[1,2048],float32[1000,2048])#5b1d3a0c7e4f2a91", the suffix is the hash of the attributes
+    std::string workload;
+    // the name of the fastest implementation
+    std::string impl;
+    // the latency in milliseconds of each benchmarked implementation, the failed ones are not listed
+    std::vector<std::pair<std::string, double>> timings;
+};
+
+/**
+ * @brief Set the cost-based selection of the lower call hook for the next build. The records of
+ * `options.impl_selection_file` are loaded if the file exists, an empty file name disables the selection
+ *
+ * @param options the build options
+ * @return Status
+ */
+Status set_impl_selection_config(const BuildOptions& options);
+
+/**
+ * @brief Select the fastest implementation of the call. The recorded choice of the workload is used if it is still a
+ * valid implementation, otherwise each implementation is built for the concrete shapes and benchmarked, and the new
+ * record is appended to the selection file
+ *
+ * @param call the relay call
+ * @param inputs the te input tensors of the call
+ * @param target the compilation target
+ * @param impls the valid implementations
+ * @param impl output parameter. the fastest implementation
+ * @param selected output parameter. false if the selection is disabled, the call has dynamic shapes or a single
+ * implementation, the caller keeps its default choice
+ * @return Status
+ */
+Status select_fastest_implementation(const tvm::relay::Call& call, const tvm::runtime::Array<tvm::te::Tensor>& inputs,
+                                     const tvm::Target& target, const std::vector<tvm::relay::OpImplementation>& impls,
+                                     tvm::relay::OpImplementation& impl, bool& selected);
+
+/**
+ * @brief Load the records of an implementation selection file
+ *
+ * @param path the selection file
+ * @param records output parameter. the records sorted by target and workload
+ * @return Status
+ */
+Status load_impl_selection_records(const std::string& path, std::vector<ImplSelectionRecord>& records);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
@@ -0,0 +1,290 @@
+#include "layout_transform.h"
+
+#include <tvm/ir/op.h>
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/relay/transform.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/op.h>
+
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+// the channel block size used by the registered FTVMAlterOpLayout of nn.conv2d, it is set only while
+// `convert_conv_layout` runs AlterOpLayout on this thread, 0 keeps the NCHW convolutions of the other builds
+thread_local int g_nchwc_block = 0;
+
+/**
+ * @brief Enable the NCHWc FTVMAlterOpLayout of nn.conv2d on this thread for the scope
+ *
+ */
+class NCHWcBlockScope final {
+public:
+    explicit NCHWcBlockScope(int block) : m_previous(g_nchwc_block) { g_nchwc_block = block; }
+    ~NCHWcBlockScope() { g_nchwc_block = m_previous; }
+
+    NCHWcBlockScope(const NCHWcBlockScope&) = delete;
+    NCHWcBlockScope& operator=(const NCHWcBlockScope&) = delete;
+
+private:
+    int m_previous;
+};
+
+/**
+ * @brief Get the largest block size which is not greater than `block` and divides `channels`
+ *
+ * @param channels the channels
+ * @param block the max block size
+ * @return int
+ */
+int get_divisible_block(int64_t channels, int block) {
+    for (int bn = block; bn > 1; --bn) {
+        if (channels % bn == 0) {
+            return bn;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief The FTVMConvertOpLayout of nn.conv2d, used by the ConvertLayout pass
+ *
+ */
+tvm::relay::Expr convert_conv2d_layout(const tvm::Attrs& attrs, const tvm::runtime::Array<tvm::relay::Expr>& args,
+                                       const tvm::runtime::Array<tvm::te::Tensor>& tinfos,
+                                       const tvm::runtime::Array<tvm::runtime::String>& desired_layouts) {
+    static const tvm::runtime::PackedFunc* conv2d = tvm::runtime::Registry::Get("relay.op.nn._make.conv2d");
+    ICHECK(conv2d) << "relay.op.nn._make.conv2d expression not found";
+
+    const auto* conv_attrs = attrs.as<tvm::relay::Conv2DAttrs>();
+    ICHECK(conv_attrs) << "invalid attributes of nn.conv2d";
+    ICHECK_GE(desired_layouts.size(), 1) << "the desired layouts of nn.conv2d are empty";
+
+    tvm::runtime::String data_layout = desired_layouts[0];
+    tvm::runtime::String kernel_layout;
+    if (desired_layouts.size() > 1 && desired_layouts[1] != "default") {
+        kernel_layout = desired_layouts[1];
+    } else if (data_layout == "NHWC") {
+        // depthwise convolution keeps the output channels innermost
+        bool depthwise = conv_attrs->groups > 1 && tinfos.size() > 1 &&
+                         tvm::tir::is_const_int(tinfos[1]->shape[0], conv_attrs->groups);
+        kernel_layout = depthwise ? "HWOI" : "HWIO";
+    } else {
+        kernel_layout = "OIHW";
+    }
+
+    return (*conv2d)(args[0], args[1], conv_attrs->strides, conv_attrs->padding, conv_attrs->dilation,
+                     conv_attrs->groups, conv_attrs->channels, conv_attrs->kernel_size, data_layout, kernel_layout,
+                     conv_attrs->out_layout, conv_attrs->out_dtype);
+}
+
+/**
+ * @brief The FTVMAlterOpLayout of nn.conv2d, used by the AlterOpLayout pass.
+ * It rewrites the NCHW convolution to contrib_conv2d_NCHWc only inside `convert_conv_layout`, the AlterOpLayout of
+ * relay.build and the other builds keep the call
+ *
+ */
+tvm::relay::Expr alter_conv2d_layout(const tvm::Attrs& attrs, const tvm::runtime::Array<tvm::relay::Expr>& args,
+                                     const tvm::runtime::Array<tvm::te::Tensor>& tinfos, const tvm::Type& out_type) {
+    int block = g_nchwc_block;
+    if (block <= 0) {
+        return tvm::relay::Expr();
+    }
+
+    static const tvm::runtime::PackedFunc* conv2d_nchwc =
+        tvm::runtime::Registry::Get("relay.op.nn._make.contrib_conv2d_NCHWc");
+    ICHECK(conv2d_nchwc) << "relay.op.nn._make.contrib_conv2d_NCHWc expression not found";
+
+    const auto* conv_attrs = attrs.as<tvm::relay::Conv2DAttrs>();
+    ICHECK(conv_attrs) << "invalid attributes of nn.conv2d";
+
+    // only the plain NCHW convolution is blocked, return an undefined expr to keep the call
+    if (conv_attrs->data_layout != "NCHW" || conv_attrs->kernel_layout != "OIHW" || conv_attrs->groups != 1 ||
+        tinfos.size() < 2) {
+        return tvm::relay::Expr();
+    }
+
+    const auto* in_channel = tinfos[0]->shape[1].as<tvm::IntImmNode>();
+    const auto* out_channel = tinfos[1]->shape[0].as<tvm::IntImmNode>();
+    if (!in_channel || !out_channel) {
+        return tvm::relay::Expr();
+    }
+
+    int ic_bn = get_divisible_block(in_channel->value, block);
+    int oc_bn = get_divisible_block(out_channel->value, block);
+
+    std::ostringstream data_layout;
+    data_layout << "NCHW" << ic_bn << "c";
+    std::ostringstream kernel_layout;
+    kernel_layout << "OIHW" << ic_bn << "i" << oc_bn << "o";
+    std::ostringstream out_layout;
+    out_layout << "NCHW" << oc_bn << "c";
+
+    return (*conv2d_nchwc)(args[0], args[1], conv_attrs->strides, conv_attrs->padding, conv_attrs->dilation,
+                           conv_attrs->groups, conv_attrs->channels, conv_attrs->kernel_size,
+                           tvm::runtime::String(data_layout.str()), tvm::runtime::String(kernel_layout.str()),
+                           tvm::runtime::String(out_layout.str()), conv_attrs->out_dtype);
+}
+
+/**
+ * @brief Register the layout functions of nn.conv2d if they are not registered yet
+ *
+ */
+void register_conv2d_layout_functions() {
+    tvm::Op conv2d_op = tvm::Op::Get("nn.conv2d");
+    if (!tvm::Op::HasAttrMap("FTVMConvertOpLayout") ||
+        !tvm::Op::GetAttrMap<tvm::relay::FTVMConvertOpLayout>("FTVMConvertOpLayout").count(conv2d_op)) {
+        tvm::OpRegEntry::RegisterOrGet("nn.conv2d")
+            .set_attr<tvm::relay::FTVMConvertOpLayout>("FTVMConvertOpLayout", convert_conv2d_layout);
+    }
+
+    if (!tvm::Op::HasAttrMap("FTVMAlterOpLayout") ||
+        !tvm::Op::GetAttrMap<tvm::relay::FTVMAlterOpLayout>("FTVMAlterOpLayout").count(conv2d_op)) {
+        tvm::OpRegEntry::RegisterOrGet("nn.conv2d")
+            .set_attr<tvm::relay::FTVMAlterOpLayout>("FTVMAlterOpLayout", alter_conv2d_layout);
+    }
+}
+
+/**
+ * @brief Count the layout_transform calls
+ *
+ */
+class LayoutTransformCounter : public tvm::relay::ExprVisitor {
+public:
+    LayoutTransformCounter() : m_layout_transform_op(tvm::Op::Get("layout_transform")) {}
+    virtual ~LayoutTransformCounter() = default;
+
+    void VisitExpr_(const tvm::relay::CallNode* call) override {
+        if (call->op.same_as(m_layout_transform_op)) {
+            if (call->args[0].as<tvm::relay::ConstantNode>()) {
+                ++m_stats.constant_transforms;
+            } else {
+                ++m_stats.activation_transforms;
+            }
+        }
+
+        tvm::relay::ExprVisitor::VisitExpr_(call);
+    }
+
+    const LayoutTransformStats& stats() const { return m_stats; }
+
+private:
+    tvm::Op m_layout_transform_op;
+    LayoutTransformStats m_stats;
+};
+
+}    // namespace
+
+int get_nchwc_block(const BuildOptions& options, const tvm::Target& target) {
+    if (options.nchwc_block > 0) {
+        return options.nchwc_block;
+    }
+
+    auto mcpu = target->GetAttr<tvm::runtime::String>("mcpu");
+    if (mcpu) {
+        std::string cpu = mcpu.value();
+        if (cpu.find("avx512") != std::string::npos || cpu == "cascadelake" || cpu == "icelake-server" ||
+            cpu == "sapphirerapids" || cpu == "znver4") {
+            return 16;
+        }
+    }
+
+    auto mattr = target->GetAttr<tvm::runtime::Array<tvm::runtime::String>>("mattr");
+    if (mattr) {
+        for (const auto& attr : mattr.value()) {
+            if (std::string(attr).find("avx512f") != std::string::npos) {
+                return 16;
+            }
+        }
+    }
+
+    return 8;
+}
+
+Status convert_conv_layout(tvm::IRModule& module, const BuildOptions& options, const tvm::Target& target) {
+    if (options.conv_layout == ConvLayout::NCHW) {
+        return Status::ok();
+    }
+
+    // type infer
+    const tvm::runtime::PackedFunc* type_infer = tvm::runtime::Registry::Get("relay._transform.InferType");
+    if (!type_infer) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._transform.InferType expression not found");
+    }
+
+    // convert layout
+    const tvm::runtime::PackedFunc* convert_layout = tvm::runtime::Registry::Get("relay._transform.ConvertLayout");
+    if (!convert_layout) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._transform.ConvertLayout expression not found");
+    }
+
+    // alter op layout
+    const tvm::runtime::PackedFunc* alter_layout = tvm::runtime::Registry::Get("relay._transform.AlterOpLayout");
+    if (!alter_layout) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._transform.AlterOpLayout expression not found");
+    }
+
+    // fold constant
+    const tvm::runtime::PackedFunc* fold_const = tvm::runtime::Registry::Get("relay._transform.FoldConstant");
+    if (!fold_const) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._transform.FoldConstant expression not found");
+    }
+
+    // pass run
+    const tvm::runtime::PackedFunc* pass_run = tvm::runtime::Registry::Get("transform.RunPass");
+    if (!pass_run) {
+        return Status(StatusCode::RUNTIME_ERROR, "transform.pass_run expression not found");
+    }
+
+    static std::once_flag registered;
+    std::call_once(registered, register_conv2d_layout_functions);
+
+    std::vector<tvm::relay::transform::Pass> passes;
+    passes.emplace_back((*type_infer)());
+
+    int block = 0;
+    if (options.conv_layout == ConvLayout::NHWC) {
+        tvm::runtime::Map<tvm::runtime::String, tvm::runtime::Array<tvm::runtime::String>> desired_layouts;
+        desired_layouts.Set("nn.conv2d", {"NHWC", "default"});
+        passes.emplace_back((*convert_layout)(desired_layouts));
+    } else {
+        block = get_nchwc_block(options, target);
+        passes.emplace_back((*alter_layout)());
+    }
+
+    // pre-pack the constant weights: layout_transform(constant) is folded at compile time
+    passes.emplace_back((*type_infer)());
+    passes.emplace_back((*fold_const)(false));
+    passes.emplace_back((*type_infer)());
+
+    NCHWcBlockScope block_scope(block);
+    for (const auto& pass : passes) {
+        module = (*pass_run)(pass, module);
+    }
+
+    return Status::ok();
+}
+
+Status count_layout_transforms(const tvm::IRModule& module, LayoutTransformStats& stats) {
+    if (!module->ContainGlobalVar("main")) {
+        return Status(StatusCode::INVALID_PARAM, "main function not found in the module");
+    }
+
+    LayoutTransformCounter counter;
+    counter(module->Lookup("main"));
+    stats = counter.stats();
+
+    return Status::ok();
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
@@ -0,0 +1,57 @@
+#ifndef _H_TVM_CPP_COMPILER_LAYOUT_TRANSFORM_H_
+#define _H_TVM_CPP_COMPILER_LAYOUT_TRANSFORM_H_
+
+#include <tvm/ir/module.h>
+#include <tvm/target/target.h>
+
+#include "compiler/build_options.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief The layout_transform statistics of a relay IRModule
+ *
+ */
+struct LayoutTransformStats {
+    // the number of layout_transform ops on the activations
+    int activation_transforms{0};
+    // the number of layout_transform ops on the constants, they are left when the weights are NOT pre-packed
+    int constant_transforms{0};
+};
+
+/**
+ * @brief Get the NCHWc channel block size
+ *
+ * @param options the build options
+ * @param target the compilation target
+ * @return int the block size. `options.nchwc_block` if it is set, otherwise 16 for AVX-512 targets and 8 for others
+ */
+int get_nchwc_block(const BuildOptions& options, const tvm::Target& target);
+
+/**
+ * @brief Convert the convolutions of the IRModule to `options.conv_layout`.
+ * NHWC runs ConvertLayout, NCHWc runs AlterOpLayout to contrib_conv2d_NCHWc. Then the constant weights are pre-packed
+ * by FoldConstant, so layout_transform is left only on the activations at the boundaries of the converted regions
+ *
+ * @param module input/output parameter. the relay IRModule
+ * @param options the build options
+ * @param target the compilation target
+ * @return Status
+ */
+Status convert_conv_layout(tvm::IRModule& module, const BuildOptions& options, const tvm::Target& target);
+
+/**
+ * @brief Count the layout_transform ops in the IRModule
+ *
+ * @param module the relay IRModule
+ * @param stats output parameter. the layout_transform statistics
+ * @return Status
+ */
+Status count_layout_transforms(const tvm::IRModule& module, LayoutTransformStats& stats);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
@@ -0,0 +1,157 @@
+#include "library_exporter.h"
+
+#include <tvm/runtime/registry.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+
+#include "utils/utils.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+// collect the DSO exportable modules in the import tree
+void collect_dso_modules(const tvm::runtime::Module& module, std::vector<tvm::runtime::Module>& dso_modules,
+                         std::unordered_set<const tvm::runtime::ModuleNode*>& visited) {
+    if (!visited.insert(module.operator->()).second) {
+        return;
+    }
+
+    if (module->IsDSOExportable()) {
+        dso_modules.emplace_back(module);
+    }
+
+    for (const auto& imported : module->imports()) {
+        collect_dso_modules(imported, dso_modules, visited);
+    }
+}
+
+// the llvm target string of the first llvm module, empty if there is no llvm module
+std::string get_llvm_target_string(const std::vector<tvm::runtime::Module>& dso_modules) {
+    for (const auto& module : dso_modules) {
+        if (std::string(module->type_key()) != "llvm") {
+            continue;
+        }
+
+        tvm::runtime::PackedFunc get_target_string = module.GetFunction("_get_target_string");
+        if (get_target_string != nullptr) {
+            std::string target_string = get_target_string();
+            return target_string;
+        }
+    }
+
+    return "";
+}
+
+}    // namespace
+
+void get_dso_modules(const tvm::runtime::Module& lib, std::vector<tvm::runtime::Module>& dso_modules) {
+    std::unordered_set<const tvm::runtime::ModuleNode*> visited;
+    dso_modules.clear();
+    collect_dso_modules(lib, dso_modules, visited);
+}
+
+Status export_library(const tvm::runtime::Module& lib, const std::string& path, const ExportOptions& options) {
+    if (!lib.defined()) {
+        return Status(StatusCode::INVALID_PARAM, "the library to export is not defined");
+    }
+
+    std::filesystem::path lib_path(path);
+    std::filesystem::path work_dir = lib_path;
+    work_dir += ".objs";
+
+    std::error_code ec;
+    std::filesystem::create_directories(work_dir, ec);
+    if (ec) {
+        std::ostringstream oss;
+        oss << "Create export directory failed: " << work_dir.string() << ", " << ec.message();
+        return Status(StatusCode::RUNTIME_ERROR, oss.str());
+    }
+
+    std::vector<std::string> files;
+    try {
+        std::vector<tvm::runtime::Module> dso_modules;
+        get_dso_modules(lib, dso_modules);
+
+        for (size_t i = 0; i < dso_modules.size(); ++i) {
+            std::string type_key = dso_modules[i]->type_key();
+            std::string suffix = type_key == "c" ? ".c" : ".o";
+            std::string file = (work_dir / ("lib" + std::to_string(i) + suffix)).string();
+            dso_modules[i]->SaveToFile(file, suffix.substr(1));
+            files.emplace_back(file);
+        }
+
+        // the imported modules which can not be linked, e.g. the metadata or the device modules, are serialized
+        // into a blob which is unpacked when the shared library is loaded
+        if (!lib->imports().empty()) {
+            std::string target_string = get_llvm_target_string(dso_modules);
+            const tvm::runtime::PackedFunc* pack_to_llvm =
+                tvm::runtime::Registry::Get("runtime.ModulePackImportsToLLVM");
+            const tvm::runtime::PackedFunc* pack_to_c = tvm::runtime::Registry::Get("runtime.ModulePackImportsToC");
+
+            if (!target_string.empty() && pack_to_llvm) {
+                tvm::runtime::Module devc = (*pack_to_llvm)(lib, false, target_string, "");
+                std::string file = (work_dir / "devc.o").string();
+                devc->SaveToFile(file, "o");
+                files.emplace_back(file);
+            } else if (pack_to_c) {
+                std::string code = (*pack_to_c)(lib, false, "");
+                std::string file = (work_dir / "devc.c").string();
+                std::ofstream ofs(file);
+                ofs << code;
+                files.emplace_back(file);
+            } else {
+                return Status(StatusCode::RUNTIME_ERROR, "runtime.ModulePackImportsToLLVM/C not found");
+            }
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    std::ostringstream cmd;
+    cmd << tvm_cpp::utils::shell_quote(options.cc) << " -shared -fPIC";
+    for (const auto& option : options.cc_options) {
+        cmd << " " << tvm_cpp::utils::shell_quote(option);
+    }
+    cmd << " -o " << tvm_cpp::utils::shell_quote(lib_path.string());
+    for (const auto& file : files) {
+        cmd << " " << tvm_cpp::utils::shell_quote(file);
+    }
+
+    int ret = std::system(cmd.str().c_str());
+    if (!options.keep_objects) {
+        std::filesystem::remove_all(work_dir, ec);
+    }
+
+    if (ret != 0) {
+        std::ostringstream oss;
+        oss << "Link the shared library failed: " << cmd.str();
+        return Status(StatusCode::RUNTIME_ERROR, oss.str());
+    }
+
+    return Status::ok();
+}
+
+Status load_library(const std::string& path, tvm::runtime::Module& lib) {
+    if (!tvm_cpp::utils::file_exist(path)) {
+        std::ostringstream oss;
+        oss << "Library does NOT exist: " << path;
+        return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+    }
+
+    try {
+        lib = tvm::runtime::Module::LoadFromFile(path);
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
@@ -0,0 +1,61 @@
+#ifndef _H_TVM_CPP_COMPILER_LIBRARY_EXPORTER_H_
+#define _H_TVM_CPP_COMPILER_LIBRARY_EXPORTER_H_
+
+#include <tvm/runtime/module.h>
+
+#include <string>
+#include <vector>
+
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief The options to export a compiled library as a shared library
+ *
+ */
+struct ExportOptions {
+    // the compiler which links the shared library
+    std::string cc{"g++"};
+    // the extra compiler options, each one is passed as a single argument, e.g. "-O2"
+    std::vector<std::string> cc_options;
+    // keep the intermediate object files next to the shared library
+    bool keep_objects{false};
+};
+
+/**
+ * @brief Get the DSO exportable modules in the import tree of the compiled library, e.g. the llvm and c modules
+ *
+ * @param lib the compiled library
+ * @param dso_modules output parameter. the DSO exportable modules, the library itself first if it is exportable
+ */
+void get_dso_modules(const tvm::runtime::Module& lib, std::vector<tvm::runtime::Module>& dso_modules);
+
+/**
+ * @brief Export the compiled library as a shared library, like `export_library` of the python api. The DSO exportable
+ * modules are saved as object or c source files, the other imported modules are serialized into an extra object
+ * file, then all of them are linked by `options.cc`. The library can be loaded by
+ * `tvm::runtime::Module::LoadFromFile`
+ *
+ * @param lib the compiled library
+ * @param path the shared library path, e.g. "model.so"
+ * @param options the export options
+ * @return Status
+ */
+Status export_library(const tvm::runtime::Module& lib, const std::string& path,
+                      const ExportOptions& options = ExportOptions());
+
+/**
+ * @brief Load a shared library exported by `export_library`
+ *
+ * @param path the shared library path
+ * @param lib output parameter. the loaded library
+ * @return Status
+ */
+Status load_library(const std::string& path, tvm::runtime::Module& lib);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
@@ -0,0 +1,173 @@
+#include "lower_call.h"
+
+#include <tvm/arith/analyzer.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/topi/generic/injective.h>
+
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include "compiler/blas_offload.h"
+#include "compiler/impl_selection.h"
+#include "compiler/te_kernels.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+/**
+ * @brief Get the implementations whose specialized conditions hold for the concrete shapes
+ *
+ * @param strategy the op strategy
+ * @param impls output parameter. the valid implementations
+ */
+void get_valid_implementations(const tvm::relay::OpStrategy& strategy,
+                               std::vector<tvm::relay::OpImplementation>& impls) {
+    tvm::arith::Analyzer analyzer;
+    for (const auto& spec : strategy->specializations) {
+        bool valid = true;
+        if (spec->condition.defined()) {
+            for (const auto& clause : spec->condition->clauses) {
+                tvm::PrimExpr simplified = analyzer.canonical_simplify(clause);
+                const tvm::IntImmNode* imm = simplified.as<tvm::IntImmNode>();
+                if (!imm || imm->value == 0) {
+                    valid = false;
+                    break;
+                }
+            }
+        }
+
+        if (valid) {
+            impls.insert(impls.end(), spec->implementations.begin(), spec->implementations.end());
+        }
+    }
+}
+
+/**
+ * @brief Create a generic injective strategy for the op which has FTVMCompute but no FTVMStrategy
+ *
+ * @param op the relay op
+ * @param strategy output parameter. the created strategy
+ * @return Status
+ */
+Status create_generic_strategy(const tvm::Op& op, tvm::relay::OpStrategy& strategy) {
+    if (!tvm::Op::HasAttrMap("FTVMCompute")) {
+        return Status(StatusCode::RUNTIME_ERROR, "FTVMCompute is not registered");
+    }
+
+    static auto fcompute = tvm::Op::GetAttrMap<tvm::relay::FTVMCompute>("FTVMCompute");
+    if (!fcompute.count(op)) {
+        std::ostringstream oss;
+        oss << "op [" << op->name << "] has neither FTVMStrategy nor FTVMCompute";
+        return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+    }
+
+    // the op strategy generate function
+    const tvm::runtime::PackedFunc* strategy_gen = tvm::runtime::Registry::Get("relay.op._make.OpStrategy");
+    if (!strategy_gen) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay.op._make.OpStrategy not found");
+    }
+
+    strategy = (*strategy_gen)();
+    tvm::relay::FTVMSchedule fschedule = [](const tvm::Attrs& attrs, const tvm::runtime::Array<tvm::te::Tensor>& outs,
+                                            const tvm::Target& target) {
+        return tvm::topi::generic::schedule_injective(target, outs);
+    };
+    strategy.AddImplementation(fcompute[op], fschedule, "injective.generic", 10);
+
+    return Status::ok();
+}
+
+}    // namespace
+
+Status select_implementation(const tvm::relay::Call& call, const tvm::runtime::Array<tvm::te::Tensor>& inputs,
+                             const tvm::Target& target, tvm::relay::OpImplementation& impl,
+                             tvm::runtime::Array<tvm::te::Tensor>& outputs) {
+    const tvm::OpNode* op_node = call->op.as<tvm::OpNode>();
+    if (!op_node) {
+        return Status(StatusCode::INVALID_PARAM, "the call is not an op call");
+    }
+
+    tvm::Op op = tvm::runtime::GetRef<tvm::Op>(op_node);
+    const tvm::Type& out_type = call->checked_type();
+
+    tvm::relay::OpStrategy strategy;
+    if (tvm::Op::HasAttrMap("FTVMStrategy") &&
+        tvm::Op::GetAttrMap<tvm::relay::FTVMStrategy>("FTVMStrategy").count(op)) {
+        static auto fstrategy = tvm::Op::GetAttrMap<tvm::relay::FTVMStrategy>("FTVMStrategy");
+        strategy = fstrategy[op](call->attrs, inputs, out_type, target);
+    } else {
+        auto status = create_generic_strategy(op, strategy);
+        if (!status.is_ok()) {
+            return status;
+        }
+    }
+
+    add_te_kernel_implementations(call, inputs, target, strategy);
+
+    std::vector<tvm::relay::OpImplementation> impls;
+    get_valid_implementations(strategy, impls);
+    // the CBLAS implementations are only selected for the calls which are large enough
+    impls.erase(std::remove_if(impls.begin(), impls.end(),
+                               [&call](const tvm::relay::OpImplementation& candidate) {
+                                   return !is_blas_implementation_allowed(call, candidate);
+                               }),
+                impls.end());
+    if (impls.empty()) {
+        std::ostringstream oss;
+        oss << "no valid implementation for op [" << op->name << "], target: " << target->str();
+        return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+    }
+
+    // the fastest implementation for the concrete shapes if the cost-based selection is enabled
+    bool selected = false;
+    auto status = select_fastest_implementation(call, inputs, target, impls, impl, selected);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    // otherwise the first implementation with the highest plevel wins
+    if (!selected) {
+        impl = impls[0];
+        for (const auto& candidate : impls) {
+            if (candidate->plevel > impl->plevel) {
+                impl = candidate;
+            }
+        }
+    }
+
+    outputs = impl.Compute(call->attrs, inputs, out_type);
+    return Status::ok();
+}
+
+void register_lower_call_hook() {
+    // every build calls it, the registry entry is created once
+    static std::once_flag registered;
+    std::call_once(registered, []() {
+        tvm::runtime::Registry::Register("relay.backend.lower_call", true)
+            .set_body_typed([](const tvm::relay::Call& call, const tvm::runtime::Array<tvm::te::Tensor>& inputs,
+                               const tvm::Target& target) {
+                tvm::relay::OpImplementation impl;
+                tvm::runtime::Array<tvm::te::Tensor> outputs;
+                auto status = select_implementation(call, inputs, target, impl, outputs);
+                if (!status.is_ok()) {
+                    LOG(FATAL) << status;
+                }
+
+                const tvm::runtime::PackedFunc* make_output =
+                    tvm::runtime::Registry::Get("relay.backend._make_LoweredOutput");
+                if (!make_output) {
+                    LOG(FATAL) << "relay.backend._make_LoweredOutput is not registered";
+                }
+
+                return (*make_output)(outputs, impl);
+            });
+    });
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
@@ -0,0 +1,41 @@
+#ifndef _H_TVM_CPP_COMPILER_LOWER_CALL_H_
+#define _H_TVM_CPP_COMPILER_LOWER_CALL_H_
+
+#include <tvm/relay/expr.h>
+#include <tvm/relay/op_strategy.h>
+#include <tvm/target/target.h>
+#include <tvm/te/tensor.h>
+
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief Select the op implementation for a relay call.
+ * The valid implementation with the highest plevel in the op strategy is selected, or the fastest one for the
+ * concrete shapes if the cost-based selection is enabled, see select_fastest_implementation. If the op has no
+ * registered strategy, a generic injective implementation is built from its FTVMCompute
+ *
+ * @param call the relay call
+ * @param inputs the te input tensors of the call
+ * @param target the compilation target
+ * @param impl output parameter. the selected implementation
+ * @param outputs output parameter. the te output tensors computed by the selected implementation
+ * @return Status
+ */
+Status select_implementation(const tvm::relay::Call& call, const tvm::runtime::Array<tvm::te::Tensor>& inputs,
+                             const tvm::Target& target, tvm::relay::OpImplementation& impl,
+                             tvm::runtime::Array<tvm::te::Tensor>& outputs);
+
+/**
+ * @brief Register the global packed function `relay.backend.lower_call` which is required by the TE compiler.
+ * It overrides any previous registration, the later calls do nothing
+ *
+ */
+void register_lower_call_hook();
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
@@ -0,0 +1,570 @@
+#include "meta_schedule_tuner.h"
+
+#include <tvm/driver/driver_api.h>
+#include <tvm/ir/expr.h>
+#include <tvm/meta_schedule/arg_info.h>
+#include <tvm/meta_schedule/builder.h>
+#include <tvm/meta_schedule/extracted_task.h>
+#include <tvm/meta_schedule/measure_callback.h>
+#include <tvm/meta_schedule/runner.h>
+#include <tvm/meta_schedule/search_strategy.h>
+#include <tvm/meta_schedule/space_generator.h>
+#include <tvm/meta_schedule/task_scheduler.h>
+#include <tvm/meta_schedule/tune_context.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/support/with.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "compiler/blas_offload.h"
+#include "compiler/model_builder.h"
+#include "compiler/tuning_record_store.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+// the logging levels of the MetaSchedule logger
+constexpr int kLogLevelInfo = 20;
+constexpr int kLogLevelWarning = 30;
+
+/**
+ * @brief The in-process artifacts of the local builder, consumed by the local runner.
+ * The artifact path of a build result is the key of its module, the modules are kept per tuning session, so the
+ * candidates which are built but never run are released when the session ends
+ *
+ */
+class ArtifactStore {
+public:
+    static ArtifactStore* get_instance() {
+        static ArtifactStore instance;
+        return &instance;
+    }
+
+    uint64_t begin_session() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        uint64_t session = m_next_session++;
+        m_sessions[session];
+        return session;
+    }
+
+    void end_session(uint64_t session) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto session_iter = m_sessions.find(session);
+        if (session_iter == m_sessions.end()) {
+            return;
+        }
+
+        for (const auto& kv : session_iter->second) {
+            m_paths.erase(kv.first);
+        }
+        m_sessions.erase(session_iter);
+    }
+
+    std::string add(uint64_t session, const tvm::runtime::Module& module) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::string path = "memory://" + std::to_string(session) + "/" + std::to_string(m_next_id++);
+        // the module of an ended session is not kept, the runner reports it as not found
+        auto session_iter = m_sessions.find(session);
+        if (session_iter != m_sessions.end()) {
+            session_iter->second.emplace(path, module);
+            m_paths.emplace(path, session);
+        }
+        return path;
+    }
+
+    bool take(const std::string& path, tvm::runtime::Module& module) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto path_iter = m_paths.find(path);
+        if (path_iter == m_paths.end()) {
+            return false;
+        }
+
+        auto session_iter = m_sessions.find(path_iter->second);
+        m_paths.erase(path_iter);
+        if (session_iter == m_sessions.end()) {
+            return false;
+        }
+
+        auto iter = session_iter->second.find(path);
+        if (iter == session_iter->second.end()) {
+            return false;
+        }
+
+        module = iter->second;
+        session_iter->second.erase(iter);
+        return true;
+    }
+
+    /**
+     * @brief Release the modules of the paths which are not taken
+     *
+     */
+    void erase(const std::vector<std::string>& paths) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& path : paths) {
+            auto path_iter = m_paths.find(path);
+            if (path_iter == m_paths.end()) {
+                continue;
+            }
+
+            auto session_iter = m_sessions.find(path_iter->second);
+            if (session_iter != m_sessions.end()) {
+                session_iter->second.erase(path);
+            }
+            m_paths.erase(path_iter);
+        }
+    }
+
+private:
+    ArtifactStore() = default;
+
+    std::mutex m_mutex;
+    uint64_t m_next_session{0};
+    uint64_t m_next_id{0};
+    std::unordered_map<uint64_t, std::unordered_map<std::string, tvm::runtime::Module>> m_sessions;
+    std::unordered_map<std::string, uint64_t> m_paths;
+};
+
+/**
+ * @brief The artifacts of a tuning session, released when the tuning ends, also by an error
+ *
+ */
+class ArtifactSession final {
+public:
+    ArtifactSession() : m_session(ArtifactStore::get_instance()->begin_session()) {}
+    ~ArtifactSession() { ArtifactStore::get_instance()->end_session(m_session); }
+
+    ArtifactSession(const ArtifactSession&) = delete;
+    ArtifactSession& operator=(const ArtifactSession&) = delete;
+
+    uint64_t id() const { return m_session; }
+
+private:
+    uint64_t m_session;
+};
+
+/**
+ * @brief The measured statistics of the tasks, updated by the progress callback
+ *
+ */
+struct TuningProgress {
+    std::vector<TaskTuningReport> reports;
+    int max_trials_global{0};
+    int total_trials{0};
+};
+
+/**
+ * @brief Build the candidates in the current process
+ *
+ */
+tvm::runtime::Array<tvm::meta_schedule::BuilderResult> local_build(
+    uint64_t session, const tvm::runtime::Array<tvm::meta_schedule::BuilderInput>& inputs) {
+    static const tvm::runtime::PackedFunc* remove_rewrite_block =
+        tvm::runtime::Registry::Get("tir.transform.RemoveWeightLayoutRewriteBlock");
+
+    tvm::runtime::Array<tvm::meta_schedule::BuilderResult> results;
+    for (const auto& input : inputs) {
+        try {
+            tvm::IRModule mod = input->mod;
+            if (remove_rewrite_block) {
+                tvm::transform::Pass pass = (*remove_rewrite_block)(true);
+                mod = pass(mod);
+            }
+
+            tvm::runtime::Module module = tvm::build(mod, input->target, tvm::Target());
+            std::string path = ArtifactStore::get_instance()->add(session, module);
+            results.push_back(tvm::meta_schedule::BuilderResult(tvm::runtime::String(path), tvm::runtime::NullOpt));
+        } catch (const tvm::runtime::Error& e) {
+            results.push_back(tvm::meta_schedule::BuilderResult(tvm::runtime::NullOpt, tvm::runtime::String(e.what())));
+        }
+    }
+
+    return results;
+}
+
+/**
+ * @brief Create the random input arguments of a candidate
+ *
+ */
+tvm::runtime::Array<tvm::runtime::NDArray> create_random_args(
+    const tvm::runtime::Array<tvm::meta_schedule::ArgInfo>& args_info) {
+    std::mt19937 engine(0);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    tvm::runtime::Array<tvm::runtime::NDArray> args;
+    for (const auto& arg_info : args_info) {
+        const auto* tensor_info = arg_info.as<tvm::meta_schedule::TensorInfoNode>();
+        ICHECK(tensor_info) << "only tensor arguments are supported";
+
+        tvm::runtime::NDArray array =
+            tvm::runtime::NDArray::Empty(tensor_info->shape, tensor_info->dtype, {DLDeviceType::kDLCPU, 0});
+        size_t size = tvm::runtime::GetDataSize(*array.operator->());
+        if (tensor_info->dtype.is_float() && tensor_info->dtype.bits() == 32) {
+            float* data = static_cast<float*>(array->data);
+            for (size_t i = 0; i < size / sizeof(float); ++i) {
+                data[i] = dist(engine);
+            }
+        } else {
+            // integer arguments are usually indices, zeros are always in range
+            std::memset(array->data, 0, size);
+        }
+
+        args.push_back(array);
+    }
+
+    return args;
+}
+
+/**
+ * @brief Run a built candidate in the current process
+ *
+ */
+tvm::meta_schedule::RunnerResult run_candidate(const tvm::meta_schedule::RunnerInput& input,
+                                               const TuningOptions& tuning) {
+    tvm::runtime::Module module;
+    if (!ArtifactStore::get_instance()->take(input->artifact_path, module)) {
+        return tvm::meta_schedule::RunnerResult(tvm::runtime::NullOpt,
+                                                tvm::runtime::String("artifact not found: " + input->artifact_path));
+    }
+
+    try {
+        tvm::runtime::PackedFunc func = module.GetFunction("__tvm_main__", true);
+        if (func == nullptr) {
+            func = module.GetFunction("main", true);
+        }
+
+        if (func == nullptr) {
+            return tvm::meta_schedule::RunnerResult(tvm::runtime::NullOpt,
+                                                    tvm::runtime::String("entry function not found"));
+        }
+
+        tvm::runtime::Array<tvm::runtime::NDArray> args = create_random_args(input->args_info);
+        std::vector<TVMValue> values(args.size());
+        std::vector<int> type_codes(args.size());
+        tvm::runtime::TVMArgsSetter setter(values.data(), type_codes.data());
+        for (size_t i = 0; i < args.size(); ++i) {
+            setter(i, args[i]);
+        }
+
+        tvm::runtime::TVMRetValue rv;
+        tvm::runtime::TVMArgs packed_args(values.data(), type_codes.data(), static_cast<int>(args.size()));
+
+        // warm up
+        func.CallPacked(packed_args, &rv);
+
+        tvm::runtime::Array<tvm::FloatImm> run_secs;
+        for (int r = 0; r < tuning.repeat; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            for (int n = 0; n < tuning.number; ++n) {
+                func.CallPacked(packed_args, &rv);
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            double secs = std::chrono::duration<double>(end - start).count() / tuning.number;
+            run_secs.push_back(tvm::FloatImm(tvm::DataType::Float(64), secs));
+        }
+
+        return tvm::meta_schedule::RunnerResult(run_secs, tvm::runtime::NullOpt);
+    } catch (const tvm::runtime::Error& e) {
+        return tvm::meta_schedule::RunnerResult(tvm::runtime::NullOpt, tvm::runtime::String(e.what()));
+    }
+}
+
+/**
+ * @brief Create the local runner. The candidates are measured one by one, so they do not compete for the cores
+ *
+ */
+tvm::meta_schedule::Runner create_local_runner(const TuningOptions& tuning) {
+    tvm::meta_schedule::Runner::FRun f_run = [tuning](tvm::runtime::Array<tvm::meta_schedule::RunnerInput> inputs) {
+        // the artifacts of the batch are released even if a run throws
+        std::vector<std::string> paths;
+        for (const auto& input : inputs) {
+            paths.emplace_back(input->artifact_path);
+        }
+        struct BatchGuard {
+            const std::vector<std::string>& paths;
+            ~BatchGuard() { ArtifactStore::get_instance()->erase(paths); }
+        } guard{paths};
+
+        tvm::runtime::Array<tvm::meta_schedule::RunnerFuture> futures;
+        for (const auto& input : inputs) {
+            tvm::meta_schedule::RunnerResult result = run_candidate(input, tuning);
+            tvm::meta_schedule::RunnerFuture::FDone f_done = []() { return true; };
+            tvm::meta_schedule::RunnerFuture::FResult f_result = [result]() { return result; };
+            futures.push_back(tvm::meta_schedule::RunnerFuture(f_done, f_result));
+        }
+
+        return futures;
+    };
+
+    return tvm::meta_schedule::Runner::PyRunner(f_run);
+}
+
+/**
+ * @brief Create the logger of the task scheduler
+ *
+ */
+tvm::runtime::PackedFunc create_logger() {
+    return tvm::runtime::TypedPackedFunc<void(int, std::string, int, std::string)>(
+               [](int level, std::string filename, int lineno, std::string msg) {
+                   if (level >= kLogLevelWarning) {
+                       std::cerr << "[meta_schedule] " << msg << std::endl;
+                   } else if (level >= kLogLevelInfo) {
+                       std::cout << "[meta_schedule] " << msg << std::endl;
+                   }
+               })
+        .packed();
+}
+
+/**
+ * @brief Create the measure callback which records the per-task progress
+ *
+ */
+tvm::meta_schedule::MeasureCallback create_progress_callback(std::shared_ptr<TuningProgress> progress) {
+    tvm::meta_schedule::MeasureCallback::FApply f_apply =
+        [progress](const tvm::meta_schedule::TaskScheduler& task_scheduler, int task_id,
+                   const tvm::runtime::Array<tvm::meta_schedule::MeasureCandidate>& measure_candidates,
+                   const tvm::runtime::Array<tvm::meta_schedule::BuilderResult>& builder_results,
+                   const tvm::runtime::Array<tvm::meta_schedule::RunnerResult>& runner_results) {
+            TaskTuningReport& report = progress->reports[task_id];
+            for (const auto& result : runner_results) {
+                ++report.trials;
+                ++progress->total_trials;
+                if (result->error_msg.defined() || !result->run_secs.defined()) {
+                    ++report.errors;
+                    continue;
+                }
+
+                double sum = 0;
+                for (const auto& sec : result->run_secs.value()) {
+                    sum += sec->value;
+                }
+                double latency_us = sum / result->run_secs.value().size() * 1e6;
+
+                if (report.first_latency_us < 0) {
+                    report.first_latency_us = latency_us;
+                }
+                if (report.best_latency_us < 0 || latency_us < report.best_latency_us) {
+                    report.best_latency_us = latency_us;
+                }
+            }
+
+            std::cout << "[tuning] " << progress->total_trials << "/" << progress->max_trials_global << " task #"
+                      << task_id << " " << report.task_name << ": trials " << report.trials << ", errors "
+                      << report.errors << ", best " << report.best_latency_us << " us" << std::endl;
+        };
+
+    tvm::meta_schedule::MeasureCallback::FAsString f_as_string = []() -> tvm::runtime::String {
+        return "TuningProgress";
+    };
+
+    return tvm::meta_schedule::MeasureCallback::PyMeasureCallback(f_apply, f_as_string);
+}
+
+}    // namespace
+
+Status open_meta_schedule_database(const std::string& dir, bool allow_missing, tvm::meta_schedule::Database& database) {
+    std::filesystem::path dir_path(dir);
+    if (!std::filesystem::exists(dir_path)) {
+        if (!allow_missing) {
+            std::ostringstream oss;
+            oss << "MetaSchedule database directory does NOT exist: " << dir;
+            return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(dir_path, ec);
+        if (ec) {
+            std::ostringstream oss;
+            oss << "Create MetaSchedule database directory failed: " << dir << ", " << ec.message();
+            return Status(StatusCode::RUNTIME_ERROR, oss.str());
+        }
+    }
+
+    std::string workload_path = (dir_path / "database_workload.json").string();
+    std::string record_path = (dir_path / "database_tuning_record.json").string();
+
+    try {
+        database = tvm::meta_schedule::Database::JSONDatabase(workload_path, record_path, allow_missing, "structural");
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status extract_tuning_tasks(const tvm::IRModule& module, const BuildOptions& options,
+                            tvm::runtime::Array<tvm::meta_schedule::ExtractedTask>& tasks) {
+    // the task extraction function
+    const tvm::runtime::PackedFunc* extract_task =
+        tvm::runtime::Registry::Get("relay.backend.MetaScheduleExtractTask");
+    if (!extract_task) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay.backend.MetaScheduleExtractTask not found");
+    }
+
+    // the extraction lowers the ops like the build, it may run before any build of the process
+    auto status = prepare_lowering(options);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    // the build compiles for the BLAS target, its tasks and records must carry the same target
+    tvm::Target target;
+    status = create_target(get_blas_target(options), target);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    // extract the tasks of the module which is compiled by the build
+    tvm::IRModule optimized_module = module;
+    status = optimize_irmodule(optimized_module, options);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    try {
+        tvm::With<tvm::transform::PassContext> scope(create_pass_context(options));
+        tvm::With<tvm::Target> target_scope(target);
+        tvm::runtime::Map<tvm::runtime::String, tvm::runtime::NDArray> params;
+        tasks = (*extract_task)(optimized_module, target, params, tvm::runtime::String("structural"));
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status tune_irmodule(const tvm::IRModule& module, const BuildOptions& options, const TuningOptions& tuning,
+                     std::vector<TaskTuningReport>& reports) {
+    if (options.meta_schedule_dir.empty() && options.tuning_store_dir.empty()) {
+        return Status(StatusCode::INVALID_PARAM, "neither meta_schedule_dir nor tuning_store_dir is set");
+    }
+
+    tvm::Target target;
+    auto status = create_target(get_blas_target(options), target);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    tvm::runtime::Optional<tvm::meta_schedule::Database> opened_database;
+    status = open_tuning_database(options, target, true, opened_database);
+    if (!status.is_ok()) {
+        return status;
+    }
+    tvm::meta_schedule::Database database = opened_database.value();
+
+    tvm::runtime::Array<tvm::meta_schedule::ExtractedTask> extracted_tasks;
+    status = extract_tuning_tasks(module, options, extracted_tasks);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    try {
+        std::cout << "[tuning] extracted " << extracted_tasks.size() << " tasks" << std::endl;
+
+        int num_threads = tuning.num_threads > 0 ? tuning.num_threads : std::thread::hardware_concurrency();
+        tvm::runtime::PackedFunc logger = create_logger();
+        auto progress = std::make_shared<TuningProgress>();
+        progress->max_trials_global = tuning.max_trials_global;
+
+        tvm::runtime::Array<tvm::meta_schedule::TuneContext> tasks;
+        tvm::runtime::Array<tvm::FloatImm> task_weights;
+        std::vector<TaskTuningReport> reused_reports;
+        for (size_t i = 0; i < extracted_tasks.size(); ++i) {
+            const auto& task = extracted_tasks[i];
+
+            // the record may come from another model with the same fused workload
+            if (tuning.skip_tuned_tasks &&
+                database->QueryTuningRecord(task->dispatched[0], task->target, task->task_name).defined()) {
+                TaskTuningReport report;
+                report.task_name = task->task_name;
+                report.weight = task->weight;
+                report.reused = true;
+                reused_reports.emplace_back(report);
+                continue;
+            }
+
+            // the default schedule rules, postprocessors and mutators of the target are used
+            tvm::meta_schedule::SpaceGenerator space_generator = tvm::meta_schedule::SpaceGenerator::PostOrderApply(
+                nullptr, tvm::runtime::NullOpt, tvm::runtime::NullOpt, tvm::runtime::NullOpt);
+            // the cost models of MetaSchedule are implemented in python, replay the traces without cost model
+            tvm::meta_schedule::SearchStrategy search_strategy =
+                tvm::meta_schedule::SearchStrategy::ReplayTrace(tuning.max_fail_count);
+
+            tvm::meta_schedule::TuneContext ctx(task->dispatched[0], task->target, space_generator, search_strategy,
+                                                task->task_name, num_threads, tuning.seed + i, logger);
+            ctx->Initialize();
+            tasks.push_back(ctx);
+            task_weights.push_back(tvm::FloatImm(tvm::DataType::Float(64), task->weight));
+
+            TaskTuningReport report;
+            report.task_name = task->task_name;
+            report.weight = task->weight;
+            progress->reports.emplace_back(report);
+        }
+
+        std::cout << "[tuning] " << reused_reports.size() << " tasks are covered by the database, " << tasks.size()
+                  << " tasks to tune" << std::endl;
+
+        reports = reused_reports;
+        if (tasks.empty()) {
+            return Status::ok();
+        }
+
+        // the candidates which are built but never run are released with the session
+        ArtifactSession artifact_session;
+        uint64_t session_id = artifact_session.id();
+        tvm::meta_schedule::Builder builder = tvm::meta_schedule::Builder::PyBuilder(
+            [session_id](const tvm::runtime::Array<tvm::meta_schedule::BuilderInput>& inputs) {
+                return local_build(session_id, inputs);
+            });
+        tvm::meta_schedule::Runner runner = create_local_runner(tuning);
+        tvm::runtime::Array<tvm::meta_schedule::MeasureCallback> callbacks{
+            tvm::meta_schedule::MeasureCallback::AddToDatabase(), create_progress_callback(progress)};
+
+        int max_trials_per_task =
+            tuning.max_trials_per_task > 0 ? tuning.max_trials_per_task : tuning.max_trials_global;
+        tvm::meta_schedule::TaskScheduler task_scheduler =
+            tvm::meta_schedule::TaskScheduler::GradientBased(logger, 0.2, 3, tuning.seed);
+        task_scheduler->Tune(tasks, task_weights, tuning.max_trials_global, max_trials_per_task,
+                             tuning.num_trials_per_iter, builder, runner, callbacks, database, tvm::runtime::NullOpt);
+        task_scheduler->PrintTuningStatistics();
+
+        reports.insert(reports.end(), progress->reports.begin(), progress->reports.end());
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+void print_tuning_reports(const std::vector<TaskTuningReport>& reports) {
+    std::cout << std::left << std::setw(6) << "id" << std::setw(48) << "task" << std::setw(8) << "weight"
+              << std::setw(8) << "trials" << std::setw(8) << "errors" << std::setw(14) << "first(us)"
+              << std::setw(14) << "best(us)" << std::setw(8) << "reused" << std::endl;
+
+    for (size_t i = 0; i < reports.size(); ++i) {
+        const auto& report = reports[i];
+        std::cout << std::left << std::setw(6) << i << std::setw(48) << report.task_name << std::setw(8)
+                  << report.weight << std::setw(8) << report.trials << std::setw(8) << report.errors << std::setw(14)
+                  << report.first_latency_us << std::setw(14) << report.best_latency_us << std::setw(8)
+                  << (report.reused ? "yes" : "no") << std::endl;
+    }
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
@@ -0,0 +1,110 @@
+#ifndef _H_TVM_CPP_COMPILER_META_SCHEDULE_TUNER_H_
+#define _H_TVM_CPP_COMPILER_META_SCHEDULE_TUNER_H_
+
+#include <tvm/ir/module.h>
+#include <tvm/meta_schedule/database.h>
+#include <tvm/meta_schedule/extracted_task.h>
+
+#include <string>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief The options of MetaSchedule tuning
+ *
+ */
+struct TuningOptions {
+    // the trial budget of all the tasks
+    int max_trials_global{1000};
+    // the trial budget of each task. 0 means `max_trials_global`
+    int max_trials_per_task{0};
+    // the number of candidates measured in each iteration
+    int num_trials_per_iter{64};
+    // the max number of failures when sampling a candidate
+    int max_fail_count{100};
+    // the number of runs in a measurement, the latency is the mean of them
+    int number{3};
+    // the number of measurements of each candidate
+    int repeat{1};
+    // the number of threads used by the tune contexts. 0 means all the logical cores (hardware_concurrency)
+    int num_threads{0};
+    // the random seed
+    int64_t seed{42};
+    // skip the tasks which already have a tuning record in the database, e.g. tuned with another model
+    bool skip_tuned_tasks{true};
+};
+
+/**
+ * @brief The tuning report of a task
+ *
+ */
+struct TaskTuningReport {
+    // the task name
+    std::string task_name;
+    // the number of occurrences of the task in the module
+    int weight{0};
+    // the number of measured candidates
+    int trials{0};
+    // the number of failed candidates
+    int errors{0};
+    // the latency of the first valid candidate in micro seconds, -1 if there is no valid candidate
+    double first_latency_us{-1};
+    // the best latency in micro seconds, -1 if there is no valid candidate
+    double best_latency_us{-1};
+    // the task is not tuned because the database has its record
+    bool reused{false};
+};
+
+/**
+ * @brief Open the MetaSchedule JSON database in the directory. The workloads are stored in `database_workload.json`
+ * and the tuning records in `database_tuning_record.json`
+ *
+ * @param dir the database directory
+ * @param allow_missing create the database files if they are missing
+ * @param database output parameter. the database
+ * @return Status
+ */
+Status open_meta_schedule_database(const std::string& dir, bool allow_missing, tvm::meta_schedule::Database& database);
+
+/**
+ * @brief Extract the tuning tasks from the IRModule. The module is optimized with `options` before the extraction,
+ * so the tasks match the ones compiled by `build_irmodule`
+ *
+ * @param module the relay IRModule
+ * @param options the build options
+ * @param tasks output parameter. the extracted tasks
+ * @return Status
+ */
+Status extract_tuning_tasks(const tvm::IRModule& module, const BuildOptions& options,
+                            tvm::runtime::Array<tvm::meta_schedule::ExtractedTask>& tasks);
+
+/**
+ * @brief Extract the tuning tasks from the IRModule, tune them with MetaSchedule on the local CPU and persist the
+ * results to the JSON database in `options.meta_schedule_dir`, or to the tuning record store in
+ * `options.tuning_store_dir`
+ *
+ * @param module the relay IRModule
+ * @param options the build options, `options.meta_schedule_dir` or `options.tuning_store_dir` must be set
+ * @param tuning the tuning options
+ * @param reports output parameter. the tuning report of each task
+ * @return Status
+ */
+Status tune_irmodule(const tvm::IRModule& module, const BuildOptions& options, const TuningOptions& tuning,
+                     std::vector<TaskTuningReport>& reports);
+
+/**
+ * @brief Print the tuning reports as a table
+ *
+ * @param reports the tuning reports
+ */
+void print_tuning_reports(const std::vector<TaskTuningReport>& reports);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
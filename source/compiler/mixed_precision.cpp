@@ -0,0 +1,180 @@
+#include "mixed_precision.h"
+
+#include <tvm/ir/op.h>
+#include <tvm/relay/expr.h>
+#include <tvm/relay/transform.h>
+#include <tvm/runtime/registry.h>
+
+#include <mutex>
+#include <sstream>
+#include <unordered_set>
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+// the conversion categories of ToMixedPrecision, see src/relay/transforms/to_mixed_precision.h
+constexpr int kMixedPrecisionAlways = 0;
+constexpr int kMixedPrecisionFollow = 1;
+constexpr int kMixedPrecisionNever = 2;
+
+// the missing op mode of ToMixedPrecision which ignores the ops without conversion category silently
+constexpr int kIgnoreMissingOps = 2;
+
+// the priority of the registered conversion category, higher than the default level of the python registration
+constexpr int kConversionTypeLevel = 11;
+
+/**
+ * @brief The op lists of the running conversion, read by the registered FTVMMixedPrecisionConversionType
+ *
+ */
+struct ConversionLists {
+    std::unordered_set<std::string> allow_ops;
+    std::unordered_set<std::string> follow_ops;
+    std::unordered_set<std::string> deny_ops;
+};
+
+// serializes the conversions, the lists do not change while ToMixedPrecision is running
+std::mutex g_conversion_mutex;
+ConversionLists g_conversion_lists;
+std::unordered_set<std::string> g_registered_ops;
+
+/**
+ * @brief The FTVMMixedPrecisionConversionType of the listed ops. It returns the conversion category, the accumulation
+ * type and the output type
+ *
+ */
+tvm::runtime::Array<tvm::runtime::ObjectRef> get_conversion_type(const tvm::relay::Call& call,
+                                                                 const std::string& mixed_precision_type) {
+    const auto* op = call->op.as<tvm::OpNode>();
+    std::string op_name = op ? op->name : "";
+
+    // called inside convert_mixed_precision, which holds g_conversion_mutex
+    int category = kMixedPrecisionNever;
+    if (g_conversion_lists.deny_ops.count(op_name)) {
+        category = kMixedPrecisionNever;
+    } else if (g_conversion_lists.allow_ops.count(op_name)) {
+        category = kMixedPrecisionAlways;
+    } else if (g_conversion_lists.follow_ops.count(op_name)) {
+        category = kMixedPrecisionFollow;
+    }
+
+    // accumulate in float32, e.g. the out_dtype of nn.conv2d, and cast the result to the mixed precision type
+    return {tvm::Integer(category), tvm::runtime::String("float32"), tvm::runtime::String(mixed_precision_type)};
+}
+
+/**
+ * @brief Register the conversion category function of the op once
+ *
+ */
+Status register_conversion_type(const std::string& op_name) {
+    try {
+        tvm::Op::Get(op_name);
+    } catch (const tvm::runtime::Error& e) {
+        std::ostringstream oss;
+        oss << "Unknown op in the mixed precision lists: " << op_name;
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    if (!g_registered_ops.insert(op_name).second) {
+        return Status::ok();
+    }
+
+    tvm::runtime::TypedPackedFunc<tvm::runtime::Array<tvm::runtime::ObjectRef>(const tvm::relay::Call&,
+                                                                               const std::string&)>
+        conversion_type(get_conversion_type);
+    tvm::OpRegEntry::RegisterOrGet(op_name).set_attr<tvm::runtime::PackedFunc>(
+        "FTVMMixedPrecisionConversionType", conversion_type.packed(), kConversionTypeLevel);
+    return Status::ok();
+}
+
+}    // namespace
+
+const std::vector<std::string>& get_default_mixed_precision_allow_ops() {
+    static const std::vector<std::string> ops{
+        "nn.conv2d", "nn.contrib_conv2d_NCHWc", "nn.conv2d_transpose", "nn.dense", "nn.matmul", "nn.batch_matmul"};
+    return ops;
+}
+
+const std::vector<std::string>& get_default_mixed_precision_follow_ops() {
+    static const std::vector<std::string> ops{
+        "nn.relu", "nn.leaky_relu", "clip", "add", "subtract", "multiply", "maximum", "minimum", "nn.bias_add",
+        "nn.max_pool2d", "nn.batch_flatten", "reshape", "transpose", "squeeze", "expand_dims", "concatenate", "split",
+        "strided_slice", "layout_transform", "nn.pad", "nn.dropout", "image.resize2d", "where", "take"};
+    return ops;
+}
+
+Status convert_mixed_precision(tvm::IRModule& module, const BuildOptions& options) {
+    if (options.mixed_precision.empty()) {
+        return Status::ok();
+    }
+
+    if (options.mixed_precision != "float16" && options.mixed_precision != "bfloat16") {
+        std::ostringstream oss;
+        oss << "Unsupported mixed precision type: " << options.mixed_precision;
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    // type infer
+    const tvm::runtime::PackedFunc* type_infer = tvm::runtime::Registry::Get("relay._transform.InferType");
+    if (!type_infer) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._transform.InferType expression not found");
+    }
+
+    // mixed precision
+    const tvm::runtime::PackedFunc* to_mixed_precision =
+        tvm::runtime::Registry::Get("relay._transform.ToMixedPrecision");
+    if (!to_mixed_precision) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._transform.ToMixedPrecision expression not found");
+    }
+
+    // fold constant
+    const tvm::runtime::PackedFunc* fold_const = tvm::runtime::Registry::Get("relay._transform.FoldConstant");
+    if (!fold_const) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._transform.FoldConstant expression not found");
+    }
+
+    // pass run
+    const tvm::runtime::PackedFunc* pass_run = tvm::runtime::Registry::Get("transform.RunPass");
+    if (!pass_run) {
+        return Status(StatusCode::RUNTIME_ERROR, "transform.pass_run expression not found");
+    }
+
+    ConversionLists lists;
+    const auto& allow_ops = options.mixed_precision_allow_ops.empty() ? get_default_mixed_precision_allow_ops()
+                                                                      : options.mixed_precision_allow_ops;
+    lists.allow_ops.insert(allow_ops.begin(), allow_ops.end());
+    lists.follow_ops.insert(get_default_mixed_precision_follow_ops().begin(),
+                            get_default_mixed_precision_follow_ops().end());
+    lists.deny_ops.insert(options.mixed_precision_deny_ops.begin(), options.mixed_precision_deny_ops.end());
+
+    // the conversion categories are global op attributes, so the conversions run one at a time
+    std::lock_guard<std::mutex> lock(g_conversion_mutex);
+    for (const auto* ops : {&lists.allow_ops, &lists.follow_ops, &lists.deny_ops}) {
+        for (const auto& op_name : *ops) {
+            auto status = register_conversion_type(op_name);
+            if (!status.is_ok()) {
+                return status;
+            }
+        }
+    }
+    g_conversion_lists = lists;
+
+    std::vector<tvm::relay::transform::Pass> passes;
+    passes.emplace_back((*type_infer)());
+    passes.emplace_back((*to_mixed_precision)(tvm::runtime::String(options.mixed_precision), kIgnoreMissingOps));
+    // the casts of the constant weights are folded, so the weights are stored in the mixed precision type
+    passes.emplace_back((*type_infer)());
+    passes.emplace_back((*fold_const)(false));
+    passes.emplace_back((*type_infer)());
+
+    for (const auto& pass : passes) {
+        module = (*pass_run)(pass, module);
+    }
+
+    return Status::ok();
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
@@ -0,0 +1,43 @@
+#ifndef _H_TVM_CPP_COMPILER_MIXED_PRECISION_H_
+#define _H_TVM_CPP_COMPILER_MIXED_PRECISION_H_
+
+#include <tvm/ir/module.h>
+
+#include <string>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief The ops converted to the mixed precision type by default, they accumulate in float32
+ *
+ * @return const std::vector<std::string>&
+ */
+const std::vector<std::string>& get_default_mixed_precision_allow_ops();
+
+/**
+ * @brief The ops which run in the type of their inputs by default, e.g. the elementwise and data movement ops
+ *
+ * @return const std::vector<std::string>&
+ */
+const std::vector<std::string>& get_default_mixed_precision_follow_ops();
+
+/**
+ * @brief Convert the IRModule to `options.mixed_precision` with ToMixedPrecision. The conversion category of each op
+ * comes from the allow/deny lists of the options: the allowed ops compute in the mixed precision type and accumulate
+ * in float32, the denied ops and the unlisted ops stay in float32. The casts of the constant weights are folded
+ *
+ * @param module input/output parameter. the relay IRModule
+ * @param options the build options, nothing is done if `options.mixed_precision` is empty
+ * @return Status
+ */
+Status convert_mixed_precision(tvm::IRModule& module, const BuildOptions& options);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
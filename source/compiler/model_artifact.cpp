@@ -0,0 +1,180 @@
+#include "model_artifact.h"
+
+#include <picojson.h>
+#include <tvm/runtime/registry.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include "utils/utils.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+Status write_file(const std::filesystem::path& path, const std::string& content) {
+    std::ofstream ofs(path, std::ios::binary);
+    if (!ofs) {
+        std::ostringstream oss;
+        oss << "Open file failed: " << path.string();
+        return Status(StatusCode::RUNTIME_ERROR, oss.str());
+    }
+
+    ofs.write(content.data(), static_cast<std::streamsize>(content.size()));
+    ofs.close();
+    if (!ofs) {
+        std::ostringstream oss;
+        oss << "Write file failed: " << path.string();
+        return Status(StatusCode::RUNTIME_ERROR, oss.str());
+    }
+
+    return Status::ok();
+}
+
+Status read_file(const std::filesystem::path& path, std::string& content) {
+    if (!tvm_cpp::utils::file_exist(path.string())) {
+        std::ostringstream oss;
+        oss << "File does NOT exist: " << path.string();
+        return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+    }
+
+    std::ifstream ifs(path, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    return Status::ok();
+}
+
+}    // namespace
+
+Status export_model_artifact(const BuildResult& result, const std::string& dir, const ExportOptions& options) {
+    std::filesystem::path dir_path(dir);
+    std::error_code ec;
+    std::filesystem::create_directories(dir_path, ec);
+    if (ec) {
+        std::ostringstream oss;
+        oss << "Create artifact directory failed: " << dir << ", " << ec.message();
+        return Status(StatusCode::RUNTIME_ERROR, oss.str());
+    }
+
+    auto status = export_library(result.lib, (dir_path / kArtifactLibraryFile).string(), options);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    if (result.executor == ExecutorKind::Graph) {
+        status = write_file(dir_path / kArtifactGraphFile, result.graph_json);
+        if (!status.is_ok()) {
+            return status;
+        }
+    }
+
+    // the params which are not linked into the library
+    std::filesystem::remove(dir_path / kArtifactParamsFile, ec);
+    if (!result.params.empty()) {
+        const tvm::runtime::PackedFunc* save_params = tvm::runtime::Registry::Get("runtime.SaveParams");
+        if (!save_params) {
+            return Status(StatusCode::RUNTIME_ERROR, "runtime.SaveParams not found");
+        }
+
+        tvm::runtime::Map<tvm::runtime::String, tvm::runtime::NDArray> params;
+        for (const auto& kv : result.params) {
+            params.Set(kv.first, kv.second);
+        }
+
+        std::string blob;
+        try {
+            blob = (*save_params)(params).operator std::string();
+        } catch (const tvm::runtime::Error& e) {
+            return Status(StatusCode::RUNTIME_ERROR, e.what());
+        }
+
+        status = write_file(dir_path / kArtifactParamsFile, blob);
+        if (!status.is_ok()) {
+            return status;
+        }
+    }
+
+    picojson::object manifest;
+    manifest["executor"] = picojson::value(executor_kind_to_string(result.executor));
+    manifest["module_name"] = picojson::value(result.module_name);
+    manifest["workspace_size"] = picojson::value(static_cast<double>(result.workspace_size));
+    manifest["constant_size"] = picojson::value(static_cast<double>(result.constant_size));
+    return write_file(dir_path / kArtifactManifestFile, picojson::value(manifest).serialize(true));
+}
+
+Status load_model_artifact(const std::string& dir, BuildResult& result) {
+    std::filesystem::path dir_path(dir);
+
+    std::string manifest_str;
+    auto status = read_file(dir_path / kArtifactManifestFile, manifest_str);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    picojson::value manifest_value;
+    std::string err = picojson::parse(manifest_value, manifest_str);
+    if (!err.empty() || !manifest_value.is<picojson::object>()) {
+        std::ostringstream oss;
+        oss << "Invalid artifact manifest: " << (dir_path / kArtifactManifestFile).string() << ", " << err;
+        return Status(StatusCode::INVALID_MODEL, oss.str());
+    }
+
+    const picojson::object& manifest = manifest_value.get<picojson::object>();
+    auto executor_iter = manifest.find("executor");
+    auto module_name_iter = manifest.find("module_name");
+    if (executor_iter == manifest.end() || module_name_iter == manifest.end() ||
+        !executor_kind_from_string(executor_iter->second.to_str(), result.executor)) {
+        return Status(StatusCode::INVALID_MODEL, "the artifact manifest has no valid executor or module name");
+    }
+
+    result.module_name = module_name_iter->second.to_str();
+    auto workspace_iter = manifest.find("workspace_size");
+    auto constant_iter = manifest.find("constant_size");
+    if ((workspace_iter != manifest.end() && !workspace_iter->second.is<double>()) ||
+        (constant_iter != manifest.end() && !constant_iter->second.is<double>())) {
+        return Status(StatusCode::INVALID_MODEL, "the artifact manifest has an invalid workspace or constant size");
+    }
+    result.workspace_size =
+        workspace_iter != manifest.end() ? static_cast<int64_t>(workspace_iter->second.get<double>()) : 0;
+    result.constant_size =
+        constant_iter != manifest.end() ? static_cast<int64_t>(constant_iter->second.get<double>()) : 0;
+
+    result.graph_json.clear();
+    if (result.executor == ExecutorKind::Graph) {
+        status = read_file(dir_path / kArtifactGraphFile, result.graph_json);
+        if (!status.is_ok()) {
+            return status;
+        }
+    }
+
+    result.params.clear();
+    if (tvm_cpp::utils::file_exist((dir_path / kArtifactParamsFile).string())) {
+        const tvm::runtime::PackedFunc* load_params = tvm::runtime::Registry::Get("runtime.LoadParams");
+        if (!load_params) {
+            return Status(StatusCode::RUNTIME_ERROR, "runtime.LoadParams not found");
+        }
+
+        std::string blob;
+        status = read_file(dir_path / kArtifactParamsFile, blob);
+        if (!status.is_ok()) {
+            return status;
+        }
+
+        try {
+            TVMByteArray bytes{blob.data(), blob.size()};
+            tvm::runtime::Map<tvm::runtime::String, tvm::runtime::NDArray> params = (*load_params)(bytes);
+            for (const auto& kv : params) {
+                result.params.emplace(kv.first, kv.second);
+            }
+        } catch (const tvm::runtime::Error& e) {
+            return Status(StatusCode::RUNTIME_ERROR, e.what());
+        }
+    }
+
+    return load_library((dir_path / kArtifactLibraryFile).string(), result.lib);
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
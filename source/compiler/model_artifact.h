@@ -0,0 +1,50 @@
+#ifndef _H_TVM_CPP_COMPILER_MODEL_ARTIFACT_H_
+#define _H_TVM_CPP_COMPILER_MODEL_ARTIFACT_H_
+
+#include <string>
+
+#include "compiler/library_exporter.h"
+#include "compiler/model_builder.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief The file names in a model artifact directory
+ *
+ */
+constexpr const char* kArtifactManifestFile = "manifest.json";
+constexpr const char* kArtifactLibraryFile = "model.so";
+constexpr const char* kArtifactGraphFile = "model.json";
+constexpr const char* kArtifactParamsFile = "model.params";
+
+/**
+ * @brief Export the build result as a model artifact directory:
+ * - manifest.json: the executor, the module name and the pool sizes
+ * - model.so: the compiled library, the params are in its .rodata if they are linked
+ * - model.json: the graph json of the graph executor
+ * - model.params: the params blob, only if the params are not linked
+ *
+ * @param result the build result
+ * @param dir the artifact directory, created if it is missing
+ * @param options the options to export the shared library
+ * @return Status
+ */
+Status export_model_artifact(const BuildResult& result, const std::string& dir,
+                             const ExportOptions& options = ExportOptions());
+
+/**
+ * @brief Load the model artifact exported by `export_model_artifact`. The library is loaded by dlopen, so the linked
+ * params are faulted in lazily and shared by the processes loading the same library
+ *
+ * @param dir the artifact directory
+ * @param result output parameter. the build result, can be passed to `create_executor`
+ * @return Status
+ */
+Status load_model_artifact(const std::string& dir, BuildResult& result);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
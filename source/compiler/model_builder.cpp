@@ -0,0 +1,360 @@
+#include "model_builder.h"
+
+#include <tvm/ir/expr.h>
+#include <tvm/ir/memory_pools.h>
+#include <tvm/ir/transform.h>
+#include <tvm/meta_schedule/database.h>
+#include <tvm/node/reflection.h>
+#include <tvm/relay/executor.h>
+#include <tvm/relay/expr.h>
+#include <tvm/relay/runtime.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/support/with.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/usmp/utils.h>
+
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "compiler/blas_offload.h"
+#include "compiler/impl_selection.h"
+#include "compiler/layout_transform.h"
+#include "compiler/lower_call.h"
+#include "compiler/mixed_precision.h"
+#include "compiler/sparse_dense.h"
+#include "compiler/te_kernels.h"
+#include "compiler/tuning_record_store.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+/**
+ * @brief Create the USMP memory pools of the target, all the intermediate tensors are planned into one workspace
+ * pool and all the constants into one constant pool
+ *
+ */
+void create_memory_pools(const BuildOptions& options, const tvm::Target& target,
+                         tvm::WorkspaceMemoryPools& workspace_pools, tvm::ConstantMemoryPools& constant_pools) {
+    // the C interface uses the default pools, they are static arrays of the generated code
+    if (options.executor != ExecutorKind::AOT || !options.usmp || options.aot_c_interface) {
+        return;
+    }
+
+    tvm::WorkspacePoolInfo workspace_pool("workspace_pool", {target});
+    tvm::ConstantPoolInfo constant_pool("constant_pool", {target}, {});
+    workspace_pools = tvm::WorkspaceMemoryPools({workspace_pool});
+    constant_pools = tvm::ConstantMemoryPools({constant_pool});
+}
+
+/**
+ * @brief Sum the allocated sizes of the USMP pools in the executor codegen metadata
+ *
+ */
+void get_pool_sizes(const tvm::runtime::ObjectRef& metadata, int64_t& workspace_size, int64_t& constant_size) {
+    workspace_size = 0;
+    constant_size = 0;
+    if (!metadata.defined()) {
+        return;
+    }
+
+    // the metadata class is internal to the relay backend, read its pool_inputs attribute by reflection
+    tvm::runtime::TVMRetValue pool_inputs =
+        tvm::ReflectionVTable::Global()->GetAttr(const_cast<tvm::runtime::Object*>(metadata.get()), "pool_inputs");
+    if (pool_inputs.type_code() == kTVMNullptr) {
+        return;
+    }
+
+    tvm::runtime::Map<tvm::tir::Var, tvm::tir::usmp::AllocatedPoolInfo> pools = pool_inputs;
+    for (const auto& kv : pools) {
+        int64_t size = kv.second->allocated_size->value;
+        if (kv.second->pool_info->IsInstance<tvm::ConstantPoolInfoNode>()) {
+            constant_size += size;
+        } else {
+            workspace_size += size;
+        }
+    }
+}
+
+}    // namespace
+
+Status create_target(const std::string& target_str, tvm::Target& target) {
+    // create target packed function
+    const tvm::runtime::PackedFunc* target_gen = tvm::runtime::Registry::Get("target.Target");
+    if (!target_gen) {
+        return Status(StatusCode::RUNTIME_ERROR, "target.Target not found");
+    }
+
+    try {
+        target = (*target_gen)(tvm::runtime::String(target_str));
+    } catch (const tvm::runtime::Error& e) {
+        std::ostringstream oss;
+        oss << "Invalid target: " << target_str << ", " << e.what();
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    return Status::ok();
+}
+
+tvm::transform::PassContext create_pass_context(const BuildOptions& options) {
+    auto pass_ctx = tvm::transform::PassContext::Create();
+    pass_ctx->opt_level = options.opt_level;
+
+    // the outputs of the mixed precision module are cast back to their original types
+    if (!options.mixed_precision.empty()) {
+        pass_ctx->config.Set("relay.ToMixedPrecision.keep_orig_output_dtype", tvm::Bool(true));
+    }
+
+    // the unified static memory planner of the AOT executor
+    if (options.executor == ExecutorKind::AOT && options.usmp) {
+        pass_ctx->config.Set("tir.usmp.enable", tvm::Bool(true));
+        pass_ctx->config.Set("tir.usmp.algorithm", tvm::runtime::String(options.usmp_algorithm));
+    }
+
+    return pass_ctx;
+}
+
+Status prepare_lowering(const BuildOptions& options) {
+    register_lower_call_hook();
+    auto status = set_blas_offload_config(options);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    set_te_kernel_config(options);
+    return set_impl_selection_config(options);
+}
+
+Status optimize_irmodule(tvm::IRModule& module, const BuildOptions& options) {
+    tvm::Target target;
+    auto status = create_target(options.target, target);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    tvm::With<tvm::transform::PassContext> scope(create_pass_context(options));
+
+    try {
+        status = convert_sparse_dense(module, options);
+        if (status.is_ok()) {
+            status = convert_conv_layout(module, options, target);
+        }
+        if (status.is_ok()) {
+            status = convert_mixed_precision(module, options);
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return status;
+}
+
+Status build_irmodule(const tvm::IRModule& module, const BuildOptions& options, BuildResult& result) {
+    // get the module gen packaged function
+    const tvm::runtime::PackedFunc* build_module = tvm::runtime::Registry::Get("relay.build_module._BuildModule");
+    if (!build_module) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay.build_module._BuildModule not found");
+    }
+
+    // get the create-executor packed function
+    const tvm::runtime::PackedFunc* create_executor = tvm::runtime::Registry::Get("relay.backend.CreateExecutor");
+    if (!create_executor) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay.backend.CreateExecutor not found");
+    }
+
+    // get the create-runtime packed function
+    const tvm::runtime::PackedFunc* create_runtime = tvm::runtime::Registry::Get("relay.backend.CreateRuntime");
+    if (!create_runtime) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay.backend.CreateRuntime not found");
+    }
+
+    tvm::Target target;
+    auto status = create_target(get_blas_target(options), target);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    if (options.aot_c_interface && options.executor != ExecutorKind::AOT) {
+        return Status(StatusCode::INVALID_PARAM, "the C interface requires the AOT executor");
+    }
+
+    // the TE compiler requires the lower call hook to select the op implementations
+    status = prepare_lowering(options);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    tvm::IRModule optimized_module = module;
+    status = optimize_irmodule(optimized_module, options);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    // apply the tuning records of the target, the store may have none of them yet
+    tvm::runtime::Optional<tvm::meta_schedule::Database> database;
+    status = open_tuning_database(options, target, false, database);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    if (!options.meta_schedule_dir.empty() && !database) {
+        std::ostringstream oss;
+        oss << "MetaSchedule database does NOT exist: " << options.meta_schedule_dir;
+        return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+    }
+
+    tvm::transform::PassContext pass_ctx = create_pass_context(options);
+    std::unique_ptr<tvm::With<tvm::meta_schedule::Database>> database_scope;
+    if (database) {
+        // lower the fused functions with the MetaSchedule tuning records
+        pass_ctx->config.Set("relay.backend.use_meta_schedule", tvm::Bool(true));
+        database_scope = std::make_unique<tvm::With<tvm::meta_schedule::Database>>(database.value());
+    }
+    tvm::With<tvm::transform::PassContext> scope(pass_ctx);
+
+    try {
+        const tvm::runtime::Array<tvm::Target> raw_targets{target};
+
+        // the executor and runtime attributes
+        tvm::runtime::Map<tvm::runtime::String, tvm::runtime::ObjectRef> executor_attrs;
+        tvm::runtime::Map<tvm::runtime::String, tvm::runtime::ObjectRef> runtime_attrs;
+        if (options.executor == ExecutorKind::AOT && options.aot_c_interface) {
+            // the C entry point takes the input and output structs, the kernels are called directly
+            executor_attrs.Set("interface-api", tvm::runtime::String("c"));
+            executor_attrs.Set("unpacked-api", tvm::Bool(true));
+            executor_attrs.Set("link-params", tvm::Bool(true));
+        } else if (options.executor == ExecutorKind::AOT) {
+            // the c++ runtime requires the packed api, the params are linked so USMP can pool the constants
+            executor_attrs.Set("interface-api", tvm::runtime::String("packed"));
+            executor_attrs.Set("unpacked-api", tvm::Bool(false));
+            executor_attrs.Set("link-params", tvm::Bool(true));
+        } else if (options.link_params) {
+            executor_attrs.Set("link-params", tvm::Bool(true));
+        }
+
+        // create the executor
+        tvm::relay::Executor executor =
+            (*create_executor)(executor_kind_to_string(options.executor), executor_attrs);
+        // create the runtime
+        tvm::relay::Runtime runtime =
+            (*create_runtime)(options.aot_c_interface ? "crt" : "cpp", runtime_attrs);
+        // memory pool
+        tvm::WorkspaceMemoryPools mem_pool;
+        tvm::ConstantMemoryPools const_mem_pool;
+        create_memory_pools(options, target, mem_pool, const_mem_pool);
+
+        // generate the relay build module
+        tvm::runtime::Module relay_build_module = (*build_module)();
+        // get member functions
+        tvm::runtime::PackedFunc build = relay_build_module->GetFunction("build");
+        tvm::runtime::PackedFunc get_graph_json = relay_build_module->GetFunction("get_graph_json");
+        tvm::runtime::PackedFunc get_module = relay_build_module->GetFunction("get_module");
+        tvm::runtime::PackedFunc get_params = relay_build_module->GetFunction("get_params");
+        tvm::runtime::PackedFunc get_executor_codegen_metadata =
+            relay_build_module->GetFunction("get_executor_codegen_metadata");
+
+        build(optimized_module, raw_targets, target, executor, runtime, mem_pool, const_mem_pool, options.module_name);
+
+        result.executor = options.executor;
+        result.module_name = options.module_name;
+        result.lib = get_module();
+        result.graph_json.clear();
+        result.workspace_size = 0;
+        result.constant_size = 0;
+        if (options.executor == ExecutorKind::Graph) {
+            tvm::runtime::String graph_json = get_graph_json();
+            result.graph_json = graph_json;
+        } else {
+            tvm::runtime::ObjectRef metadata = get_executor_codegen_metadata();
+            get_pool_sizes(metadata, result.workspace_size, result.constant_size);
+        }
+
+        tvm::runtime::Map<tvm::runtime::String, tvm::relay::Constant> params = get_params();
+        result.params.clear();
+        for (const auto& kv : params) {
+            result.params.emplace(kv.first, kv.second->data);
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status create_graph_executor(const BuildResult& result, tvm::runtime::Module& executor) {
+    if (result.executor != ExecutorKind::Graph) {
+        return Status(StatusCode::INVALID_PARAM, "the build result is not compiled for the graph executor");
+    }
+
+    // the graph executor create function
+    const tvm::runtime::PackedFunc* graph_executor_create = tvm::runtime::Registry::Get("tvm.graph_executor.create");
+    if (!graph_executor_create) {
+        return Status(StatusCode::RUNTIME_ERROR, "tvm.graph_executor.create not found");
+    }
+
+    try {
+        executor = (*graph_executor_create)(result.graph_json, result.lib, static_cast<int>(kDLCPU), 0);
+
+        tvm::runtime::PackedFunc set_input = executor.GetFunction("set_input");
+        for (const auto& kv : result.params) {
+            set_input(kv.first, kv.second);
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status create_aot_executor(const BuildResult& result, tvm::runtime::Module& executor) {
+    if (result.executor != ExecutorKind::AOT) {
+        return Status(StatusCode::INVALID_PARAM, "the build result is not compiled for the AOT executor");
+    }
+
+    // the AOT executor factory create function
+    const tvm::runtime::PackedFunc* aot_factory_create =
+        tvm::runtime::Registry::Get("tvm.aot_executor_factory.create");
+    if (!aot_factory_create) {
+        return Status(StatusCode::RUNTIME_ERROR, "tvm.aot_executor_factory.create not found");
+    }
+
+    try {
+        // the arguments are the library, the module name and the params as name/data pairs
+        std::vector<TVMValue> values(2 + result.params.size() * 2);
+        std::vector<int> type_codes(values.size());
+        tvm::runtime::TVMArgsSetter setter(values.data(), type_codes.data());
+        setter(0, result.lib);
+        setter(1, result.module_name.c_str());
+
+        int index = 2;
+        for (const auto& kv : result.params) {
+            setter(index++, kv.first.c_str());
+            setter(index++, kv.second);
+        }
+
+        tvm::runtime::TVMRetValue rv;
+        aot_factory_create->CallPacked(
+            tvm::runtime::TVMArgs(values.data(), type_codes.data(), static_cast<int>(values.size())), &rv);
+        tvm::runtime::Module factory = rv;
+
+        DLDevice dev{DLDeviceType::kDLCPU, 0};
+        executor = factory.GetFunction(result.module_name)(dev);
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status create_executor(const BuildResult& result, tvm::runtime::Module& executor) {
+    if (result.executor == ExecutorKind::AOT) {
+        return create_aot_executor(result, executor);
+    }
+
+    return create_graph_executor(result, executor);
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
@@ -0,0 +1,122 @@
+#ifndef _H_TVM_CPP_COMPILER_MODEL_BUILDER_H_
+#define _H_TVM_CPP_COMPILER_MODEL_BUILDER_H_
+
+#include <tvm/ir/module.h>
+#include <tvm/ir/transform.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/target/target.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "compiler/build_options.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief The result of building a relay IRModule
+ *
+ */
+struct BuildResult {
+    // the executor of the compiled module
+    ExecutorKind executor{ExecutorKind::Graph};
+    // the module name of the compiled library
+    std::string module_name;
+    // the graph json, empty for the AOT executor
+    std::string graph_json;
+    // the compiled library
+    tvm::runtime::Module lib;
+    // the params lifted from the module. key: the param name, value: the param data
+    std::unordered_map<std::string, tvm::runtime::NDArray> params;
+    // the size of the USMP workspace pools in bytes, 0 if the workspace is not planned by USMP
+    int64_t workspace_size{0};
+    // the size of the USMP constant pools in bytes, 0 if the constants are not planned by USMP
+    int64_t constant_size{0};
+};
+
+/**
+ * @brief Create the compilation target
+ *
+ * @param target_str the target string, e.g. "llvm -mcpu=skylake-avx512"
+ * @param target output parameter. the target
+ * @return Status
+ */
+Status create_target(const std::string& target_str, tvm::Target& target);
+
+/**
+ * @brief Create the pass context with the build options
+ *
+ * @param options the build options
+ * @return tvm::transform::PassContext
+ */
+tvm::transform::PassContext create_pass_context(const BuildOptions& options);
+
+/**
+ * @brief Prepare the TE lowering of the build options: register the lower call hook, which TVM looks up once per
+ * process, and set the BLAS offload, TE kernel and implementation selection configs. It is called by every path which
+ * lowers the ops, e.g. the builds and the tuning task extraction
+ *
+ * @param options the build options
+ * @return Status
+ */
+Status prepare_lowering(const BuildOptions& options);
+
+/**
+ * @brief Run the optional optimizations of the build options on the IRModule, e.g. the sparse dense conversion, the
+ * conv layout conversion and the mixed precision conversion. It is called by `build_irmodule`, and exposed to inspect
+ * the optimized module
+ *
+ * @param module input/output parameter. the relay IRModule
+ * @param options the build options
+ * @return Status
+ */
+Status optimize_irmodule(tvm::IRModule& module, const BuildOptions& options);
+
+/**
+ * @brief Build the relay IRModule with the executor of the build options. The AOT executor links the params into
+ * the library, and plans the workspace and constants into a workspace pool and a constant pool when `options.usmp`
+ * is set
+ *
+ * @param module the relay IRModule
+ * @param options the build options
+ * @param result output parameter. the build result
+ * @return Status
+ */
+Status build_irmodule(const tvm::IRModule& module, const BuildOptions& options, BuildResult& result);
+
+/**
+ * @brief Create a graph executor on CPU from the build result, the params are set to the executor
+ *
+ * @param result the build result
+ * @param executor output parameter. the graph executor module
+ * @return Status
+ */
+Status create_graph_executor(const BuildResult& result, tvm::runtime::Module& executor);
+
+/**
+ * @brief Create an AOT executor on CPU from the build result, the params are set to the executor
+ *
+ * @param result the build result of the AOT executor
+ * @param executor output parameter. the AOT executor module
+ * @return Status
+ */
+Status create_aot_executor(const BuildResult& result, tvm::runtime::Module& executor);
+
+/**
+ * @brief Create the executor of the build result on CPU. The graph and AOT executors share the `set_input`, `run`
+ * and `get_output` functions
+ *
+ * @param result the build result
+ * @param executor output parameter. the executor module
+ * @return Status
+ */
+Status create_executor(const BuildResult& result, tvm::runtime::Module& executor);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
@@ -0,0 +1,172 @@
+#include "model_evaluator.h"
+
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+bool is_float32(const tvm::runtime::NDArray& array) {
+    return array->dtype.code == kDLFloat && array->dtype.bits == 32 && array->dtype.lanes == 1;
+}
+
+size_t get_element_num(const tvm::runtime::NDArray& array) {
+    return tvm::runtime::GetDataSize(*array.operator->()) / sizeof(float);
+}
+
+size_t get_argmax(const tvm::runtime::NDArray& array) {
+    const float* data = static_cast<const float*>(array->data);
+    return static_cast<size_t>(std::max_element(data, data + get_element_num(array)) - data);
+}
+
+}    // namespace
+
+Status set_executor_inputs(tvm::runtime::Module& executor, const sample_utils::TensorMap& inputs) {
+    try {
+        tvm::runtime::PackedFunc set_input = executor.GetFunction("set_input");
+        for (const auto& kv : inputs) {
+            set_input(kv.first, kv.second);
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status run_executor(tvm::runtime::Module& executor, const sample_utils::TensorMap& inputs,
+                    std::vector<tvm::runtime::NDArray>& outputs) {
+    auto status = set_executor_inputs(executor, inputs);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    outputs.clear();
+    try {
+        executor.GetFunction("run")();
+
+        tvm::runtime::PackedFunc get_output = executor.GetFunction("get_output");
+        int num_outputs = executor.GetFunction("get_num_outputs")();
+        for (int i = 0; i < num_outputs; ++i) {
+            tvm::runtime::NDArray output = get_output(i);
+            if (!is_float32(output)) {
+                std::ostringstream oss;
+                oss << "Output " << i << " is not float32, only float32 outputs are compared";
+                return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+            }
+
+            // the output buffer is reused by the next run
+            outputs.emplace_back(output.CopyTo({DLDeviceType::kDLCPU, 0}));
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status compare_executors(tvm::runtime::Module& reference, tvm::runtime::Module& candidate,
+                         const std::vector<sample_utils::TensorMap>& samples, AccuracyReport& report) {
+    report = AccuracyReport();
+
+    double abs_diff_sum = 0;
+    size_t element_count = 0;
+    double cosine_sum = 0;
+    int top1_matches = 0;
+
+    for (const auto& sample : samples) {
+        std::vector<tvm::runtime::NDArray> ref_outputs;
+        auto status = run_executor(reference, sample, ref_outputs);
+        if (!status.is_ok()) {
+            return status;
+        }
+
+        std::vector<tvm::runtime::NDArray> cand_outputs;
+        status = run_executor(candidate, sample, cand_outputs);
+        if (!status.is_ok()) {
+            return status;
+        }
+
+        if (ref_outputs.size() != cand_outputs.size()) {
+            return Status(StatusCode::INVALID_PARAM, "the executors have different numbers of outputs");
+        }
+
+        double dot = 0;
+        double ref_norm = 0;
+        double cand_norm = 0;
+        for (size_t i = 0; i < ref_outputs.size(); ++i) {
+            size_t element_num = get_element_num(ref_outputs[i]);
+            if (element_num != get_element_num(cand_outputs[i])) {
+                std::ostringstream oss;
+                oss << "Output " << i << " of the executors have different sizes";
+                return Status(StatusCode::INVALID_PARAM, oss.str());
+            }
+
+            const float* ref = static_cast<const float*>(ref_outputs[i]->data);
+            const float* cand = static_cast<const float*>(cand_outputs[i]->data);
+            for (size_t j = 0; j < element_num; ++j) {
+                double diff = std::fabs(static_cast<double>(ref[j]) - cand[j]);
+                report.max_abs_diff = std::max(report.max_abs_diff, diff);
+                abs_diff_sum += diff;
+                dot += static_cast<double>(ref[j]) * cand[j];
+                ref_norm += static_cast<double>(ref[j]) * ref[j];
+                cand_norm += static_cast<double>(cand[j]) * cand[j];
+            }
+            element_count += element_num;
+        }
+
+        double cosine = ref_norm > 0 && cand_norm > 0 ? dot / std::sqrt(ref_norm * cand_norm) : 1.0;
+        report.min_cosine = std::min(report.min_cosine, cosine);
+        cosine_sum += cosine;
+
+        if (!ref_outputs.empty() && get_argmax(ref_outputs[0]) == get_argmax(cand_outputs[0])) {
+            ++top1_matches;
+        }
+
+        ++report.samples;
+    }
+
+    if (report.samples > 0) {
+        report.mean_abs_diff = element_count > 0 ? abs_diff_sum / element_count : 0;
+        report.mean_cosine = cosine_sum / report.samples;
+        report.top1_agreement = static_cast<double>(top1_matches) / report.samples;
+    }
+
+    return Status::ok();
+}
+
+Status measure_executor_latency(tvm::runtime::Module& executor, const sample_utils::TensorMap& inputs, int warmup,
+                                int iterations, double& latency_ms) {
+    auto status = set_executor_inputs(executor, inputs);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    try {
+        tvm::runtime::PackedFunc run = executor.GetFunction("run");
+        for (int i = 0; i < warmup; ++i) {
+            run();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            run();
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        latency_ms = std::chrono::duration<double, std::milli>(end - start).count() / std::max(iterations, 1);
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
@@ -0,0 +1,82 @@
+#ifndef _H_TVM_CPP_COMPILER_MODEL_EVALUATOR_H_
+#define _H_TVM_CPP_COMPILER_MODEL_EVALUATOR_H_
+
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <vector>
+
+#include "utils/sample_utils.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief The output drift of a candidate build against the reference build over the samples
+ *
+ */
+struct AccuracyReport {
+    // the number of compared samples
+    int samples{0};
+    // the max absolute difference of all the output elements
+    double max_abs_diff{0};
+    // the mean absolute difference of all the output elements
+    double mean_abs_diff{0};
+    // the min cosine similarity of the outputs of a sample
+    double min_cosine{1};
+    // the mean cosine similarity of the outputs of the samples
+    double mean_cosine{0};
+    // the fraction of the samples whose argmax of the first output matches the reference
+    double top1_agreement{0};
+};
+
+/**
+ * @brief Set the inputs to the executor, the graph and AOT executors share `set_input`
+ *
+ * @param executor the executor module
+ * @param inputs the input tensors
+ * @return Status
+ */
+Status set_executor_inputs(tvm::runtime::Module& executor, const sample_utils::TensorMap& inputs);
+
+/**
+ * @brief Run the executor with the inputs and copy the float32 outputs
+ *
+ * @param executor the executor module
+ * @param inputs the input tensors
+ * @param outputs output parameter. the copied outputs
+ * @return Status
+ */
+Status run_executor(tvm::runtime::Module& executor, const sample_utils::TensorMap& inputs,
+                    std::vector<tvm::runtime::NDArray>& outputs);
+
+/**
+ * @brief Run the reference and the candidate executors on the samples and compare their float32 outputs
+ *
+ * @param reference the reference executor, e.g. the float32 build
+ * @param candidate the candidate executor, e.g. the mixed precision or int8 build
+ * @param samples the input samples
+ * @param report output parameter. the accuracy report
+ * @return Status
+ */
+Status compare_executors(tvm::runtime::Module& reference, tvm::runtime::Module& candidate,
+                         const std::vector<sample_utils::TensorMap>& samples, AccuracyReport& report);
+
+/**
+ * @brief Measure the mean latency of the executor
+ *
+ * @param executor the executor module
+ * @param inputs the input tensors
+ * @param warmup the number of warm up runs
+ * @param iterations the number of timed runs
+ * @param latency_ms output parameter. the mean latency in milli seconds
+ * @return Status
+ */
+Status measure_executor_latency(tvm::runtime::Module& executor, const sample_utils::TensorMap& inputs, int warmup,
+                                int iterations, double& latency_ms);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
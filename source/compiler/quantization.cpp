@@ -0,0 +1,446 @@
+#include "quantization.h"
+
+#include <tvm/ir/op.h>
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/expr.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/transform.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <unordered_map>
+
+#include "compiler/model_builder.h"
+#include "compiler/model_evaluator.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+// the max value of the symmetric int8 range
+constexpr float kInt8Max = 127.0f;
+// the number of the quantized bins of the KL calibration
+constexpr int kQuantizedBins = 255;
+
+bool is_float32_tensor(const tvm::Type& type, size_t ndim) {
+    const auto* tensor_type = type.as<tvm::relay::TensorTypeNode>();
+    return tensor_type && tensor_type->dtype == tvm::DataType::Float(32) && tensor_type->shape.size() == ndim;
+}
+
+/**
+ * @brief Collect the nn.conv2d and nn.dense ops with constant float32 weights, in the topological order
+ *
+ */
+class QuantizableOpCollector : public tvm::relay::ExprVisitor {
+public:
+    QuantizableOpCollector() : m_conv2d_op(tvm::Op::Get("nn.conv2d")), m_dense_op(tvm::Op::Get("nn.dense")) {}
+    virtual ~QuantizableOpCollector() = default;
+
+    void VisitExpr_(const tvm::relay::CallNode* call) override {
+        tvm::relay::ExprVisitor::VisitExpr_(call);
+
+        if (call->args.size() < 2 || !call->args[1].as<tvm::relay::ConstantNode>()) {
+            return;
+        }
+
+        if (call->op.same_as(m_conv2d_op)) {
+            const auto* attrs = call->attrs.as<tvm::relay::Conv2DAttrs>();
+            if (attrs && attrs->data_layout == "NCHW" && attrs->kernel_layout == "OIHW" &&
+                is_float32_tensor(call->args[0]->checked_type(), 4) &&
+                is_float32_tensor(call->args[1]->checked_type(), 4)) {
+                m_calls.emplace_back(call);
+            }
+        } else if (call->op.same_as(m_dense_op)) {
+            if (is_float32_tensor(call->args[0]->checked_type(), 2) &&
+                is_float32_tensor(call->args[1]->checked_type(), 2)) {
+                m_calls.emplace_back(call);
+            }
+        }
+    }
+
+    const std::vector<const tvm::relay::CallNode*>& calls() const { return m_calls; }
+
+private:
+    tvm::Op m_conv2d_op;
+    tvm::Op m_dense_op;
+    std::vector<const tvm::relay::CallNode*> m_calls;
+};
+
+tvm::relay::Constant create_scalar_constant(float value) {
+    tvm::runtime::NDArray array =
+        tvm::runtime::NDArray::Empty({}, {DLDataTypeCode::kDLFloat, 32, 1}, {DLDeviceType::kDLCPU, 0});
+    static_cast<float*>(array->data)[0] = value;
+    return tvm::relay::Constant(array);
+}
+
+tvm::relay::Constant create_zero_point_constant() {
+    tvm::runtime::NDArray array =
+        tvm::runtime::NDArray::Empty({}, {DLDataTypeCode::kDLInt, 32, 1}, {DLDeviceType::kDLCPU, 0});
+    static_cast<int32_t*>(array->data)[0] = 0;
+    return tvm::relay::Constant(array);
+}
+
+tvm::relay::Constant create_vector_constant(const std::vector<float>& values) {
+    tvm::runtime::NDArray array = tvm::runtime::NDArray::Empty({static_cast<int64_t>(values.size())},
+                                                               {DLDataTypeCode::kDLFloat, 32, 1},
+                                                               {DLDeviceType::kDLCPU, 0});
+    std::copy(values.begin(), values.end(), static_cast<float*>(array->data));
+    return tvm::relay::Constant(array);
+}
+
+/**
+ * @brief Quantize the float32 weight to int8 per output channel (axis 0)
+ *
+ */
+void quantize_weight(const tvm::runtime::NDArray& weight, tvm::runtime::NDArray& qweight, std::vector<float>& scales) {
+    int64_t out_channels = weight->shape[0];
+    int64_t element_num = 1;
+    for (int i = 0; i < weight->ndim; ++i) {
+        element_num *= weight->shape[i];
+    }
+    int64_t channel_size = element_num / out_channels;
+
+    qweight = tvm::runtime::NDArray::Empty(weight.Shape(), {DLDataTypeCode::kDLInt, 8, 1}, {DLDeviceType::kDLCPU, 0});
+    const float* data = static_cast<const float*>(weight->data);
+    int8_t* qdata = static_cast<int8_t*>(qweight->data);
+
+    scales.resize(out_channels);
+    for (int64_t o = 0; o < out_channels; ++o) {
+        const float* channel = data + o * channel_size;
+        float max_abs = 0;
+        for (int64_t i = 0; i < channel_size; ++i) {
+            max_abs = std::max(max_abs, std::fabs(channel[i]));
+        }
+
+        float scale = max_abs > 0 ? max_abs / kInt8Max : 1.0f;
+        scales[o] = scale;
+        for (int64_t i = 0; i < channel_size; ++i) {
+            float q = std::round(channel[i] / scale);
+            qdata[o * channel_size + i] = static_cast<int8_t>(std::clamp(q, -kInt8Max, kInt8Max));
+        }
+    }
+}
+
+/**
+ * @brief Rewrite the calibrated ops to the qnn ops
+ *
+ */
+class QnnRewriter : public tvm::relay::ExprMutator {
+public:
+    explicit QnnRewriter(const std::unordered_map<const tvm::relay::CallNode*, float>& input_scales)
+        : m_input_scales(input_scales),
+          m_quantize(tvm::runtime::Registry::Get("relay.qnn.op._make.quantize")),
+          m_dequantize(tvm::runtime::Registry::Get("relay.qnn.op._make.dequantize")),
+          m_qnn_conv2d(tvm::runtime::Registry::Get("relay.qnn.op._make.conv2d")),
+          m_qnn_dense(tvm::runtime::Registry::Get("relay.qnn.op._make.dense")) {}
+    virtual ~QnnRewriter() = default;
+
+    bool valid() const { return m_quantize && m_dequantize && m_qnn_conv2d && m_qnn_dense; }
+
+    tvm::relay::Expr VisitExpr_(const tvm::relay::CallNode* call) override {
+        tvm::relay::Expr new_expr = tvm::relay::ExprMutator::VisitExpr_(call);
+        auto iter = m_input_scales.find(call);
+        if (iter == m_input_scales.end()) {
+            return new_expr;
+        }
+
+        const auto* new_call = new_expr.as<tvm::relay::CallNode>();
+        const auto* weight = new_call->args[1].as<tvm::relay::ConstantNode>();
+
+        float input_scale = iter->second;
+        tvm::runtime::NDArray qweight;
+        std::vector<float> kernel_scales;
+        quantize_weight(weight->data, qweight, kernel_scales);
+
+        std::vector<float> output_scales(kernel_scales.size());
+        for (size_t i = 0; i < kernel_scales.size(); ++i) {
+            output_scales[i] = input_scale * kernel_scales[i];
+        }
+
+        tvm::relay::Expr zero_point = create_zero_point_constant();
+        tvm::relay::Expr input_scale_expr = create_scalar_constant(input_scale);
+        tvm::relay::Expr qdata =
+            (*m_quantize)(new_call->args[0], input_scale_expr, zero_point, 1, tvm::DataType::Int(8));
+
+        tvm::relay::Expr qout;
+        if (const auto* attrs = call->attrs.as<tvm::relay::Conv2DAttrs>()) {
+            tvm::runtime::Array<tvm::PrimExpr> kernel_size{tvm::Integer(qweight->shape[2]),
+                                                           tvm::Integer(qweight->shape[3])};
+            qout = (*m_qnn_conv2d)(qdata, tvm::relay::Constant(qweight), zero_point, zero_point, input_scale_expr,
+                                   create_vector_constant(kernel_scales), attrs->strides, attrs->padding,
+                                   attrs->dilation, attrs->groups, tvm::Integer(qweight->shape[0]), kernel_size,
+                                   attrs->data_layout, attrs->kernel_layout, attrs->out_layout, tvm::DataType::Int(32));
+        } else {
+            qout = (*m_qnn_dense)(qdata, tvm::relay::Constant(qweight), zero_point, zero_point, input_scale_expr,
+                                  create_vector_constant(kernel_scales), tvm::Integer(qweight->shape[0]),
+                                  tvm::DataType::Int(32));
+        }
+
+        // the output channel is the axis 1 of both NCHW and the dense output
+        return (*m_dequantize)(qout, create_vector_constant(output_scales), zero_point, 1, tvm::DataType::Float(32));
+    }
+
+private:
+    const std::unordered_map<const tvm::relay::CallNode*, float>& m_input_scales;
+    const tvm::runtime::PackedFunc* m_quantize;
+    const tvm::runtime::PackedFunc* m_dequantize;
+    const tvm::runtime::PackedFunc* m_qnn_conv2d;
+    const tvm::runtime::PackedFunc* m_qnn_dense;
+};
+
+/**
+ * @brief Choose the clipping threshold from the symmetric histogram in [-max_abs, max_abs]
+ *
+ */
+Status choose_threshold(const std::vector<int32_t>& hist, float max_abs, const QuantizeOptions& options,
+                        const tvm::runtime::PackedFunc* find_scale_by_kl, float& threshold) {
+    threshold = max_abs;
+    if (options.mode == CalibrationMode::Max || max_abs <= 0) {
+        return Status::ok();
+    }
+
+    int num_bins = static_cast<int>(hist.size());
+    std::vector<float> edges(num_bins + 1);
+    for (int i = 0; i <= num_bins; ++i) {
+        edges[i] = -max_abs + 2 * max_abs * i / num_bins;
+    }
+
+    if (options.mode == CalibrationMode::KL) {
+        try {
+            // the histogram and the edges are passed as raw pointers
+            std::vector<int32_t> hist_copy = hist;
+            double kl_threshold = (*find_scale_by_kl)(static_cast<void*>(hist_copy.data()),
+                                                      static_cast<void*>(edges.data()), num_bins, kQuantizedBins);
+            threshold = static_cast<float>(kl_threshold);
+        } catch (const tvm::runtime::Error& e) {
+            return Status(StatusCode::RUNTIME_ERROR, e.what());
+        }
+        return Status::ok();
+    }
+
+    // the percentile of the absolute values, accumulated from the center bins outward. The center bin of an odd
+    // histogram holds the zero, the two center bins of an even one meet at it
+    int64_t total = 0;
+    for (int32_t count : hist) {
+        total += count;
+    }
+
+    int64_t target = static_cast<int64_t>(std::ceil(total * options.percentile / 100.0));
+    int64_t accumulated = 0;
+    int upper = num_bins / 2;
+    int lower = num_bins % 2 == 1 ? upper : upper - 1;
+    for (int i = 0; upper + i < num_bins; ++i) {
+        accumulated += hist[upper + i];
+        if (lower - i != upper + i) {
+            accumulated += hist[lower - i];
+        }
+        if (accumulated >= target) {
+            threshold = edges[upper + i + 1];
+            return Status::ok();
+        }
+    }
+
+    return Status::ok();
+}
+
+}    // namespace
+
+Status quantize_irmodule(const tvm::IRModule& module, const std::vector<sample_utils::TensorMap>& samples,
+                         const BuildOptions& build_options, const QuantizeOptions& options, tvm::IRModule& quantized,
+                         QuantizeStats& stats) {
+    if (samples.empty()) {
+        return Status(StatusCode::INVALID_PARAM, "the calibration samples are empty");
+    }
+
+    // type infer
+    const tvm::runtime::PackedFunc* type_infer = tvm::runtime::Registry::Get("relay._transform.InferType");
+    if (!type_infer) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._transform.InferType expression not found");
+    }
+
+    // simplify inference, e.g. batch norm to multiply and add
+    const tvm::runtime::PackedFunc* simplify_inference =
+        tvm::runtime::Registry::Get("relay._transform.SimplifyInference");
+    if (!simplify_inference) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._transform.SimplifyInference expression not found");
+    }
+
+    // fold constant
+    const tvm::runtime::PackedFunc* fold_const = tvm::runtime::Registry::Get("relay._transform.FoldConstant");
+    if (!fold_const) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._transform.FoldConstant expression not found");
+    }
+
+    // pass run
+    const tvm::runtime::PackedFunc* pass_run = tvm::runtime::Registry::Get("transform.RunPass");
+    if (!pass_run) {
+        return Status(StatusCode::RUNTIME_ERROR, "transform.pass_run expression not found");
+    }
+
+    // the tuple and function generators
+    const tvm::runtime::PackedFunc* tuple = tvm::runtime::Registry::Get("relay.ir.Tuple");
+    const tvm::runtime::PackedFunc* function = tvm::runtime::Registry::Get("relay.ir.Function");
+    if (!tuple || !function) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay.ir.Tuple or relay.ir.Function expression not found");
+    }
+
+    if (options.num_bins <= 0) {
+        return Status(StatusCode::INVALID_PARAM, "the number of histogram bins must be positive");
+    }
+
+    if (options.mode == CalibrationMode::Percentile && (options.percentile <= 0 || options.percentile > 100)) {
+        return Status(StatusCode::INVALID_PARAM, "the calibration percentile must be in (0, 100]");
+    }
+
+    // the KL minimization of TVM walks the bins around the center bin of an odd histogram
+    const tvm::runtime::PackedFunc* find_scale_by_kl = nullptr;
+    if (options.mode == CalibrationMode::KL) {
+        if (options.num_bins % 2 == 0 || options.num_bins < kQuantizedBins) {
+            std::ostringstream oss;
+            oss << "the KL calibration needs an odd number of histogram bins, at least " << kQuantizedBins
+                << ", got " << options.num_bins;
+            return Status(StatusCode::INVALID_PARAM, oss.str());
+        }
+
+        find_scale_by_kl = tvm::runtime::Registry::Get("relay._quantize.FindScaleByKLMinimization");
+        if (!find_scale_by_kl) {
+            return Status(StatusCode::RUNTIME_ERROR, "relay._quantize.FindScaleByKLMinimization not found");
+        }
+    }
+
+    stats = QuantizeStats();
+
+    // Step 1. fold the weights to constants, the module is kept alive so the collected call nodes stay valid
+    std::vector<tvm::relay::transform::Pass> passes;
+    passes.emplace_back((*type_infer)());
+    passes.emplace_back((*simplify_inference)());
+    passes.emplace_back((*fold_const)(false));
+    passes.emplace_back((*type_infer)());
+
+    tvm::IRModule prepared = module;
+    try {
+        for (const auto& pass : passes) {
+            prepared = (*pass_run)(pass, prepared);
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    const auto* main_func = prepared->Lookup("main").as<tvm::relay::FunctionNode>();
+    if (!main_func) {
+        return Status(StatusCode::INVALID_PARAM, "the module has no relay main function");
+    }
+
+    QuantizableOpCollector collector;
+    collector.VisitExpr(prepared->Lookup("main"));
+
+    std::vector<const tvm::relay::CallNode*> calls;
+    bool first_conv = true;
+    for (const auto* call : collector.calls()) {
+        bool is_conv = call->attrs.as<tvm::relay::Conv2DAttrs>() != nullptr;
+        if (is_conv && first_conv && options.skip_first_conv) {
+            first_conv = false;
+            ++stats.skipped_ops;
+            continue;
+        }
+        first_conv = first_conv && !is_conv;
+        calls.emplace_back(call);
+    }
+
+    if (calls.empty()) {
+        quantized = prepared;
+        return Status::ok();
+    }
+
+    // Step 2. build a module which outputs the inputs of the ops to calibrate
+    tvm::runtime::Array<tvm::relay::Expr> activations;
+    for (const auto* call : calls) {
+        activations.push_back(call->args[0]);
+    }
+
+    tvm::relay::Expr calib_func = (*function)(main_func->params, (*tuple)(activations, tvm::relay::Span()),
+                                              tvm::relay::Type(), tvm::runtime::Array<tvm::relay::TypeVar>(),
+                                              tvm::DictAttrs(), tvm::relay::Span());
+
+    BuildOptions calib_options;
+    calib_options.target = build_options.target;
+    calib_options.opt_level = build_options.opt_level;
+
+    BuildResult calib_result;
+    auto status = build_irmodule(tvm::IRModule::FromExpr(calib_func), calib_options, calib_result);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    tvm::runtime::Module calib_executor;
+    status = create_executor(calib_result, calib_executor);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    // Step 3. the max absolute values, then the histograms in [-max, max]
+    std::vector<float> max_abs(calls.size(), 0.0f);
+    std::vector<std::vector<int32_t>> hists(calls.size(), std::vector<int32_t>(options.num_bins, 0));
+    int rounds = options.mode == CalibrationMode::Max ? 1 : 2;
+    for (int round = 0; round < rounds; ++round) {
+        for (const auto& sample : samples) {
+            std::vector<tvm::runtime::NDArray> outputs;
+            status = run_executor(calib_executor, sample, outputs);
+            if (!status.is_ok()) {
+                return status;
+            }
+
+            for (size_t i = 0; i < calls.size(); ++i) {
+                const float* data = static_cast<const float*>(outputs[i]->data);
+                size_t element_num = tvm::runtime::GetDataSize(*outputs[i].operator->()) / sizeof(float);
+                if (round == 0) {
+                    for (size_t j = 0; j < element_num; ++j) {
+                        max_abs[i] = std::max(max_abs[i], std::fabs(data[j]));
+                    }
+                } else if (max_abs[i] > 0) {
+                    for (size_t j = 0; j < element_num; ++j) {
+                        int bin = static_cast<int>((data[j] + max_abs[i]) / (2 * max_abs[i]) * options.num_bins);
+                        ++hists[i][std::clamp(bin, 0, options.num_bins - 1)];
+                    }
+                }
+            }
+        }
+    }
+
+    std::unordered_map<const tvm::relay::CallNode*, float> input_scales;
+    for (size_t i = 0; i < calls.size(); ++i) {
+        float threshold = 0;
+        status = choose_threshold(hists[i], max_abs[i], options, find_scale_by_kl, threshold);
+        if (!status.is_ok()) {
+            return status;
+        }
+        input_scales.emplace(calls[i], threshold > 0 ? threshold / kInt8Max : 1.0f);
+
+        if (calls[i]->attrs.as<tvm::relay::Conv2DAttrs>()) {
+            ++stats.quantized_convs;
+        } else {
+            ++stats.quantized_denses;
+        }
+    }
+
+    // Step 4. rewrite the ops to the qnn ops
+    QnnRewriter rewriter(input_scales);
+    if (!rewriter.valid()) {
+        return Status(StatusCode::RUNTIME_ERROR, "the qnn op generators are not found");
+    }
+
+    try {
+        tvm::relay::Expr new_main = rewriter.VisitExpr(prepared->Lookup("main"));
+        quantized = (*pass_run)((*type_infer)(), tvm::IRModule::FromExpr(new_main));
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
@@ -0,0 +1,91 @@
+#ifndef _H_TVM_CPP_COMPILER_QUANTIZATION_H_
+#define _H_TVM_CPP_COMPILER_QUANTIZATION_H_
+
+#include <tvm/ir/module.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "utils/sample_utils.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief The method to choose the activation clipping threshold from the calibration histogram
+ *
+ */
+enum class CalibrationMode : uint8_t {
+    // minimize the KL divergence between the float and the quantized distributions
+    KL,
+    // the percentile of the absolute values
+    Percentile,
+    // the max absolute value
+    Max
+};
+
+constexpr const char* calibration_mode_to_string(CalibrationMode mode) {
+    switch (mode) {
+        case CalibrationMode::KL:
+            return "kl";
+        case CalibrationMode::Percentile:
+            return "percentile";
+        case CalibrationMode::Max:
+            return "max";
+        default:
+            return "unknown";
+    }
+}
+
+/**
+ * @brief The options of the post-training int8 quantization
+ *
+ */
+struct QuantizeOptions {
+    // the calibration method of the activations
+    CalibrationMode mode{CalibrationMode::KL};
+    // the percentile of CalibrationMode::Percentile, in (0, 100]
+    double percentile{99.99};
+    // the number of histogram bins of the activations, odd and at least 255 for CalibrationMode::KL
+    int num_bins{8001};
+    // keep the first convolution in float32, it sees the raw input and is usually sensitive to quantization
+    bool skip_first_conv{true};
+};
+
+/**
+ * @brief The statistics of the quantization
+ *
+ */
+struct QuantizeStats {
+    // the number of nn.conv2d rewritten to qnn.conv2d
+    int quantized_convs{0};
+    // the number of nn.dense rewritten to qnn.dense
+    int quantized_denses{0};
+    // the number of nn.conv2d and nn.dense kept in float32
+    int skipped_ops{0};
+};
+
+/**
+ * @brief Quantize the nn.conv2d and nn.dense ops of the IRModule to int8.
+ * The inputs of the ops are calibrated by running the float module on the samples, the constant weights are
+ * quantized per output channel. Each quantized op becomes qnn.quantize -> qnn.conv2d/qnn.dense with int32
+ * accumulation -> qnn.dequantize, the qnn ops are lowered by the QNN legalization of the build
+ *
+ * @param module the float relay IRModule
+ * @param samples the calibration samples
+ * @param build_options the options to build the calibration module, e.g. the target
+ * @param options the quantization options
+ * @param quantized output parameter. the quantized relay IRModule
+ * @param stats output parameter. the quantization statistics
+ * @return Status
+ */
+Status quantize_irmodule(const tvm::IRModule& module, const std::vector<sample_utils::TensorMap>& samples,
+                         const BuildOptions& build_options, const QuantizeOptions& options, tvm::IRModule& quantized,
+                         QuantizeStats& stats);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
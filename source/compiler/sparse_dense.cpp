@@ -0,0 +1,279 @@
+#include "sparse_dense.h"
+
+#include <tvm/ir/op.h>
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/expr.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/transform.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+bool is_float32_matrix(const tvm::Type& type) {
+    const auto* tensor_type = type.as<tvm::relay::TensorTypeNode>();
+    return tensor_type && tensor_type->dtype == tvm::DataType::Float(32) && tensor_type->shape.size() == 2;
+}
+
+/**
+ * @brief Check whether the (block_rows, 1) block at the block row and the column has a non-zero value
+ *
+ */
+bool is_nonzero_block(const float* data, int64_t input, int block_rows, int64_t block_row, int64_t column) {
+    for (int r = 0; r < block_rows; ++r) {
+        if (data[(block_row * block_rows + r) * input + column] != 0.0f) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Convert the [units, input] weight to the BSR format with (block_rows, 1) blocks
+ *
+ * @param weight the dense weight
+ * @param block_rows the row block size
+ * @param bsr_data output parameter. the [nonzero_blocks, block_rows, 1] block values
+ * @param bsr_indices output parameter. the [nonzero_blocks] column of each block
+ * @param bsr_indptr output parameter. the [units / block_rows + 1] offsets of the block rows
+ */
+void convert_to_bsr(const tvm::runtime::NDArray& weight, int block_rows, tvm::runtime::NDArray& bsr_data,
+                    tvm::runtime::NDArray& bsr_indices, tvm::runtime::NDArray& bsr_indptr) {
+    int64_t units = weight->shape[0];
+    int64_t input = weight->shape[1];
+    int64_t block_row_num = units / block_rows;
+    const float* data = static_cast<const float*>(weight->data);
+
+    std::vector<int32_t> indices;
+    std::vector<int32_t> indptr{0};
+    for (int64_t i = 0; i < block_row_num; ++i) {
+        for (int64_t k = 0; k < input; ++k) {
+            if (is_nonzero_block(data, input, block_rows, i, k)) {
+                indices.emplace_back(static_cast<int32_t>(k));
+            }
+        }
+        indptr.emplace_back(static_cast<int32_t>(indices.size()));
+    }
+
+    int64_t nonzero_blocks = static_cast<int64_t>(indices.size());
+    DLDevice cpu{DLDeviceType::kDLCPU, 0};
+    bsr_data = tvm::runtime::NDArray::Empty({nonzero_blocks, block_rows, 1}, {DLDataTypeCode::kDLFloat, 32, 1}, cpu);
+    bsr_indices = tvm::runtime::NDArray::Empty({nonzero_blocks}, {DLDataTypeCode::kDLInt, 32, 1}, cpu);
+    bsr_indptr =
+        tvm::runtime::NDArray::Empty({static_cast<int64_t>(indptr.size())}, {DLDataTypeCode::kDLInt, 32, 1}, cpu);
+
+    float* block_data = static_cast<float*>(bsr_data->data);
+    for (int64_t i = 0; i < block_row_num; ++i) {
+        for (int32_t j = indptr[i]; j < indptr[i + 1]; ++j) {
+            for (int r = 0; r < block_rows; ++r) {
+                block_data[j * block_rows + r] = data[(i * block_rows + r) * input + indices[j]];
+            }
+        }
+    }
+
+    std::copy(indices.begin(), indices.end(), static_cast<int32_t*>(bsr_indices->data));
+    std::copy(indptr.begin(), indptr.end(), static_cast<int32_t*>(bsr_indptr->data));
+}
+
+/**
+ * @brief Rewrite the nn.dense ops with sparse constant weights to nn.sparse_dense
+ *
+ */
+class SparseDenseRewriter : public tvm::relay::ExprMutator {
+public:
+    SparseDenseRewriter(const BuildOptions& options, const tvm::runtime::PackedFunc* sparse_dense)
+        : m_options(options), m_sparse_dense(sparse_dense), m_dense_op(tvm::Op::Get("nn.dense")) {}
+    virtual ~SparseDenseRewriter() = default;
+
+    tvm::relay::Expr VisitExpr_(const tvm::relay::CallNode* call) override {
+        tvm::relay::Expr new_expr = tvm::relay::ExprMutator::VisitExpr_(call);
+        if (!call->op.same_as(m_dense_op)) {
+            return new_expr;
+        }
+
+        const auto* new_call = new_expr.as<tvm::relay::CallNode>();
+        const auto* weight = new_call->args[1].as<tvm::relay::ConstantNode>();
+        const auto* attrs = call->attrs.as<tvm::relay::DenseAttrs>();
+        // nn.sparse_dense has no out_dtype, so only the plain float32 dense is converted
+        if (!weight || !attrs || (!attrs->out_dtype.is_void() && attrs->out_dtype != tvm::DataType::Float(32)) ||
+            !is_float32_matrix(call->args[0]->checked_type()) || !is_float32_matrix(call->args[1]->checked_type())) {
+            return new_expr;
+        }
+
+        int block_rows = choose_block_rows(weight->data);
+        if (block_rows <= 0) {
+            return new_expr;
+        }
+
+        tvm::runtime::NDArray bsr_data;
+        tvm::runtime::NDArray bsr_indices;
+        tvm::runtime::NDArray bsr_indptr;
+        convert_to_bsr(weight->data, block_rows, bsr_data, bsr_indices, bsr_indptr);
+
+        return (*m_sparse_dense)(new_call->args[0], tvm::relay::Constant(bsr_data), tvm::relay::Constant(bsr_indices),
+                                 tvm::relay::Constant(bsr_indptr), false);
+    }
+
+private:
+    /**
+     * @brief Choose the row block size of the weight
+     *
+     * @return int the block size, or 0 if the weight is not sparse enough
+     */
+    int choose_block_rows(const tvm::runtime::NDArray& weight) const {
+        int64_t units = weight->shape[0];
+        std::vector<int> candidates{m_options.sparse_block_size};
+        if (m_options.sparse_block_size <= 0) {
+            candidates = get_default_sparse_block_sizes();
+        }
+
+        for (int block_rows : candidates) {
+            if (units % block_rows == 0 && get_block_sparsity(weight, block_rows) >= m_options.sparse_threshold) {
+                return block_rows;
+            }
+        }
+
+        return 0;
+    }
+
+    const BuildOptions& m_options;
+    const tvm::runtime::PackedFunc* m_sparse_dense;
+    tvm::Op m_dense_op;
+};
+
+/**
+ * @brief Count the nn.sparse_dense and nn.dense ops
+ *
+ */
+class SparseDenseCounter : public tvm::relay::ExprVisitor {
+public:
+    SparseDenseCounter() : m_sparse_dense_op(tvm::Op::Get("nn.sparse_dense")), m_dense_op(tvm::Op::Get("nn.dense")) {}
+    virtual ~SparseDenseCounter() = default;
+
+    void VisitExpr_(const tvm::relay::CallNode* call) override {
+        if (call->op.same_as(m_sparse_dense_op)) {
+            ++m_stats.sparse_denses;
+
+            const auto* bsr_data = call->args[1].as<tvm::relay::ConstantNode>();
+            const auto* bsr_indptr = call->args[3].as<tvm::relay::ConstantNode>();
+            const auto* data_type = call->args[0]->checked_type().as<tvm::relay::TensorTypeNode>();
+            if (bsr_data && bsr_indptr && data_type) {
+                const auto* input = data_type->shape[1].as<tvm::IntImmNode>();
+                m_stats.nonzero_blocks += bsr_data->data->shape[0];
+                m_stats.total_blocks += (bsr_indptr->data->shape[0] - 1) * (input ? input->value : 0);
+            }
+        } else if (call->op.same_as(m_dense_op)) {
+            ++m_stats.denses;
+        }
+
+        tvm::relay::ExprVisitor::VisitExpr_(call);
+    }
+
+    const SparseDenseStats& stats() const { return m_stats; }
+
+private:
+    tvm::Op m_sparse_dense_op;
+    tvm::Op m_dense_op;
+    SparseDenseStats m_stats;
+};
+
+}    // namespace
+
+const std::vector<int>& get_default_sparse_block_sizes() {
+    static const std::vector<int> block_sizes{16, 8, 4, 2, 1};
+    return block_sizes;
+}
+
+double get_block_sparsity(const tvm::runtime::NDArray& weight, int block_rows) {
+    int64_t units = weight->shape[0];
+    int64_t input = weight->shape[1];
+    int64_t block_row_num = units / block_rows;
+    if (block_row_num == 0 || input == 0) {
+        return 0;
+    }
+
+    const float* data = static_cast<const float*>(weight->data);
+    int64_t zero_blocks = 0;
+    for (int64_t i = 0; i < block_row_num; ++i) {
+        for (int64_t k = 0; k < input; ++k) {
+            if (!is_nonzero_block(data, input, block_rows, i, k)) {
+                ++zero_blocks;
+            }
+        }
+    }
+
+    return static_cast<double>(zero_blocks) / (block_row_num * input);
+}
+
+Status convert_sparse_dense(tvm::IRModule& module, const BuildOptions& options) {
+    if (options.sparse_threshold <= 0) {
+        return Status::ok();
+    }
+
+    if (options.sparse_threshold > 1) {
+        std::ostringstream oss;
+        oss << "Invalid sparse threshold: " << options.sparse_threshold << ", it should be in (0, 1]";
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    // type infer
+    const tvm::runtime::PackedFunc* type_infer = tvm::runtime::Registry::Get("relay._transform.InferType");
+    if (!type_infer) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._transform.InferType expression not found");
+    }
+
+    // fold constant
+    const tvm::runtime::PackedFunc* fold_const = tvm::runtime::Registry::Get("relay._transform.FoldConstant");
+    if (!fold_const) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._transform.FoldConstant expression not found");
+    }
+
+    // pass run
+    const tvm::runtime::PackedFunc* pass_run = tvm::runtime::Registry::Get("transform.RunPass");
+    if (!pass_run) {
+        return Status(StatusCode::RUNTIME_ERROR, "transform.pass_run expression not found");
+    }
+
+    // sparse dense
+    const tvm::runtime::PackedFunc* sparse_dense = tvm::runtime::Registry::Get("relay.op.nn._make.sparse_dense");
+    if (!sparse_dense) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay.op.nn._make.sparse_dense expression not found");
+    }
+
+    // the weights of the Gemm with transB = 0 are transposed constants until they are folded
+    std::vector<tvm::relay::transform::Pass> passes;
+    passes.emplace_back((*type_infer)());
+    passes.emplace_back((*fold_const)(false));
+    passes.emplace_back((*type_infer)());
+
+    for (const auto& pass : passes) {
+        module = (*pass_run)(pass, module);
+    }
+
+    SparseDenseRewriter rewriter(options, sparse_dense);
+    tvm::relay::Expr new_main = rewriter.VisitExpr(module->Lookup("main"));
+    module = (*pass_run)((*type_infer)(), tvm::IRModule::FromExpr(new_main));
+
+    return Status::ok();
+}
+
+Status count_sparse_denses(const tvm::IRModule& module, SparseDenseStats& stats) {
+    if (!module->ContainGlobalVar("main")) {
+        return Status(StatusCode::INVALID_PARAM, "main function not found in the module");
+    }
+
+    SparseDenseCounter counter;
+    counter(module->Lookup("main"));
+    stats = counter.stats();
+
+    return Status::ok();
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
@@ -0,0 +1,71 @@
+#ifndef _H_TVM_CPP_COMPILER_SPARSE_DENSE_H_
+#define _H_TVM_CPP_COMPILER_SPARSE_DENSE_H_
+
+#include <tvm/ir/module.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief The sparse_dense statistics of a relay IRModule
+ *
+ */
+struct SparseDenseStats {
+    // the number of nn.sparse_dense ops
+    int sparse_denses{0};
+    // the number of nn.dense ops
+    int denses{0};
+    // the number of the non-zero blocks of all the BSR weights
+    int64_t nonzero_blocks{0};
+    // the number of all the blocks of the BSR weights, zero or not
+    int64_t total_blocks{0};
+};
+
+/**
+ * @brief The row block sizes tried from the largest when `BuildOptions::sparse_block_size` is 0
+ *
+ * @return const std::vector<int>&
+ */
+const std::vector<int>& get_default_sparse_block_sizes();
+
+/**
+ * @brief Get the ratio of the all-zero blocks of a 2-D float32 weight split into (block_rows, 1) blocks
+ *
+ * @param weight the [units, input] weight of nn.dense
+ * @param block_rows the row block size, it must divide the units
+ * @return double the block sparsity in [0, 1]
+ */
+double get_block_sparsity(const tvm::runtime::NDArray& weight, int block_rows);
+
+/**
+ * @brief Convert the nn.dense ops with sparse constant weights to nn.sparse_dense with BSR weights.
+ * The weights are folded to constants first. A weight is converted if its block sparsity reaches
+ * `options.sparse_threshold`. The block size is `options.sparse_block_size`, or the largest default block size
+ * which reaches the threshold, since larger blocks vectorize better
+ *
+ * @param module input/output parameter. the relay IRModule
+ * @param options the build options, nothing is done if `options.sparse_threshold` is not positive
+ * @return Status
+ */
+Status convert_sparse_dense(tvm::IRModule& module, const BuildOptions& options);
+
+/**
+ * @brief Count the nn.sparse_dense and nn.dense ops in the IRModule
+ *
+ * @param module the relay IRModule
+ * @param stats output parameter. the sparse_dense statistics
+ * @return Status
+ */
+Status count_sparse_denses(const tvm::IRModule& module, SparseDenseStats& stats);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
@@ -0,0 +1,397 @@
+#include "te_kernels.h"
+
+#include <tvm/ir/op.h>
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/te/operation.h>
+#include <tvm/tir/op.h>
+#include <tvm/topi/nn.h>
+
+#include <atomic>
+#include <unordered_set>
+#include <vector>
+
+#include "compiler/layout_transform.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+constexpr const char* kDenseTag = "dense_blocked";
+constexpr const char* kDensePackTag = "dense_blocked_pack";
+constexpr const char* kConv2dTag = "conv2d_3x3_direct";
+constexpr const char* kConv2dPackTag = "conv2d_3x3_direct_pack";
+
+// whether the lower call hook adds the hand-scheduled kernels
+std::atomic<bool> g_te_kernels_enabled{false};
+
+bool get_const_int(const tvm::PrimExpr& expr, int64_t& value) {
+    const auto* imm = expr.as<tvm::IntImmNode>();
+    if (!imm) {
+        return false;
+    }
+    value = imm->value;
+    return true;
+}
+
+bool is_float32_static(const tvm::te::Tensor& tensor, size_t ndim) {
+    if (tensor->dtype != tvm::DataType::Float(32) || tensor->shape.size() != ndim) {
+        return false;
+    }
+
+    int64_t dim = 0;
+    for (const auto& expr : tensor->shape) {
+        if (!get_const_int(expr, dim)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// the largest block size which is not greater than `block` and divides `extent`
+int get_divisible_block(int64_t extent, int block) {
+    for (int bn = block; bn > 1; --bn) {
+        if (extent % bn == 0) {
+            return bn;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Find the kernel and its weight packing in the fused function, the other compute ops are inlined
+ *
+ */
+void find_kernel_tensors(tvm::te::Schedule& s, const tvm::te::Tensor& out, const std::string& kernel_tag,
+                         const std::string& pack_tag, tvm::te::Tensor& kernel, tvm::te::Tensor& packed) {
+    std::vector<tvm::te::Operation> stack{out->op};
+    std::unordered_set<const tvm::runtime::Object*> visited;
+    while (!stack.empty()) {
+        tvm::te::Operation op = stack.back();
+        stack.pop_back();
+        const auto* compute = op.as<tvm::te::ComputeOpNode>();
+        if (!compute || !visited.insert(op.get()).second) {
+            continue;
+        }
+
+        if (compute->tag == kernel_tag) {
+            kernel = op.output(0);
+        } else if (compute->tag == pack_tag) {
+            packed = op.output(0);
+        } else if (!op.same_as(out->op)) {
+            // e.g. the padding and the broadcast of the bias
+            s[op].compute_inline();
+        }
+
+        for (const auto& input : compute->InputTensors()) {
+            stack.emplace_back(input->op);
+        }
+    }
+}
+
+/**
+ * @brief Get the symmetric padding of nn.conv2d
+ *
+ * @return true
+ * @return false if the padding is not symmetric or not static
+ */
+bool get_symmetric_padding(const tvm::runtime::Array<tvm::PrimExpr>& padding, int64_t& pad_h, int64_t& pad_w) {
+    std::vector<int64_t> pads;
+    for (const auto& expr : padding) {
+        int64_t pad = 0;
+        if (!get_const_int(expr, pad)) {
+            return false;
+        }
+        pads.emplace_back(pad);
+    }
+
+    if (pads.size() == 1) {
+        pad_h = pad_w = pads[0];
+        return true;
+    }
+    if (pads.size() == 2) {
+        pad_h = pads[0];
+        pad_w = pads[1];
+        return true;
+    }
+    // top, left, bottom, right
+    if (pads.size() == 4 && pads[0] == pads[2] && pads[1] == pads[3]) {
+        pad_h = pads[0];
+        pad_w = pads[1];
+        return true;
+    }
+    return false;
+}
+
+bool is_all_ones(const tvm::runtime::Array<tvm::PrimExpr>& values) {
+    for (const auto& expr : values) {
+        int64_t value = 0;
+        if (!get_const_int(expr, value) || value != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool is_float32_out_dtype(const tvm::DataType& out_dtype) {
+    return out_dtype.is_void() || out_dtype == tvm::DataType::Float(32);
+}
+
+void add_dense_implementation(const tvm::relay::Call& call, const tvm::runtime::Array<tvm::te::Tensor>& inputs,
+                              int lanes, tvm::relay::OpStrategy& strategy) {
+    const auto* attrs = call->attrs.as<tvm::relay::DenseAttrs>();
+    if (!attrs || !is_float32_out_dtype(attrs->out_dtype) || inputs.size() != 2 ||
+        !is_float32_static(inputs[0], 2) || !is_float32_static(inputs[1], 2)) {
+        return;
+    }
+
+    int64_t m = 0;
+    int64_t n = 0;
+    get_const_int(inputs[0]->shape[0], m);
+    get_const_int(inputs[1]->shape[0], n);
+
+    DenseBlocking blocking;
+    if (n % (2 * lanes) == 0) {
+        blocking.nb = 2 * lanes;
+    } else if (n % lanes == 0) {
+        blocking.nb = lanes;
+    } else {
+        return;
+    }
+    blocking.mb = get_divisible_block(m, 4);
+
+    tvm::relay::FTVMCompute fcompute = [blocking](const tvm::Attrs& attrs,
+                                                  const tvm::runtime::Array<tvm::te::Tensor>& inputs,
+                                                  const tvm::Type& out_type) -> tvm::runtime::Array<tvm::te::Tensor> {
+        return {dense_blocked(inputs[0], inputs[1], blocking)};
+    };
+    tvm::relay::FTVMSchedule fschedule = [blocking](const tvm::Attrs& attrs,
+                                                    const tvm::runtime::Array<tvm::te::Tensor>& outs,
+                                                    const tvm::Target& target) {
+        return schedule_dense_blocked(outs, blocking);
+    };
+    strategy.AddImplementation(fcompute, fschedule, "dense_blocked.te_kernels", kTeKernelPriority);
+}
+
+void add_conv2d_implementation(const tvm::relay::Call& call, const tvm::runtime::Array<tvm::te::Tensor>& inputs,
+                               int lanes, tvm::relay::OpStrategy& strategy) {
+    const auto* attrs = call->attrs.as<tvm::relay::Conv2DAttrs>();
+    if (!attrs || attrs->data_layout != "NCHW" || attrs->kernel_layout != "OIHW" || attrs->groups != 1 ||
+        !is_float32_out_dtype(attrs->out_dtype) || !is_all_ones(attrs->strides) || !is_all_ones(attrs->dilation) ||
+        inputs.size() != 2 || !is_float32_static(inputs[0], 4) || !is_float32_static(inputs[1], 4)) {
+        return;
+    }
+
+    int64_t out_channels = 0;
+    int64_t kernel_h = 0;
+    int64_t kernel_w = 0;
+    int64_t width = 0;
+    get_const_int(inputs[1]->shape[0], out_channels);
+    get_const_int(inputs[1]->shape[2], kernel_h);
+    get_const_int(inputs[1]->shape[3], kernel_w);
+    get_const_int(inputs[0]->shape[3], width);
+
+    int64_t pad_h = 0;
+    int64_t pad_w = 0;
+    if (kernel_h != 3 || kernel_w != 3 || !get_symmetric_padding(attrs->padding, pad_h, pad_w)) {
+        return;
+    }
+
+    Conv2dBlocking blocking;
+    blocking.ob = get_divisible_block(out_channels, 4);
+    blocking.vw = get_divisible_block(width + 2 * pad_w - 2, lanes);
+
+    int pad_h_value = static_cast<int>(pad_h);
+    int pad_w_value = static_cast<int>(pad_w);
+    tvm::relay::FTVMCompute fcompute = [blocking, pad_h_value, pad_w_value](
+                                           const tvm::Attrs& attrs, const tvm::runtime::Array<tvm::te::Tensor>& inputs,
+                                           const tvm::Type& out_type) -> tvm::runtime::Array<tvm::te::Tensor> {
+        return {conv2d_3x3_direct(inputs[0], inputs[1], pad_h_value, pad_w_value, blocking)};
+    };
+    tvm::relay::FTVMSchedule fschedule = [blocking](const tvm::Attrs& attrs,
+                                                    const tvm::runtime::Array<tvm::te::Tensor>& outs,
+                                                    const tvm::Target& target) {
+        return schedule_conv2d_3x3_direct(outs, blocking);
+    };
+    strategy.AddImplementation(fcompute, fschedule, "conv2d_3x3_direct.te_kernels", kTeKernelPriority);
+}
+
+}    // namespace
+
+tvm::te::Tensor dense_blocked(const tvm::te::Tensor& data, const tvm::te::Tensor& weight,
+                              const DenseBlocking& blocking) {
+    tvm::PrimExpr m = data->shape[0];
+    tvm::PrimExpr k = data->shape[1];
+    tvm::PrimExpr n = weight->shape[0];
+    int nb = blocking.nb;
+
+    // the nb columns of a tile are contiguous in the packed weight
+    tvm::te::Tensor packed = tvm::te::compute(
+        {tvm::indexdiv(n, nb), k, nb},
+        [&](const tvm::runtime::Array<tvm::tir::Var>& i) { return weight(i[0] * nb + i[2], i[1]); },
+        "packed_weight", kDensePackTag);
+
+    tvm::te::IterVar rk = tvm::te::reduce_axis(tvm::Range(0, k), "k");
+    return tvm::te::compute(
+        {m, n},
+        [&](const tvm::runtime::Array<tvm::tir::Var>& i) {
+            return tvm::sum(data(i[0], rk->var) * packed(tvm::indexdiv(i[1], nb), rk->var, tvm::indexmod(i[1], nb)),
+                            {rk});
+        },
+        "dense_blocked", kDenseTag);
+}
+
+tvm::te::Schedule schedule_dense_blocked(const tvm::runtime::Array<tvm::te::Tensor>& outs,
+                                         const DenseBlocking& blocking) {
+    tvm::te::Tensor out = outs[0];
+    tvm::te::Schedule s = tvm::te::create_schedule({out->op});
+
+    tvm::te::Tensor dense;
+    tvm::te::Tensor packed;
+    find_kernel_tensors(s, out, kDenseTag, kDensePackTag, dense, packed);
+    if (!dense.defined()) {
+        return s;
+    }
+
+    if (packed.defined()) {
+        const auto* pack_op = packed->op.as<tvm::te::ComputeOpNode>();
+        s[packed->op].parallel(pack_op->axis[0]);
+        s[packed->op].vectorize(pack_op->axis[2]);
+    }
+
+    // accumulate in a local buffer if no injective op follows
+    tvm::te::Tensor acc = dense->op.same_as(out->op) ? s.cache_write(dense, "global") : dense;
+
+    const auto* out_op = out->op.as<tvm::te::ComputeOpNode>();
+    if (out_op->axis.size() != 2) {
+        // e.g. a reshape follows, the dense is computed at the root
+        const auto* acc_op = acc->op.as<tvm::te::ComputeOpNode>();
+        s[acc->op].parallel(acc_op->axis[0]);
+        return s;
+    }
+
+    tvm::te::IterVar io, jo, ii, ji, tile;
+    s[out->op].tile(out_op->axis[0], out_op->axis[1], blocking.mb, blocking.nb, &io, &jo, &ii, &ji);
+    s[out->op].fuse(io, jo, &tile);
+    s[out->op].parallel(tile);
+    s[out->op].vectorize(ji);
+    s[acc->op].compute_at(s[out->op], tile);
+
+    // the (mb, nb) tile stays in registers over the reduction
+    const auto* acc_op = acc->op.as<tvm::te::ComputeOpNode>();
+    tvm::te::IterVar ko, ki;
+    s[acc->op].split(acc_op->reduce_axis[0], blocking.kb, &ko, &ki);
+    s[acc->op].reorder({ko, ki, acc_op->axis[0], acc_op->axis[1]});
+    s[acc->op].unroll(ki);
+    s[acc->op].unroll(acc_op->axis[0]);
+    s[acc->op].vectorize(acc_op->axis[1]);
+
+    return s;
+}
+
+tvm::te::Tensor conv2d_3x3_direct(const tvm::te::Tensor& data, const tvm::te::Tensor& weight, int pad_h, int pad_w,
+                                  const Conv2dBlocking& blocking) {
+    tvm::PrimExpr batch = data->shape[0];
+    tvm::PrimExpr in_channels = data->shape[1];
+    tvm::PrimExpr out_channels = weight->shape[0];
+    tvm::PrimExpr out_h = data->shape[2] + 2 * pad_h - 2;
+    tvm::PrimExpr out_w = data->shape[3] + 2 * pad_w - 2;
+    int ob = blocking.ob;
+
+    tvm::te::Tensor padded = data;
+    if (pad_h > 0 || pad_w > 0) {
+        tvm::runtime::Array<tvm::PrimExpr> pads{0, 0, pad_h, pad_w};
+        padded = tvm::topi::pad(data, pads, pads, tvm::tir::make_const(tvm::DataType::Float(32), 0), "conv2d_pad");
+    }
+
+    // the ob output channels of a tile are contiguous in the packed weight
+    tvm::te::Tensor packed = tvm::te::compute(
+        {tvm::indexdiv(out_channels, ob), in_channels, 3, 3, ob},
+        [&](const tvm::runtime::Array<tvm::tir::Var>& i) { return weight(i[0] * ob + i[4], i[1], i[2], i[3]); },
+        "packed_kernel", kConv2dPackTag);
+
+    tvm::te::IterVar rc = tvm::te::reduce_axis(tvm::Range(0, in_channels), "rc");
+    tvm::te::IterVar rh = tvm::te::reduce_axis(tvm::Range(0, 3), "rh");
+    tvm::te::IterVar rw = tvm::te::reduce_axis(tvm::Range(0, 3), "rw");
+    return tvm::te::compute(
+        {batch, out_channels, out_h, out_w},
+        [&](const tvm::runtime::Array<tvm::tir::Var>& i) {
+            return tvm::sum(padded(i[0], rc->var, i[2] + rh->var, i[3] + rw->var) *
+                                packed(tvm::indexdiv(i[1], ob), rc->var, rh->var, rw->var, tvm::indexmod(i[1], ob)),
+                            {rc, rh, rw});
+        },
+        "conv2d_3x3_direct", kConv2dTag);
+}
+
+tvm::te::Schedule schedule_conv2d_3x3_direct(const tvm::runtime::Array<tvm::te::Tensor>& outs,
+                                             const Conv2dBlocking& blocking) {
+    tvm::te::Tensor out = outs[0];
+    tvm::te::Schedule s = tvm::te::create_schedule({out->op});
+
+    tvm::te::Tensor conv;
+    tvm::te::Tensor packed;
+    find_kernel_tensors(s, out, kConv2dTag, kConv2dPackTag, conv, packed);
+    if (!conv.defined()) {
+        return s;
+    }
+
+    if (packed.defined()) {
+        const auto* pack_op = packed->op.as<tvm::te::ComputeOpNode>();
+        s[packed->op].parallel(pack_op->axis[0]);
+        s[packed->op].vectorize(pack_op->axis[4]);
+    }
+
+    tvm::te::Tensor acc = conv->op.same_as(out->op) ? s.cache_write(conv, "global") : conv;
+
+    const auto* out_op = out->op.as<tvm::te::ComputeOpNode>();
+    if (out_op->axis.size() != 4) {
+        const auto* acc_op = acc->op.as<tvm::te::ComputeOpNode>();
+        s[acc->op].parallel(acc_op->axis[1]);
+        return s;
+    }
+
+    tvm::te::IterVar oo, oi, wo, wi, batch_channels, rows;
+    s[out->op].split(out_op->axis[1], blocking.ob, &oo, &oi);
+    s[out->op].split(out_op->axis[3], blocking.vw, &wo, &wi);
+    s[out->op].reorder({out_op->axis[0], oo, out_op->axis[2], wo, oi, wi});
+    s[out->op].fuse(out_op->axis[0], oo, &batch_channels);
+    s[out->op].fuse(batch_channels, out_op->axis[2], &rows);
+    s[out->op].parallel(rows);
+    s[out->op].vectorize(wi);
+    s[acc->op].compute_at(s[out->op], wo);
+
+    // the (ob, vw) tile stays in registers over the input channels and the 3x3 window
+    const auto* acc_op = acc->op.as<tvm::te::ComputeOpNode>();
+    s[acc->op].reorder({acc_op->axis[0], acc_op->axis[2], acc_op->reduce_axis[0], acc_op->reduce_axis[1],
+                        acc_op->reduce_axis[2], acc_op->axis[1], acc_op->axis[3]});
+    s[acc->op].unroll(acc_op->reduce_axis[1]);
+    s[acc->op].unroll(acc_op->reduce_axis[2]);
+    s[acc->op].unroll(acc_op->axis[1]);
+    s[acc->op].vectorize(acc_op->axis[3]);
+
+    return s;
+}
+
+void set_te_kernel_config(const BuildOptions& options) { g_te_kernels_enabled = options.te_kernels; }
+
+void add_te_kernel_implementations(const tvm::relay::Call& call, const tvm::runtime::Array<tvm::te::Tensor>& inputs,
+                                   const tvm::Target& target, tvm::relay::OpStrategy& strategy) {
+    if (!g_te_kernels_enabled) {
+        return;
+    }
+
+    static const tvm::Op& dense_op = tvm::Op::Get("nn.dense");
+    static const tvm::Op& conv2d_op = tvm::Op::Get("nn.conv2d");
+
+    // the floats of a vector register
+    int lanes = get_nchwc_block(BuildOptions(), target);
+    if (call->op.same_as(dense_op)) {
+        add_dense_implementation(call, inputs, lanes, strategy);
+    } else if (call->op.same_as(conv2d_op)) {
+        add_conv2d_implementation(call, inputs, lanes, strategy);
+    }
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
@@ -0,0 +1,114 @@
+#ifndef _H_TVM_CPP_COMPILER_TE_KERNELS_H_
+#define _H_TVM_CPP_COMPILER_TE_KERNELS_H_
+
+#include <tvm/relay/expr.h>
+#include <tvm/relay/op_strategy.h>
+#include <tvm/target/target.h>
+#include <tvm/te/schedule.h>
+#include <tvm/te/tensor.h>
+
+#include "compiler/build_options.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief The plevel of the hand-scheduled kernels, above the default x86 schedules and below the CBLAS ones
+ *
+ */
+constexpr int kTeKernelPriority = 12;
+
+/**
+ * @brief The block sizes of the dense kernel
+ *
+ */
+struct DenseBlocking {
+    // the rows of the output tile, unrolled in the registers
+    int mb{4};
+    // the columns of the output tile, vectorized. the weight is packed to [n / nb, k, nb]
+    int nb{16};
+    // the reduction split
+    int kb{4};
+};
+
+/**
+ * @brief The block sizes of the direct 3x3 convolution kernel
+ *
+ */
+struct Conv2dBlocking {
+    // the output channels of the tile, unrolled in the registers. the weight is packed to [o / ob, c, 3, 3, ob]
+    int ob{4};
+    // the output columns of the tile, vectorized
+    int vw{8};
+};
+
+/**
+ * @brief Register-blocked dense, out[m, n] = sum_k data[m, k] * weight[n, k]
+ *
+ * @param data the [m, k] float32 data
+ * @param weight the [n, k] float32 weight, n must be a multiple of `blocking.nb`
+ * @param blocking the block sizes
+ * @return tvm::te::Tensor the [m, n] output
+ */
+tvm::te::Tensor dense_blocked(const tvm::te::Tensor& data, const tvm::te::Tensor& weight,
+                              const DenseBlocking& blocking);
+
+/**
+ * @brief Schedule the dense_blocked kernel and the injective ops fused after it: tiled by (mb, nb), the tiles run in
+ * parallel, the inner tile is unrolled and vectorized
+ *
+ * @param outs the outputs of the fused function
+ * @param blocking the block sizes used by `dense_blocked`
+ * @return tvm::te::Schedule
+ */
+tvm::te::Schedule schedule_dense_blocked(const tvm::runtime::Array<tvm::te::Tensor>& outs,
+                                         const DenseBlocking& blocking);
+
+/**
+ * @brief Direct 3x3 NCHW convolution with stride 1, dilation 1 and symmetric padding
+ *
+ * @param data the [n, c, h, w] float32 data
+ * @param weight the [o, c, 3, 3] float32 weight, o must be a multiple of `blocking.ob`
+ * @param pad_h the top and bottom padding
+ * @param pad_w the left and right padding
+ * @param blocking the block sizes
+ * @return tvm::te::Tensor the [n, o, h + 2 * pad_h - 2, w + 2 * pad_w - 2] output
+ */
+tvm::te::Tensor conv2d_3x3_direct(const tvm::te::Tensor& data, const tvm::te::Tensor& weight, int pad_h, int pad_w,
+                                  const Conv2dBlocking& blocking);
+
+/**
+ * @brief Schedule the conv2d_3x3_direct kernel and the injective ops fused after it: the (ob, vw) output tile is
+ * accumulated in registers over the input channels and the 3x3 window, the rows run in parallel
+ *
+ * @param outs the outputs of the fused function
+ * @param blocking the block sizes used by `conv2d_3x3_direct`
+ * @return tvm::te::Schedule
+ */
+tvm::te::Schedule schedule_conv2d_3x3_direct(const tvm::runtime::Array<tvm::te::Tensor>& outs,
+                                             const Conv2dBlocking& blocking);
+
+/**
+ * @brief Enable or disable the hand-scheduled kernels for the lower call hook of the following builds
+ *
+ * @param options the build options
+ */
+void set_te_kernel_config(const BuildOptions& options);
+
+/**
+ * @brief Add the hand-scheduled implementations to the op strategy of the call if they are enabled and support the
+ * concrete shapes and attributes: nn.dense with float32 static shapes, and nn.conv2d NCHW/OIHW 3x3 with stride 1,
+ * dilation 1, one group and symmetric padding
+ *
+ * @param call the relay call
+ * @param inputs the te input tensors of the call
+ * @param target the compilation target, the vector width decides the block sizes
+ * @param strategy input/output parameter. the op strategy
+ */
+void add_te_kernel_implementations(const tvm::relay::Call& call, const tvm::runtime::Array<tvm::te::Tensor>& inputs,
+                                   const tvm::Target& target, tvm::relay::OpStrategy& strategy);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
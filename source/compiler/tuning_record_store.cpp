@@ -0,0 +1,202 @@
+#include "tuning_record_store.h"
+
+#include <tvm/meta_schedule/extracted_task.h>
+#include <tvm/node/serialization.h>
+#include <tvm/runtime/registry.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+#include <unordered_set>
+
+#include "compiler/blas_offload.h"
+#include "compiler/meta_schedule_tuner.h"
+#include "compiler/model_builder.h"
+#include "utils/utils.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+const char* const kWorkloadFile = "database_workload.json";
+const char* const kTuningRecordFile = "database_tuning_record.json";
+
+// the deduplication key of a tuning record, the workload hash and the serialized trace, latency and target
+std::string get_record_key(const tvm::meta_schedule::TuningRecord& record) {
+    std::ostringstream oss;
+    oss << record->workload->shash << "|" << tvm::SaveJSON(record->AsJSON());
+    return oss.str();
+}
+
+// merge the records of a target directory into the destination target directory
+Status merge_target_database(const std::filesystem::path& src_dir, const std::filesystem::path& dst_dir,
+                             MergeStats& stats) {
+    tvm::meta_schedule::Database src;
+    Status status = open_meta_schedule_database(src_dir.string(), false, src);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    tvm::meta_schedule::Database dst;
+    status = open_meta_schedule_database(dst_dir.string(), true, dst);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    try {
+        std::unordered_set<std::string> existing_keys;
+        for (const auto& record : dst->GetAllTuningRecords()) {
+            existing_keys.insert(get_record_key(record));
+        }
+
+        for (const auto& record : src->GetAllTuningRecords()) {
+            if (!record->run_secs.defined() || record->run_secs.value().empty()) {
+                ++stats.skipped_records;
+                continue;
+            }
+
+            std::string key = get_record_key(record);
+            if (existing_keys.count(key)) {
+                ++stats.skipped_records;
+                continue;
+            }
+
+            // the workload index differs between the databases, commit the workload to the destination first
+            const tvm::IRModule& mod = record->workload->mod;
+            if (!dst->HasWorkload(mod)) {
+                ++stats.new_workloads;
+            }
+            tvm::meta_schedule::Workload workload = dst->CommitWorkload(mod);
+
+            dst->CommitTuningRecord(tvm::meta_schedule::TuningRecord(record->trace, workload, record->run_secs,
+                                                                     record->target, record->args_info));
+            existing_keys.insert(key);
+            ++stats.new_records;
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    ++stats.targets;
+    return Status::ok();
+}
+
+}    // namespace
+
+std::string get_target_key(const tvm::Target& target) {
+    std::ostringstream oss;
+    oss << target->kind->name << "_" << std::hex << std::setw(16) << std::setfill('0')
+        << tvm_cpp::utils::fnv1a_hash(target->str());
+    return oss.str();
+}
+
+Status open_tuning_database(const BuildOptions& options, const tvm::Target& target, bool create,
+                            tvm::runtime::Optional<tvm::meta_schedule::Database>& database) {
+    database = tvm::runtime::NullOpt;
+
+    std::filesystem::path dir;
+    if (!options.meta_schedule_dir.empty()) {
+        dir = options.meta_schedule_dir;
+    } else if (!options.tuning_store_dir.empty()) {
+        dir = std::filesystem::path(options.tuning_store_dir) / get_target_key(target);
+    } else {
+        return Status::ok();
+    }
+
+    // the store has no record of the target yet
+    if (!create && !std::filesystem::exists(dir / kWorkloadFile)) {
+        return Status::ok();
+    }
+
+    tvm::meta_schedule::Database json_database;
+    Status status = open_meta_schedule_database(dir.string(), create, json_database);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    database = json_database;
+    return Status::ok();
+}
+
+Status query_tuning_coverage(const tvm::IRModule& module, const BuildOptions& options, TuningCoverage& coverage) {
+    tvm::Target target;
+    Status status = create_target(get_blas_target(options), target);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    // the extraction registers the lower call hook itself, the query needs no earlier build in the process
+    tvm::runtime::Array<tvm::meta_schedule::ExtractedTask> tasks;
+    status = extract_tuning_tasks(module, options, tasks);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    tvm::runtime::Optional<tvm::meta_schedule::Database> database;
+    status = open_tuning_database(options, target, false, database);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    coverage = TuningCoverage();
+    try {
+        for (const auto& task : tasks) {
+            ++coverage.total_tasks;
+            coverage.total_weight += task->weight;
+
+            bool covered = database.defined() &&
+                           database.value()
+                               ->QueryTuningRecord(task->dispatched[0], task->target, task->task_name)
+                               .defined();
+            if (covered) {
+                ++coverage.covered_tasks;
+                coverage.covered_weight += task->weight;
+            } else {
+                coverage.uncovered_tasks.emplace_back(task->task_name);
+            }
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status merge_tuning_stores(const std::vector<std::string>& src_dirs, const std::string& dst_dir, MergeStats& stats) {
+    stats = MergeStats();
+
+    std::filesystem::path dst_path(dst_dir);
+    for (const auto& src_dir : src_dirs) {
+        std::filesystem::path src_path(src_dir);
+        if (!std::filesystem::is_directory(src_path)) {
+            std::ostringstream oss;
+            oss << "Tuning record store does NOT exist: " << src_dir;
+            return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+        }
+
+        std::error_code ec;
+        if (std::filesystem::equivalent(src_path, dst_path, ec)) {
+            continue;
+        }
+
+        // each sub directory holds the records of a target
+        for (const auto& entry : std::filesystem::directory_iterator(src_path)) {
+            if (!entry.is_directory() || !std::filesystem::exists(entry.path() / kWorkloadFile) ||
+                !std::filesystem::exists(entry.path() / kTuningRecordFile)) {
+                continue;
+            }
+
+            Status status = merge_target_database(entry.path(), dst_path / entry.path().filename(), stats);
+            if (!status.is_ok()) {
+                return status;
+            }
+        }
+    }
+
+    return Status::ok();
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
@@ -0,0 +1,97 @@
+#ifndef _H_TVM_CPP_COMPILER_TUNING_RECORD_STORE_H_
+#define _H_TVM_CPP_COMPILER_TUNING_RECORD_STORE_H_
+
+#include <tvm/ir/module.h>
+#include <tvm/meta_schedule/database.h>
+#include <tvm/runtime/container/optional.h>
+#include <tvm/target/target.h>
+
+#include <string>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief The coverage of the tuning tasks of a module by the existing tuning records
+ *
+ */
+struct TuningCoverage {
+    // the number of tasks extracted from the module
+    int total_tasks{0};
+    // the number of tasks which have a tuning record
+    int covered_tasks{0};
+    // the number of occurrences of all the tasks in the module
+    int total_weight{0};
+    // the number of occurrences of the covered tasks in the module
+    int covered_weight{0};
+    // the names of the tasks without tuning record
+    std::vector<std::string> uncovered_tasks;
+};
+
+/**
+ * @brief The statistics of merging tuning record stores
+ *
+ */
+struct MergeStats {
+    // the number of merged target directories
+    int targets{0};
+    // the number of workloads which are new in the destination store
+    int new_workloads{0};
+    // the number of records added to the destination store
+    int new_records{0};
+    // the number of records skipped because they exist in the destination store or failed
+    int skipped_records{0};
+};
+
+/**
+ * @brief Get the key of the target in the tuning record store. The key is stable across hosts, so the stores of
+ * different hosts can be merged. e.g. "llvm_5b1d3a0c7e4f2a91"
+ *
+ * @param target the compilation target
+ * @return std::string
+ */
+std::string get_target_key(const tvm::Target& target);
+
+/**
+ * @brief Open the tuning database of the build options. `options.meta_schedule_dir` is opened as is, otherwise the
+ * records of the target are in the sub directory `get_target_key(target)` of `options.tuning_store_dir`. The
+ * workloads are keyed by their structural hash, so identical fused workloads of different models share records
+ *
+ * @param options the build options
+ * @param target the compilation target
+ * @param create create the database if it is missing
+ * @param database output parameter. the database, NullOpt if no directory is set or the database is missing
+ * @return Status
+ */
+Status open_tuning_database(const BuildOptions& options, const tvm::Target& target, bool create,
+                            tvm::runtime::Optional<tvm::meta_schedule::Database>& database);
+
+/**
+ * @brief Query how many tuning tasks of the module are covered by the records in the database
+ *
+ * @param module the relay IRModule
+ * @param options the build options
+ * @param coverage output parameter. the coverage
+ * @return Status
+ */
+Status query_tuning_coverage(const tvm::IRModule& module, const BuildOptions& options, TuningCoverage& coverage);
+
+/**
+ * @brief Merge the tuning record stores of several hosts into the destination store. The records of each target
+ * directory are merged into the same target directory of the destination, duplicated and failed records are skipped
+ *
+ * @param src_dirs the source store directories
+ * @param dst_dir the destination store directory, created if it is missing
+ * @param stats output parameter. the merge statistics
+ * @return Status
+ */
+Status merge_tuning_stores(const std::vector<std::string>& src_dirs, const std::string& dst_dir, MergeStats& stats);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
@@ -0,0 +1,164 @@
+#include "vm_builder.h"
+
+#include <tvm/ir/transform.h>
+#include <tvm/meta_schedule/database.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/support/with.h>
+#include <tvm/target/target.h>
+
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+
+#include "compiler/blas_offload.h"
+#include "compiler/model_builder.h"
+#include "compiler/tuning_record_store.h"
+#include "utils/utils.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+namespace {
+
+// the allocator types of the virtual machine, see tvm/runtime/vm/memory_manager.h
+constexpr int kPooledAllocator = 2;
+
+}    // namespace
+
+Status build_vm_executable(const tvm::IRModule& module, const BuildOptions& options,
+                           tvm::runtime::Module& executable) {
+    // the VM compiler create function
+    const tvm::runtime::PackedFunc* vm_compiler_create = tvm::runtime::Registry::Get("relay._vm._VMCompiler");
+    if (!vm_compiler_create) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._vm._VMCompiler not found");
+    }
+
+    tvm::Target target;
+    auto status = create_target(get_blas_target(options), target);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    // the TE compiler requires the lower call hook to select the op implementations
+    status = prepare_lowering(options);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    tvm::IRModule optimized_module = module;
+    status = optimize_irmodule(optimized_module, options);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    // apply the tuning records of the target as the graph executor build does
+    tvm::runtime::Optional<tvm::meta_schedule::Database> database;
+    status = open_tuning_database(options, target, false, database);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    tvm::transform::PassContext pass_ctx = create_pass_context(options);
+    std::unique_ptr<tvm::With<tvm::meta_schedule::Database>> database_scope;
+    if (database) {
+        pass_ctx->config.Set("relay.backend.use_meta_schedule", tvm::Bool(true));
+        database_scope = std::make_unique<tvm::With<tvm::meta_schedule::Database>>(database.value());
+    }
+    tvm::With<tvm::transform::PassContext> scope(pass_ctx);
+
+    try {
+        tvm::runtime::Module vm_compiler = (*vm_compiler_create)();
+        tvm::runtime::PackedFunc lower = vm_compiler.GetFunction("lower");
+        tvm::runtime::PackedFunc codegen = vm_compiler.GetFunction("codegen");
+        tvm::runtime::PackedFunc get_executable = vm_compiler.GetFunction("get_executable");
+
+        const tvm::runtime::Array<tvm::Target> raw_targets{target};
+        lower(optimized_module, raw_targets);
+        codegen();
+        executable = get_executable();
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status save_vm_executable(const tvm::runtime::Module& executable, const std::string& code_path,
+                          const std::string& lib_path, const ExportOptions& export_options) {
+    std::string code;
+    tvm::runtime::Module lib;
+    try {
+        code = executable.GetFunction("save")().operator std::string();
+        lib = executable.GetFunction("get_lib")();
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    std::ofstream ofs(code_path, std::ios::binary);
+    if (!ofs) {
+        std::ostringstream oss;
+        oss << "Open the bytecode file failed: " << code_path;
+        return Status(StatusCode::RUNTIME_ERROR, oss.str());
+    }
+    ofs.write(code.data(), static_cast<std::streamsize>(code.size()));
+    ofs.close();
+
+    return export_library(lib, lib_path, export_options);
+}
+
+Status load_vm_executable(const std::string& code_path, const std::string& lib_path,
+                          tvm::runtime::Module& executable) {
+    // the executable load function
+    const tvm::runtime::PackedFunc* load_executable = tvm::runtime::Registry::Get("runtime.Load_Executable");
+    if (!load_executable) {
+        return Status(StatusCode::RUNTIME_ERROR, "runtime.Load_Executable not found");
+    }
+
+    if (!tvm_cpp::utils::file_exist(code_path)) {
+        std::ostringstream oss;
+        oss << "Bytecode file does NOT exist: " << code_path;
+        return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+    }
+
+    std::ifstream ifs(code_path, std::ios::binary);
+    std::string code((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+    tvm::runtime::Module lib;
+    auto status = load_library(lib_path, lib);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    try {
+        TVMByteArray code_bytes{code.data(), code.size()};
+        executable = (*load_executable)(code_bytes, lib);
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status create_virtual_machine(const tvm::runtime::Module& executable, tvm::runtime::Module& vm) {
+    // the virtual machine create function
+    const tvm::runtime::PackedFunc* vm_create = tvm::runtime::Registry::Get("runtime._VirtualMachine");
+    if (!vm_create) {
+        return Status(StatusCode::RUNTIME_ERROR, "runtime._VirtualMachine not found");
+    }
+
+    try {
+        vm = (*vm_create)(executable);
+
+        // the device type, device id and allocator type of each device
+        tvm::runtime::PackedFunc init = vm.GetFunction("init");
+        init(static_cast<int>(kDLCPU), 0, kPooledAllocator);
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+}    // namespace compiler
+}    // namespace tvm_cpp
@@ -0,0 +1,64 @@
+#ifndef _H_TVM_CPP_COMPILER_VM_BUILDER_H_
+#define _H_TVM_CPP_COMPILER_VM_BUILDER_H_
+
+#include <tvm/ir/module.h>
+#include <tvm/runtime/module.h>
+
+#include <string>
+
+#include "compiler/build_options.h"
+#include "compiler/library_exporter.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace compiler {
+
+/**
+ * @brief Compile the relay IRModule to a Relay VM executable. Unlike the graph executor, the inputs may have dynamic
+ * dims (relay Any), so a single executable runs all the batch sizes or sequence lengths
+ *
+ * @param module the relay IRModule
+ * @param options the build options, the executor kind is ignored
+ * @param executable output parameter. the VM executable
+ * @return Status
+ */
+Status build_vm_executable(const tvm::IRModule& module, const BuildOptions& options,
+                           tvm::runtime::Module& executable);
+
+/**
+ * @brief Save the VM executable, the bytecode to `code_path` and the kernels as a shared library to `lib_path`
+ *
+ * @param executable the VM executable
+ * @param code_path the bytecode file path, e.g. "model.ro"
+ * @param lib_path the shared library path, e.g. "model.so"
+ * @param export_options the options to export the shared library
+ * @return Status
+ */
+Status save_vm_executable(const tvm::runtime::Module& executable, const std::string& code_path,
+                          const std::string& lib_path, const ExportOptions& export_options = ExportOptions());
+
+/**
+ * @brief Load the VM executable saved by `save_vm_executable`
+ *
+ * @param code_path the bytecode file path
+ * @param lib_path the shared library path
+ * @param executable output parameter. the VM executable
+ * @return Status
+ */
+Status load_vm_executable(const std::string& code_path, const std::string& lib_path,
+                          tvm::runtime::Module& executable);
+
+/**
+ * @brief Create a virtual machine on CPU with the pooled allocator. Run it by
+ * `set_input("main", inputs...)` and `invoke("main")`
+ *
+ * @param executable the VM executable
+ * @param vm output parameter. the virtual machine module
+ * @return Status
+ */
+Status create_virtual_machine(const tvm::runtime::Module& executable, tvm::runtime::Module& vm);
+
+}    // namespace compiler
+}    // namespace tvm_cpp
+
+#endif
@@ -75,7 +75,10 @@ Status ConvParser::parse_op(const onnx::NodeProto& proto_node,
 
     std::vector<int64_t> weight_shape;
     tvm::DataType dtype;
-    tvm_cpp::relay_utils::infer_relay_shape_dtype(weight_iter->second, weight_shape, dtype);
+    auto shape_status = tvm_cpp::relay_utils::infer_relay_shape_dtype(weight_iter->second, weight_shape, dtype);
+    if (!shape_status.is_ok()) {
+        return shape_status;
+    }
     if (weight_shape.size() < 3) {
         return Status(StatusCode::INVALID_MODEL, "Invalid weight shape");
     }
@@ -89,7 +89,11 @@ Status GemmParser::parse_op(const onnx::NodeProto& proto_node,
     // get the matrix B shape
     std::vector<int64_t> matrixB_shape;
     tvm::DataType matrixB_dtype;
-    tvm_cpp::relay_utils::infer_relay_shape_dtype(inputB_iter->second, matrixB_shape, matrixB_dtype);
+    auto shape_status =
+        tvm_cpp::relay_utils::infer_relay_shape_dtype(inputB_iter->second, matrixB_shape, matrixB_dtype);
+    if (!shape_status.is_ok()) {
+        return shape_status;
+    }
     int channels = transB ? matrixB_shape[0] : matrixB_shape[1];
 
     tvm::runtime::Array<tvm::Integer> axes({1, 0});
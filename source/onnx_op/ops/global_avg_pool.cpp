@@ -42,7 +42,10 @@ Status GlobalAveragePoolParser::parse_op(const onnx::NodeProto& proto_node,
 
     std::vector<int64_t> input_shape;
     tvm::DataType input_dtype;
-    tvm_cpp::relay_utils::infer_relay_shape_dtype(input_iter->second, input_shape, input_dtype);
+    auto shape_status = tvm_cpp::relay_utils::infer_relay_shape_dtype(input_iter->second, input_shape, input_dtype);
+    if (!shape_status.is_ok()) {
+        return shape_status;
+    }
 
     tvm::relay::Expr result_expr;
     int input_rank = (int)input_shape.size();
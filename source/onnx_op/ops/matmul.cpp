@@ -99,12 +99,19 @@ Status MatMulParser::parse_method_1(const onnx::NodeProto& proto_node,
     // get the matrix A shape
     std::vector<int64_t> matrixA_shape;
     tvm::DataType matrixA_dtype;
-    tvm_cpp::relay_utils::infer_relay_shape_dtype(matrixA_iter->second, matrixA_shape, matrixA_dtype);
+    auto shape_status =
+        tvm_cpp::relay_utils::infer_relay_shape_dtype(matrixA_iter->second, matrixA_shape, matrixA_dtype);
+    if (!shape_status.is_ok()) {
+        return shape_status;
+    }
 
     // get the matrix B shape
     std::vector<int64_t> matrixB_shape;
     tvm::DataType matrixB_dtype;
-    tvm_cpp::relay_utils::infer_relay_shape_dtype(matrixB_iter->second, matrixB_shape, matrixB_dtype);
+    shape_status = tvm_cpp::relay_utils::infer_relay_shape_dtype(matrixB_iter->second, matrixB_shape, matrixB_dtype);
+    if (!shape_status.is_ok()) {
+        return shape_status;
+    }
 
     if (matrixA_shape.size() > 2 || matrixB_shape.size() > 2) {
         std::vector<int64_t> output_batch;
@@ -305,12 +312,19 @@ Status MatMulParser::parse_method_2(const onnx::NodeProto& proto_node,
     // get the matrix A shape
     std::vector<int64_t> matrixA_shape;
     tvm::DataType matrixA_dtype;
-    tvm_cpp::relay_utils::infer_relay_shape_dtype(matrixA_iter->second, matrixA_shape, matrixA_dtype);
+    auto shape_status =
+        tvm_cpp::relay_utils::infer_relay_shape_dtype(matrixA_iter->second, matrixA_shape, matrixA_dtype);
+    if (!shape_status.is_ok()) {
+        return shape_status;
+    }
 
     // get the matrix B shape
     std::vector<int64_t> matrixB_shape;
     tvm::DataType matrixB_dtype;
-    tvm_cpp::relay_utils::infer_relay_shape_dtype(matrixB_iter->second, matrixB_shape, matrixB_dtype);
+    shape_status = tvm_cpp::relay_utils::infer_relay_shape_dtype(matrixB_iter->second, matrixB_shape, matrixB_dtype);
+    if (!shape_status.is_ok()) {
+        return shape_status;
+    }
 
     tvm::relay::Expr result_expr;
     result_expr = (*matmul)(matrixA_iter->second, matrixB_iter->second, matrixB_shape[matrixB_shape.size() - 1],
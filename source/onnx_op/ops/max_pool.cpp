@@ -69,7 +69,10 @@ Status MaxPoolParser::parse_op(const onnx::NodeProto& proto_node,
 
     std::vector<int64_t> input_shape;
     tvm::DataType dtype;
-    tvm_cpp::relay_utils::infer_relay_shape_dtype(input_iter->second, input_shape, dtype);
+    auto shape_status = tvm_cpp::relay_utils::infer_relay_shape_dtype(input_iter->second, input_shape, dtype);
+    if (!shape_status.is_ok()) {
+        return shape_status;
+    }
 
     int dims = input_shape.size() - 2;
     if (dims != 2) {
@@ -62,7 +62,11 @@ Status ReshapeParser::parse_op(const onnx::NodeProto& proto_node,
 
     std::vector<int64_t> new_shape_shape;
     tvm::DataType new_shape_dtype;
-    tvm_cpp::relay_utils::infer_relay_shape_dtype(new_shape_iter->second, new_shape_shape, new_shape_dtype);
+    auto shape_status =
+        tvm_cpp::relay_utils::infer_relay_shape_dtype(new_shape_iter->second, new_shape_shape, new_shape_dtype);
+    if (!shape_status.is_ok()) {
+        return shape_status;
+    }
     int64_t scale_ele_nums = 1;
     for (auto& dim : new_shape_shape) {
         scale_ele_nums *= dim;
@@ -70,7 +70,10 @@ Status ResizeParser::parse_op(const onnx::NodeProto& proto_node,
     // get the input shape and data type
     std::vector<int64_t> input_shape;
     tvm::DataType input_dtype;
-    tvm_cpp::relay_utils::infer_relay_shape_dtype(input_iter->second, input_shape, input_dtype);
+    auto shape_status = tvm_cpp::relay_utils::infer_relay_shape_dtype(input_iter->second, input_shape, input_dtype);
+    if (!shape_status.is_ok()) {
+        return shape_status;
+    }
 
     // get the scale relay
     const std::string& scale_name = proto_node.input(2);
@@ -97,7 +100,10 @@ Status ResizeParser::parse_op(const onnx::NodeProto& proto_node,
 
         std::vector<int64_t> size_shape;
         tvm::DataType size_dtype;
-        tvm_cpp::relay_utils::infer_relay_shape_dtype(size_iter->second, size_shape, size_dtype);
+        auto shape_status = tvm_cpp::relay_utils::infer_relay_shape_dtype(size_iter->second, size_shape, size_dtype);
+        if (!shape_status.is_ok()) {
+            return shape_status;
+        }
 
         int64_t size_ele_nums = 1;
         for (auto& dim : size_shape) {
@@ -127,7 +133,10 @@ Status ResizeParser::parse_op(const onnx::NodeProto& proto_node,
     } else {
         std::vector<int64_t> scale_shape;
         tvm::DataType scale_dtype;
-        tvm_cpp::relay_utils::infer_relay_shape_dtype(scale_iter->second, scale_shape, scale_dtype);
+        shape_status = tvm_cpp::relay_utils::infer_relay_shape_dtype(scale_iter->second, scale_shape, scale_dtype);
+        if (!shape_status.is_ok()) {
+            return shape_status;
+        }
 
         int64_t scale_ele_nums = 1;
         for (auto& dim : scale_shape) {
@@ -68,7 +68,10 @@ Status SqueezeParser::parse_op(const onnx::NodeProto& proto_node,
 
         std::vector<int64_t> axes_shape;
         tvm::DataType axes_dtype;
-        tvm_cpp::relay_utils::infer_relay_shape_dtype(input1_iter->second, axes_shape, axes_dtype);
+        auto shape_status = tvm_cpp::relay_utils::infer_relay_shape_dtype(input1_iter->second, axes_shape, axes_dtype);
+        if (!shape_status.is_ok()) {
+            return shape_status;
+        }
 
         int64_t axes_ele_nums = 1;
         for (auto& dim : axes_shape) {
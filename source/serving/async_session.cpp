@@ -0,0 +1,286 @@
+#include "async_session.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include "serving/numa.h"
+
+namespace tvm_cpp {
+namespace serving {
+
+namespace {
+
+// the bounds of the queue time and the latency histograms in microseconds
+constexpr int64_t kMinLatencyBoundUs = 1;
+constexpr int64_t kMaxLatencyBoundUs = 10 * 1000 * 1000;
+
+int64_t elapsed_us(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+}    // namespace
+
+AsyncSession::AsyncSession(const AsyncOptions& options)
+    : m_options(options), m_queue(static_cast<size_t>(options.queue_capacity)) {}
+
+AsyncSession::~AsyncSession() { stop(); }
+
+Status AsyncSession::create(const ExecutorFactory& factory, const AsyncOptions& options,
+                            std::unique_ptr<AsyncSession>& session) {
+    if (options.workers < 1 || options.queue_capacity < 1 || options.spin_count < 0) {
+        return Status(StatusCode::INVALID_PARAM, "the async session requires workers and a queue capacity over 0");
+    }
+
+    std::vector<ThreadConfig> thread_configs;
+    auto status = split_thread_config(options.thread_config, options.workers, thread_configs);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    // the NUMA node of each worker is the node of its cores
+    std::vector<int> numa_nodes(options.workers, -1);
+    if (options.numa_local || options.numa_replicate_params) {
+        if (options.thread_config.cores.empty()) {
+            return Status(StatusCode::INVALID_PARAM, "the NUMA placement requires the cores of the thread config");
+        }
+
+        std::vector<NumaNode> nodes;
+        status = get_numa_nodes(nodes);
+        for (int i = 0; status.is_ok() && i < options.workers; ++i) {
+            status = find_numa_node(nodes, thread_configs[i].cores, numa_nodes[i]);
+        }
+        if (!status.is_ok()) {
+            return status;
+        }
+    }
+
+    std::unique_ptr<AsyncSession> result(new AsyncSession(options));
+    for (int i = 0; i < options.workers; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->factory = &factory;
+        if (options.numa_replicate_params) {
+            // one replica of the params per node, it is shared by the workers of the node
+            auto iter = std::find_if(result->m_replicas.begin(), result->m_replicas.end(),
+                                     [&](const auto& replica) { return replica->get_numa_node() == numa_nodes[i]; });
+            if (iter == result->m_replicas.end()) {
+                auto replica = std::make_unique<ExecutorFactory>();
+                status = factory.replicate_to_numa_node(numa_nodes[i], *replica);
+                if (!status.is_ok()) {
+                    return status;
+                }
+                iter = result->m_replicas.insert(result->m_replicas.end(), std::move(replica));
+            }
+            worker->factory = iter->get();
+        }
+        worker->thread_config = thread_configs[i];
+        worker->numa_node = options.numa_local ? numa_nodes[i] : -1;
+
+        worker->queue_time_us = Histogram::exponential(kMinLatencyBoundUs, kMaxLatencyBoundUs);
+        worker->latency_us = Histogram::exponential(kMinLatencyBoundUs, kMaxLatencyBoundUs);
+        result->m_workers.emplace_back(std::move(worker));
+    }
+
+    std::vector<std::future<Status>> started;
+    for (auto& worker : result->m_workers) {
+        started.emplace_back(worker->started.get_future());
+        worker->thread = std::thread(&AsyncSession::worker_loop, result.get(), std::ref(*worker));
+    }
+    for (auto& worker_started : started) {
+        status = worker_started.get();
+        if (!status.is_ok()) {
+            result->stop();
+            return status;
+        }
+    }
+
+    session = std::move(result);
+    return Status::ok();
+}
+
+Status AsyncSession::submit(const sample_utils::TensorMap& inputs, std::future<InferResult>& result) {
+    auto promise = std::make_shared<std::promise<InferResult>>();
+    std::future<InferResult> future = promise->get_future();
+    auto status = submit(inputs, [promise](InferResult&& value) { promise->set_value(std::move(value)); });
+    if (status.is_ok()) {
+        result = std::move(future);
+    }
+    return status;
+}
+
+Status AsyncSession::submit(const sample_utils::TensorMap& inputs, InferCallback callback) {
+    if (!callback) {
+        return Status(StatusCode::INVALID_PARAM, "the callback of the async request is empty");
+    }
+
+    // a worker keeps the inputs of its previous request bound, a missing input would run on them
+    for (const auto& info : get_inputs()) {
+        auto iter = inputs.find(info.name);
+        if (iter == inputs.end() || !iter->second.defined()) {
+            ++m_rejected;
+            return Status(StatusCode::INVALID_PARAM, "input not found: " + info.name);
+        }
+    }
+
+    // stop() waits for the submissions in flight before it drains the queue, so a request pushed after the check
+    // is either run or completed by the drain
+    ++m_submitting;
+    if (m_stopped) {
+        --m_submitting;
+        ++m_rejected;
+        return Status(StatusCode::RUNTIME_ERROR, "the async session is stopped");
+    }
+
+    auto request = std::make_unique<Request>();
+    request->inputs = inputs;
+    request->callback = std::move(callback);
+    request->submit_time = std::chrono::steady_clock::now();
+    if (!m_queue.try_push(std::move(request))) {
+        --m_submitting;
+        ++m_rejected;
+        return Status(StatusCode::RUNTIME_ERROR, "the request queue of the async session is full");
+    }
+    --m_submitting;
+    ++m_submitted;
+
+    // a worker parks after it publishes m_idle and rechecks m_pending, so either it sees this request or it is
+    // woken up here
+    ++m_pending;
+    if (m_idle > 0) {
+        std::lock_guard<std::mutex> lock(m_park_mutex);
+        m_park_cv.notify_one();
+    }
+
+    return Status::ok();
+}
+
+AsyncStats AsyncSession::get_stats() const {
+    AsyncStats stats;
+    stats.submitted = m_submitted;
+    stats.rejected = m_rejected;
+    stats.queue_time_us = Histogram::exponential(kMinLatencyBoundUs, kMaxLatencyBoundUs);
+    stats.latency_us = Histogram::exponential(kMinLatencyBoundUs, kMaxLatencyBoundUs);
+    for (const auto& worker : m_workers) {
+        std::lock_guard<std::mutex> lock(worker->stats_mutex);
+        stats.completed += worker->completed;
+        stats.queue_time_us.merge(worker->queue_time_us);
+        stats.latency_us.merge(worker->latency_us);
+    }
+    return stats;
+}
+
+void AsyncSession::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_park_mutex);
+        m_stopped = true;
+    }
+    m_park_cv.notify_all();
+
+    // the submissions which passed the stopped check finish their push before the queue is drained
+    while (m_submitting > 0) {
+        std::this_thread::yield();
+    }
+
+    for (auto& worker : m_workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+
+    // the requests which raced with the stop are completed with an error, so no callback is lost
+    std::unique_ptr<Request> request;
+    while (m_queue.try_pop(request)) {
+        --m_pending;
+        InferResult result;
+        result.status = Status(StatusCode::RUNTIME_ERROR, "the async session is stopped");
+        request->callback(std::move(result));
+    }
+}
+
+void AsyncSession::worker_loop(Worker& worker) {
+    // the memory policy is set first, so the TVM pool threads inherit it. the session is loaded by the worker, its
+    // workspace is allocated and touched under the policy of the worker. the TVM thread pool is thread local, it is
+    // configured before the first run
+    Status status = worker.numa_node >= 0 ? bind_thread_memory(worker.numa_node) : Status::ok();
+    if (status.is_ok()) {
+        status = apply_thread_config(worker.thread_config);
+    }
+    if (status.is_ok()) {
+        status = worker.session.load(*worker.factory);
+    }
+    worker.started.set_value(status);
+    if (!status.is_ok()) {
+        return;
+    }
+
+    std::unique_ptr<Request> request;
+    while (true) {
+        // poll the queue for a while before parking, a busy service does not pay the wake up
+        bool popped = false;
+        for (int i = 0; i <= m_options.spin_count && !popped; ++i) {
+            popped = m_queue.try_pop(request);
+            if (!popped && i < m_options.spin_count) {
+                std::this_thread::yield();
+            }
+        }
+
+        if (popped) {
+            --m_pending;
+            run_request(worker, *request);
+            request.reset();
+            continue;
+        }
+
+        if (m_stopped) {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(m_park_mutex);
+        ++m_idle;
+        m_park_cv.wait(lock, [this]() { return m_stopped || m_pending > 0; });
+        --m_idle;
+    }
+}
+
+void AsyncSession::run_request(Worker& worker, Request& request) {
+    auto start = std::chrono::steady_clock::now();
+    InferResult result;
+    // an exception must NOT escape the worker thread, the callback gets the error instead
+    try {
+        result.status = worker.session.set_inputs(request.inputs);
+        if (result.status.is_ok()) {
+            result.status = worker.session.run();
+        }
+
+        // the session outputs are overwritten by the next request of the worker
+        const auto& outputs = worker.session.get_outputs();
+        for (size_t i = 0; result.status.is_ok() && i < outputs.size(); ++i) {
+            tvm::runtime::NDArray output;
+            result.status = worker.session.get_output(static_cast<int>(i), output);
+            if (result.status.is_ok()) {
+                result.outputs.emplace_back(
+                    tvm::runtime::NDArray::Empty(outputs[i].shape, outputs[i].dtype, {kDLCPU, 0}));
+                result.outputs.back().CopyFrom(output);
+            }
+        }
+    } catch (const std::exception& e) {
+        result.status = Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+    if (!result.status.is_ok()) {
+        result.outputs.clear();
+    }
+    request.inputs.clear();
+
+    auto end = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(worker.stats_mutex);
+        ++worker.completed;
+        worker.queue_time_us.record(elapsed_us(request.submit_time, start));
+        worker.latency_us.record(elapsed_us(request.submit_time, end));
+    }
+
+    request.callback(std::move(result));
+}
+
+}    // namespace serving
+}    // namespace tvm_cpp
@@ -0,0 +1,190 @@
+#ifndef _H_TVM_CPP_SERVING_ASYNC_SESSION_H_
+#define _H_TVM_CPP_SERVING_ASYNC_SESSION_H_
+
+#include <tvm/runtime/ndarray.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "serving/executor_factory.h"
+#include "serving/histogram.h"
+#include "serving/inference_session.h"
+#include "serving/mpmc_queue.h"
+#include "serving/thread_config.h"
+#include "utils/sample_utils.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace serving {
+
+/**
+ * @brief The options of the async session
+ *
+ */
+struct AsyncOptions {
+    // the worker threads, each one runs its own inference session. the workers times the TVM runtime threads of a
+    // run should not exceed the cores
+    int workers{2};
+    // the max requests waiting in the queue, the later submissions are rejected
+    int queue_capacity{1024};
+    // the empty polls of the queue before an idle worker sleeps
+    int spin_count{1000};
+    // the threads and the cores of the session, they are split evenly among the workers, e.g. 2 workers on the
+    // cores 0-7 run on 0-3 and 4-7
+    ThreadConfig thread_config;
+    // allocate the workspace of each worker on the NUMA node of its cores, it requires the cores
+    bool numa_local{false};
+    // copy the params to each NUMA node of the workers, they are read locally at the cost of a copy per node
+    bool numa_replicate_params{false};
+};
+
+/**
+ * @brief The result of an async request
+ *
+ */
+struct InferResult {
+    Status status;
+    // the outputs in the order of the session outputs, they are owned by the result
+    std::vector<tvm::runtime::NDArray> outputs;
+};
+
+/**
+ * @brief The completion callback of an async request, it is called on a worker thread and must not block
+ *
+ */
+using InferCallback = std::function<void(InferResult&&)>;
+
+/**
+ * @brief The statistics of the async session since it is created
+ *
+ */
+struct AsyncStats {
+    int64_t submitted{0};
+    int64_t completed{0};
+    // the submissions rejected because the queue is full or the session is stopped
+    int64_t rejected{0};
+    // the time from the submission to the start of the run and to the completion in microseconds
+    Histogram queue_time_us;
+    Histogram latency_us;
+};
+
+/**
+ * @brief The asynchronous inference API over a fixed pool of workers. `submit` pushes the request to a lock-free
+ * queue and returns at once, so the caller threads, e.g. the network threads, never wait for the inference. The
+ * workers share the params by the executor factory
+ *
+ */
+class AsyncSession final {
+public:
+    AsyncSession(const AsyncSession&) = delete;
+    AsyncSession& operator=(const AsyncSession&) = delete;
+    ~AsyncSession();
+
+    /**
+     * @brief Create the session of each worker by the factory and start the workers
+     *
+     * @param factory the loaded executor factory
+     * @param options the async options
+     * @param session output parameter. the async session
+     * @return Status
+     */
+    static Status create(const ExecutorFactory& factory, const AsyncOptions& options,
+                         std::unique_ptr<AsyncSession>& session);
+
+    /**
+     * @brief Submit a request whose result is delivered by the future
+     *
+     * @param inputs the input tensors by name, every model input is required, they are kept alive until it is run
+     * @param result output parameter. the future of the result
+     * @return Status the rejection of the submission, the errors of the run are in the result
+     */
+    Status submit(const sample_utils::TensorMap& inputs, std::future<InferResult>& result);
+
+    /**
+     * @brief Submit a request whose result is delivered to the callback
+     *
+     * @param inputs the input tensors by name, every model input is required, they are kept alive until it is run
+     * @param callback the completion callback, it is not called if the submission is rejected
+     * @return Status the rejection of the submission, the errors of the run are in the result
+     */
+    Status submit(const sample_utils::TensorMap& inputs, InferCallback callback);
+
+    /**
+     * @brief The inputs of the model
+     *
+     */
+    const std::vector<TensorInfo>& get_inputs() const { return m_workers[0]->session.get_inputs(); }
+
+    /**
+     * @brief The outputs of the model
+     *
+     */
+    const std::vector<TensorInfo>& get_outputs() const { return m_workers[0]->session.get_outputs(); }
+
+    AsyncStats get_stats() const;
+
+    /**
+     * @brief Run the queued requests and stop the workers, the later submissions are rejected
+     *
+     */
+    void stop();
+
+private:
+    struct Request {
+        sample_utils::TensorMap inputs;
+        InferCallback callback;
+        std::chrono::steady_clock::time_point submit_time;
+    };
+
+    struct Worker {
+        // the factory of the session, the session is loaded on the worker thread
+        const ExecutorFactory* factory{nullptr};
+        InferenceSession session;
+        ThreadConfig thread_config;
+        int numa_node{-1};
+        // the result of applying the thread config on the worker thread
+        std::promise<Status> started;
+        std::thread thread;
+        // the statistics of the worker, the lock is only contended by `get_stats`
+        std::mutex stats_mutex;
+        int64_t completed{0};
+        Histogram queue_time_us;
+        Histogram latency_us;
+    };
+
+    explicit AsyncSession(const AsyncOptions& options);
+
+    void worker_loop(Worker& worker);
+    void run_request(Worker& worker, Request& request);
+
+    AsyncOptions m_options;
+    MpmcQueue<std::unique_ptr<Request>> m_queue;
+    // the replicas of the factory on the NUMA nodes of the workers
+    std::vector<std::unique_ptr<ExecutorFactory>> m_replicas;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    // the requests pushed and not popped yet, and the workers parked on the condition variable
+    std::atomic<int64_t> m_pending{0};
+    // the submissions between the stopped check and the push
+    std::atomic<int> m_submitting{0};
+    std::atomic<int> m_idle{0};
+    std::atomic<bool> m_stopped{false};
+    std::mutex m_park_mutex;
+    std::condition_variable m_park_cv;
+
+    std::atomic<int64_t> m_submitted{0};
+    std::atomic<int64_t> m_rejected{0};
+};
+
+}    // namespace serving
+}    // namespace tvm_cpp
+
+#endif
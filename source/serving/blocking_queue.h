@@ -0,0 +1,100 @@
+#ifndef _H_TVM_CPP_SERVING_BLOCKING_QUEUE_H_
+#define _H_TVM_CPP_SERVING_BLOCKING_QUEUE_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace tvm_cpp {
+namespace serving {
+
+/**
+ * @brief The bounded blocking queue between two threads. `push` waits while the queue is full, so a slow consumer
+ * holds back the producer instead of letting the queue grow, `pop` waits while it is empty. `close` wakes up both
+ * sides, the values queued before it are still popped
+ *
+ * @tparam T the value type, it must be movable
+ */
+template <typename T>
+class BlockingQueue final {
+public:
+    /**
+     * @brief Create the queue
+     *
+     * @param capacity the max values in the queue, at least 1
+     */
+    explicit BlockingQueue(size_t capacity) : m_capacity(capacity > 0 ? capacity : 1) {}
+
+    BlockingQueue(const BlockingQueue&) = delete;
+    BlockingQueue& operator=(const BlockingQueue&) = delete;
+
+    /**
+     * @brief Push the value, wait while the queue is full
+     *
+     * @return true
+     * @return false if the queue is closed, the value is not moved
+     */
+    bool push(T&& value) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_full.wait(lock, [this]() { return m_closed || m_values.size() < m_capacity; });
+        if (m_closed) {
+            return false;
+        }
+
+        m_values.emplace_back(std::move(value));
+        lock.unlock();
+        m_not_empty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Pop the oldest value, wait while the queue is empty
+     *
+     * @param value output parameter. the value
+     * @return true
+     * @return false if the queue is closed and empty
+     */
+    bool pop(T& value) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_empty.wait(lock, [this]() { return m_closed || !m_values.empty(); });
+        if (m_values.empty()) {
+            return false;
+        }
+
+        value = std::move(m_values.front());
+        m_values.pop_front();
+        lock.unlock();
+        m_not_full.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Close the queue, the later pushes fail and the pops fail once the queue is drained
+     *
+     */
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_not_full.notify_all();
+        m_not_empty.notify_all();
+    }
+
+    size_t capacity() const { return m_capacity; }
+
+private:
+    size_t m_capacity;
+    std::mutex m_mutex;
+    std::condition_variable m_not_full;
+    std::condition_variable m_not_empty;
+    std::deque<T> m_values;
+    bool m_closed{false};
+};
+
+}    // namespace serving
+}    // namespace tvm_cpp
+
+#endif
@@ -0,0 +1,310 @@
+#include "dynamic_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <sstream>
+#include <utility>
+
+namespace tvm_cpp {
+namespace serving {
+
+namespace {
+
+// the bounds of the queue time histogram in microseconds
+constexpr int64_t kMinQueueTimeBoundUs = 1;
+constexpr int64_t kMaxQueueTimeBoundUs = 10 * 1000 * 1000;
+
+/**
+ * @brief Get the tensor of a single sample, the dim 0 of the batched tensor is replaced by 1
+ *
+ */
+Status get_sample_info(const TensorInfo& info, int64_t batch_size, TensorInfo& sample) {
+    if (info.shape.empty() || info.shape[0] != batch_size) {
+        std::ostringstream oss;
+        oss << "the dim 0 of " << info.name << " is not the batch size " << batch_size;
+        return Status(StatusCode::INVALID_MODEL, oss.str());
+    }
+
+    sample = info;
+    sample.shape[0] = 1;
+    return Status::ok();
+}
+
+bool same_tensors(const std::vector<TensorInfo>& lhs, const std::vector<TensorInfo>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const TensorInfo& a, const TensorInfo& b) {
+        return a.name == b.name && a.shape == b.shape && a.dtype == b.dtype;
+    });
+}
+
+char* get_data(const tvm::runtime::NDArray& array) {
+    return static_cast<char*>(array->data) + array->byte_offset;
+}
+
+}    // namespace
+
+DynamicBatcher::~DynamicBatcher() { stop(); }
+
+Status DynamicBatcher::create(std::vector<std::unique_ptr<InferenceSession>> sessions, const BatcherOptions& options,
+                              std::unique_ptr<DynamicBatcher>& batcher) {
+    if (sessions.empty()) {
+        return Status(StatusCode::INVALID_PARAM, "the dynamic batcher requires at least one session");
+    }
+
+    std::unique_ptr<DynamicBatcher> result(new DynamicBatcher());
+    for (auto& session : sessions) {
+        if (!session || !session->is_loaded() || session->get_inputs().empty()) {
+            return Status(StatusCode::INVALID_PARAM, "the sessions of the dynamic batcher must be loaded with inputs");
+        }
+
+        BatchSession batch_session;
+        batch_session.batch_size = session->get_inputs()[0].shape.empty() ? 0 : session->get_inputs()[0].shape[0];
+        std::vector<TensorInfo> inputs;
+        std::vector<TensorInfo> outputs;
+        for (auto* tensors : {&session->get_inputs(), &session->get_outputs()}) {
+            for (const auto& info : *tensors) {
+                TensorInfo sample;
+                auto status = get_sample_info(info, batch_session.batch_size, sample);
+                if (!status.is_ok()) {
+                    return status;
+                }
+                (tensors == &session->get_inputs() ? inputs : outputs).emplace_back(sample);
+            }
+        }
+
+        if (result->m_sessions.empty()) {
+            result->m_inputs = inputs;
+            result->m_outputs = outputs;
+        } else if (!same_tensors(inputs, result->m_inputs) || !same_tensors(outputs, result->m_outputs)) {
+            return Status(StatusCode::INVALID_PARAM, "the sessions of the dynamic batcher are not the same model");
+        }
+
+        // the batched inputs are gathered in place, the session reads them without copy
+        const auto& session_inputs = session->get_inputs();
+        int64_t copied_inputs = session->get_zero_copy_stats().copied_inputs;
+        for (size_t i = 0; i < session_inputs.size(); ++i) {
+            batch_session.inputs.emplace_back(
+                tvm::runtime::NDArray::Empty(session_inputs[i].shape, session_inputs[i].dtype, {kDLCPU, 0}));
+            auto status = session->set_input_zero_copy(static_cast<int>(i), batch_session.inputs.back());
+            if (!status.is_ok()) {
+                return status;
+            }
+        }
+        // a bind which fell back to a copy only sees the data at bind time
+        batch_session.zero_copy = session->get_zero_copy_stats().copied_inputs == copied_inputs;
+
+        batch_session.session = std::move(session);
+        result->m_sessions.emplace_back(std::move(batch_session));
+    }
+
+    std::sort(result->m_sessions.begin(), result->m_sessions.end(),
+              [](const BatchSession& lhs, const BatchSession& rhs) { return lhs.batch_size < rhs.batch_size; });
+    for (size_t i = 1; i < result->m_sessions.size(); ++i) {
+        if (result->m_sessions[i].batch_size == result->m_sessions[i - 1].batch_size) {
+            return Status(StatusCode::INVALID_PARAM, "the sessions of the dynamic batcher have the same batch size");
+        }
+    }
+
+    int64_t largest = result->m_sessions.back().batch_size;
+    if (options.max_batch_size > largest || options.max_delay_us < 0) {
+        std::ostringstream oss;
+        oss << "invalid batcher options, the max batch size " << options.max_batch_size << " exceeds " << largest
+            << " or the max delay is negative";
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    result->m_options = options;
+    result->m_max_batch_size = options.max_batch_size > 0 ? options.max_batch_size : static_cast<int>(largest);
+    result->m_stats.queue_time_us = Histogram::exponential(kMinQueueTimeBoundUs, kMaxQueueTimeBoundUs);
+    result->m_stats.batch_size = Histogram::linear(1, result->m_max_batch_size);
+    std::promise<Status> started;
+    std::future<Status> started_future = started.get_future();
+    result->m_dispatcher = std::thread(&DynamicBatcher::dispatch_loop, result.get(), std::move(started));
+    auto status = started_future.get();
+    if (!status.is_ok()) {
+        result->stop();
+        return status;
+    }
+
+    batcher = std::move(result);
+    return Status::ok();
+}
+
+Status DynamicBatcher::infer(const sample_utils::TensorMap& inputs, std::vector<tvm::runtime::NDArray>& outputs) {
+    auto request = std::make_shared<Request>();
+    for (const auto& info : m_inputs) {
+        auto iter = inputs.find(info.name);
+        if (iter == inputs.end() || !iter->second.defined()) {
+            return Status(StatusCode::INVALID_PARAM, "input not found: " + info.name);
+        }
+
+        // the samples of the request replace the dim 0
+        const DLTensor* tensor = iter->second.operator->();
+        int64_t samples = tensor->ndim > 0 ? tensor->shape[0] : 0;
+        if (samples < 1 || samples > m_max_batch_size || (request->samples > 0 && samples != request->samples)) {
+            std::ostringstream oss;
+            oss << "the samples of " << info.name << " must be in [1, " << m_max_batch_size
+                << "] and the same for all the inputs";
+            return Status(StatusCode::INVALID_PARAM, oss.str());
+        }
+
+        TensorInfo expected = info;
+        expected.shape[0] = samples;
+        auto status = validate_tensor(expected, tensor);
+        if (!status.is_ok()) {
+            return status;
+        }
+        if (tensor->device.device_type != kDLCPU || !is_compact(tensor)) {
+            return Status(StatusCode::INVALID_PARAM, "the data of " + info.name + " is not compact on CPU");
+        }
+
+        request->samples = samples;
+        request->inputs.emplace_back(iter->second);
+    }
+
+    std::future<Status> done = request->done.get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopped) {
+            return Status(StatusCode::RUNTIME_ERROR, "the dynamic batcher is stopped");
+        }
+
+        request->submit_time = std::chrono::steady_clock::now();
+        m_queued_samples += request->samples;
+        m_queue.emplace_back(request);
+    }
+    m_cv.notify_all();
+
+    auto status = done.get();
+    if (status.is_ok()) {
+        outputs = std::move(request->outputs);
+    }
+    return status;
+}
+
+BatcherStats DynamicBatcher::get_stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void DynamicBatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopped = true;
+    }
+    m_cv.notify_all();
+
+    if (m_dispatcher.joinable()) {
+        m_dispatcher.join();
+    }
+}
+
+void DynamicBatcher::dispatch_loop(std::promise<Status> started) {
+    // the TVM thread pool is thread local, it is configured before the first batch
+    Status config_status = apply_thread_config(m_options.thread_config);
+    started.set_value(config_status);
+    if (!config_status.is_ok()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_cv.wait(lock, [this]() { return m_stopped || !m_queue.empty(); });
+        if (m_queue.empty()) {
+            break;
+        }
+
+        // wait for more requests until the batch is full or the oldest request reaches the deadline
+        auto deadline = m_queue.front()->submit_time + std::chrono::microseconds(m_options.max_delay_us);
+        m_cv.wait_until(lock, deadline, [this]() { return m_stopped || m_queued_samples >= m_max_batch_size; });
+
+        // the requests are dispatched in order, a request which does not fit waits for the next batch
+        std::vector<std::shared_ptr<Request>> batch;
+        int64_t samples = 0;
+        auto now = std::chrono::steady_clock::now();
+        while (!m_queue.empty() && samples + m_queue.front()->samples <= m_max_batch_size) {
+            const auto& request = m_queue.front();
+            samples += request->samples;
+            m_stats.queue_time_us.record(
+                std::chrono::duration_cast<std::chrono::microseconds>(now - request->submit_time).count());
+            batch.emplace_back(request);
+            m_queue.pop_front();
+        }
+        m_queued_samples -= samples;
+
+        // the smallest batch size which fits the samples
+        auto iter = std::find_if(m_sessions.begin(), m_sessions.end(),
+                                 [samples](const BatchSession& session) { return session.batch_size >= samples; });
+        ++m_stats.batches;
+        m_stats.requests += static_cast<int64_t>(batch.size());
+        m_stats.samples += samples;
+        m_stats.padded_samples += iter->batch_size - samples;
+        m_stats.batch_size.record(samples);
+
+        lock.unlock();
+        auto status = run_batch(*iter, batch);
+        for (auto& request : batch) {
+            request->done.set_value(status);
+        }
+        lock.lock();
+    }
+}
+
+Status DynamicBatcher::run_batch(BatchSession& session, const std::vector<std::shared_ptr<Request>>& batch) {
+    // an exception must NOT escape the worker thread, the requests of the batch get the error instead
+    try {
+        // gather the samples of the requests, the padded samples are zero
+        for (size_t i = 0; i < m_inputs.size(); ++i) {
+            size_t sample_bytes = m_inputs[i].bytes();
+            char* data = get_data(session.inputs[i]);
+            size_t offset = 0;
+            for (const auto& request : batch) {
+                size_t bytes = sample_bytes * static_cast<size_t>(request->samples);
+                std::memcpy(data + offset, get_data(request->inputs[i]), bytes);
+                offset += bytes;
+            }
+            std::memset(data + offset, 0, sample_bytes * static_cast<size_t>(session.batch_size) - offset);
+
+            if (!session.zero_copy) {
+                auto status = session.session->set_input(static_cast<int>(i), session.inputs[i]);
+                if (!status.is_ok()) {
+                    return status;
+                }
+            }
+        }
+
+        auto status = session.session->run();
+        if (!status.is_ok()) {
+            return status;
+        }
+
+        // scatter the outputs to a new tensor per request, the session outputs are overwritten by the next batch
+        for (size_t i = 0; i < m_outputs.size(); ++i) {
+            tvm::runtime::NDArray output;
+            status = session.session->get_output(static_cast<int>(i), output);
+            if (!status.is_ok()) {
+                return status;
+            }
+
+            size_t sample_bytes = m_outputs[i].bytes();
+            const char* data = get_data(output);
+            size_t offset = 0;
+            for (const auto& request : batch) {
+                std::vector<int64_t> shape = m_outputs[i].shape;
+                shape[0] = request->samples;
+                request->outputs.emplace_back(tvm::runtime::NDArray::Empty(shape, m_outputs[i].dtype, {kDLCPU, 0}));
+
+                size_t bytes = sample_bytes * static_cast<size_t>(request->samples);
+                std::memcpy(get_data(request->outputs.back()), data + offset, bytes);
+                offset += bytes;
+            }
+        }
+    } catch (const std::exception& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+}    // namespace serving
+}    // namespace tvm_cpp
@@ -0,0 +1,160 @@
+#ifndef _H_TVM_CPP_SERVING_DYNAMIC_BATCHER_H_
+#define _H_TVM_CPP_SERVING_DYNAMIC_BATCHER_H_
+
+#include <tvm/runtime/ndarray.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "serving/histogram.h"
+#include "serving/inference_session.h"
+#include "serving/thread_config.h"
+#include "utils/sample_utils.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace serving {
+
+/**
+ * @brief The options of the dynamic batcher
+ *
+ */
+struct BatcherOptions {
+    // the max samples of a batch, 0 means the largest batch size of the sessions
+    int max_batch_size{0};
+    // the max time the oldest request waits for the others before its batch is dispatched
+    int64_t max_delay_us{2000};
+    // the threads and the cores of the dispatch thread, which runs the batches
+    ThreadConfig thread_config;
+};
+
+/**
+ * @brief The statistics of the dynamic batcher since it is created
+ *
+ */
+struct BatcherStats {
+    int64_t requests{0};
+    int64_t batches{0};
+    // the samples of the dispatched batches and the padded samples added to fill the session batch sizes
+    int64_t samples{0};
+    int64_t padded_samples{0};
+    // the time from the submission of a request to the dispatch of its batch in microseconds
+    Histogram queue_time_us;
+    // the samples of each batch before padding
+    Histogram batch_size;
+};
+
+/**
+ * @brief The dynamic batcher in front of the sessions specialized to fixed batch sizes. The concurrent requests are
+ * queued and coalesced until the batch is full or the oldest request reaches the deadline, the batch is padded to the
+ * smallest session batch size which fits it and run as one call, then the outputs are scattered back to the requests.
+ * The dim 0 of every input and output is the batch, a request holds one or more samples
+ *
+ */
+class DynamicBatcher final {
+public:
+    DynamicBatcher(const DynamicBatcher&) = delete;
+    DynamicBatcher& operator=(const DynamicBatcher&) = delete;
+    ~DynamicBatcher();
+
+    /**
+     * @brief Create the batcher and start its dispatch thread
+     *
+     * @param sessions the loaded sessions of the same model specialized to different batch sizes, the batcher owns
+     * them
+     * @param options the batcher options
+     * @param batcher output parameter. the batcher
+     * @return Status
+     */
+    static Status create(std::vector<std::unique_ptr<InferenceSession>> sessions, const BatcherOptions& options,
+                         std::unique_ptr<DynamicBatcher>& batcher);
+
+    /**
+     * @brief Queue a request and wait for its outputs, it is thread-safe
+     *
+     * @param inputs the input tensors by name, dim 0 is the samples of the request
+     * @param outputs output parameter. the outputs in the order of `get_outputs()`, dim 0 is the samples
+     * @return Status
+     */
+    Status infer(const sample_utils::TensorMap& inputs, std::vector<tvm::runtime::NDArray>& outputs);
+
+    /**
+     * @brief The inputs of the model with the batch dim of 1
+     *
+     */
+    const std::vector<TensorInfo>& get_inputs() const { return m_inputs; }
+
+    /**
+     * @brief The outputs of the model with the batch dim of 1
+     *
+     */
+    const std::vector<TensorInfo>& get_outputs() const { return m_outputs; }
+
+    /**
+     * @brief The max samples of a batch
+     *
+     */
+    int get_max_batch_size() const { return m_max_batch_size; }
+
+    BatcherStats get_stats() const;
+
+    /**
+     * @brief Dispatch the queued requests and stop the dispatch thread, the later requests are rejected
+     *
+     */
+    void stop();
+
+private:
+    struct Request {
+        // the inputs in the order of `get_inputs()`
+        std::vector<tvm::runtime::NDArray> inputs;
+        int64_t samples{0};
+        std::chrono::steady_clock::time_point submit_time;
+        std::vector<tvm::runtime::NDArray> outputs;
+        std::promise<Status> done;
+    };
+
+    /**
+     * @brief The session of a batch size and its batched inputs which are bound to it without copy
+     *
+     */
+    struct BatchSession {
+        int64_t batch_size{0};
+        std::unique_ptr<InferenceSession> session;
+        std::vector<tvm::runtime::NDArray> inputs;
+        // the session reads the inputs in place, otherwise they are copied to it before each batch
+        bool zero_copy{true};
+    };
+
+    DynamicBatcher() = default;
+
+    void dispatch_loop(std::promise<Status> started);
+    Status run_batch(BatchSession& session, const std::vector<std::shared_ptr<Request>>& batch);
+
+    BatcherOptions m_options;
+    int m_max_batch_size{0};
+    std::vector<TensorInfo> m_inputs;
+    std::vector<TensorInfo> m_outputs;
+    // ascending batch sizes
+    std::vector<BatchSession> m_sessions;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::shared_ptr<Request>> m_queue;
+    int64_t m_queued_samples{0};
+    bool m_stopped{false};
+    BatcherStats m_stats;
+    std::thread m_dispatcher;
+};
+
+}    // namespace serving
+}    // namespace tvm_cpp
+
+#endif
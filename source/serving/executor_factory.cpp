@@ -0,0 +1,227 @@
+#include "executor_factory.h"
+
+#include <picojson.h>
+#include <tvm/runtime/data_type.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "compiler/model_artifact.h"
+#include "compiler/model_builder.h"
+#include "serving/numa.h"
+
+namespace tvm_cpp {
+namespace serving {
+
+namespace {
+
+/**
+ * @brief Get the list of a graph json attr, e.g. "storage_id": ["list_int", [...]]
+ *
+ */
+const picojson::array* get_attr_list(const picojson::value& attrs, const std::string& name) {
+    if (!attrs.contains(name)) {
+        return nullptr;
+    }
+
+    const picojson::value& attr = attrs.get(name);
+    if (!attr.is<picojson::array>() || attr.get<picojson::array>().size() != 2 || !attr.get(1).is<picojson::array>()) {
+        return nullptr;
+    }
+
+    return &attr.get(1).get<picojson::array>();
+}
+
+/**
+ * @brief Get the storage id of each param and the size of each storage id planned by the graph json
+ *
+ */
+Status parse_graph_storage(const std::string& graph_json,
+                           const std::unordered_map<std::string, tvm::runtime::NDArray>& params,
+                           std::unordered_map<std::string, int64_t>& param_storage_ids,
+                           std::map<int64_t, int64_t>& storage_bytes) {
+    picojson::value graph;
+    std::string err = picojson::parse(graph, graph_json);
+    if (!err.empty() || !graph.is<picojson::object>() || !graph.get("nodes").is<picojson::array>() ||
+        !graph.get("arg_nodes").is<picojson::array>() || !graph.get("node_row_ptr").is<picojson::array>() ||
+        !graph.get("attrs").is<picojson::object>()) {
+        return Status(StatusCode::INVALID_MODEL, "Invalid graph json: " + err);
+    }
+
+    const picojson::value& attrs = graph.get("attrs");
+    const picojson::array* storage_ids = get_attr_list(attrs, "storage_id");
+    const picojson::array* shapes = get_attr_list(attrs, "shape");
+    const picojson::array* dltypes = get_attr_list(attrs, "dltype");
+    if (!storage_ids || !shapes || !dltypes || storage_ids->size() != shapes->size() ||
+        storage_ids->size() != dltypes->size()) {
+        return Status(StatusCode::INVALID_MODEL, "Invalid storage_id, shape or dltype in the graph json");
+    }
+
+    // a storage id is shared by the entries whose lifetimes do not overlap, its size is the largest entry
+    storage_bytes.clear();
+    for (size_t i = 0; i < storage_ids->size(); ++i) {
+        const picojson::value& shape = (*shapes)[i];
+        if (!(*storage_ids)[i].is<double>() || !shape.is<picojson::array>() || !(*dltypes)[i].is<std::string>()) {
+            return Status(StatusCode::INVALID_MODEL, "Invalid storage entry in the graph json");
+        }
+
+        tvm::DataType dtype(tvm::runtime::String2DLDataType((*dltypes)[i].get<std::string>()));
+        int64_t bytes = (dtype.bits() * dtype.lanes() + 7) / 8;
+        for (const auto& dim : shape.get<picojson::array>()) {
+            bytes *= static_cast<int64_t>(dim.get<double>());
+        }
+
+        int64_t& size = storage_bytes[static_cast<int64_t>((*storage_ids)[i].get<double>())];
+        size = std::max(size, bytes);
+    }
+
+    const picojson::array& nodes = graph.get("nodes").get<picojson::array>();
+    const picojson::array& row_ptr = graph.get("node_row_ptr").get<picojson::array>();
+    param_storage_ids.clear();
+    for (const auto& arg : graph.get("arg_nodes").get<picojson::array>()) {
+        size_t node_id = static_cast<size_t>(arg.get<double>());
+        if (node_id >= nodes.size() || node_id >= row_ptr.size()) {
+            return Status(StatusCode::INVALID_MODEL, "Invalid arg node in the graph json");
+        }
+
+        std::string name = nodes[node_id].get("name").to_str();
+        if (!params.count(name)) {
+            continue;
+        }
+
+        size_t entry_id = static_cast<size_t>(row_ptr[node_id].get<double>());
+        if (entry_id >= storage_ids->size()) {
+            return Status(StatusCode::INVALID_MODEL, "Invalid entry of param " + name);
+        }
+        param_storage_ids[name] = static_cast<int64_t>((*storage_ids)[entry_id].get<double>());
+    }
+
+    return Status::ok();
+}
+
+}    // namespace
+
+Status ExecutorFactory::load(const std::string& artifact_dir) {
+    compiler::BuildResult result;
+    auto status = compiler::load_model_artifact(artifact_dir, result);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    if (result.executor != compiler::ExecutorKind::Graph) {
+        return Status(StatusCode::INVALID_PARAM, "the executor factory requires a graph executor artifact");
+    }
+
+    return init(std::move(result.graph_json), result.lib, std::move(result.params));
+}
+
+Status ExecutorFactory::replicate_to_numa_node(int node, ExecutorFactory& replica) const {
+    if (!is_loaded()) {
+        return Status(StatusCode::RUNTIME_ERROR, "the executor factory is not loaded");
+    }
+
+    std::unordered_map<std::string, tvm::runtime::NDArray> params;
+    try {
+        for (const auto& kv : m_params) {
+            const DLTensor* param = kv.second.operator->();
+            tvm::runtime::NDArray copy;
+            auto status = empty_on_numa_node(std::vector<int64_t>(param->shape, param->shape + param->ndim),
+                                             param->dtype, node, copy);
+            if (!status.is_ok()) {
+                return status;
+            }
+            // the pages are allocated on the node as the copy touches them
+            copy.CopyFrom(kv.second);
+            params.emplace(kv.first, copy);
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    auto status = replica.init(m_graph_json, m_lib, std::move(params));
+    if (!status.is_ok()) {
+        return status;
+    }
+    replica.m_numa_node = node;
+    return Status::ok();
+}
+
+Status ExecutorFactory::init(std::string graph_json, tvm::runtime::Module lib,
+                             std::unordered_map<std::string, tvm::runtime::NDArray> params_by_name) {
+    std::unordered_map<std::string, int64_t> param_storage_ids;
+    std::map<int64_t, int64_t> storage_bytes;
+    auto status = parse_graph_storage(graph_json, params_by_name, param_storage_ids, storage_bytes);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    auto params = std::make_shared<std::unordered_map<int64_t, tvm::runtime::NDArray>>();
+    int64_t params_bytes = 0;
+    for (const auto& kv : param_storage_ids) {
+        const tvm::runtime::NDArray& param = params_by_name.at(kv.first);
+        if (!params->emplace(kv.second, param).second) {
+            return Status(StatusCode::INVALID_MODEL, "the storage of param " + kv.first + " is shared");
+        }
+        params_bytes += static_cast<int64_t>(tvm::runtime::GetDataSize(*param.operator->()));
+        storage_bytes.erase(kv.second);
+    }
+
+    int64_t executor_storage_bytes = 0;
+    for (const auto& kv : storage_bytes) {
+        executor_storage_bytes += kv.second;
+    }
+
+    m_lookup_param = nullptr;
+    if (!params->empty()) {
+        // the arguments are the library, the storage id, the template DLTensor and the device. the executor views the
+        // returned NDArray as the storage, a null return allocates it
+        m_lookup_param = tvm::runtime::PackedFunc([params](tvm::runtime::TVMArgs args, tvm::runtime::TVMRetValue* rv) {
+            int64_t storage_id = args[1];
+            auto iter = params->find(storage_id);
+            if (iter == params->end()) {
+                *rv = nullptr;
+                return;
+            }
+            *rv = iter->second;
+        });
+    }
+
+    m_graph_json = std::move(graph_json);
+    m_lib = lib;
+    m_params = std::move(params_by_name);
+    m_numa_node = -1;
+    m_params_bytes = params_bytes;
+    m_executor_storage_bytes = executor_storage_bytes;
+    return Status::ok();
+}
+
+Status ExecutorFactory::create_executor(tvm::runtime::Module& executor) const {
+    if (!is_loaded()) {
+        return Status(StatusCode::RUNTIME_ERROR, "the executor factory is not loaded");
+    }
+
+    // the graph executor create function
+    const tvm::runtime::PackedFunc* graph_executor_create = tvm::runtime::Registry::Get("tvm.graph_executor.create");
+    if (!graph_executor_create) {
+        return Status(StatusCode::RUNTIME_ERROR, "tvm.graph_executor.create not found");
+    }
+
+    try {
+        if (m_lookup_param != nullptr) {
+            executor = (*graph_executor_create)(m_graph_json, m_lib, m_lookup_param, static_cast<int>(kDLCPU), 0);
+        } else {
+            // no params or the params are linked into the library, they are shared by the library already
+            executor = (*graph_executor_create)(m_graph_json, m_lib, static_cast<int>(kDLCPU), 0);
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+}    // namespace serving
+}    // namespace tvm_cpp
@@ -0,0 +1,113 @@
+#ifndef _H_TVM_CPP_SERVING_EXECUTOR_FACTORY_H_
+#define _H_TVM_CPP_SERVING_EXECUTOR_FACTORY_H_
+
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace serving {
+
+/**
+ * @brief The factory of the graph executors of an exported artifact. The library and the params are loaded once by
+ * `load`, every executor created by the factory binds the same param NDArrays, so an executor only allocates the
+ * storage of the activations and the inputs and outputs. The factory is thread-safe after `load`
+ *
+ */
+class ExecutorFactory final {
+public:
+    ExecutorFactory() = default;
+    ExecutorFactory(const ExecutorFactory&) = delete;
+    ExecutorFactory& operator=(const ExecutorFactory&) = delete;
+
+    /**
+     * @brief Load the library and the params of the artifact exported by `export_model_artifact` with the graph
+     * executor
+     *
+     * @param artifact_dir the artifact directory
+     * @return Status
+     */
+    Status load(const std::string& artifact_dir);
+
+    /**
+     * @brief Create a replica of the factory whose params are copied to the memory of a NUMA node, so the executors
+     * run on the cores of the node read the weights locally. The library and the graph json are shared, the params
+     * linked into the library are not replicated
+     *
+     * @param node the NUMA node id
+     * @param replica output parameter. the replica factory
+     * @return Status
+     */
+    Status replicate_to_numa_node(int node, ExecutorFactory& replica) const;
+
+    /**
+     * @brief Whether the factory is loaded
+     *
+     */
+    bool is_loaded() const { return m_lib.defined(); }
+
+    /**
+     * @brief Create a graph executor on CPU which shares the params of the factory. The params must not be set by the
+     * executor, they are the same buffers in every executor
+     *
+     * @param executor output parameter. the graph executor module
+     * @return Status
+     */
+    Status create_executor(tvm::runtime::Module& executor) const;
+
+    /**
+     * @brief The graph json of the artifact
+     *
+     */
+    const std::string& get_graph_json() const { return m_graph_json; }
+
+    /**
+     * @brief The params shared by the executors, empty if the params are linked into the library
+     *
+     */
+    const std::unordered_map<std::string, tvm::runtime::NDArray>& get_params() const { return m_params; }
+
+    /**
+     * @brief The size of the shared params in bytes, it is paid once by the factory
+     *
+     */
+    int64_t get_params_bytes() const { return m_params_bytes; }
+
+    /**
+     * @brief The size of the storage planned by the graph json except the params in bytes, it is paid by each
+     * executor
+     *
+     */
+    int64_t get_executor_storage_bytes() const { return m_executor_storage_bytes; }
+
+    /**
+     * @brief The NUMA node of the params of a replica, -1 if they are placed by the default policy
+     *
+     */
+    int get_numa_node() const { return m_numa_node; }
+
+private:
+    Status init(std::string graph_json, tvm::runtime::Module lib,
+                std::unordered_map<std::string, tvm::runtime::NDArray> params_by_name);
+
+    std::string m_graph_json;
+    tvm::runtime::Module m_lib;
+    std::unordered_map<std::string, tvm::runtime::NDArray> m_params;
+    // look up the param of a storage id, it is passed to the graph executor as the linked param lookup so the
+    // executor binds the param instead of allocating its storage. null if there is no param
+    tvm::runtime::PackedFunc m_lookup_param;
+    int64_t m_params_bytes{0};
+    int64_t m_executor_storage_bytes{0};
+    int m_numa_node{-1};
+};
+
+}    // namespace serving
+}    // namespace tvm_cpp
+
+#endif
@@ -0,0 +1,90 @@
+#include "histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace tvm_cpp {
+namespace serving {
+
+Histogram::Histogram(std::vector<int64_t> bounds) : m_bounds(std::move(bounds)), m_counts(m_bounds.size() + 1, 0) {}
+
+Histogram Histogram::exponential(int64_t first, int64_t last) {
+    std::vector<int64_t> bounds;
+    for (int64_t bound = std::max<int64_t>(first, 1); bounds.empty() || bounds.back() < last; bound *= 2) {
+        bounds.emplace_back(bound);
+    }
+    return Histogram(std::move(bounds));
+}
+
+Histogram Histogram::linear(int64_t first, int64_t last) {
+    std::vector<int64_t> bounds;
+    for (int64_t bound = first; bound <= last; ++bound) {
+        bounds.emplace_back(bound);
+    }
+    return Histogram(std::move(bounds));
+}
+
+void Histogram::record(int64_t value) {
+    size_t bucket = std::lower_bound(m_bounds.begin(), m_bounds.end(), value) - m_bounds.begin();
+    ++m_counts[bucket];
+    m_min = m_count > 0 ? std::min(m_min, value) : value;
+    m_max = m_count > 0 ? std::max(m_max, value) : value;
+    m_sum += value;
+    ++m_count;
+}
+
+void Histogram::merge(const Histogram& other) {
+    if (other.m_count == 0 || other.m_bounds != m_bounds) {
+        return;
+    }
+
+    for (size_t i = 0; i < m_counts.size(); ++i) {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_min = m_count > 0 ? std::min(m_min, other.m_min) : other.m_min;
+    m_max = m_count > 0 ? std::max(m_max, other.m_max) : other.m_max;
+    m_sum += other.m_sum;
+    m_count += other.m_count;
+}
+
+int64_t Histogram::percentile(double p) const {
+    if (m_count == 0) {
+        return 0;
+    }
+
+    int64_t rank = std::max<int64_t>(1, static_cast<int64_t>(std::ceil(p * m_count)));
+    int64_t seen = 0;
+    for (size_t i = 0; i < m_bounds.size(); ++i) {
+        seen += m_counts[i];
+        if (seen >= rank) {
+            return std::min(m_bounds[i], m_max);
+        }
+    }
+
+    return m_max;
+}
+
+std::ostream& operator<<(std::ostream& os, const Histogram& histogram) {
+    const auto& bounds = histogram.bounds();
+    const auto& counts = histogram.counts();
+    bool first = true;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] == 0) {
+            continue;
+        }
+
+        os << (first ? "" : " ");
+        if (i < bounds.size()) {
+            os << "<=" << bounds[i] << ":" << counts[i];
+        } else {
+            os << ">" << (bounds.empty() ? 0 : bounds.back()) << ":" << counts[i];
+        }
+        first = false;
+    }
+
+    return os;
+}
+
+}    // namespace serving
+}    // namespace tvm_cpp
@@ -0,0 +1,87 @@
+#ifndef _H_TVM_CPP_SERVING_HISTOGRAM_H_
+#define _H_TVM_CPP_SERVING_HISTOGRAM_H_
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace tvm_cpp {
+namespace serving {
+
+/**
+ * @brief A histogram of integer values with fixed bucket bounds, e.g. the latencies in microseconds. It is not
+ * thread-safe, the owner records the values under its own lock
+ *
+ */
+class Histogram final {
+public:
+    Histogram() = default;
+
+    /**
+     * @brief Create the histogram with the upper bounds of the buckets, bucket i counts the values in
+     * (bounds[i - 1], bounds[i]], an extra bucket counts the values above the last bound
+     *
+     * @param bounds the ascending upper bounds
+     */
+    explicit Histogram(std::vector<int64_t> bounds);
+
+    /**
+     * @brief The bounds first, 2 * first, 4 * first, ... up to the first one not less than last
+     *
+     */
+    static Histogram exponential(int64_t first, int64_t last);
+
+    /**
+     * @brief The bounds first, first + 1, ... last, i.e. a bucket per value
+     *
+     */
+    static Histogram linear(int64_t first, int64_t last);
+
+    void record(int64_t value);
+
+    /**
+     * @brief Add the counts of another histogram with the same bounds
+     *
+     */
+    void merge(const Histogram& other);
+
+    int64_t count() const { return m_count; }
+    int64_t min() const { return m_count > 0 ? m_min : 0; }
+    int64_t max() const { return m_count > 0 ? m_max : 0; }
+    double mean() const { return m_count > 0 ? static_cast<double>(m_sum) / m_count : 0; }
+
+    /**
+     * @brief The upper bound of the bucket which holds the p-th quantile, the max for the last bucket
+     *
+     * @param p the quantile in [0, 1], e.g. 0.99
+     * @return int64_t
+     */
+    int64_t percentile(double p) const;
+
+    const std::vector<int64_t>& bounds() const { return m_bounds; }
+
+    /**
+     * @brief The counts of the buckets, one more than the bounds
+     *
+     */
+    const std::vector<int64_t>& counts() const { return m_counts; }
+
+private:
+    std::vector<int64_t> m_bounds;
+    std::vector<int64_t> m_counts{0};
+    int64_t m_count{0};
+    int64_t m_sum{0};
+    int64_t m_min{0};
+    int64_t m_max{0};
+};
+
+/**
+ * @brief Print the non-empty buckets, e.g. "<=1:3 <=2:10 >2:1"
+ *
+ */
+std::ostream& operator<<(std::ostream& os, const Histogram& histogram);
+
+}    // namespace serving
+}    // namespace tvm_cpp
+
+#endif
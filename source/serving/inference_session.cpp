@@ -0,0 +1,725 @@
+#include "inference_session.h"
+
+#include <picojson.h>
+#include <tvm/runtime/device_api.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace tvm_cpp {
+namespace serving {
+
+namespace {
+
+std::string shape_to_string(const std::vector<int64_t>& shape) {
+    std::ostringstream oss;
+    oss << "[";
+    for (size_t i = 0; i < shape.size(); ++i) {
+        oss << (i > 0 ? ", " : "") << shape[i];
+    }
+    oss << "]";
+    return oss.str();
+}
+
+/**
+ * @brief Get the shape and the dtype of the graph entries from the graph json attributes
+ *
+ */
+bool get_entry_info(const picojson::value& graph, size_t entry_id, TensorInfo& info) {
+    const picojson::value& attrs = graph.get("attrs");
+    const picojson::value& shapes = attrs.get("shape");
+    const picojson::value& dltypes = attrs.get("dltype");
+    // e.g. "shape": ["list_shape", [[1, 3, 224, 224], ...]], "dltype": ["list_str", ["float32", ...]]
+    if (!shapes.is<picojson::array>() || shapes.get<picojson::array>().size() != 2 || !dltypes.is<picojson::array>() ||
+        dltypes.get<picojson::array>().size() != 2) {
+        return false;
+    }
+
+    const picojson::value& shape_list = shapes.get(1);
+    const picojson::value& dltype_list = dltypes.get(1);
+    if (!shape_list.is<picojson::array>() || !dltype_list.is<picojson::array>() ||
+        entry_id >= shape_list.get<picojson::array>().size() || entry_id >= dltype_list.get<picojson::array>().size()) {
+        return false;
+    }
+
+    const picojson::value& shape = shape_list.get(entry_id);
+    const picojson::value& dltype = dltype_list.get(entry_id);
+    if (!shape.is<picojson::array>() || !dltype.is<std::string>()) {
+        return false;
+    }
+
+    info.shape.clear();
+    for (const auto& dim : shape.get<picojson::array>()) {
+        if (!dim.is<double>()) {
+            return false;
+        }
+        info.shape.emplace_back(static_cast<int64_t>(dim.get<double>()));
+    }
+    info.dtype = tvm::DataType(tvm::runtime::String2DLDataType(dltype.get<std::string>()));
+    return true;
+}
+
+/**
+ * @brief Get the inputs and the outputs of the graph json, the params are skipped
+ *
+ */
+Status parse_graph_tensors(const std::string& graph_json,
+                           const std::unordered_map<std::string, tvm::runtime::NDArray>& params,
+                           std::vector<TensorInfo>& inputs, std::vector<TensorInfo>& outputs) {
+    picojson::value graph;
+    std::string err = picojson::parse(graph, graph_json);
+    if (!err.empty() || !graph.is<picojson::object>() || !graph.get("nodes").is<picojson::array>() ||
+        !graph.get("arg_nodes").is<picojson::array>() || !graph.get("heads").is<picojson::array>() ||
+        !graph.get("node_row_ptr").is<picojson::array>() || !graph.get("attrs").is<picojson::object>()) {
+        return Status(StatusCode::INVALID_MODEL, "Invalid graph json: " + err);
+    }
+
+    const picojson::array& nodes = graph.get("nodes").get<picojson::array>();
+    const picojson::array& row_ptr = graph.get("node_row_ptr").get<picojson::array>();
+    auto get_entry_id = [&](size_t node_id, size_t index) {
+        return static_cast<size_t>(row_ptr[node_id].get<double>()) + index;
+    };
+
+    inputs.clear();
+    for (const auto& arg : graph.get("arg_nodes").get<picojson::array>()) {
+        size_t node_id = static_cast<size_t>(arg.get<double>());
+        if (node_id >= nodes.size() || node_id >= row_ptr.size()) {
+            return Status(StatusCode::INVALID_MODEL, "Invalid arg node in the graph json");
+        }
+
+        TensorInfo info;
+        info.name = nodes[node_id].get("name").to_str();
+        if (params.count(info.name)) {
+            continue;
+        }
+
+        if (!get_entry_info(graph, get_entry_id(node_id, 0), info)) {
+            return Status(StatusCode::INVALID_MODEL, "Invalid shape or dtype of input " + info.name);
+        }
+        inputs.emplace_back(info);
+    }
+
+    outputs.clear();
+    for (const auto& head : graph.get("heads").get<picojson::array>()) {
+        // [node_id, index, version]
+        if (!head.is<picojson::array>() || head.get<picojson::array>().size() < 2) {
+            return Status(StatusCode::INVALID_MODEL, "Invalid head in the graph json");
+        }
+
+        size_t node_id = static_cast<size_t>(head.get(0).get<double>());
+        size_t index = static_cast<size_t>(head.get(1).get<double>());
+        TensorInfo info;
+        info.name = get_output_name(static_cast<int>(outputs.size()));
+        if (node_id >= row_ptr.size() || !get_entry_info(graph, get_entry_id(node_id, index), info)) {
+            return Status(StatusCode::INVALID_MODEL, "Invalid shape or dtype of " + info.name);
+        }
+        outputs.emplace_back(info);
+    }
+
+    return Status::ok();
+}
+
+/**
+ * @brief Own the DLPack tensor, its deleter is called when the last reference is released
+ *
+ */
+std::shared_ptr<DLManagedTensor> manage_dlpack(DLManagedTensor* tensor) {
+    return std::shared_ptr<DLManagedTensor>(tensor, [](DLManagedTensor* ptr) {
+        if (ptr->deleter) {
+            ptr->deleter(ptr);
+        }
+    });
+}
+
+bool is_dlpack_zero_copy_compatible(const TensorInfo& info, DLManagedTensor* tensor) {
+    return is_zero_copy_compatible(&tensor->dl_tensor) && validate_tensor(info, &tensor->dl_tensor).is_ok();
+}
+
+}    // namespace
+
+size_t TensorInfo::bytes() const {
+    size_t count = 1;
+    for (int64_t dim : shape) {
+        count *= static_cast<size_t>(dim);
+    }
+    return count * ((dtype.bits() * dtype.lanes() + 7) / 8);
+}
+
+std::string get_output_name(int index) { return "output_" + std::to_string(index); }
+
+Status validate_tensor(const TensorInfo& info, const tvm::runtime::NDArray& data) {
+    if (!data.defined()) {
+        return Status(StatusCode::INVALID_PARAM, "the data of " + info.name + " is undefined");
+    }
+
+    return validate_tensor(info, data.operator->());
+}
+
+Status validate_tensor(const TensorInfo& info, const DLTensor* tensor) {
+    bool same_shape = tensor->ndim == static_cast<int>(info.shape.size()) &&
+                      std::equal(info.shape.begin(), info.shape.end(), tensor->shape);
+    if (!same_shape || tvm::DataType(tensor->dtype) != info.dtype) {
+        std::ostringstream oss;
+        oss << "the data of " << info.name << " is " << tvm::DataType(tensor->dtype) << " "
+            << shape_to_string(std::vector<int64_t>(tensor->shape, tensor->shape + tensor->ndim)) << ", expected "
+            << info.dtype << " " << shape_to_string(info.shape);
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    return Status::ok();
+}
+
+bool is_zero_copy_compatible(const DLTensor* tensor) {
+    // the executor is created on CPU 0
+    if (tensor->device.device_type != kDLCPU || tensor->device.device_id != 0) {
+        return false;
+    }
+
+    uintptr_t address = reinterpret_cast<uintptr_t>(tensor->data) + tensor->byte_offset;
+    if (address % tvm::runtime::kAllocAlignment != 0) {
+        return false;
+    }
+
+    return is_compact(tensor);
+}
+
+bool is_compact(const DLTensor* tensor) {
+    if (tensor->strides) {
+        int64_t expected = 1;
+        for (int i = tensor->ndim - 1; i >= 0; --i) {
+            if (tensor->shape[i] != 1 && tensor->strides[i] != expected) {
+                return false;
+            }
+            expected *= tensor->shape[i];
+        }
+    }
+
+    return true;
+}
+
+Status InferenceSession::load(const std::string& artifact_dir) {
+    ExecutorFactory factory;
+    auto status = factory.load(artifact_dir);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    return load(factory);
+}
+
+Status InferenceSession::load(const ExecutorFactory& factory) {
+    std::vector<TensorInfo> inputs;
+    std::vector<TensorInfo> outputs;
+    auto status = parse_graph_tensors(factory.get_graph_json(), factory.get_params(), inputs, outputs);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    tvm::runtime::Module executor;
+    status = factory.create_executor(executor);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    try {
+        m_set_input = executor.GetFunction("set_input");
+        m_run = executor.GetFunction("run");
+        m_get_output = executor.GetFunction("get_output");
+        m_get_input = executor.GetFunction("get_input");
+        m_set_input_zero_copy = executor.GetFunction("set_input_zero_copy");
+        m_set_output_zero_copy = executor.GetFunction("set_output_zero_copy");
+        tvm::runtime::PackedFunc get_input_index = executor.GetFunction("get_input_index");
+        tvm::runtime::PackedFunc get_num_outputs = executor.GetFunction("get_num_outputs");
+
+        int num_outputs = get_num_outputs();
+        if (num_outputs != static_cast<int>(outputs.size())) {
+            return Status(StatusCode::INVALID_MODEL, "the outputs of the executor do not match the graph json");
+        }
+
+        m_executor_input_indices.clear();
+        m_input_indices.clear();
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            int executor_index = get_input_index(inputs[i].name);
+            if (executor_index < 0) {
+                return Status(StatusCode::INVALID_MODEL, "input not found in the executor: " + inputs[i].name);
+            }
+            m_executor_input_indices.emplace_back(executor_index);
+            m_input_indices[inputs[i].name] = static_cast<int>(i);
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    m_output_indices.clear();
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        m_output_indices[outputs[i].name] = static_cast<int>(i);
+    }
+
+    m_zero_copy_inputs.assign(inputs.size(), tvm::runtime::NDArray());
+    m_output_bindings.assign(outputs.size(), OutputBinding());
+    m_zero_copy_stats = ZeroCopyStats();
+    m_output_pool.reset();
+    m_inputs = std::move(inputs);
+    m_outputs = std::move(outputs);
+    m_executor = executor;
+    return Status::ok();
+}
+
+Status InferenceSession::get_input_index(const std::string& name, int& index) const {
+    auto iter = m_input_indices.find(name);
+    if (iter == m_input_indices.end()) {
+        return Status(StatusCode::INVALID_PARAM, "input not found: " + name);
+    }
+
+    index = iter->second;
+    return Status::ok();
+}
+
+Status InferenceSession::get_output_index(const std::string& name, int& index) const {
+    auto iter = m_output_indices.find(name);
+    if (iter == m_output_indices.end()) {
+        return Status(StatusCode::INVALID_PARAM, "output not found: " + name);
+    }
+
+    index = iter->second;
+    return Status::ok();
+}
+
+Status InferenceSession::set_input(const std::string& name, const tvm::runtime::NDArray& data) {
+    int index = 0;
+    auto status = get_input_index(name, index);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    return set_input(index, data);
+}
+
+Status InferenceSession::set_input(int index, const tvm::runtime::NDArray& data) {
+    auto status = check_input_index(index);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    status = validate_tensor(m_inputs[index], data);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    try {
+        int executor_index = m_executor_input_indices[index];
+        if (m_zero_copy_inputs[index].defined()) {
+            // the executor reads the caller-owned buffer until the executor-owned one is bound again
+            m_set_input_zero_copy(executor_index, m_get_input(executor_index));
+            m_zero_copy_inputs[index] = tvm::runtime::NDArray();
+        }
+        m_set_input(executor_index, data);
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status InferenceSession::set_inputs(const sample_utils::TensorMap& inputs) {
+    for (const auto& kv : inputs) {
+        auto status = set_input(kv.first, kv.second);
+        if (!status.is_ok()) {
+            return status;
+        }
+    }
+
+    return Status::ok();
+}
+
+Status InferenceSession::run() {
+    if (!is_loaded()) {
+        return Status(StatusCode::RUNTIME_ERROR, "the inference session is not loaded");
+    }
+
+    try {
+        m_run();
+
+        for (size_t i = 0; i < m_output_bindings.size(); ++i) {
+            OutputBinding& binding = m_output_bindings[i];
+            if (binding.copy) {
+                tvm::runtime::NDArray output = m_get_output(static_cast<int>(i));
+                output.CopyTo(&binding.copy_target);
+            }
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status InferenceSession::create_output_pool(int max_buffers) {
+    if (!is_loaded()) {
+        return Status(StatusCode::RUNTIME_ERROR, "the inference session is not loaded");
+    }
+
+    std::vector<std::vector<int64_t>> shapes;
+    std::vector<tvm::DataType> dtypes;
+    for (const auto& output : m_outputs) {
+        shapes.emplace_back(output.shape);
+        dtypes.emplace_back(output.dtype);
+    }
+
+    std::shared_ptr<TensorPool> pool;
+    auto status = TensorPool::create(shapes, dtypes, max_buffers, pool);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    m_output_pool_keys.clear();
+    for (const auto& output : m_outputs) {
+        m_output_pool_keys.emplace_back(pool->find_key(output.shape, output.dtype));
+    }
+    m_output_pool_copies.assign(m_outputs.size(), false);
+    m_output_pool = pool;
+    return Status::ok();
+}
+
+Status InferenceSession::run(std::vector<PooledTensor>& outputs) {
+    if (!m_output_pool) {
+        return Status(StatusCode::RUNTIME_ERROR, "the output pool of the session is not created");
+    }
+
+    outputs.resize(m_outputs.size());
+    for (size_t i = 0; i < m_outputs.size(); ++i) {
+        auto status = m_output_pool->acquire(m_output_pool_keys[i], outputs[i]);
+        if (!status.is_ok()) {
+            return status;
+        }
+    }
+
+    size_t bound = 0;
+    try {
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            try {
+                m_set_output_zero_copy(static_cast<int>(i), outputs[i].get());
+                m_output_pool_copies[i] = false;
+            } catch (const tvm::runtime::Error& e) {
+                // e.g. the output is an input of the graph, it is copied to the buffer after the run
+                m_output_pool_copies[i] = true;
+            }
+            bound = i + 1;
+        }
+
+        m_run();
+
+        // the buffers belong to the caller now, the executor writes the bound or its own buffers again
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            int index = static_cast<int>(i);
+            const tvm::runtime::NDArray& zero_copy = m_output_bindings[i].zero_copy;
+            if (m_output_pool_copies[i]) {
+                tvm::runtime::NDArray output = zero_copy.defined() ? zero_copy : m_get_output(index);
+                tvm::runtime::NDArray target = outputs[i].get();
+                target.CopyFrom(output);
+            } else {
+                m_set_output_zero_copy(index, zero_copy.defined() ? zero_copy : m_get_output(index));
+            }
+        }
+    } catch (const tvm::runtime::Error& e) {
+        // the caller releases the buffers on the failure, the executor must NOT keep writing them
+        for (size_t i = 0; i < bound; ++i) {
+            if (m_output_pool_copies[i]) {
+                continue;
+            }
+            int index = static_cast<int>(i);
+            const tvm::runtime::NDArray& zero_copy = m_output_bindings[i].zero_copy;
+            try {
+                m_set_output_zero_copy(index, zero_copy.defined() ? zero_copy : m_get_output(index));
+            } catch (const tvm::runtime::Error&) {
+            }
+        }
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status InferenceSession::get_output(const std::string& name, tvm::runtime::NDArray& data) const {
+    int index = 0;
+    auto status = get_output_index(name, index);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    return get_output(index, data);
+}
+
+Status InferenceSession::get_output(int index, tvm::runtime::NDArray& data) const {
+    auto status = check_output_index(index);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    if (m_output_bindings[index].zero_copy.defined()) {
+        data = m_output_bindings[index].zero_copy;
+        return Status::ok();
+    }
+
+    try {
+        data = m_get_output(index);
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status InferenceSession::set_input_zero_copy(int index, const tvm::runtime::NDArray& data) {
+    auto status = check_input_index(index);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    if (!data.defined()) {
+        return Status(StatusCode::INVALID_PARAM, "the data of " + m_inputs[index].name + " is undefined");
+    }
+
+    return bind_input(index, data.operator->(), data);
+}
+
+Status InferenceSession::set_input_zero_copy(int index, void* data) {
+    auto status = check_input_index(index);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    if (!data) {
+        return Status(StatusCode::INVALID_PARAM, "the data of " + m_inputs[index].name + " is null");
+    }
+
+    TensorInfo& info = m_inputs[index];
+    DLTensor tensor{data,   {kDLCPU, 0}, static_cast<int>(info.shape.size()), info.dtype, info.shape.data(),
+                    nullptr, 0};
+    tvm::runtime::NDArray external;
+    try {
+        if (is_zero_copy_compatible(&tensor)) {
+            external = tvm::runtime::NDArray::FromExternalDLTensor(tensor);
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return bind_input(index, &tensor, external);
+}
+
+Status InferenceSession::set_input_zero_copy(int index, DLManagedTensor* tensor) {
+    if (!tensor) {
+        return Status(StatusCode::INVALID_PARAM, "the DLPack tensor is null");
+    }
+
+    auto status = check_input_index(index);
+    if (!status.is_ok()) {
+        manage_dlpack(tensor);
+        return status;
+    }
+
+    if (is_dlpack_zero_copy_compatible(m_inputs[index], tensor)) {
+        tvm::runtime::NDArray external;
+        try {
+            // the NDArray calls the deleter when it is released
+            external = tvm::runtime::NDArray::FromDLPack(tensor);
+        } catch (const tvm::runtime::Error& e) {
+            return Status(StatusCode::RUNTIME_ERROR, e.what());
+        }
+        return bind_input(index, external.operator->(), external);
+    }
+
+    // the tensor is released after the copy
+    std::shared_ptr<DLManagedTensor> managed = manage_dlpack(tensor);
+    return bind_input(index, &tensor->dl_tensor, tvm::runtime::NDArray());
+}
+
+Status InferenceSession::set_output_zero_copy(int index, const tvm::runtime::NDArray& data) {
+    auto status = check_output_index(index);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    if (!data.defined()) {
+        return Status(StatusCode::INVALID_PARAM, "the data of " + m_outputs[index].name + " is undefined");
+    }
+
+    return bind_output(index, data.operator->(), data, nullptr);
+}
+
+Status InferenceSession::set_output_zero_copy(int index, void* data) {
+    auto status = check_output_index(index);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    if (!data) {
+        return Status(StatusCode::INVALID_PARAM, "the data of " + m_outputs[index].name + " is null");
+    }
+
+    // the shape points to the output info, so the copy target stays valid
+    TensorInfo& info = m_outputs[index];
+    DLTensor tensor{data,   {kDLCPU, 0}, static_cast<int>(info.shape.size()), info.dtype, info.shape.data(),
+                    nullptr, 0};
+    tvm::runtime::NDArray external;
+    try {
+        if (is_zero_copy_compatible(&tensor)) {
+            external = tvm::runtime::NDArray::FromExternalDLTensor(tensor);
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return bind_output(index, &tensor, external, nullptr);
+}
+
+Status InferenceSession::set_output_zero_copy(int index, DLManagedTensor* tensor) {
+    if (!tensor) {
+        return Status(StatusCode::INVALID_PARAM, "the DLPack tensor is null");
+    }
+
+    auto status = check_output_index(index);
+    if (!status.is_ok()) {
+        manage_dlpack(tensor);
+        return status;
+    }
+
+    if (is_dlpack_zero_copy_compatible(m_outputs[index], tensor)) {
+        tvm::runtime::NDArray external;
+        try {
+            external = tvm::runtime::NDArray::FromDLPack(tensor);
+        } catch (const tvm::runtime::Error& e) {
+            return Status(StatusCode::RUNTIME_ERROR, e.what());
+        }
+        return bind_output(index, external.operator->(), external, nullptr);
+    }
+
+    // the copy target keeps the tensor alive until the output is bound again
+    return bind_output(index, &tensor->dl_tensor, tvm::runtime::NDArray(), manage_dlpack(tensor));
+}
+
+Status InferenceSession::clear_zero_copy() {
+    if (!is_loaded()) {
+        return Status(StatusCode::RUNTIME_ERROR, "the inference session is not loaded");
+    }
+
+    try {
+        for (size_t i = 0; i < m_zero_copy_inputs.size(); ++i) {
+            if (m_zero_copy_inputs[i].defined()) {
+                int executor_index = m_executor_input_indices[i];
+                m_set_input_zero_copy(executor_index, m_get_input(executor_index));
+                m_zero_copy_inputs[i] = tvm::runtime::NDArray();
+            }
+        }
+
+        for (size_t i = 0; i < m_output_bindings.size(); ++i) {
+            if (m_output_bindings[i].zero_copy.defined()) {
+                int index = static_cast<int>(i);
+                m_set_output_zero_copy(index, m_get_output(index));
+            }
+            m_output_bindings[i] = OutputBinding();
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status InferenceSession::check_input_index(int index) const {
+    if (!is_loaded()) {
+        return Status(StatusCode::RUNTIME_ERROR, "the inference session is not loaded");
+    }
+
+    if (index < 0 || index >= static_cast<int>(m_inputs.size())) {
+        return Status(StatusCode::INVALID_PARAM, "input index out of range: " + std::to_string(index));
+    }
+
+    return Status::ok();
+}
+
+Status InferenceSession::check_output_index(int index) const {
+    if (!is_loaded()) {
+        return Status(StatusCode::RUNTIME_ERROR, "the inference session is not loaded");
+    }
+
+    if (index < 0 || index >= static_cast<int>(m_outputs.size())) {
+        return Status(StatusCode::INVALID_PARAM, "output index out of range: " + std::to_string(index));
+    }
+
+    return Status::ok();
+}
+
+Status InferenceSession::bind_input(int index, const DLTensor* tensor, const tvm::runtime::NDArray& external) {
+    auto status = validate_tensor(m_inputs[index], tensor);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    int executor_index = m_executor_input_indices[index];
+    try {
+        if (external.defined() && is_zero_copy_compatible(tensor)) {
+            try {
+                m_set_input_zero_copy(executor_index, external);
+                m_zero_copy_inputs[index] = external;
+                ++m_zero_copy_stats.zero_copy_inputs;
+                return Status::ok();
+            } catch (const tvm::runtime::Error& e) {
+                // the executor rejects the buffer, it is copied below
+            }
+        }
+
+        tvm::runtime::NDArray owned = m_get_input(executor_index);
+        owned.CopyFrom(tensor);
+        if (m_zero_copy_inputs[index].defined()) {
+            m_set_input_zero_copy(executor_index, owned);
+            m_zero_copy_inputs[index] = tvm::runtime::NDArray();
+        }
+        ++m_zero_copy_stats.copied_inputs;
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status InferenceSession::bind_output(int index, const DLTensor* tensor, const tvm::runtime::NDArray& external,
+                                     const std::shared_ptr<DLManagedTensor>& managed) {
+    auto status = validate_tensor(m_outputs[index], tensor);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    OutputBinding binding;
+    try {
+        if (external.defined() && is_zero_copy_compatible(tensor)) {
+            try {
+                m_set_output_zero_copy(index, external);
+                binding.zero_copy = external;
+                m_output_bindings[index] = binding;
+                ++m_zero_copy_stats.zero_copy_outputs;
+                return Status::ok();
+            } catch (const tvm::runtime::Error& e) {
+                // e.g. the output is an input of the graph, it is copied after each run
+            }
+        }
+
+        if (m_output_bindings[index].zero_copy.defined()) {
+            m_set_output_zero_copy(index, m_get_output(index));
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    binding.copy = true;
+    binding.copy_target = *tensor;
+    binding.copy_array = external;
+    binding.copy_managed = managed;
+    m_output_bindings[index] = binding;
+    ++m_zero_copy_stats.copied_outputs;
+    return Status::ok();
+}
+
+}    // namespace serving
+}    // namespace tvm_cpp
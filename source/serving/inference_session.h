@@ -0,0 +1,368 @@
+#ifndef _H_TVM_CPP_SERVING_INFERENCE_SESSION_H_
+#define _H_TVM_CPP_SERVING_INFERENCE_SESSION_H_
+
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "serving/executor_factory.h"
+#include "serving/tensor_pool.h"
+#include "utils/sample_utils.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace serving {
+
+/**
+ * @brief The name, shape and dtype of an input or output of the model
+ *
+ */
+struct TensorInfo {
+    std::string name;
+    std::vector<int64_t> shape;
+    tvm::DataType dtype;
+
+    /**
+     * @brief Get the size of the tensor in bytes
+     *
+     * @return size_t
+     */
+    size_t bytes() const;
+};
+
+/**
+ * @brief The bindings of the caller-owned buffers since the session is loaded
+ *
+ */
+struct ZeroCopyStats {
+    // the inputs and outputs bound to the executor without copy
+    int64_t zero_copy_inputs{0};
+    int64_t zero_copy_outputs{0};
+    // the inputs and outputs copied because the buffer is not aligned, not compact or not on CPU
+    int64_t copied_inputs{0};
+    int64_t copied_outputs{0};
+};
+
+/**
+ * @brief The name of the i-th output, the graph json keeps no output names
+ *
+ * @param index the output index
+ * @return std::string e.g. "output_0"
+ */
+std::string get_output_name(int index);
+
+/**
+ * @brief The inference session of an exported graph executor artifact. The graph executor is created once by `load`,
+ * the inputs and outputs are resolved from the graph json at load time, so a call only compares the shapes and calls
+ * the cached executor functions. A session is not thread-safe, use one session per thread
+ *
+ */
+class InferenceSession final {
+public:
+    InferenceSession() = default;
+    InferenceSession(const InferenceSession&) = delete;
+    InferenceSession& operator=(const InferenceSession&) = delete;
+
+    /**
+     * @brief Load the artifact exported by `export_model_artifact` with the graph executor and create the executor
+     *
+     * @param artifact_dir the artifact directory
+     * @return Status
+     */
+    Status load(const std::string& artifact_dir);
+
+    /**
+     * @brief Create the executor by the factory, the params are shared with the other sessions of the factory
+     *
+     * @param factory the loaded executor factory
+     * @return Status
+     */
+    Status load(const ExecutorFactory& factory);
+
+    /**
+     * @brief Whether the session is loaded
+     *
+     */
+    bool is_loaded() const { return m_executor.defined(); }
+
+    /**
+     * @brief The inputs of the model, the params are not listed
+     *
+     */
+    const std::vector<TensorInfo>& get_inputs() const { return m_inputs; }
+
+    /**
+     * @brief The outputs of the model, named by `get_output_name`
+     *
+     */
+    const std::vector<TensorInfo>& get_outputs() const { return m_outputs; }
+
+    /**
+     * @brief Get the index of the named input
+     *
+     * @param name the input name
+     * @param index output parameter. the index in `get_inputs()`
+     * @return Status
+     */
+    Status get_input_index(const std::string& name, int& index) const;
+
+    /**
+     * @brief Get the index of the named output
+     *
+     * @param name the output name
+     * @param index output parameter. the index in `get_outputs()`
+     * @return Status
+     */
+    Status get_output_index(const std::string& name, int& index) const;
+
+    /**
+     * @brief Copy the data to the named input of the executor
+     *
+     * @param name the input name
+     * @param data the data whose shape and dtype must match the input
+     * @return Status
+     */
+    Status set_input(const std::string& name, const tvm::runtime::NDArray& data);
+
+    /**
+     * @brief Copy the data to the i-th input of the executor, it skips the name lookup of the named version
+     *
+     * @param index the index in `get_inputs()`
+     * @param data the data whose shape and dtype must match the input
+     * @return Status
+     */
+    Status set_input(int index, const tvm::runtime::NDArray& data);
+
+    /**
+     * @brief Set all the inputs of the map
+     *
+     * @param inputs the input tensors by name
+     * @return Status
+     */
+    Status set_inputs(const sample_utils::TensorMap& inputs);
+
+    /**
+     * @brief Run the model with the inputs which are set
+     *
+     * @return Status
+     */
+    Status run();
+
+    /**
+     * @brief Create the output pool of the session, see `run(std::vector<PooledTensor>&)`
+     *
+     * @param max_buffers the cap of the pooled buffers of each output shape and dtype, e.g. the max number of the
+     * responses in flight
+     * @return Status
+     */
+    Status create_output_pool(int max_buffers);
+
+    /**
+     * @brief The output pool, null if it is not created
+     *
+     */
+    const std::shared_ptr<TensorPool>& get_output_pool() const { return m_output_pool; }
+
+    /**
+     * @brief Run the model and write the outputs directly to the buffers acquired from the output pool. The buffers
+     * return to the pool when the caller releases them, so the steady state does not allocate. The output bindings
+     * are not used by this run and are restored after it
+     *
+     * @param outputs output parameter. the outputs in the order of `get_outputs()`
+     * @return Status
+     */
+    Status run(std::vector<PooledTensor>& outputs);
+
+    /**
+     * @brief Get the named output of the last run
+     *
+     * @param name the output name
+     * @param data output parameter. the output of the executor, it is not copied and is overwritten by the next run
+     * @return Status
+     */
+    Status get_output(const std::string& name, tvm::runtime::NDArray& data) const;
+
+    /**
+     * @brief Get the i-th output of the last run
+     *
+     * @param index the index in `get_outputs()`
+     * @param data output parameter. the output of the executor, it is not copied and is overwritten by the next run
+     * @return Status
+     */
+    Status get_output(int index, tvm::runtime::NDArray& data) const;
+
+    /**
+     * @brief Bind the caller-owned data to the i-th input without copy, the executor reads it directly in each `run`
+     * until the input is set again. The data must stay valid and unchanged during `run`. If the data is not aligned to
+     * `tvm::runtime::kAllocAlignment`, not compact or not on CPU, it is copied once by this call instead
+     *
+     * @param index the index in `get_inputs()`
+     * @param data the data whose shape and dtype must match the input
+     * @return Status
+     */
+    Status set_input_zero_copy(int index, const tvm::runtime::NDArray& data);
+
+    /**
+     * @brief Bind a raw CPU buffer with the shape and the dtype of the i-th input, see the NDArray version
+     *
+     * @param index the index in `get_inputs()`
+     * @param data the buffer of `get_inputs()[index].bytes()` bytes
+     * @return Status
+     */
+    Status set_input_zero_copy(int index, void* data);
+
+    /**
+     * @brief Bind a DLPack tensor to the i-th input, see the NDArray version. The session takes the ownership of the
+     * tensor, its deleter is called when the tensor is released
+     *
+     * @param index the index in `get_inputs()`
+     * @param tensor the DLPack tensor whose shape and dtype must match the input
+     * @return Status
+     */
+    Status set_input_zero_copy(int index, DLManagedTensor* tensor);
+
+    /**
+     * @brief Bind the caller-owned data to the i-th output without copy, the executor writes it directly in each `run`
+     * and `get_output` returns it. It falls back to copy the output to the data after each `run` if the data is not
+     * aligned, not compact or not on CPU
+     *
+     * @param index the index in `get_outputs()`
+     * @param data the data whose shape and dtype must match the output
+     * @return Status
+     */
+    Status set_output_zero_copy(int index, const tvm::runtime::NDArray& data);
+
+    /**
+     * @brief Bind a raw CPU buffer with the shape and the dtype of the i-th output, see the NDArray version
+     *
+     * @param index the index in `get_outputs()`
+     * @param data the buffer of `get_outputs()[index].bytes()` bytes
+     * @return Status
+     */
+    Status set_output_zero_copy(int index, void* data);
+
+    /**
+     * @brief Bind a DLPack tensor to the i-th output, see the NDArray version. The session takes the ownership of the
+     * tensor
+     *
+     * @param index the index in `get_outputs()`
+     * @param tensor the DLPack tensor whose shape and dtype must match the output
+     * @return Status
+     */
+    Status set_output_zero_copy(int index, DLManagedTensor* tensor);
+
+    /**
+     * @brief Bind the executor-owned buffers again and release the caller-owned ones
+     *
+     * @return Status
+     */
+    Status clear_zero_copy();
+
+    /**
+     * @brief The statistics of the zero-copy bindings
+     *
+     */
+    const ZeroCopyStats& get_zero_copy_stats() const { return m_zero_copy_stats; }
+
+    /**
+     * @brief The graph executor module, valid after `load`
+     *
+     */
+    tvm::runtime::Module& get_executor() { return m_executor; }
+
+private:
+    /**
+     * @brief The caller-owned buffer of an output
+     *
+     */
+    struct OutputBinding {
+        // the buffer written by the executor, undefined if the output is not bound or is copied
+        tvm::runtime::NDArray zero_copy;
+        // the buffer which the output is copied to after each run, it is not suitable for zero-copy
+        bool copy{false};
+        DLTensor copy_target{};
+        // keep the owner of the copy target alive, an NDArray or a DLPack tensor
+        tvm::runtime::NDArray copy_array;
+        std::shared_ptr<DLManagedTensor> copy_managed;
+    };
+
+    Status check_input_index(int index) const;
+    Status check_output_index(int index) const;
+    Status bind_input(int index, const DLTensor* tensor, const tvm::runtime::NDArray& external);
+    Status bind_output(int index, const DLTensor* tensor, const tvm::runtime::NDArray& external,
+                       const std::shared_ptr<DLManagedTensor>& managed);
+
+    tvm::runtime::Module m_executor;
+    tvm::runtime::PackedFunc m_set_input;
+    tvm::runtime::PackedFunc m_run;
+    tvm::runtime::PackedFunc m_get_output;
+    tvm::runtime::PackedFunc m_get_input;
+    tvm::runtime::PackedFunc m_set_input_zero_copy;
+    tvm::runtime::PackedFunc m_set_output_zero_copy;
+
+    std::vector<TensorInfo> m_inputs;
+    std::vector<TensorInfo> m_outputs;
+    // the input indices of the graph executor, the params are inputs of the graph executor too
+    std::vector<int> m_executor_input_indices;
+    std::unordered_map<std::string, int> m_input_indices;
+    std::unordered_map<std::string, int> m_output_indices;
+
+    // the caller-owned inputs bound without copy, undefined if the executor-owned buffer is used
+    std::vector<tvm::runtime::NDArray> m_zero_copy_inputs;
+    std::vector<OutputBinding> m_output_bindings;
+    ZeroCopyStats m_zero_copy_stats;
+
+    std::shared_ptr<TensorPool> m_output_pool;
+    // the pool key of each output
+    std::vector<int> m_output_pool_keys;
+    // whether the executor rejects the pooled buffer of each output, the output is copied to it instead
+    std::vector<bool> m_output_pool_copies;
+};
+
+/**
+ * @brief Check whether the data matches the shape and the dtype of the tensor info
+ *
+ * @param info the expected tensor
+ * @param data the data
+ * @return Status
+ */
+Status validate_tensor(const TensorInfo& info, const tvm::runtime::NDArray& data);
+
+/**
+ * @brief Check whether the DLTensor matches the shape and the dtype of the tensor info
+ *
+ * @param info the expected tensor
+ * @param tensor the DLTensor
+ * @return Status
+ */
+Status validate_tensor(const TensorInfo& info, const DLTensor* tensor);
+
+/**
+ * @brief Whether the DLTensor can be bound to the CPU executor without copy, i.e. it is on CPU, compact and its data
+ * is aligned to `tvm::runtime::kAllocAlignment`
+ *
+ * @param tensor the DLTensor
+ * @return true
+ * @return false
+ */
+bool is_zero_copy_compatible(const DLTensor* tensor);
+
+/**
+ * @brief Whether the DLTensor is compact row-major, i.e. it has no strides or the strides of a compact tensor
+ *
+ * @param tensor the DLTensor
+ * @return true
+ * @return false
+ */
+bool is_compact(const DLTensor* tensor);
+
+}    // namespace serving
+}    // namespace tvm_cpp
+
+#endif
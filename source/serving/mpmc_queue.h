@@ -0,0 +1,128 @@
+#ifndef _H_TVM_CPP_SERVING_MPMC_QUEUE_H_
+#define _H_TVM_CPP_SERVING_MPMC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace tvm_cpp {
+namespace serving {
+
+/**
+ * @brief The bounded lock-free multi-producer multi-consumer queue of D. Vyukov. Each cell has a sequence number, a
+ * producer claims the cell at the enqueue position by a CAS when the sequence equals the position, and publishes the
+ * value by bumping the sequence, a consumer does the same at the dequeue position. Neither side blocks, a full or
+ * empty queue fails the call
+ *
+ * @tparam T the value type, it must be default constructible and movable
+ */
+template <typename T>
+class MpmcQueue final {
+public:
+    /**
+     * @brief Create the queue
+     *
+     * @param capacity the max values in the queue, rounded up to a power of 2
+     */
+    explicit MpmcQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+
+        m_mask = size - 1;
+        m_cells = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /**
+     * @brief Push the value, it is not moved if the queue is full
+     *
+     * @return true
+     * @return false if the queue is full
+     */
+    bool try_push(T&& value) {
+        Cell* cell = nullptr;
+        size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // the cell still holds the value of the previous lap
+                return false;
+            } else {
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop the oldest value
+     *
+     * @param value output parameter. the value
+     * @return true
+     * @return false if the queue is empty
+     */
+    bool try_pop(T& value) {
+        Cell* cell = nullptr;
+        size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // the value of the cell is not published yet
+                return false;
+            } else {
+                pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(cell->value);
+        cell->value = T();
+        // the cell is free for the producer of the next lap
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return m_mask + 1; }
+
+private:
+    static constexpr size_t kCacheLineSize = 64;
+
+    struct alignas(kCacheLineSize) Cell {
+        std::atomic<size_t> sequence{0};
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask{0};
+    // the positions are on their own cache lines, the producers and the consumers do not share them
+    alignas(kCacheLineSize) std::atomic<size_t> m_enqueue_pos{0};
+    alignas(kCacheLineSize) std::atomic<size_t> m_dequeue_pos{0};
+};
+
+}    // namespace serving
+}    // namespace tvm_cpp
+
+#endif
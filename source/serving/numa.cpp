@@ -0,0 +1,209 @@
+#include "numa.h"
+
+#include <dlpack/dlpack.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+
+#include "serving/thread_config.h"
+
+namespace tvm_cpp {
+namespace serving {
+
+namespace {
+
+// the memory policies of <numaif.h>, the syscalls are called directly so libnuma is not required
+constexpr int kMpolDefault = 0;
+constexpr int kMpolPreferred = 1;
+constexpr int kMpolBind = 2;
+constexpr unsigned kMpolMfMove = 1 << 1;
+// the bits of the node masks
+constexpr int kMaxNumaNodes = 1024;
+constexpr int kBitsPerMask = 8 * sizeof(unsigned long);
+
+struct NodeMask {
+    unsigned long bits[kMaxNumaNodes / kBitsPerMask]{};
+};
+
+Status get_node_mask(int node, NodeMask& mask) {
+    if (node < 0 || node >= kMaxNumaNodes) {
+        return Status(StatusCode::INVALID_PARAM, "invalid NUMA node " + std::to_string(node));
+    }
+    mask = NodeMask();
+    mask.bits[node / kBitsPerMask] = 1UL << (node % kBitsPerMask);
+    return Status::ok();
+}
+
+/**
+ * @brief The memory of an NDArray allocated by `empty_on_numa_node`, it is unmapped by the DLPack deleter
+ *
+ */
+struct NumaAllocation {
+    DLManagedTensor managed;
+    std::vector<int64_t> shape;
+    size_t mapped_bytes{0};
+};
+
+void delete_numa_allocation(DLManagedTensor* managed) {
+    auto* allocation = static_cast<NumaAllocation*>(managed->manager_ctx);
+    munmap(allocation->managed.dl_tensor.data, allocation->mapped_bytes);
+    delete allocation;
+}
+
+}    // namespace
+
+Status get_numa_nodes(std::vector<NumaNode>& nodes) {
+    nodes.clear();
+    std::error_code ec;
+    std::filesystem::directory_iterator iter("/sys/devices/system/node", ec);
+    if (!ec) {
+        for (const auto& entry : iter) {
+            std::string name = entry.path().filename().string();
+            if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+                name.find_first_not_of("0123456789", 4) != std::string::npos) {
+                continue;
+            }
+
+            NumaNode node;
+            node.id = std::stoi(name.substr(4));
+            std::ifstream ifs(entry.path() / "cpulist");
+            std::string cpulist;
+            if (std::getline(ifs, cpulist) && !cpulist.empty()) {
+                auto status = parse_core_list(cpulist, node.cores);
+                if (!status.is_ok()) {
+                    return status;
+                }
+            }
+            nodes.emplace_back(std::move(node));
+        }
+    }
+
+    if (nodes.empty()) {
+        NumaNode node;
+        for (unsigned core = 0; core < std::thread::hardware_concurrency(); ++core) {
+            node.cores.push_back(static_cast<int>(core));
+        }
+        nodes.emplace_back(std::move(node));
+    }
+
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+    return Status::ok();
+}
+
+Status find_numa_node(const std::vector<NumaNode>& nodes, const std::vector<int>& cores, int& node) {
+    std::map<int, int> local_cores;
+    for (const auto& numa_node : nodes) {
+        for (int core : cores) {
+            if (std::find(numa_node.cores.begin(), numa_node.cores.end(), core) != numa_node.cores.end()) {
+                ++local_cores[numa_node.id];
+            }
+        }
+    }
+
+    if (local_cores.empty()) {
+        return Status(StatusCode::INVALID_PARAM, "the cores are not on any NUMA node");
+    }
+
+    auto iter = std::max_element(local_cores.begin(), local_cores.end(),
+                                 [](const std::pair<const int, int>& a, const std::pair<const int, int>& b) {
+                                     return a.second < b.second;
+                                 });
+    node = iter->first;
+    return Status::ok();
+}
+
+Status empty_on_numa_node(const std::vector<int64_t>& shape, tvm::DataType dtype, int node,
+                          tvm::runtime::NDArray& array) {
+    NodeMask mask;
+    auto status = get_node_mask(node, mask);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    size_t bytes = (dtype.bits() * dtype.lanes() + 7) / 8;
+    for (int64_t dim : shape) {
+        bytes *= static_cast<size_t>(dim);
+    }
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t mapped_bytes = std::max<size_t>((bytes + page_size - 1) / page_size, 1) * page_size;
+
+    void* data = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+        return Status(StatusCode::OUT_OF_MEMORY, "mmap of " + std::to_string(mapped_bytes) + " bytes failed");
+    }
+
+    // the kernel reads maxnode - 1 bits of the mask
+    if (syscall(SYS_mbind, data, mapped_bytes, kMpolBind, mask.bits, kMaxNumaNodes + 1, kMpolMfMove) != 0) {
+        int error = errno;
+        munmap(data, mapped_bytes);
+        return Status(StatusCode::RUNTIME_ERROR, std::string("mbind failed: ") + std::strerror(error));
+    }
+
+    auto* allocation = new NumaAllocation();
+    allocation->shape = shape;
+    allocation->mapped_bytes = mapped_bytes;
+    DLTensor& tensor = allocation->managed.dl_tensor;
+    tensor.data = data;
+    tensor.device = {kDLCPU, 0};
+    tensor.ndim = static_cast<int32_t>(shape.size());
+    tensor.dtype = dtype;
+    tensor.shape = allocation->shape.data();
+    tensor.strides = nullptr;
+    tensor.byte_offset = 0;
+    allocation->managed.manager_ctx = allocation;
+    allocation->managed.deleter = delete_numa_allocation;
+
+    array = tvm::runtime::NDArray::FromDLPack(&allocation->managed);
+    return Status::ok();
+}
+
+Status bind_thread_memory(int node) {
+    long ret = 0;
+    if (node < 0) {
+        ret = syscall(SYS_set_mempolicy, kMpolDefault, nullptr, 0);
+    } else {
+        NodeMask mask;
+        auto status = get_node_mask(node, mask);
+        if (!status.is_ok()) {
+            return status;
+        }
+        // preferred rather than bound, a full node falls back to the others instead of failing the allocation
+        ret = syscall(SYS_set_mempolicy, kMpolPreferred, mask.bits, kMaxNumaNodes + 1);
+    }
+
+    if (ret != 0) {
+        return Status(StatusCode::THREAD_ERROR, std::string("set_mempolicy failed: ") + std::strerror(errno));
+    }
+    return Status::ok();
+}
+
+Status get_memory_numa_node(const void* address, int& node) {
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    void* page = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(address) & ~(page_size - 1));
+    int page_status = 0;
+    // without the target nodes, move_pages only reports the node of each page
+    if (syscall(SYS_move_pages, 0, 1UL, &page, nullptr, &page_status, 0) != 0) {
+        return Status(StatusCode::RUNTIME_ERROR, std::string("move_pages failed: ") + std::strerror(errno));
+    }
+
+    if (page_status == -ENOENT) {
+        node = -1;
+    } else if (page_status < 0) {
+        return Status(StatusCode::RUNTIME_ERROR, std::string("move_pages failed: ") + std::strerror(-page_status));
+    } else {
+        node = page_status;
+    }
+    return Status::ok();
+}
+
+}    // namespace serving
+}    // namespace tvm_cpp
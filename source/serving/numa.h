@@ -0,0 +1,77 @@
+#ifndef _H_TVM_CPP_SERVING_NUMA_H_
+#define _H_TVM_CPP_SERVING_NUMA_H_
+
+#include <tvm/runtime/data_type.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace serving {
+
+/**
+ * @brief A NUMA node and its cores
+ *
+ */
+struct NumaNode {
+    int id{0};
+    // empty for a node with memory only
+    std::vector<int> cores;
+};
+
+/**
+ * @brief Get the NUMA nodes of the host from sysfs, a host without NUMA has a single node 0 with all the cores
+ *
+ * @param nodes output parameter. the nodes in the order of the ids
+ * @return Status
+ */
+Status get_numa_nodes(std::vector<NumaNode>& nodes);
+
+/**
+ * @brief Find the NUMA node local to the cores, the node with the most of them if they span several nodes
+ *
+ * @param nodes the NUMA nodes
+ * @param cores the cores, e.g. the cores of a thread config
+ * @param node output parameter. the node id
+ * @return Status
+ */
+Status find_numa_node(const std::vector<NumaNode>& nodes, const std::vector<int>& cores, int& node);
+
+/**
+ * @brief Allocate an NDArray on CPU whose pages are bound to the memory of a NUMA node. The memory is mapped apart
+ * from the heap, so the binding holds whichever thread touches it first
+ *
+ * @param shape the shape
+ * @param dtype the data type
+ * @param node the NUMA node id
+ * @param array output parameter. the array, it is not initialized
+ * @return Status
+ */
+Status empty_on_numa_node(const std::vector<int64_t>& shape, tvm::DataType dtype, int node,
+                          tvm::runtime::NDArray& array);
+
+/**
+ * @brief Set the memory policy of the calling thread, the pages it touches first are allocated on the node, or on
+ * another one if the node is out of memory. The threads created later by the thread inherit the policy
+ *
+ * @param node the NUMA node id, -1 restores the default policy of the local node
+ * @return Status
+ */
+Status bind_thread_memory(int node);
+
+/**
+ * @brief Get the NUMA node of the page at the address
+ *
+ * @param address the address
+ * @param node output parameter. the node id, -1 if the page is not allocated yet
+ * @return Status
+ */
+Status get_memory_numa_node(const void* address, int& node);
+
+}    // namespace serving
+}    // namespace tvm_cpp
+
+#endif
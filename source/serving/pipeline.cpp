@@ -0,0 +1,817 @@
+#include "pipeline.h"
+
+#include <picojson.h>
+#include <tvm/ir/expr.h>
+#include <tvm/ir/op.h>
+#include <tvm/relay/expr.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/runtime/registry.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "compiler/artifact_cache.h"
+#include "compiler/model_artifact.h"
+#include "compiler/model_builder.h"
+
+namespace tvm_cpp {
+namespace serving {
+
+namespace {
+
+// the name prefix of the tensors passed between the stages, followed by the position of the node
+constexpr const char* kBoundaryPrefix = "pipeline_tensor_";
+constexpr const char* kManifestName = "pipeline.json";
+// the bounds of the time histograms in microseconds
+constexpr int64_t kMinTimeBoundUs = 1;
+constexpr int64_t kMaxTimeBoundUs = 10 * 1000 * 1000;
+
+int64_t elapsed_us(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+/**
+ * @brief Get the size of a tensor type, false if it is not a tensor of static shape
+ *
+ */
+bool get_static_tensor_bytes(const tvm::Type& type, int64_t& bytes) {
+    const auto* tensor_type = type.as<tvm::relay::TensorTypeNode>();
+    if (!tensor_type) {
+        return false;
+    }
+
+    bytes = (tensor_type->dtype.bits() * tensor_type->dtype.lanes() + 7) / 8;
+    for (const auto& dim : tensor_type->shape) {
+        const auto* value = dim.as<tvm::IntImmNode>();
+        if (!value) {
+            return false;
+        }
+        bytes *= value->value;
+    }
+    return true;
+}
+
+/**
+ * @brief A computed node of the main function
+ *
+ */
+struct GraphNode {
+    tvm::relay::Expr expr;
+    // the position of the last node which uses it, the root is used after the last position
+    int last_use{-1};
+    bool passable{false};
+    int64_t bytes{0};
+};
+
+/**
+ * @brief The calls, tuples and tuple items of the main function in post order, a topological order of the dataflow
+ *
+ */
+struct DataflowGraph {
+    std::vector<GraphNode> nodes;
+    std::unordered_map<const tvm::runtime::Object*, int> positions;
+    // the positions of the op calls, the cuts are after them
+    std::vector<int> call_positions;
+    // the tensors computed up to a position and used after it, and those which can not be passed
+    std::vector<int> live_tensors;
+    std::vector<int> live_unpassable;
+    std::vector<int64_t> live_bytes;
+};
+
+Status build_dataflow_graph(const tvm::IRModule& module, DataflowGraph& graph) {
+    // type infer
+    const tvm::runtime::PackedFunc* type_infer = tvm::runtime::Registry::Get("relay._transform.InferType");
+    if (!type_infer) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._transform.InferType expression not found");
+    }
+
+    // pass run
+    const tvm::runtime::PackedFunc* pass_run = tvm::runtime::Registry::Get("transform.RunPass");
+    if (!pass_run) {
+        return Status(StatusCode::RUNTIME_ERROR, "transform.pass_run expression not found");
+    }
+
+    if (!module->ContainGlobalVar("main")) {
+        return Status(StatusCode::INVALID_PARAM, "main function not found in the module");
+    }
+
+    tvm::IRModule typed_module;
+    try {
+        typed_module = (*pass_run)((*type_infer)(), module);
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    const auto* main_func = typed_module->Lookup("main").as<tvm::relay::FunctionNode>();
+    if (!main_func) {
+        return Status(StatusCode::INVALID_PARAM, "the module has no relay main function");
+    }
+
+    graph = DataflowGraph();
+    bool dataflow = true;
+    tvm::relay::PostOrderVisit(main_func->body, [&](const tvm::relay::Expr& expr) {
+        if (expr.as<tvm::relay::FunctionNode>() || expr.as<tvm::relay::LetNode>() || expr.as<tvm::relay::IfNode>()) {
+            dataflow = false;
+            return;
+        }
+
+        int position = static_cast<int>(graph.nodes.size());
+        // the operands are visited before the node, so they have their positions
+        auto use = [&](const tvm::relay::Expr& operand) {
+            auto iter = graph.positions.find(operand.get());
+            if (iter != graph.positions.end()) {
+                graph.nodes[iter->second].last_use = position;
+            }
+        };
+
+        if (const auto* call = expr.as<tvm::relay::CallNode>()) {
+            for (const auto& arg : call->args) {
+                use(arg);
+            }
+            if (call->op.as<tvm::OpNode>()) {
+                graph.call_positions.push_back(position);
+            }
+        } else if (const auto* tuple = expr.as<tvm::relay::TupleNode>()) {
+            for (const auto& field : tuple->fields) {
+                use(field);
+            }
+        } else if (const auto* item = expr.as<tvm::relay::TupleGetItemNode>()) {
+            use(item->tuple);
+        } else {
+            // the vars, constants and ops stay in every stage which uses them
+            return;
+        }
+
+        GraphNode node;
+        node.expr = expr;
+        node.passable = get_static_tensor_bytes(expr->checked_type(), node.bytes);
+        graph.positions[expr.get()] = position;
+        graph.nodes.emplace_back(std::move(node));
+    });
+
+    if (!dataflow) {
+        return Status(StatusCode::INVALID_PARAM, "the pipeline split supports the dataflow graphs of calls and tuples");
+    }
+
+    auto root = graph.positions.find(main_func->body.get());
+    if (root == graph.positions.end()) {
+        return Status(StatusCode::INVALID_PARAM, "the main function computes nothing to split");
+    }
+
+    // the nodes live across the cut after position b are computed at or before b and used after it
+    int size = static_cast<int>(graph.nodes.size());
+    graph.nodes[root->second].last_use = size;
+    std::vector<int> tensors(size + 1, 0);
+    std::vector<int> unpassable(size + 1, 0);
+    std::vector<int64_t> bytes(size + 1, 0);
+    for (int p = 0; p < size; ++p) {
+        const GraphNode& node = graph.nodes[p];
+        if (node.last_use <= p) {
+            continue;
+        }
+        tensors[p] += 1;
+        tensors[node.last_use] -= 1;
+        unpassable[p] += node.passable ? 0 : 1;
+        unpassable[node.last_use] -= node.passable ? 0 : 1;
+        bytes[p] += node.bytes;
+        bytes[node.last_use] -= node.bytes;
+    }
+
+    graph.live_tensors.assign(size, 0);
+    graph.live_unpassable.assign(size, 0);
+    graph.live_bytes.assign(size, 0);
+    for (int b = 0; b < size; ++b) {
+        graph.live_tensors[b] = (b > 0 ? graph.live_tensors[b - 1] : 0) + tensors[b];
+        graph.live_unpassable[b] = (b > 0 ? graph.live_unpassable[b - 1] : 0) + unpassable[b];
+        graph.live_bytes[b] = (b > 0 ? graph.live_bytes[b - 1] : 0) + bytes[b];
+    }
+
+    return Status::ok();
+}
+
+/**
+ * @brief Whether the main function can be cut after the position, the root is always in the last stage
+ *
+ */
+bool is_valid_cut(const DataflowGraph& graph, int position) {
+    return position < static_cast<int>(graph.nodes.size()) - 1 && graph.live_unpassable[position] == 0;
+}
+
+/**
+ * @brief Rebuild the nodes of a stage, the nodes of the earlier stages become the params of the stage named by their
+ * positions
+ *
+ */
+class StageBuilder : public tvm::relay::ExprMutator {
+public:
+    StageBuilder(const DataflowGraph& graph, int begin, const tvm::runtime::PackedFunc* var_gen)
+        : m_graph(graph), m_begin(begin), m_var_gen(var_gen) {}
+    virtual ~StageBuilder() = default;
+
+    tvm::relay::Expr VisitExpr(const tvm::relay::Expr& expr) override {
+        auto iter = m_graph.positions.find(expr.get());
+        if (iter == m_graph.positions.end() || iter->second > m_begin) {
+            return tvm::relay::ExprMutator::VisitExpr(expr);
+        }
+
+        // computed by an earlier stage
+        auto var_iter = m_boundary_vars.find(iter->second);
+        if (var_iter != m_boundary_vars.end()) {
+            return var_iter->second;
+        }
+        tvm::relay::Var var =
+            (*m_var_gen)(kBoundaryPrefix + std::to_string(iter->second), expr->checked_type(), tvm::relay::Span());
+        m_boundary_vars.emplace(iter->second, var);
+        m_params.push_back(var);
+        return var;
+    }
+
+    tvm::relay::Expr VisitExpr_(const tvm::relay::VarNode* var) override {
+        tvm::relay::Var graph_var = tvm::runtime::GetRef<tvm::relay::Var>(var);
+        if (m_graph_vars.insert(var).second) {
+            m_params.push_back(graph_var);
+        }
+        return graph_var;
+    }
+
+    const tvm::runtime::Array<tvm::relay::Var>& params() const { return m_params; }
+
+private:
+    const DataflowGraph& m_graph;
+    int m_begin;
+    const tvm::runtime::PackedFunc* m_var_gen;
+    std::unordered_map<int, tvm::relay::Var> m_boundary_vars;
+    std::unordered_set<const tvm::relay::VarNode*> m_graph_vars;
+    tvm::runtime::Array<tvm::relay::Var> m_params;
+};
+
+/**
+ * @brief Export the artifact to a temporary directory first like the artifact cache, a partial one is never loaded
+ *
+ */
+Status export_stage_artifact(const compiler::BuildResult& result, const std::string& artifact_dir) {
+    std::string tmp_dir = artifact_dir + ".tmp." + std::to_string(getpid());
+    std::error_code ec;
+    std::filesystem::remove_all(tmp_dir, ec);
+    auto status = compiler::export_model_artifact(result, tmp_dir);
+    if (!status.is_ok()) {
+        std::filesystem::remove_all(tmp_dir, ec);
+        return status;
+    }
+
+    std::filesystem::rename(tmp_dir, artifact_dir, ec);
+    if (ec) {
+        std::filesystem::remove_all(tmp_dir, ec);
+        if (!compiler::has_cached_artifact(artifact_dir)) {
+            return Status(StatusCode::RUNTIME_ERROR, "Move the stage artifact failed: " + artifact_dir);
+        }
+    }
+    return Status::ok();
+}
+
+}    // namespace
+
+Status get_pipeline_cuts(const tvm::IRModule& module, std::vector<PipelineCut>& cuts) {
+    DataflowGraph graph;
+    auto status = build_dataflow_graph(module, graph);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    cuts.clear();
+    for (size_t i = 0; i < graph.call_positions.size(); ++i) {
+        int position = graph.call_positions[i];
+        if (!is_valid_cut(graph, position)) {
+            continue;
+        }
+
+        PipelineCut cut;
+        cut.call_index = static_cast<int>(i);
+        cut.op_name = graph.nodes[position].expr.as<tvm::relay::CallNode>()->op.as<tvm::OpNode>()->name;
+        cut.live_tensors = graph.live_tensors[position];
+        cut.live_bytes = graph.live_bytes[position];
+        cuts.emplace_back(std::move(cut));
+    }
+
+    return Status::ok();
+}
+
+Status choose_pipeline_cuts(const tvm::IRModule& module, int stages, std::vector<int>& call_indices) {
+    if (stages < 1) {
+        return Status(StatusCode::INVALID_PARAM, "the pipeline requires at least one stage");
+    }
+
+    DataflowGraph graph;
+    auto status = build_dataflow_graph(module, graph);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    std::vector<int> valid;
+    for (size_t i = 0; i < graph.call_positions.size(); ++i) {
+        if (is_valid_cut(graph, graph.call_positions[i])) {
+            valid.push_back(static_cast<int>(i));
+        }
+    }
+    if (static_cast<int>(valid.size()) < stages - 1) {
+        std::ostringstream oss;
+        oss << "the main function has " << valid.size() << " valid cuts for " << stages << " stages";
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    int64_t calls = static_cast<int64_t>(graph.call_positions.size());
+    int64_t window = std::max<int64_t>(1, calls / (4 * stages));
+    call_indices.clear();
+    size_t first = 0;
+    for (int j = 1; j < stages; ++j) {
+        int64_t target = j * calls / stages;
+        // leave a valid cut for each of the later boundaries
+        size_t last = valid.size() - static_cast<size_t>(stages - j);
+        // a cut in the window around the target with the fewest live bytes, or the nearest one
+        auto is_better = [&](size_t k, size_t chosen) {
+            int64_t distance = std::abs(valid[k] - target);
+            int64_t chosen_distance = std::abs(valid[chosen] - target);
+            if ((distance <= window) != (chosen_distance <= window)) {
+                return distance <= window;
+            }
+            int64_t bytes = graph.live_bytes[graph.call_positions[valid[k]]];
+            int64_t chosen_bytes = graph.live_bytes[graph.call_positions[valid[chosen]]];
+            if (distance <= window && bytes != chosen_bytes) {
+                return bytes < chosen_bytes;
+            }
+            return distance < chosen_distance;
+        };
+        size_t chosen = first;
+        for (size_t k = first + 1; k <= last; ++k) {
+            if (is_better(k, chosen)) {
+                chosen = k;
+            }
+        }
+
+        call_indices.push_back(valid[chosen]);
+        first = chosen + 1;
+    }
+
+    return Status::ok();
+}
+
+Status split_pipeline_stages(const tvm::IRModule& module, const std::vector<int>& call_indices,
+                             std::vector<PipelineStage>& stages) {
+    DataflowGraph graph;
+    auto status = build_dataflow_graph(module, graph);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    std::vector<int> boundaries;
+    for (size_t i = 0; i < call_indices.size(); ++i) {
+        int index = call_indices[i];
+        if (index < 0 || index >= static_cast<int>(graph.call_positions.size()) ||
+            (i > 0 && index <= call_indices[i - 1]) || !is_valid_cut(graph, graph.call_positions[index])) {
+            std::ostringstream oss;
+            oss << "invalid pipeline cut after call " << index << ", the cuts must be ascending valid cuts";
+            return Status(StatusCode::INVALID_PARAM, oss.str());
+        }
+        boundaries.push_back(graph.call_positions[index]);
+    }
+
+    // var generate function
+    const tvm::runtime::PackedFunc* var_gen = tvm::runtime::Registry::Get("relay.ir.Var");
+    if (!var_gen) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay.ir.Var expression not found");
+    }
+
+    // get the tuple relay
+    const tvm::runtime::PackedFunc* tuple = tvm::runtime::Registry::Get("relay.ir.Tuple");
+    if (!tuple) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay.ir.Tuple expression not found");
+    }
+
+    // get the function relay
+    const tvm::runtime::PackedFunc* function = tvm::runtime::Registry::Get("relay.ir.Function");
+    if (!function) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay.ir.Function expression not found");
+    }
+
+    int root = static_cast<int>(graph.nodes.size()) - 1;
+    stages.clear();
+    try {
+        for (size_t k = 0; k <= boundaries.size(); ++k) {
+            int begin = k == 0 ? -1 : boundaries[k - 1];
+            int end = k == boundaries.size() ? root : boundaries[k];
+
+            PipelineStage stage;
+            std::vector<int> output_positions;
+            if (k == boundaries.size()) {
+                output_positions.push_back(root);
+                const auto* tuple_type = graph.nodes[root].expr->checked_type().as<tvm::TupleTypeNode>();
+                size_t outputs = tuple_type ? tuple_type->fields.size() : 1;
+                for (size_t i = 0; i < outputs; ++i) {
+                    stage.outputs.emplace_back(get_output_name(static_cast<int>(i)));
+                }
+            } else {
+                // the nodes of the stage used by the later stages
+                for (int p = begin + 1; p <= end; ++p) {
+                    if (graph.nodes[p].last_use > end) {
+                        output_positions.push_back(p);
+                        stage.outputs.emplace_back(kBoundaryPrefix + std::to_string(p));
+                    }
+                }
+            }
+
+            StageBuilder builder(graph, begin, var_gen);
+            tvm::relay::Expr body;
+            if (k < boundaries.size() && output_positions.size() > 1) {
+                tvm::runtime::Array<tvm::relay::Expr> fields;
+                for (int p : output_positions) {
+                    fields.push_back(builder.VisitExpr(graph.nodes[p].expr));
+                }
+                body = (*tuple)(fields, tvm::relay::Span());
+            } else {
+                body = builder.VisitExpr(graph.nodes[output_positions[0]].expr);
+            }
+
+            tvm::relay::Expr func = (*function)(builder.params(), body, tvm::relay::Type(),
+                                                tvm::runtime::Array<tvm::relay::TypeVar>(), tvm::DictAttrs(),
+                                                tvm::relay::Span());
+            stage.module = tvm::IRModule::FromExpr(func);
+            stages.emplace_back(std::move(stage));
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+Status compile_pipeline_stages(const tvm::IRModule& module, const std::vector<int>& call_indices,
+                               const compiler::BuildOptions& options, const std::string& dir,
+                               std::string& pipeline_dir) {
+    // the stages of another module or other build options are not reused
+    std::string key;
+    auto status = compiler::get_module_cache_key(module, options, key);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    std::string name = "pipeline";
+    for (int index : call_indices) {
+        name += "_" + std::to_string(index);
+    }
+    name += "_" + key;
+    pipeline_dir = (std::filesystem::path(dir) / name).string();
+    std::string manifest_path = (std::filesystem::path(pipeline_dir) / kManifestName).string();
+    // the manifest is written after all the stages, so the pipeline is complete
+    if (std::filesystem::exists(manifest_path)) {
+        return Status::ok();
+    }
+
+    std::vector<PipelineStage> stages;
+    status = split_pipeline_stages(module, call_indices, stages);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(pipeline_dir, ec);
+    picojson::array values;
+    for (size_t i = 0; i < stages.size(); ++i) {
+        std::string artifact_name = "stage_" + std::to_string(i);
+        std::string artifact_dir = (std::filesystem::path(pipeline_dir) / artifact_name).string();
+        if (!compiler::has_cached_artifact(artifact_dir)) {
+            compiler::BuildResult result;
+            status = compiler::build_irmodule(stages[i].module, options, result);
+            if (!status.is_ok()) {
+                return status;
+            }
+
+            status = export_stage_artifact(result, artifact_dir);
+            if (!status.is_ok()) {
+                return status;
+            }
+        }
+
+        picojson::array outputs;
+        for (const auto& output : stages[i].outputs) {
+            outputs.emplace_back(output);
+        }
+        picojson::object value;
+        value["artifact"] = picojson::value(artifact_name);
+        value["outputs"] = picojson::value(outputs);
+        values.emplace_back(value);
+    }
+
+    picojson::object root;
+    root["stages"] = picojson::value(values);
+    std::string tmp_path = manifest_path + ".tmp." + std::to_string(getpid());
+    {
+        std::ofstream ofs(tmp_path, std::ios::binary);
+        if (!ofs) {
+            std::ostringstream oss;
+            oss << "Open file failed: " << tmp_path;
+            return Status(StatusCode::RUNTIME_ERROR, oss.str());
+        }
+        ofs << picojson::value(root).serialize(true);
+        ofs.close();
+        if (!ofs) {
+            std::filesystem::remove(tmp_path, ec);
+            return Status(StatusCode::RUNTIME_ERROR, "Write the pipeline manifest failed: " + tmp_path);
+        }
+    }
+    std::filesystem::rename(tmp_path, manifest_path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_path, ec);
+        return Status(StatusCode::RUNTIME_ERROR, "Move the pipeline manifest failed: " + manifest_path);
+    }
+
+    return Status::ok();
+}
+
+PipelineSession::~PipelineSession() { stop(); }
+
+Status PipelineSession::create(const std::string& pipeline_dir, const PipelineOptions& options,
+                               std::unique_ptr<PipelineSession>& session) {
+    std::string manifest_path = (std::filesystem::path(pipeline_dir) / kManifestName).string();
+    std::ifstream ifs(manifest_path, std::ios::binary);
+    if (!ifs) {
+        std::ostringstream oss;
+        oss << "File does NOT exist: " << manifest_path;
+        return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+    }
+
+    picojson::value root;
+    std::string err = picojson::parse(root, ifs);
+    if (!err.empty() || !root.is<picojson::object>() || !root.contains("stages") ||
+        !root.get("stages").is<picojson::array>() || root.get("stages").get<picojson::array>().empty()) {
+        std::ostringstream oss;
+        oss << "Invalid pipeline manifest: " << manifest_path << " " << err;
+        return Status(StatusCode::INVALID_MODEL, oss.str());
+    }
+
+    const picojson::array& values = root.get("stages").get<picojson::array>();
+    if ((!options.stage_threads.empty() && options.stage_threads.size() != values.size()) ||
+        options.queue_capacity < 1) {
+        std::ostringstream oss;
+        oss << "invalid pipeline options, " << options.stage_threads.size() << " thread configs for " << values.size()
+            << " stages or a queue capacity under 1";
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    std::unique_ptr<PipelineSession> result(new PipelineSession());
+    result->m_latency_us = Histogram::exponential(kMinTimeBoundUs, kMaxTimeBoundUs);
+    for (size_t i = 0; i < values.size(); ++i) {
+        const picojson::value& value = values[i];
+        if (!value.is<picojson::object>() || !value.get("artifact").is<std::string>() ||
+            !value.get("outputs").is<picojson::array>()) {
+            std::ostringstream oss;
+            oss << "Invalid stage in the pipeline manifest: " << value.serialize();
+            return Status(StatusCode::INVALID_MODEL, oss.str());
+        }
+
+        auto stage = std::make_unique<Stage>();
+        stage->artifact_dir = (std::filesystem::path(pipeline_dir) / value.get("artifact").get<std::string>()).string();
+        for (const auto& output : value.get("outputs").get<picojson::array>()) {
+            stage->outputs.emplace_back(output.to_str());
+        }
+        if (!options.stage_threads.empty()) {
+            stage->thread_config = options.stage_threads[i];
+        }
+        stage->queue = std::make_unique<BlockingQueue<std::unique_ptr<Request>>>(options.queue_capacity);
+        stage->stats.wait_time_us = Histogram::exponential(kMinTimeBoundUs, kMaxTimeBoundUs);
+        stage->stats.run_time_us = Histogram::exponential(kMinTimeBoundUs, kMaxTimeBoundUs);
+        result->m_stages.emplace_back(std::move(stage));
+    }
+
+    // each stage is loaded on its own thread after its thread config is applied
+    std::vector<std::future<Status>> started;
+    for (size_t i = 0; i < result->m_stages.size(); ++i) {
+        started.emplace_back(result->m_stages[i]->started.get_future());
+        result->m_stages[i]->thread = std::thread(&PipelineSession::stage_loop, result.get(), i);
+    }
+    Status status = Status::ok();
+    for (auto& stage_started : started) {
+        Status stage_status = stage_started.get();
+        if (status.is_ok() && !stage_status.is_ok()) {
+            status = stage_status;
+        }
+    }
+
+    // the graph inputs are the stage inputs which no earlier stage computes, a tensor is released after the last
+    // stage which uses it
+    std::unordered_set<std::string> produced;
+    std::unordered_map<std::string, size_t> last_uses;
+    for (size_t i = 0; status.is_ok() && i < result->m_stages.size(); ++i) {
+        Stage& stage = *result->m_stages[i];
+        if (stage.outputs.size() != stage.session.get_outputs().size()) {
+            std::ostringstream oss;
+            oss << "the stage " << i << " has " << stage.session.get_outputs().size() << " outputs instead of "
+                << stage.outputs.size();
+            status = Status(StatusCode::INVALID_MODEL, oss.str());
+            break;
+        }
+
+        for (const auto& input : stage.session.get_inputs()) {
+            if (!produced.count(input.name) && !last_uses.count(input.name)) {
+                if (input.name.compare(0, std::strlen(kBoundaryPrefix), kBoundaryPrefix) == 0) {
+                    status = Status(StatusCode::INVALID_MODEL, "no earlier stage computes " + input.name);
+                    break;
+                }
+                result->m_inputs.emplace_back(input);
+            }
+            last_uses[input.name] = i;
+        }
+        produced.insert(stage.outputs.begin(), stage.outputs.end());
+    }
+    if (!status.is_ok()) {
+        result->stop();
+        return status;
+    }
+
+    for (const auto& kv : last_uses) {
+        result->m_stages[kv.second]->released.emplace_back(kv.first);
+    }
+
+    session = std::move(result);
+    return Status::ok();
+}
+
+Status PipelineSession::submit(const sample_utils::TensorMap& inputs, std::future<InferResult>& result) {
+    if (m_stopped) {
+        return Status(StatusCode::RUNTIME_ERROR, "the pipeline session is stopped");
+    }
+
+    auto request = std::make_unique<Request>();
+    request->tensors = inputs;
+    request->submit_time = std::chrono::steady_clock::now();
+    request->enqueue_time = request->submit_time;
+    std::future<InferResult> future = request->promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        if (!m_started) {
+            m_started = true;
+            m_first_submit_time = request->submit_time;
+        }
+    }
+
+    if (!m_stages[0]->queue->push(std::move(request))) {
+        return Status(StatusCode::RUNTIME_ERROR, "the pipeline session is stopped");
+    }
+
+    result = std::move(future);
+    return Status::ok();
+}
+
+Status PipelineSession::run(const sample_utils::TensorMap& inputs, std::vector<tvm::runtime::NDArray>& outputs) {
+    std::future<InferResult> future;
+    auto status = submit(inputs, future);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    InferResult result = future.get();
+    if (result.status.is_ok()) {
+        outputs = std::move(result.outputs);
+    }
+    return result.status;
+}
+
+PipelineStats PipelineSession::get_stats() const {
+    PipelineStats stats;
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        stats.completed = m_completed;
+        stats.latency_us = m_latency_us;
+        std::chrono::duration<double> elapsed = m_last_complete_time - m_first_submit_time;
+        if (m_completed > 0 && elapsed.count() > 0) {
+            stats.throughput = static_cast<double>(m_completed) / elapsed.count();
+        }
+    }
+
+    for (const auto& stage : m_stages) {
+        std::lock_guard<std::mutex> lock(stage->stats_mutex);
+        stats.stages.emplace_back(stage->stats);
+    }
+    return stats;
+}
+
+void PipelineSession::stop() {
+    m_stopped = true;
+    // the stages are closed in order, each one runs the requests queued before and passes them on
+    for (auto& stage : m_stages) {
+        stage->queue->close();
+        if (stage->thread.joinable()) {
+            stage->thread.join();
+        }
+    }
+}
+
+void PipelineSession::stage_loop(size_t index) {
+    Stage& stage = *m_stages[index];
+    Status status = apply_thread_config(stage.thread_config);
+    if (status.is_ok()) {
+        status = stage.session.load(stage.artifact_dir);
+    }
+    stage.started.set_value(status);
+    if (!status.is_ok()) {
+        return;
+    }
+
+    bool last = index + 1 == m_stages.size();
+    std::unique_ptr<Request> request;
+    while (stage.queue->pop(request)) {
+        auto start = std::chrono::steady_clock::now();
+        status = run_stage(stage, *request);
+        auto end = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(stage.stats_mutex);
+            ++stage.stats.runs;
+            stage.stats.wait_time_us.record(elapsed_us(request->enqueue_time, start));
+            stage.stats.run_time_us.record(elapsed_us(start, end));
+        }
+
+        InferResult result;
+        result.status = status;
+        if (status.is_ok() && !last) {
+            request->enqueue_time = end;
+            if (m_stages[index + 1]->queue->push(std::move(request))) {
+                continue;
+            }
+            result.status = Status(StatusCode::RUNTIME_ERROR, "the pipeline session is stopped");
+        } else if (status.is_ok()) {
+            for (const auto& name : stage.outputs) {
+                result.outputs.emplace_back(request->tensors.at(name));
+            }
+        }
+
+        complete(*request, std::move(result));
+        request.reset();
+    }
+}
+
+Status PipelineSession::run_stage(Stage& stage, Request& request) {
+    // an exception must NOT escape the stage thread, the request gets the error instead
+    try {
+        const auto& inputs = stage.session.get_inputs();
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            auto iter = request.tensors.find(inputs[i].name);
+            if (iter == request.tensors.end()) {
+                return Status(StatusCode::INVALID_PARAM, "the input " + inputs[i].name + " is not set");
+            }
+
+            auto status = stage.session.set_input(static_cast<int>(i), iter->second);
+            if (!status.is_ok()) {
+                return status;
+            }
+        }
+
+        auto status = stage.session.run();
+        if (!status.is_ok()) {
+            return status;
+        }
+
+        for (const auto& name : stage.released) {
+            request.tensors.erase(name);
+        }
+
+        // the session outputs are overwritten by the next request of the stage
+        const auto& outputs = stage.session.get_outputs();
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            tvm::runtime::NDArray output;
+            status = stage.session.get_output(static_cast<int>(i), output);
+            if (!status.is_ok()) {
+                return status;
+            }
+
+            tvm::runtime::NDArray copy = tvm::runtime::NDArray::Empty(outputs[i].shape, outputs[i].dtype, {kDLCPU, 0});
+            copy.CopyFrom(output);
+            request.tensors[stage.outputs[i]] = copy;
+        }
+    } catch (const std::exception& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+void PipelineSession::complete(Request& request, InferResult&& result) {
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        ++m_completed;
+        m_last_complete_time = now;
+        m_latency_us.record(elapsed_us(request.submit_time, now));
+    }
+    request.promise.set_value(std::move(result));
+}
+
+}    // namespace serving
+}    // namespace tvm_cpp
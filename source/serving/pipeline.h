@@ -0,0 +1,243 @@
+#ifndef _H_TVM_CPP_SERVING_PIPELINE_H_
+#define _H_TVM_CPP_SERVING_PIPELINE_H_
+
+#include <tvm/ir/module.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "serving/async_session.h"
+#include "serving/blocking_queue.h"
+#include "serving/histogram.h"
+#include "serving/inference_session.h"
+#include "serving/thread_config.h"
+#include "utils/sample_utils.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace serving {
+
+/**
+ * @brief A point where the main function can be cut into two sequential stages, after a call in the post order of
+ * the function. The tensors computed before the cut and used after it are passed to the next stage
+ *
+ */
+struct PipelineCut {
+    // the index of the call among the calls of the main function in post order
+    int call_index{0};
+    std::string op_name;
+    int live_tensors{0};
+    int64_t live_bytes{0};
+};
+
+/**
+ * @brief Get the points where the main function can be cut. A point is valid when every tensor live across it has a
+ * static shape, a tuple live across a cut can not be passed between the executors
+ *
+ * @param module the module whose main function is a dataflow graph
+ * @param cuts output parameter. the valid cuts in the order of the calls
+ * @return Status
+ */
+Status get_pipeline_cuts(const tvm::IRModule& module, std::vector<PipelineCut>& cuts);
+
+/**
+ * @brief Choose the cuts which split the calls evenly into the stages, a cut with fewer live bytes is preferred near
+ * each even split point. The stages are balanced by the number of calls, which is only a proxy of their time, the
+ * per-stage latency of the pipeline tells how to move the cuts
+ *
+ * @param module the module whose main function is a dataflow graph
+ * @param stages the number of stages
+ * @param call_indices output parameter. the call indices of the stages - 1 cuts
+ * @return Status
+ */
+Status choose_pipeline_cuts(const tvm::IRModule& module, int stages, std::vector<int>& call_indices);
+
+/**
+ * @brief A stage of the split main function
+ *
+ */
+struct PipelineStage {
+    // the main function of the stage, its params are the graph inputs and the tensors of the earlier stages it uses
+    tvm::IRModule module;
+    // the names of the outputs, the tensors used by the later stages, or the graph outputs for the last stage
+    std::vector<std::string> outputs;
+};
+
+/**
+ * @brief Split the main function into sequential stages after the calls
+ *
+ * @param module the module whose main function is a dataflow graph
+ * @param call_indices the ascending call indices of the cuts, each one a valid cut of `get_pipeline_cuts`
+ * @param stages output parameter. the call_indices.size() + 1 stages
+ * @return Status
+ */
+Status split_pipeline_stages(const tvm::IRModule& module, const std::vector<int>& call_indices,
+                             std::vector<PipelineStage>& stages);
+
+/**
+ * @brief Split the module and compile each stage to the pipeline directory of the cuts, the module and the build
+ * options, which is reused if it is complete. The stages are exported to "stage_<i>" with the manifest "pipeline.json"
+ *
+ * @param module the module whose main function is a dataflow graph
+ * @param call_indices the ascending call indices of the cuts
+ * @param options the build options of every stage
+ * @param dir the parent directory of the pipelines of the module
+ * @param pipeline_dir output parameter. the pipeline directory
+ * @return Status
+ */
+Status compile_pipeline_stages(const tvm::IRModule& module, const std::vector<int>& call_indices,
+                               const compiler::BuildOptions& options, const std::string& dir,
+                               std::string& pipeline_dir);
+
+/**
+ * @brief The options of the pipeline session
+ *
+ */
+struct PipelineOptions {
+    // the thread config of each stage, e.g. disjoint core groups, empty keeps the TVM defaults of every stage
+    std::vector<ThreadConfig> stage_threads;
+    // the max requests waiting in front of each stage, a full queue holds back the stage before it
+    int queue_capacity{4};
+};
+
+/**
+ * @brief The statistics of a pipeline stage
+ *
+ */
+struct StageStats {
+    int64_t runs{0};
+    // the time waiting in front of the stage and the time of the run in microseconds
+    Histogram wait_time_us;
+    Histogram run_time_us;
+};
+
+/**
+ * @brief The statistics of the pipeline since it is created
+ *
+ */
+struct PipelineStats {
+    int64_t completed{0};
+    // the completed requests per second from the first submission to the last completion
+    double throughput{0};
+    Histogram latency_us;
+    std::vector<StageStats> stages;
+};
+
+/**
+ * @brief The pipeline of the compiled stages. Each stage runs on its own thread with its own thread config, so the
+ * stages of different requests overlap on disjoint cores, and the bounded queues between the stages pass the tensors
+ * of each request on. The throughput is bound by the slowest stage, the latency of a request is the sum of the stages
+ *
+ */
+class PipelineSession final {
+public:
+    PipelineSession(const PipelineSession&) = delete;
+    PipelineSession& operator=(const PipelineSession&) = delete;
+    ~PipelineSession();
+
+    /**
+     * @brief Load the stages of the pipeline directory and start the stage threads
+     *
+     * @param pipeline_dir the directory of `compile_pipeline_stages`
+     * @param options the pipeline options
+     * @param session output parameter. the pipeline session
+     * @return Status
+     */
+    static Status create(const std::string& pipeline_dir, const PipelineOptions& options,
+                         std::unique_ptr<PipelineSession>& session);
+
+    /**
+     * @brief Submit a request to the first stage, it waits while the queue of the first stage is full
+     *
+     * @param inputs the graph inputs by name
+     * @param result output parameter. the future of the result
+     * @return Status the rejection of the submission, the errors of the run are in the result
+     */
+    Status submit(const sample_utils::TensorMap& inputs, std::future<InferResult>& result);
+
+    /**
+     * @brief Submit a request and wait for its outputs
+     *
+     * @param inputs the graph inputs by name
+     * @param outputs output parameter. the graph outputs
+     * @return Status
+     */
+    Status run(const sample_utils::TensorMap& inputs, std::vector<tvm::runtime::NDArray>& outputs);
+
+    /**
+     * @brief The graph inputs, the inputs of the stages which are not computed by an earlier stage
+     *
+     */
+    const std::vector<TensorInfo>& get_inputs() const { return m_inputs; }
+
+    /**
+     * @brief The graph outputs, the outputs of the last stage
+     *
+     */
+    const std::vector<TensorInfo>& get_outputs() const { return m_stages.back()->session.get_outputs(); }
+
+    size_t get_stage_count() const { return m_stages.size(); }
+
+    PipelineStats get_stats() const;
+
+    /**
+     * @brief Run the queued requests through the stages and stop the stage threads, the later submissions are rejected
+     *
+     */
+    void stop();
+
+private:
+    struct Request {
+        // the graph inputs and the outputs of the stages run so far, dropped once no later stage uses them
+        sample_utils::TensorMap tensors;
+        std::promise<InferResult> promise;
+        std::chrono::steady_clock::time_point submit_time;
+        std::chrono::steady_clock::time_point enqueue_time;
+    };
+
+    struct Stage {
+        std::string artifact_dir;
+        InferenceSession session;
+        ThreadConfig thread_config;
+        // the result of loading the session on the stage thread
+        std::promise<Status> started;
+        std::vector<std::string> outputs;
+        // the tensors of the request no later stage uses
+        std::vector<std::string> released;
+        std::unique_ptr<BlockingQueue<std::unique_ptr<Request>>> queue;
+        std::thread thread;
+        mutable std::mutex stats_mutex;
+        StageStats stats;
+    };
+
+    PipelineSession() = default;
+
+    void stage_loop(size_t index);
+    Status run_stage(Stage& stage, Request& request);
+    void complete(Request& request, InferResult&& result);
+
+    std::vector<std::unique_ptr<Stage>> m_stages;
+    std::vector<TensorInfo> m_inputs;
+    std::atomic<bool> m_stopped{false};
+
+    mutable std::mutex m_stats_mutex;
+    int64_t m_completed{0};
+    bool m_started{false};
+    std::chrono::steady_clock::time_point m_first_submit_time;
+    std::chrono::steady_clock::time_point m_last_complete_time;
+    Histogram m_latency_us;
+};
+
+}    // namespace serving
+}    // namespace tvm_cpp
+
+#endif
@@ -0,0 +1,799 @@
+#include "shape_buckets.h"
+
+#include <picojson.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <sstream>
+
+#include "compiler/artifact_cache.h"
+#include "compiler/model_artifact.h"
+#include "compiler/model_builder.h"
+#include "utils/relay_utils.h"
+#include "utils/utils.h"
+
+namespace tvm_cpp {
+namespace serving {
+
+namespace {
+
+// the bucket names longer than this are replaced by the hash of the shapes
+constexpr size_t kMaxBucketNameLength = 128;
+
+/**
+ * @brief Serialize the shapes by the input names, e.g. "x:1,3,224,224;"
+ *
+ */
+std::string serialize_shapes(const ShapeMap& shapes) {
+    std::map<std::string, std::vector<int64_t>> sorted(shapes.begin(), shapes.end());
+    std::ostringstream oss;
+    for (const auto& kv : sorted) {
+        oss << kv.first << ":";
+        for (size_t i = 0; i < kv.second.size(); ++i) {
+            oss << (i > 0 ? "," : "") << kv.second[i];
+        }
+        oss << ";";
+    }
+    return oss.str();
+}
+
+bool same_inputs_and_ranks(const ShapeMap& lhs, const ShapeMap& rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+
+    for (const auto& kv : lhs) {
+        auto iter = rhs.find(kv.first);
+        if (iter == rhs.end() || iter->second.size() != kv.second.size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief The smallest bucket which covers both shapes
+ *
+ */
+ShapeMap merge_shapes(const ShapeMap& lhs, const ShapeMap& rhs) {
+    ShapeMap merged = lhs;
+    for (auto& kv : merged) {
+        const auto& other = rhs.at(kv.first);
+        for (size_t i = 0; i < kv.second.size(); ++i) {
+            kv.second[i] = std::max(kv.second[i], other[i]);
+        }
+    }
+    return merged;
+}
+
+/**
+ * @brief The index of the bucket with the fewest elements which covers the shapes, -1 if none covers them
+ *
+ */
+int find_bucket(const ShapeMap& shapes, const std::vector<ShapeMap>& buckets, const std::vector<int64_t>& elements) {
+    int found = -1;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        if (is_shape_in_bucket(shapes, buckets[i]) && (found < 0 || elements[i] < elements[found])) {
+            found = static_cast<int>(i);
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Choose the buckets of the shapes which vary in a single dim, the shapes are sorted by the dim. The buckets are
+ * the right ends of the segments which minimize the padding, `dp[j][i]` is the min padding of the first i shapes
+ * covered by j buckets
+ *
+ */
+void choose_segment_buckets(const std::vector<std::pair<ShapeMap, int64_t>>& entries, int max_buckets,
+                            std::vector<ShapeMap>& buckets) {
+    size_t n = entries.size();
+    std::vector<int64_t> prefix_counts(n + 1, 0);
+    std::vector<int64_t> prefix_elements(n + 1, 0);
+    std::vector<int64_t> elements(n);
+    for (size_t i = 0; i < n; ++i) {
+        elements[i] = get_shape_elements(entries[i].first);
+        prefix_counts[i + 1] = prefix_counts[i] + entries[i].second;
+        prefix_elements[i + 1] = prefix_elements[i] + entries[i].second * elements[i];
+    }
+
+    // the padding of the shapes [l, r] to the shape r
+    auto cost = [&](size_t l, size_t r) {
+        return elements[r] * (prefix_counts[r + 1] - prefix_counts[l]) - (prefix_elements[r + 1] - prefix_elements[l]);
+    };
+
+    size_t k = std::min(n, static_cast<size_t>(max_buckets));
+    constexpr int64_t kInf = std::numeric_limits<int64_t>::max();
+    std::vector<std::vector<int64_t>> dp(k + 1, std::vector<int64_t>(n + 1, kInf));
+    std::vector<std::vector<size_t>> split(k + 1, std::vector<size_t>(n + 1, 0));
+    dp[0][0] = 0;
+    for (size_t j = 1; j <= k; ++j) {
+        for (size_t i = j; i <= n; ++i) {
+            for (size_t m = j - 1; m < i; ++m) {
+                if (dp[j - 1][m] == kInf) {
+                    continue;
+                }
+
+                int64_t value = dp[j - 1][m] + cost(m, i - 1);
+                if (value < dp[j][i]) {
+                    dp[j][i] = value;
+                    split[j][i] = m;
+                }
+            }
+        }
+    }
+
+    buckets.clear();
+    for (size_t j = k, i = n; j > 0; --j) {
+        buckets.emplace_back(entries[i - 1].first);
+        i = split[j][i];
+    }
+    std::reverse(buckets.begin(), buckets.end());
+}
+
+/**
+ * @brief Merge the clusters of the shapes greedily, each step merges the pair which adds the least padding
+ *
+ */
+void choose_merged_buckets(const std::vector<std::pair<ShapeMap, int64_t>>& entries, int max_buckets,
+                           std::vector<ShapeMap>& buckets) {
+    struct Cluster {
+        ShapeMap bucket;
+        // the requests and the sum of their elements
+        int64_t count{0};
+        int64_t elements{0};
+
+        int64_t padding() const { return get_shape_elements(bucket) * count - elements; }
+    };
+
+    std::vector<Cluster> clusters;
+    for (const auto& entry : entries) {
+        clusters.emplace_back(Cluster{entry.first, entry.second, entry.second * get_shape_elements(entry.first)});
+    }
+
+    while (clusters.size() > static_cast<size_t>(max_buckets)) {
+        size_t best_a = 0;
+        size_t best_b = 1;
+        int64_t best_delta = std::numeric_limits<int64_t>::max();
+        for (size_t a = 0; a < clusters.size(); ++a) {
+            for (size_t b = a + 1; b < clusters.size(); ++b) {
+                Cluster merged{merge_shapes(clusters[a].bucket, clusters[b].bucket),
+                               clusters[a].count + clusters[b].count, clusters[a].elements + clusters[b].elements};
+                int64_t delta = merged.padding() - clusters[a].padding() - clusters[b].padding();
+                if (delta < best_delta) {
+                    best_delta = delta;
+                    best_a = a;
+                    best_b = b;
+                }
+            }
+        }
+
+        clusters[best_a].bucket = merge_shapes(clusters[best_a].bucket, clusters[best_b].bucket);
+        clusters[best_a].count += clusters[best_b].count;
+        clusters[best_a].elements += clusters[best_b].elements;
+        clusters.erase(clusters.begin() + static_cast<std::ptrdiff_t>(best_b));
+    }
+
+    buckets.clear();
+    for (const auto& cluster : clusters) {
+        buckets.emplace_back(cluster.bucket);
+    }
+}
+
+char* get_data(const tvm::runtime::NDArray& array) {
+    return static_cast<char*>(array->data) + array->byte_offset;
+}
+
+std::vector<int64_t> get_shape(const DLTensor* tensor) {
+    return std::vector<int64_t>(tensor->shape, tensor->shape + tensor->ndim);
+}
+
+/**
+ * @brief Copy the leading region of the source tensor to the leading region of the destination tensor, both are
+ * compact row-major. It pads a request to a bucket and crops an output of a bucket
+ *
+ */
+void copy_region(const char* src, const std::vector<int64_t>& src_shape, char* dst,
+                 const std::vector<int64_t>& dst_shape, const std::vector<int64_t>& region, size_t element_bytes) {
+    size_t ndim = region.size();
+    if (ndim == 0) {
+        std::memcpy(dst, src, element_bytes);
+        return;
+    }
+    if (std::any_of(region.begin(), region.end(), [](int64_t dim) { return dim <= 0; })) {
+        return;
+    }
+
+    std::vector<int64_t> src_strides(ndim, 1);
+    std::vector<int64_t> dst_strides(ndim, 1);
+    for (size_t i = ndim - 1; i > 0; --i) {
+        src_strides[i - 1] = src_strides[i] * src_shape[i];
+        dst_strides[i - 1] = dst_strides[i] * dst_shape[i];
+    }
+
+    size_t row_bytes = static_cast<size_t>(region.back()) * element_bytes;
+    std::vector<int64_t> index(ndim - 1, 0);
+    while (true) {
+        int64_t src_offset = 0;
+        int64_t dst_offset = 0;
+        for (size_t i = 0; i + 1 < ndim; ++i) {
+            src_offset += index[i] * src_strides[i];
+            dst_offset += index[i] * dst_strides[i];
+        }
+        std::memcpy(dst + dst_offset * element_bytes, src + src_offset * element_bytes, row_bytes);
+
+        // the next row of the region
+        size_t dim = ndim - 1;
+        while (dim > 0 && ++index[dim - 1] == region[dim - 1]) {
+            index[dim - 1] = 0;
+            --dim;
+        }
+        if (dim == 0) {
+            break;
+        }
+    }
+}
+
+size_t get_element_bytes(const tvm::DataType& dtype) { return (dtype.bits() * dtype.lanes() + 7) / 8; }
+
+}    // namespace
+
+void ShapeHistogram::record(const ShapeMap& shapes, int64_t count) {
+    std::string key = serialize_shapes(shapes);
+    auto iter = m_indices.find(key);
+    if (iter == m_indices.end()) {
+        m_indices.emplace(key, m_entries.size());
+        m_entries.emplace_back(shapes, count);
+    } else {
+        m_entries[iter->second].second += count;
+    }
+    m_total += count;
+}
+
+void ShapeHistogram::record(const sample_utils::TensorMap& inputs) {
+    ShapeMap shapes;
+    for (const auto& kv : inputs) {
+        shapes.emplace(kv.first, get_shape(kv.second.operator->()));
+    }
+    record(shapes);
+}
+
+Status ShapeHistogram::save(const std::string& path) const {
+    picojson::array values;
+    for (const auto& entry : m_entries) {
+        picojson::object shapes;
+        for (const auto& kv : entry.first) {
+            picojson::array dims;
+            for (int64_t dim : kv.second) {
+                dims.emplace_back(static_cast<double>(dim));
+            }
+            shapes[kv.first] = picojson::value(dims);
+        }
+
+        picojson::object value;
+        value["shapes"] = picojson::value(shapes);
+        value["count"] = picojson::value(static_cast<double>(entry.second));
+        values.emplace_back(value);
+    }
+
+    picojson::object root;
+    root["entries"] = picojson::value(values);
+
+    std::ofstream ofs(path, std::ios::binary);
+    if (!ofs) {
+        std::ostringstream oss;
+        oss << "Open file failed: " << path;
+        return Status(StatusCode::RUNTIME_ERROR, oss.str());
+    }
+    ofs << picojson::value(root).serialize(true);
+    return Status::ok();
+}
+
+Status ShapeHistogram::load(const std::string& path) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) {
+        std::ostringstream oss;
+        oss << "File does NOT exist: " << path;
+        return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+    }
+
+    picojson::value root;
+    std::string err = picojson::parse(root, ifs);
+    if (!err.empty() || !root.is<picojson::object>() || !root.contains("entries") ||
+        !root.get("entries").is<picojson::array>()) {
+        std::ostringstream oss;
+        oss << "Invalid shape histogram file: " << path << " " << err;
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    for (const auto& value : root.get("entries").get<picojson::array>()) {
+        if (!value.is<picojson::object>() || !value.get("shapes").is<picojson::object>() ||
+            !value.get("count").is<double>()) {
+            std::ostringstream oss;
+            oss << "Invalid entry in the shape histogram file: " << value.serialize();
+            return Status(StatusCode::INVALID_PARAM, oss.str());
+        }
+
+        ShapeMap shapes;
+        for (const auto& kv : value.get("shapes").get<picojson::object>()) {
+            if (!kv.second.is<picojson::array>()) {
+                return Status(StatusCode::INVALID_PARAM, "Invalid shape of " + kv.first + " in " + path);
+            }
+
+            std::vector<int64_t>& shape = shapes[kv.first];
+            for (const auto& dim : kv.second.get<picojson::array>()) {
+                if (!dim.is<double>()) {
+                    return Status(StatusCode::INVALID_PARAM, "Invalid shape of " + kv.first + " in " + path);
+                }
+                shape.emplace_back(static_cast<int64_t>(dim.get<double>()));
+            }
+        }
+        record(shapes, static_cast<int64_t>(value.get("count").get<double>()));
+    }
+
+    return Status::ok();
+}
+
+int64_t get_shape_elements(const ShapeMap& shapes) {
+    int64_t elements = 0;
+    for (const auto& kv : shapes) {
+        elements += std::accumulate(kv.second.begin(), kv.second.end(), int64_t(1), std::multiplies<int64_t>());
+    }
+    return elements;
+}
+
+bool is_shape_in_bucket(const ShapeMap& shapes, const ShapeMap& bucket) {
+    if (!same_inputs_and_ranks(shapes, bucket)) {
+        return false;
+    }
+
+    for (const auto& kv : shapes) {
+        const auto& bucket_shape = bucket.at(kv.first);
+        for (size_t i = 0; i < kv.second.size(); ++i) {
+            if (kv.second[i] > bucket_shape[i]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int64_t get_padded_elements(const ShapeHistogram& histogram, const std::vector<ShapeMap>& buckets) {
+    std::vector<int64_t> elements;
+    for (const auto& bucket : buckets) {
+        elements.emplace_back(get_shape_elements(bucket));
+    }
+
+    int64_t padded = 0;
+    for (const auto& entry : histogram.entries()) {
+        int index = find_bucket(entry.first, buckets, elements);
+        if (index >= 0) {
+            padded += entry.second * (elements[index] - get_shape_elements(entry.first));
+        }
+    }
+    return padded;
+}
+
+Status choose_shape_buckets(const ShapeHistogram& histogram, int max_buckets, std::vector<ShapeMap>& buckets,
+                            int64_t& padded_elements) {
+    const auto& entries = histogram.entries();
+    if (entries.empty() || max_buckets < 1) {
+        return Status(StatusCode::INVALID_PARAM, "the shape histogram is empty or the max buckets is less than 1");
+    }
+
+    // the dims which vary between the recorded shapes
+    const ShapeMap& first = entries[0].first;
+    std::vector<std::pair<std::string, size_t>> varying;
+    for (const auto& entry : entries) {
+        if (!same_inputs_and_ranks(entry.first, first)) {
+            return Status(StatusCode::INVALID_PARAM, "the recorded shapes have different inputs or ranks: " +
+                                                         serialize_shapes(entry.first) + " " + serialize_shapes(first));
+        }
+    }
+    for (const auto& kv : first) {
+        for (size_t i = 0; i < kv.second.size(); ++i) {
+            bool varies = std::any_of(entries.begin(), entries.end(), [&](const std::pair<ShapeMap, int64_t>& entry) {
+                return entry.first.at(kv.first)[i] != kv.second[i];
+            });
+            if (varies) {
+                varying.emplace_back(kv.first, i);
+            }
+        }
+    }
+
+    if (varying.size() <= 1) {
+        std::vector<std::pair<ShapeMap, int64_t>> sorted = entries;
+        if (!varying.empty()) {
+            const auto& dim = varying[0];
+            std::sort(sorted.begin(), sorted.end(),
+                      [&](const std::pair<ShapeMap, int64_t>& lhs, const std::pair<ShapeMap, int64_t>& rhs) {
+                          return lhs.first.at(dim.first)[dim.second] < rhs.first.at(dim.first)[dim.second];
+                      });
+        }
+        choose_segment_buckets(sorted, max_buckets, buckets);
+    } else {
+        choose_merged_buckets(entries, max_buckets, buckets);
+    }
+
+    padded_elements = get_padded_elements(histogram, buckets);
+    return Status::ok();
+}
+
+std::string get_bucket_name(const ShapeMap& bucket) {
+    std::map<std::string, std::vector<int64_t>> sorted(bucket.begin(), bucket.end());
+    std::ostringstream oss;
+    oss << "bucket";
+    for (const auto& kv : sorted) {
+        oss << "_";
+        for (char c : kv.first) {
+            oss << (std::isalnum(static_cast<unsigned char>(c)) ? c : '-');
+        }
+        for (int64_t dim : kv.second) {
+            oss << "x" << dim;
+        }
+    }
+
+    std::string name = oss.str();
+    if (name.size() > kMaxBucketNameLength) {
+        std::ostringstream hashed;
+        hashed << "bucket_" << std::hex << tvm_cpp::utils::fnv1a_hash(serialize_shapes(bucket));
+        return hashed.str();
+    }
+    return name;
+}
+
+Status compile_shape_buckets(const tvm::IRModule& module, const std::vector<ShapeMap>& buckets,
+                             const compiler::BuildOptions& options, const std::string& dir,
+                             std::vector<std::string>& artifact_dirs) {
+    artifact_dirs.clear();
+
+    // the buckets of another module or other build options are not reused
+    std::string key;
+    auto status = compiler::get_module_cache_key(module, options, key);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    for (const auto& bucket : buckets) {
+        std::string artifact_dir = (std::filesystem::path(dir) / (get_bucket_name(bucket) + "_" + key)).string();
+        artifact_dirs.emplace_back(artifact_dir);
+        if (compiler::has_cached_artifact(artifact_dir)) {
+            continue;
+        }
+
+        tvm::IRModule bucket_module = module;
+        status = tvm_cpp::relay_utils::specialize_input_shapes(bucket, bucket_module);
+        if (!status.is_ok()) {
+            return status;
+        }
+
+        compiler::BuildResult result;
+        status = compiler::build_irmodule(bucket_module, options, result);
+        if (!status.is_ok()) {
+            return status;
+        }
+
+        // export to a temporary directory first like the artifact cache, a partial artifact is never loaded
+        std::string tmp_dir = artifact_dir + ".tmp." + std::to_string(getpid());
+        std::error_code ec;
+        std::filesystem::remove_all(tmp_dir, ec);
+        status = compiler::export_model_artifact(result, tmp_dir);
+        if (!status.is_ok()) {
+            std::filesystem::remove_all(tmp_dir, ec);
+            return status;
+        }
+
+        std::filesystem::rename(tmp_dir, artifact_dir, ec);
+        if (ec) {
+            std::filesystem::remove_all(tmp_dir, ec);
+            if (!compiler::has_cached_artifact(artifact_dir)) {
+                return Status(StatusCode::RUNTIME_ERROR, "Move the bucket artifact failed: " + artifact_dir);
+            }
+        }
+    }
+
+    return Status::ok();
+}
+
+Status BucketedSession::load(const std::vector<std::string>& artifact_dirs) {
+    return load_buckets(artifact_dirs, nullptr);
+}
+
+Status BucketedSession::load(const std::vector<std::string>& artifact_dirs,
+                             const std::vector<std::vector<CropRule>>& crop_rules) {
+    return load_buckets(artifact_dirs, &crop_rules);
+}
+
+Status BucketedSession::check_crop_rules(const std::vector<TensorInfo>& inputs, const std::vector<TensorInfo>& outputs,
+                                         const std::vector<std::vector<CropRule>>& crop_rules) {
+    if (crop_rules.size() != outputs.size()) {
+        return Status(StatusCode::INVALID_PARAM, "the crop rules do not match the outputs");
+    }
+
+    for (size_t o = 0; o < outputs.size(); ++o) {
+        if (crop_rules[o].size() != outputs[o].shape.size()) {
+            return Status(StatusCode::INVALID_PARAM, "the crop rules do not match the dims of " + outputs[o].name);
+        }
+
+        for (const auto& rule : crop_rules[o]) {
+            if (rule.input < 0) {
+                continue;
+            }
+            if (rule.input >= static_cast<int>(inputs.size()) || rule.input_dim < 0 ||
+                rule.input_dim >= static_cast<int>(inputs[rule.input].shape.size()) || rule.numerator <= 0 ||
+                rule.denominator <= 0) {
+                return Status(StatusCode::INVALID_PARAM, "invalid crop rule of " + outputs[o].name);
+            }
+        }
+    }
+
+    return Status::ok();
+}
+
+Status BucketedSession::choose_crop_rule(const std::vector<Bucket>& sessions, size_t output, size_t output_dim,
+                                         const std::vector<CropRule>& candidates, CropRule& rule) {
+    // the candidates of the same input dim index which have the same dims in every bucket are interchangeable, e.g.
+    // the sequence length of the token ids and of the attention mask
+    auto equivalent = [&sessions](const CropRule& a, const CropRule& b) {
+        if (a.input_dim != b.input_dim || a.numerator != b.numerator || a.denominator != b.denominator) {
+            return false;
+        }
+        for (const auto& bucket : sessions) {
+            const auto& inputs = bucket.session->get_inputs();
+            if (inputs[a.input].shape[a.input_dim] != inputs[b.input].shape[b.input_dim]) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // the input dim of the same index is preferred when the ranks match, e.g. the W of an NCHW output follows the W
+    // of the NCHW input instead of the H which equals it in square buckets
+    const auto& inputs = sessions[0].session->get_inputs();
+    const auto& info = sessions[0].session->get_outputs()[output];
+    std::vector<CropRule> same_index;
+    for (const auto& candidate : candidates) {
+        if (candidate.input_dim == static_cast<int>(output_dim) &&
+            inputs[candidate.input].shape.size() == info.shape.size()) {
+            same_index.emplace_back(candidate);
+        }
+    }
+
+    const auto& preferred = same_index.empty() ? candidates : same_index;
+    rule = CropRule();
+    for (const auto& candidate : preferred) {
+        if (rule.input >= 0 && !equivalent(rule, candidate)) {
+            std::ostringstream oss;
+            oss << "the dim " << output_dim << " of " << info.name << " follows both " << inputs[rule.input].name
+                << "[" << rule.input_dim << "] and " << inputs[candidate.input].name << "[" << candidate.input_dim
+                << "], give the crop rules";
+            return Status(StatusCode::INVALID_MODEL, oss.str());
+        }
+        if (rule.input < 0) {
+            rule = candidate;
+        }
+    }
+
+    return Status::ok();
+}
+
+Status BucketedSession::infer_crop_rules(const std::vector<Bucket>& sessions,
+                                         std::vector<std::vector<CropRule>>& crop_rules) {
+    const auto& first_inputs = sessions[0].session->get_inputs();
+    const auto& first_outputs = sessions[0].session->get_outputs();
+    crop_rules.assign(first_outputs.size(), std::vector<CropRule>());
+
+    // an output dim follows the input dims which vary by the same ratio in every bucket, or the equal input dims
+    for (size_t o = 0; o < first_outputs.size(); ++o) {
+        for (size_t od = 0; od < first_outputs[o].shape.size(); ++od) {
+            std::vector<CropRule> proportional;
+            std::vector<CropRule> equal;
+            for (size_t i = 0; i < first_inputs.size(); ++i) {
+                for (size_t id = 0; id < first_inputs[i].shape.size(); ++id) {
+                    int64_t out0 = first_outputs[o].shape[od];
+                    int64_t in0 = first_inputs[i].shape[id];
+                    bool consistent = in0 > 0;
+                    bool varies = false;
+                    bool same = out0 == in0;
+                    for (const auto& bucket : sessions) {
+                        int64_t out = bucket.session->get_outputs()[o].shape[od];
+                        int64_t in = bucket.session->get_inputs()[i].shape[id];
+                        consistent = consistent && out * in0 == out0 * in;
+                        varies = varies || in != in0;
+                        same = same && out == in;
+                    }
+
+                    if (consistent && varies && out0 > 0) {
+                        int64_t divisor = std::gcd(out0, in0);
+                        proportional.emplace_back(
+                            CropRule{static_cast<int>(i), static_cast<int>(id), out0 / divisor, in0 / divisor});
+                    } else if (same && out0 > 1) {
+                        // a dim of 1 is never cropped
+                        equal.emplace_back(CropRule{static_cast<int>(i), static_cast<int>(id), 1, 1});
+                    }
+                }
+            }
+
+            CropRule rule;
+            auto status = choose_crop_rule(sessions, o, od, proportional.empty() ? equal : proportional, rule);
+            if (!status.is_ok()) {
+                return status;
+            }
+            crop_rules[o].emplace_back(rule);
+        }
+    }
+
+    return Status::ok();
+}
+
+Status BucketedSession::load_buckets(const std::vector<std::string>& artifact_dirs,
+                                     const std::vector<std::vector<CropRule>>* given_rules) {
+    if (artifact_dirs.empty()) {
+        return Status(StatusCode::INVALID_PARAM, "the bucketed session requires at least one artifact");
+    }
+
+    std::vector<ShapeMap> buckets;
+    std::vector<Bucket> sessions;
+    for (const auto& artifact_dir : artifact_dirs) {
+        Bucket bucket;
+        bucket.session = std::make_unique<InferenceSession>();
+        auto status = bucket.session->load(artifact_dir);
+        if (!status.is_ok()) {
+            return status;
+        }
+
+        const auto& inputs = bucket.session->get_inputs();
+        const auto& outputs = bucket.session->get_outputs();
+        if (!sessions.empty()) {
+            const auto& first_inputs = sessions[0].session->get_inputs();
+            const auto& first_outputs = sessions[0].session->get_outputs();
+            bool same = inputs.size() == first_inputs.size() && outputs.size() == first_outputs.size();
+            for (size_t i = 0; same && i < inputs.size(); ++i) {
+                same = inputs[i].name == first_inputs[i].name && inputs[i].dtype == first_inputs[i].dtype &&
+                       inputs[i].shape.size() == first_inputs[i].shape.size();
+            }
+            for (size_t i = 0; same && i < outputs.size(); ++i) {
+                same = outputs[i].dtype == first_outputs[i].dtype &&
+                       outputs[i].shape.size() == first_outputs[i].shape.size();
+            }
+            if (!same) {
+                return Status(StatusCode::INVALID_MODEL, "the bucket artifacts are different models: " + artifact_dir);
+            }
+        }
+
+        ShapeMap shapes;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            shapes.emplace(inputs[i].name, inputs[i].shape);
+            bucket.inputs.emplace_back(tvm::runtime::NDArray::Empty(inputs[i].shape, inputs[i].dtype, {kDLCPU, 0}));
+            status = bucket.session->set_input_zero_copy(static_cast<int>(i), bucket.inputs.back());
+            if (!status.is_ok()) {
+                return status;
+            }
+        }
+        // the requests are padded into the bound inputs, a copying bind would leave the executor on stale data
+        if (bucket.session->get_zero_copy_stats().copied_inputs > 0) {
+            return Status(StatusCode::RUNTIME_ERROR, "the padded inputs are not bound without copy: " + artifact_dir);
+        }
+        bucket.elements = get_shape_elements(shapes);
+        buckets.emplace_back(std::move(shapes));
+        sessions.emplace_back(std::move(bucket));
+    }
+
+    std::vector<std::vector<CropRule>> crop_rules;
+    if (given_rules) {
+        auto status =
+            check_crop_rules(sessions[0].session->get_inputs(), sessions[0].session->get_outputs(), *given_rules);
+        if (!status.is_ok()) {
+            return status;
+        }
+        crop_rules = *given_rules;
+    } else {
+        auto status = infer_crop_rules(sessions, crop_rules);
+        if (!status.is_ok()) {
+            return status;
+        }
+    }
+
+    m_buckets = std::move(buckets);
+    m_sessions = std::move(sessions);
+    m_crop_rules = std::move(crop_rules);
+    m_stats = BucketStats();
+    m_stats.requests.assign(m_sessions.size(), 0);
+    return Status::ok();
+}
+
+Status BucketedSession::run(const sample_utils::TensorMap& inputs, std::vector<tvm::runtime::NDArray>& outputs) {
+    if (m_sessions.empty()) {
+        return Status(StatusCode::RUNTIME_ERROR, "the bucketed session is not loaded");
+    }
+
+    ShapeMap shapes;
+    const auto& infos = m_sessions[0].session->get_inputs();
+    std::vector<const DLTensor*> tensors;
+    for (const auto& info : infos) {
+        auto iter = inputs.find(info.name);
+        if (iter == inputs.end() || !iter->second.defined()) {
+            return Status(StatusCode::INVALID_PARAM, "input not found: " + info.name);
+        }
+
+        const DLTensor* tensor = iter->second.operator->();
+        if (tvm::DataType(tensor->dtype) != info.dtype || tensor->device.device_type != kDLCPU ||
+            !is_compact(tensor)) {
+            return Status(StatusCode::INVALID_PARAM, "the data of " + info.name + " is not compact " +
+                                                         tvm::runtime::DLDataType2String(info.dtype) + " on CPU");
+        }
+        shapes.emplace(info.name, get_shape(tensor));
+        tensors.emplace_back(tensor);
+    }
+
+    std::vector<int64_t> elements;
+    for (const auto& bucket : m_sessions) {
+        elements.emplace_back(bucket.elements);
+    }
+    int index = find_bucket(shapes, m_buckets, elements);
+    if (index < 0) {
+        ++m_stats.rejected;
+        return Status(StatusCode::INVALID_PARAM, "no bucket covers the shapes " + serialize_shapes(shapes));
+    }
+
+    // pad the inputs with zeros
+    Bucket& bucket = m_sessions[index];
+    const ShapeMap& bucket_shapes = m_buckets[index];
+    for (size_t i = 0; i < infos.size(); ++i) {
+        const auto& shape = shapes.at(infos[i].name);
+        const auto& bucket_shape = bucket_shapes.at(infos[i].name);
+        char* data = get_data(bucket.inputs[i]);
+        if (shape != bucket_shape) {
+            std::memset(data, 0, infos[i].bytes());
+        }
+        copy_region(static_cast<const char*>(tensors[i]->data) + tensors[i]->byte_offset, shape, data, bucket_shape,
+                    shape, get_element_bytes(infos[i].dtype));
+    }
+
+    auto status = bucket.session->run();
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    // crop the outputs to the request
+    outputs.clear();
+    const auto& bucket_outputs = bucket.session->get_outputs();
+    for (size_t o = 0; o < bucket_outputs.size(); ++o) {
+        tvm::runtime::NDArray output;
+        status = bucket.session->get_output(static_cast<int>(o), output);
+        if (!status.is_ok()) {
+            return status;
+        }
+
+        std::vector<int64_t> crop = bucket_outputs[o].shape;
+        for (size_t d = 0; d < crop.size(); ++d) {
+            const CropRule& rule = m_crop_rules[o][d];
+            if (rule.input >= 0) {
+                int64_t dim = shapes.at(infos[rule.input].name)[rule.input_dim];
+                crop[d] = std::min(crop[d], (dim * rule.numerator + rule.denominator - 1) / rule.denominator);
+            }
+        }
+
+        outputs.emplace_back(tvm::runtime::NDArray::Empty(crop, bucket_outputs[o].dtype, {kDLCPU, 0}));
+        copy_region(get_data(output), bucket_outputs[o].shape, get_data(outputs.back()), crop, crop,
+                    get_element_bytes(bucket_outputs[o].dtype));
+    }
+
+    int64_t request_elements = get_shape_elements(shapes);
+    ++m_stats.requests[index];
+    m_stats.elements += request_elements;
+    m_stats.padded_elements += bucket.elements - request_elements;
+    return Status::ok();
+}
+
+}    // namespace serving
+}    // namespace tvm_cpp
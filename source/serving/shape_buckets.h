@@ -0,0 +1,241 @@
+#ifndef _H_TVM_CPP_SERVING_SHAPE_BUCKETS_H_
+#define _H_TVM_CPP_SERVING_SHAPE_BUCKETS_H_
+
+#include <tvm/ir/module.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "serving/inference_session.h"
+#include "utils/sample_utils.h"
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace serving {
+
+/**
+ * @brief The shapes of the inputs. key: the input name, value: the shape
+ *
+ */
+using ShapeMap = std::unordered_map<std::string, std::vector<int64_t>>;
+
+/**
+ * @brief The histogram of the input shapes of the requests, it is recorded by the service and saved to choose the
+ * buckets of the next deployment
+ *
+ */
+class ShapeHistogram final {
+public:
+    /**
+     * @brief Count the shapes of a request
+     *
+     * @param shapes the input shapes
+     * @param count the number of the requests
+     */
+    void record(const ShapeMap& shapes, int64_t count = 1);
+
+    /**
+     * @brief Count the shapes of the input tensors
+     *
+     */
+    void record(const sample_utils::TensorMap& inputs);
+
+    /**
+     * @brief The distinct shapes and their counts in the order they are first recorded
+     *
+     */
+    const std::vector<std::pair<ShapeMap, int64_t>>& entries() const { return m_entries; }
+
+    int64_t total() const { return m_total; }
+
+    /**
+     * @brief Write the histogram to a JSON file, e.g. {"entries": [{"shapes": {"x": [1, 128]}, "count": 10}]}
+     *
+     * @param path the JSON file
+     * @return Status
+     */
+    Status save(const std::string& path) const;
+
+    /**
+     * @brief Read the histogram written by `save`, the counts are added to the recorded ones
+     *
+     * @param path the JSON file
+     * @return Status
+     */
+    Status load(const std::string& path);
+
+private:
+    std::vector<std::pair<ShapeMap, int64_t>> m_entries;
+    // key: the serialized shapes, value: the index in m_entries
+    std::unordered_map<std::string, size_t> m_indices;
+    int64_t m_total{0};
+};
+
+/**
+ * @brief Get the elements of the input shapes
+ *
+ */
+int64_t get_shape_elements(const ShapeMap& shapes);
+
+/**
+ * @brief Whether the bucket covers the shapes, i.e. they have the same inputs and ranks and no dim of the shapes
+ * exceeds the bucket
+ *
+ */
+bool is_shape_in_bucket(const ShapeMap& shapes, const ShapeMap& bucket);
+
+/**
+ * @brief Get the padded elements of the recorded requests, each request is padded to the smallest bucket which
+ * covers it, the requests which no bucket covers are skipped
+ *
+ * @param histogram the recorded shapes
+ * @param buckets the buckets
+ * @return int64_t
+ */
+int64_t get_padded_elements(const ShapeHistogram& histogram, const std::vector<ShapeMap>& buckets);
+
+/**
+ * @brief Choose the buckets which minimize the padded elements of the recorded requests. Each request is padded to
+ * the smallest bucket which covers it. If a single dim varies the choice is optimal by dynamic programming, otherwise
+ * the closest buckets are merged greedily, which is cubic in the distinct shapes
+ *
+ * @param histogram the recorded shapes, they must have the same inputs and ranks
+ * @param max_buckets the max number of the buckets
+ * @param buckets output parameter. the buckets, the largest shape of each dim is always covered
+ * @param padded_elements output parameter. the padded elements of the recorded requests with the buckets
+ * @return Status
+ */
+Status choose_shape_buckets(const ShapeHistogram& histogram, int max_buckets, std::vector<ShapeMap>& buckets,
+                            int64_t& padded_elements);
+
+/**
+ * @brief Get the artifact directory name of a bucket, e.g. "bucket_x1x3x224x224"
+ *
+ */
+std::string get_bucket_name(const ShapeMap& bucket);
+
+/**
+ * @brief Compile the module with the inputs specialized to each bucket and export the artifacts, the existing ones of
+ * the same module and build options are reused
+ *
+ * @param module the module whose inputs have dynamic dims
+ * @param buckets the buckets
+ * @param options the build options
+ * @param dir the directory of the artifacts
+ * @param artifact_dirs output parameter. the artifact directory of each bucket
+ * @return Status
+ */
+Status compile_shape_buckets(const tvm::IRModule& module, const std::vector<ShapeMap>& buckets,
+                             const compiler::BuildOptions& options, const std::string& dir,
+                             std::vector<std::string>& artifact_dirs);
+
+/**
+ * @brief The statistics of the bucketed session since it is loaded
+ *
+ */
+struct BucketStats {
+    // the requests run by each bucket
+    std::vector<int64_t> requests;
+    // the requests which no bucket covers
+    int64_t rejected{0};
+    // the input elements of the requests and the zeros padded to the buckets
+    int64_t elements{0};
+    int64_t padded_elements{0};
+};
+
+/**
+ * @brief The session of the artifacts compiled for the shape buckets. A request is padded with zeros to the smallest
+ * bucket which covers it, and the outputs are cropped to the request. An output dim is cropped when it follows an
+ * input dim which varies between the buckets by the same ratio, e.g. the sequence length or the feature map size of a
+ * stride 2 conv, otherwise when it equals an input dim in every bucket, or by the crop rules of the caller. The model
+ * must ignore the padding, e.g. by an attention mask input which is padded with zeros too. It is not thread-safe like
+ * `InferenceSession`
+ *
+ */
+class BucketedSession final {
+public:
+    /**
+     * @brief The output dim follows the dim `input_dim` of the input `input` as
+     * `output = ceil(input * numerator / denominator)`, input -1 keeps the dim of the bucket
+     *
+     */
+    struct CropRule {
+        int input{-1};
+        int input_dim{0};
+        int64_t numerator{1};
+        int64_t denominator{1};
+    };
+
+    BucketedSession() = default;
+    BucketedSession(const BucketedSession&) = delete;
+    BucketedSession& operator=(const BucketedSession&) = delete;
+
+    /**
+     * @brief Load the artifacts of the buckets, they are compiled from the same model. The crop rules are inferred
+     * from the shapes of the buckets, an input dim of the same index is preferred when the ranks match. An output dim
+     * which follows more than one input dim is rejected, the crop rules must be given then
+     *
+     * @param artifact_dirs the artifact directories, e.g. the output of `compile_shape_buckets`
+     * @return Status
+     */
+    Status load(const std::vector<std::string>& artifact_dirs);
+
+    /**
+     * @brief Load the artifacts of the buckets with the crop rules given by the caller
+     *
+     * @param artifact_dirs the artifact directories, e.g. the output of `compile_shape_buckets`
+     * @param crop_rules the crop rule of each dim of each output
+     * @return Status
+     */
+    Status load(const std::vector<std::string>& artifact_dirs, const std::vector<std::vector<CropRule>>& crop_rules);
+
+    /**
+     * @brief The input shapes of the buckets in the order of the artifacts
+     *
+     */
+    const std::vector<ShapeMap>& get_buckets() const { return m_buckets; }
+
+    /**
+     * @brief Run a request
+     *
+     * @param inputs the input tensors by name, each dim must not exceed the largest bucket
+     * @param outputs output parameter. the cropped outputs in the order of the session outputs
+     * @return Status
+     */
+    Status run(const sample_utils::TensorMap& inputs, std::vector<tvm::runtime::NDArray>& outputs);
+
+    const BucketStats& get_stats() const { return m_stats; }
+
+private:
+    struct Bucket {
+        std::unique_ptr<InferenceSession> session;
+        // the padded inputs bound to the session without copy
+        std::vector<tvm::runtime::NDArray> inputs;
+        int64_t elements{0};
+    };
+
+    static Status check_crop_rules(const std::vector<TensorInfo>& inputs, const std::vector<TensorInfo>& outputs,
+                                   const std::vector<std::vector<CropRule>>& crop_rules);
+    static Status infer_crop_rules(const std::vector<Bucket>& sessions, std::vector<std::vector<CropRule>>& crop_rules);
+    static Status choose_crop_rule(const std::vector<Bucket>& sessions, size_t output, size_t output_dim,
+                                   const std::vector<CropRule>& candidates, CropRule& rule);
+    Status load_buckets(const std::vector<std::string>& artifact_dirs,
+                        const std::vector<std::vector<CropRule>>* given_rules);
+
+    std::vector<ShapeMap> m_buckets;
+    std::vector<Bucket> m_sessions;
+    // the crop rule of each dim of each output, input -1 keeps the dim of the bucket
+    std::vector<std::vector<CropRule>> m_crop_rules;
+    BucketStats m_stats;
+};
+
+}    // namespace serving
+}    // namespace tvm_cpp
+
+#endif
@@ -0,0 +1,232 @@
+#include "tensor_pool.h"
+
+#include <sstream>
+
+namespace tvm_cpp {
+namespace serving {
+
+namespace {
+
+// the head of a free list packs the node index + 1 in the low 32 bits, 0 is empty, and a tag in the high 32 bits
+// which changes on every update, so a stale head of the ABA problem fails the compare-exchange
+constexpr uint64_t kIndexMask = 0xffffffffULL;
+
+uint64_t make_head(uint64_t old_head, uint64_t index_plus_one) {
+    return (((old_head >> 32) + 1) << 32) | index_plus_one;
+}
+
+void update_max(std::atomic<int64_t>& max_value, int64_t value) {
+    int64_t current = max_value.load(std::memory_order_relaxed);
+    while (current < value && !max_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+}    // namespace
+
+/**
+ * @brief The buffers of a key. The buffers are created lazily up to the cap, a buffer is only read by the thread
+ * which popped its node from the free list
+ *
+ */
+struct TensorPool::Bucket {
+    std::vector<int64_t> shape;
+    tvm::DataType dtype;
+    int64_t bytes{0};
+
+    std::vector<tvm::runtime::NDArray> buffers;
+    std::unique_ptr<std::atomic<uint32_t>[]> next;
+    std::atomic<uint64_t> head{0};
+
+    std::atomic<int64_t> allocated{0};
+    std::atomic<int64_t> in_use{0};
+    std::atomic<int64_t> high_water_mark{0};
+    std::atomic<int64_t> reused{0};
+    std::atomic<int64_t> overflow{0};
+
+    bool pop(int& node) {
+        uint64_t head_value = head.load(std::memory_order_acquire);
+        while (true) {
+            uint64_t index_plus_one = head_value & kIndexMask;
+            if (index_plus_one == 0) {
+                return false;
+            }
+
+            uint32_t next_plus_one = next[index_plus_one - 1].load(std::memory_order_relaxed);
+            if (head.compare_exchange_weak(head_value, make_head(head_value, next_plus_one),
+                                           std::memory_order_acquire, std::memory_order_acquire)) {
+                node = static_cast<int>(index_plus_one - 1);
+                return true;
+            }
+        }
+    }
+
+    void push(int node) {
+        uint64_t head_value = head.load(std::memory_order_relaxed);
+        uint64_t new_head = 0;
+        do {
+            next[node].store(static_cast<uint32_t>(head_value & kIndexMask), std::memory_order_relaxed);
+            new_head = make_head(head_value, static_cast<uint64_t>(node) + 1);
+        } while (!head.compare_exchange_weak(head_value, new_head, std::memory_order_release,
+                                             std::memory_order_relaxed));
+    }
+};
+
+PooledTensor::PooledTensor(PooledTensor&& other) noexcept
+    : m_pool(std::move(other.m_pool)), m_bucket(other.m_bucket), m_node(other.m_node),
+      m_array(std::move(other.m_array)) {
+    other.m_bucket = -1;
+    other.m_node = -1;
+}
+
+PooledTensor& PooledTensor::operator=(PooledTensor&& other) noexcept {
+    if (this != &other) {
+        reset();
+        m_pool = std::move(other.m_pool);
+        m_bucket = other.m_bucket;
+        m_node = other.m_node;
+        m_array = std::move(other.m_array);
+        other.m_bucket = -1;
+        other.m_node = -1;
+    }
+    return *this;
+}
+
+void PooledTensor::reset() {
+    m_array = tvm::runtime::NDArray();
+    if (m_pool) {
+        m_pool->release(m_bucket, m_node);
+        m_pool.reset();
+    }
+    m_bucket = -1;
+    m_node = -1;
+}
+
+Status TensorPool::create(const std::vector<std::vector<int64_t>>& shapes, const std::vector<tvm::DataType>& dtypes,
+                          int max_buffers, std::shared_ptr<TensorPool>& pool) {
+    if (shapes.size() != dtypes.size()) {
+        return Status(StatusCode::INVALID_PARAM, "the shapes and the dtypes of the tensor pool do not match");
+    }
+
+    if (max_buffers <= 0) {
+        return Status(StatusCode::INVALID_PARAM, "the cap of the tensor pool must be positive");
+    }
+
+    pool = std::shared_ptr<TensorPool>(new TensorPool());
+    pool->m_max_buffers = max_buffers;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        if (pool->find_key(shapes[i], dtypes[i]) >= 0) {
+            continue;
+        }
+
+        int64_t count = 1;
+        for (int64_t dim : shapes[i]) {
+            if (dim < 0) {
+                return Status(StatusCode::INVALID_PARAM, "the pooled tensors must have static shapes");
+            }
+            count *= dim;
+        }
+
+        auto bucket = std::make_unique<Bucket>();
+        bucket->shape = shapes[i];
+        bucket->dtype = dtypes[i];
+        bucket->bytes = count * ((dtypes[i].bits() * dtypes[i].lanes() + 7) / 8);
+        bucket->buffers.resize(max_buffers);
+        bucket->next = std::make_unique<std::atomic<uint32_t>[]>(max_buffers);
+        pool->m_buckets.emplace_back(std::move(bucket));
+    }
+
+    return Status::ok();
+}
+
+TensorPool::~TensorPool() = default;
+
+int TensorPool::find_key(const std::vector<int64_t>& shape, const tvm::DataType& dtype) const {
+    for (size_t i = 0; i < m_buckets.size(); ++i) {
+        if (m_buckets[i]->shape == shape && m_buckets[i]->dtype == dtype) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+Status TensorPool::acquire(int key, PooledTensor& tensor) {
+    if (key < 0 || key >= static_cast<int>(m_buckets.size())) {
+        return Status(StatusCode::INVALID_PARAM, "tensor pool key out of range: " + std::to_string(key));
+    }
+
+    tensor.reset();
+    Bucket& bucket = *m_buckets[key];
+    int node = -1;
+    if (!bucket.pop(node)) {
+        // reserve a new buffer below the cap
+        int64_t allocated = bucket.allocated.load(std::memory_order_relaxed);
+        while (allocated < m_max_buffers &&
+               !bucket.allocated.compare_exchange_weak(allocated, allocated + 1, std::memory_order_relaxed)) {
+        }
+
+        if (allocated >= m_max_buffers) {
+            bucket.overflow.fetch_add(1, std::memory_order_relaxed);
+            try {
+                tensor.m_array = tvm::runtime::NDArray::Empty(bucket.shape, bucket.dtype, {kDLCPU, 0});
+            } catch (const tvm::runtime::Error& e) {
+                return Status(StatusCode::OUT_OF_MEMORY, e.what());
+            }
+            return Status::ok();
+        }
+        node = static_cast<int>(allocated);
+    }
+
+    if (bucket.buffers[node].defined()) {
+        bucket.reused.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        try {
+            bucket.buffers[node] = tvm::runtime::NDArray::Empty(bucket.shape, bucket.dtype, {kDLCPU, 0});
+        } catch (const tvm::runtime::Error& e) {
+            // the empty node is allocated by the next acquisition
+            bucket.push(node);
+            return Status(StatusCode::OUT_OF_MEMORY, e.what());
+        }
+    }
+
+    tensor.m_pool = shared_from_this();
+    tensor.m_bucket = key;
+    tensor.m_node = node;
+    tensor.m_array = bucket.buffers[node];
+
+    int64_t in_use = bucket.in_use.fetch_add(1, std::memory_order_relaxed) + 1;
+    update_max(bucket.high_water_mark, in_use);
+    return Status::ok();
+}
+
+Status TensorPool::acquire(const std::vector<int64_t>& shape, const tvm::DataType& dtype, PooledTensor& tensor) {
+    int key = find_key(shape, dtype);
+    if (key < 0) {
+        std::ostringstream oss;
+        oss << "the tensor pool has no key of " << dtype << " with " << shape.size() << " dims";
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    return acquire(key, tensor);
+}
+
+TensorPoolStats TensorPool::get_stats() const {
+    TensorPoolStats stats;
+    for (const auto& bucket : m_buckets) {
+        int64_t allocated = bucket->allocated.load(std::memory_order_relaxed);
+        stats.allocated += allocated;
+        stats.allocated_bytes += allocated * bucket->bytes;
+        stats.in_use += bucket->in_use.load(std::memory_order_relaxed);
+        stats.high_water_mark += bucket->high_water_mark.load(std::memory_order_relaxed);
+        stats.reused += bucket->reused.load(std::memory_order_relaxed);
+        stats.overflow += bucket->overflow.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void TensorPool::release(int bucket, int node) {
+    m_buckets[bucket]->in_use.fetch_sub(1, std::memory_order_relaxed);
+    m_buckets[bucket]->push(node);
+}
+
+}    // namespace serving
+}    // namespace tvm_cpp
@@ -0,0 +1,142 @@
+#ifndef _H_TVM_CPP_SERVING_TENSOR_POOL_H_
+#define _H_TVM_CPP_SERVING_TENSOR_POOL_H_
+
+#include <tvm/runtime/data_type.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace serving {
+
+class TensorPool;
+
+/**
+ * @brief The statistics of a tensor pool, summed over its keys
+ *
+ */
+struct TensorPoolStats {
+    // the buffers allocated by the pool, they are kept until the pool is destroyed
+    int64_t allocated{0};
+    int64_t allocated_bytes{0};
+    // the buffers acquired and not released yet
+    int64_t in_use{0};
+    // the sum of the max numbers of the buffers of each key in use at the same time
+    int64_t high_water_mark{0};
+    // the acquisitions served from the free list
+    int64_t reused{0};
+    // the acquisitions beyond the cap, they are served by an unpooled allocation
+    int64_t overflow{0};
+};
+
+/**
+ * @brief A tensor acquired from a TensorPool, the buffer returns to the pool when the handle is reset or destroyed.
+ * The NDArray must not be used after that
+ *
+ */
+class PooledTensor final {
+public:
+    PooledTensor() = default;
+    ~PooledTensor() { reset(); }
+
+    PooledTensor(const PooledTensor&) = delete;
+    PooledTensor& operator=(const PooledTensor&) = delete;
+    PooledTensor(PooledTensor&& other) noexcept;
+    PooledTensor& operator=(PooledTensor&& other) noexcept;
+
+    const tvm::runtime::NDArray& get() const { return m_array; }
+    bool defined() const { return m_array.defined(); }
+    // false if the tensor was allocated beyond the cap of the pool
+    bool is_pooled() const { return m_node >= 0; }
+
+    /**
+     * @brief Return the buffer to the pool
+     *
+     */
+    void reset();
+
+private:
+    friend class TensorPool;
+
+    std::shared_ptr<TensorPool> m_pool;
+    int m_bucket{-1};
+    int m_node{-1};
+    tvm::runtime::NDArray m_array;
+};
+
+/**
+ * @brief A pool of CPU tensors keyed by (shape, dtype). The released buffers are kept in a lock-free free list of each
+ * key, so the acquisitions and the releases of any thread do not allocate once the pool is warm. At most `max_buffers`
+ * buffers of each key are pooled
+ *
+ */
+class TensorPool final : public std::enable_shared_from_this<TensorPool> {
+public:
+    /**
+     * @brief Create the pool
+     *
+     * @param shapes the shapes of the pooled tensors, a shape may appear several times
+     * @param dtypes the dtypes of the pooled tensors
+     * @param max_buffers the cap of the buffers of each key
+     * @param pool output parameter. the pool
+     * @return Status
+     */
+    static Status create(const std::vector<std::vector<int64_t>>& shapes, const std::vector<tvm::DataType>& dtypes,
+                         int max_buffers, std::shared_ptr<TensorPool>& pool);
+
+    ~TensorPool();
+
+    /**
+     * @brief Find the key of (shape, dtype)
+     *
+     * @return int the key index, -1 if it is not pooled
+     */
+    int find_key(const std::vector<int64_t>& shape, const tvm::DataType& dtype) const;
+
+    /**
+     * @brief Acquire a tensor of the key, it is reused from the free list or allocated
+     *
+     * @param key the key index from `find_key`
+     * @param tensor output parameter. the tensor
+     * @return Status
+     */
+    Status acquire(int key, PooledTensor& tensor);
+
+    /**
+     * @brief Acquire a tensor of (shape, dtype)
+     *
+     * @param shape the shape
+     * @param dtype the dtype
+     * @param tensor output parameter. the tensor
+     * @return Status
+     */
+    Status acquire(const std::vector<int64_t>& shape, const tvm::DataType& dtype, PooledTensor& tensor);
+
+    /**
+     * @brief Get the statistics of the pool
+     *
+     * @return TensorPoolStats
+     */
+    TensorPoolStats get_stats() const;
+
+private:
+    friend class PooledTensor;
+
+    struct Bucket;
+
+    TensorPool() = default;
+    void release(int bucket, int node);
+
+    int m_max_buffers{0};
+    std::vector<std::unique_ptr<Bucket>> m_buckets;
+};
+
+}    // namespace serving
+}    // namespace tvm_cpp
+
+#endif
@@ -0,0 +1,137 @@
+#include "thread_config.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/string.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+namespace tvm_cpp {
+namespace serving {
+
+namespace {
+
+// the affinity modes of `runtime.config_threadpool`, see threading::ThreadGroup::AffinityMode of TVM
+constexpr int kAffinityBig = 1;
+constexpr int kAffinitySpecifyOneCorePerThread = -2;
+constexpr int kAffinitySpecifyThreadShareAllCore = -3;
+
+bool parse_core(const std::string& text, int& core) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos || text.size() > 6) {
+        return false;
+    }
+    core = std::stoi(text);
+    return true;
+}
+
+}    // namespace
+
+Status parse_core_list(const std::string& text, std::vector<int>& cores) {
+    cores.clear();
+    std::istringstream iss(text);
+    std::string item;
+    while (std::getline(iss, item, ',')) {
+        size_t dash = item.find('-');
+        int first = 0;
+        int last = 0;
+        bool valid = dash == std::string::npos
+                         ? parse_core(item, first) && parse_core(item, last)
+                         : parse_core(item.substr(0, dash), first) && parse_core(item.substr(dash + 1), last);
+        if (!valid || first > last) {
+            return Status(StatusCode::INVALID_PARAM, "invalid core list: " + text);
+        }
+
+        for (int core = first; core <= last; ++core) {
+            cores.push_back(core);
+        }
+    }
+
+    if (cores.empty()) {
+        return Status(StatusCode::INVALID_PARAM, "empty core list");
+    }
+    return Status::ok();
+}
+
+Status split_thread_config(const ThreadConfig& config, int parts, std::vector<ThreadConfig>& configs) {
+    if (parts < 1) {
+        return Status(StatusCode::INVALID_PARAM, "the thread config is split to 0 parts");
+    }
+    if (!config.cores.empty() && static_cast<int>(config.cores.size()) < parts) {
+        return Status(StatusCode::INVALID_PARAM, "the thread config has " + std::to_string(config.cores.size()) +
+                                                     " cores for " + std::to_string(parts) + " threads");
+    }
+
+    configs.assign(parts, ThreadConfig());
+    for (int i = 0; i < parts; ++i) {
+        // the first parts take the remainder, one more core or thread each
+        if (config.threads > 0) {
+            configs[i].threads = std::max(1, config.threads / parts + (i < config.threads % parts ? 1 : 0));
+        }
+        if (!config.cores.empty()) {
+            size_t size = config.cores.size() / parts;
+            size_t rest = config.cores.size() % parts;
+            size_t begin = i * size + std::min<size_t>(i, rest);
+            size_t end = begin + size + (static_cast<size_t>(i) < rest ? 1 : 0);
+            configs[i].cores.assign(config.cores.begin() + begin, config.cores.begin() + end);
+        }
+    }
+
+    return Status::ok();
+}
+
+Status apply_thread_config(const ThreadConfig& config) {
+    if (config.threads < 0) {
+        return Status(StatusCode::INVALID_PARAM, "the thread count of the thread config is negative");
+    }
+    if (config.threads == 0 && config.cores.empty()) {
+        return Status::ok();
+    }
+
+    if (!config.cores.empty()) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (int core : config.cores) {
+            if (core < 0 || core >= CPU_SETSIZE) {
+                return Status(StatusCode::INVALID_PARAM, "invalid core " + std::to_string(core));
+            }
+            CPU_SET(core, &cpu_set);
+        }
+
+        // the calling thread runs the first task of each parallel region, so it is pinned with the pool
+        int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        if (ret != 0) {
+            return Status(StatusCode::THREAD_ERROR, "pthread_setaffinity_np failed with " + std::to_string(ret));
+        }
+    }
+
+    const tvm::runtime::PackedFunc* config_threadpool = tvm::runtime::Registry::Get("runtime.config_threadpool");
+    if (!config_threadpool) {
+        return Status(StatusCode::RUNTIME_ERROR, "runtime.config_threadpool not found");
+    }
+
+    try {
+        if (config.cores.empty()) {
+            (*config_threadpool)(kAffinityBig, config.threads);
+        } else {
+            int threads = config.threads > 0 ? config.threads : static_cast<int>(config.cores.size());
+            int mode = threads <= static_cast<int>(config.cores.size()) ? kAffinitySpecifyOneCorePerThread
+                                                                        : kAffinitySpecifyThreadShareAllCore;
+            tvm::runtime::Array<tvm::runtime::String> cpus;
+            for (int core : config.cores) {
+                cpus.push_back(std::to_string(core));
+            }
+            (*config_threadpool)(mode, threads, cpus);
+        }
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
+}    // namespace serving
+}    // namespace tvm_cpp
@@ -0,0 +1,57 @@
+#ifndef _H_TVM_CPP_SERVING_THREAD_CONFIG_H_
+#define _H_TVM_CPP_SERVING_THREAD_CONFIG_H_
+
+#include <string>
+#include <vector>
+
+#include "utils/status.h"
+
+namespace tvm_cpp {
+namespace serving {
+
+/**
+ * @brief The intra-op threads and the cores of the runs of a thread. The TVM thread pool is thread local, the runs
+ * issued by a thread use the pool of that thread, so the sessions run by different threads are configured apart
+ *
+ */
+struct ThreadConfig {
+    // the threads of the TVM thread pool including the calling thread, 0 means one per core, or the TVM default
+    // without cores
+    int threads{0};
+    // the logical cpus of the calling thread and its pool threads, empty means the TVM default binding
+    std::vector<int> cores;
+};
+
+/**
+ * @brief Parse a core list like "0-7,16,18-19"
+ *
+ * @param text the comma separated cores and ranges
+ * @param cores output parameter. the cores in the order of the list
+ * @return Status
+ */
+Status parse_core_list(const std::string& text, std::vector<int>& cores);
+
+/**
+ * @brief Split the config to the parts run by different threads, e.g. the workers of a session. The cores are split
+ * into disjoint contiguous groups and the threads are divided among the parts
+ *
+ * @param config the config of all the parts
+ * @param parts the number of parts
+ * @param configs output parameter. the config of each part
+ * @return Status
+ */
+Status split_thread_config(const ThreadConfig& config, int parts, std::vector<ThreadConfig>& configs);
+
+/**
+ * @brief Pin the calling thread to the cores and configure its TVM thread pool, the pool threads are pinned one per
+ * core when there are enough cores, or share all of them otherwise. It is called before the first run of the thread
+ *
+ * @param config the thread config, the default config keeps the TVM defaults
+ * @return Status
+ */
+Status apply_thread_config(const ThreadConfig& config);
+
+}    // namespace serving
+}    // namespace tvm_cpp
+
+#endif
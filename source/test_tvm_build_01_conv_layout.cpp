@@ -0,0 +1,125 @@
+#include <tvm/ir/module.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "compiler/layout_transform.h"
+#include "compiler/model_builder.h"
+#include "onnx.proto3.pb.h"
+#include "utils/onnx_utils.h"
+#include "utils/relay_utils.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::onnx_utils;
+using namespace tvm_cpp::relay_utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+
+int main(int argc, char** argv) {
+    if (argc <= 1) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx [iterations] [target]" << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    int iterations = argc > 2 ? std::stoi(argv[2]) : 100;
+    std::string target = argc > 3 ? argv[3] : "llvm";
+
+    onnx::ModelProto onnx_model;
+    auto ret = load_onnx_model(file_name, onnx_model);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    // the dynamic dims are set to 1
+    std::unordered_map<std::string, std::vector<int64_t>> input_shapes;
+    get_graph_input_shapes(onnx_model.graph(), 1, input_shapes);
+    std::vector<TensorMap> samples;
+    create_random_samples(input_shapes, 1, 0, samples);
+
+    const std::vector<ConvLayout> layouts{ConvLayout::NCHW, ConvLayout::NHWC, ConvLayout::NCHWc};
+
+    std::cout << std::left << std::setw(8) << "layout" << std::setw(14) << "build(ms)" << std::setw(14)
+              << "latency(ms)" << std::setw(14) << "act. trans" << std::setw(14) << "const trans" << std::endl;
+
+    // every layout is reported, a broken layout fails the test at the end
+    bool failed = false;
+    for (auto layout : layouts) {
+        tvm::IRModule mod;
+        ret = parse_graph_to_irmodule(onnx_model.graph(), mod);
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+
+        BuildOptions options;
+        options.target = target;
+        options.conv_layout = layout;
+
+        // the layout transforms left after the weights are pre-packed
+        tvm::IRModule optimized_mod = mod;
+        ret = optimize_irmodule(optimized_mod, options);
+        if (!ret.is_ok()) {
+            std::cerr << conv_layout_to_string(layout) << " optimize failed: " << ret << std::endl;
+            failed = true;
+            continue;
+        }
+
+        LayoutTransformStats stats;
+        count_layout_transforms(optimized_mod, stats);
+
+        auto build_start = std::chrono::steady_clock::now();
+        BuildResult result;
+        ret = build_irmodule(mod, options, result);
+        auto build_end = std::chrono::steady_clock::now();
+        if (!ret.is_ok()) {
+            std::cerr << conv_layout_to_string(layout) << " build failed: " << ret << std::endl;
+            failed = true;
+            continue;
+        }
+
+        tvm::runtime::Module executor;
+        ret = create_graph_executor(result, executor);
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+
+        tvm::runtime::PackedFunc set_input = executor.GetFunction("set_input");
+        for (const auto& kv : samples[0]) {
+            set_input(kv.first, kv.second);
+        }
+        tvm::runtime::PackedFunc run = executor.GetFunction("run");
+
+        // warm up
+        for (int i = 0; i < 10; ++i) {
+            run();
+        }
+
+        auto run_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            run();
+        }
+        auto run_end = std::chrono::steady_clock::now();
+
+        double build_ms = std::chrono::duration<double, std::milli>(build_end - build_start).count();
+        double latency_ms = std::chrono::duration<double, std::milli>(run_end - run_start).count() / iterations;
+
+        std::cout << std::left << std::setw(8) << conv_layout_to_string(layout) << std::setw(14) << build_ms
+                  << std::setw(14) << latency_ms << std::setw(14) << stats.activation_transforms << std::setw(14)
+                  << stats.constant_transforms << std::endl;
+    }
+
+    return failed ? -1 : 0;
+}
@@ -0,0 +1,135 @@
+#include <tvm/ir/module.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "compiler/meta_schedule_tuner.h"
+#include "compiler/model_builder.h"
+#include "onnx.proto3.pb.h"
+#include "utils/onnx_utils.h"
+#include "utils/relay_utils.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::onnx_utils;
+using namespace tvm_cpp::relay_utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+
+// build the module and measure the mean latency in milli seconds
+int measure_latency(const tvm::IRModule& mod, const BuildOptions& options, const TensorMap& sample, int iterations,
+                    double& latency_ms) {
+    BuildResult result;
+    auto ret = build_irmodule(mod, options, result);
+    if (!ret.is_ok()) {
+        std::cerr << "build failed: " << ret << std::endl;
+        return -1;
+    }
+
+    tvm::runtime::Module executor;
+    ret = create_graph_executor(result, executor);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    tvm::runtime::PackedFunc set_input = executor.GetFunction("set_input");
+    for (const auto& kv : sample) {
+        set_input(kv.first, kv.second);
+    }
+    tvm::runtime::PackedFunc run = executor.GetFunction("run");
+
+    // warm up
+    for (int i = 0; i < 10; ++i) {
+        run();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        run();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    latency_ms = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx work_dir [max_trials] [target]" << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string work_dir(argv[2]);
+    int max_trials = argc > 3 ? std::stoi(argv[3]) : 1000;
+    std::string target = argc > 4 ? argv[4] : "llvm";
+    int iterations = 100;
+
+    onnx::ModelProto onnx_model;
+    auto ret = load_onnx_model(file_name, onnx_model);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    tvm::IRModule mod;
+    ret = parse_graph_to_irmodule(onnx_model.graph(), mod);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    // the dynamic dims are set to 1
+    std::unordered_map<std::string, std::vector<int64_t>> input_shapes;
+    get_graph_input_shapes(onnx_model.graph(), 1, input_shapes);
+    std::vector<TensorMap> samples;
+    create_random_samples(input_shapes, 1, 0, samples);
+
+    // Step 1. the latency with the default schedules
+    BuildOptions options;
+    options.target = target;
+
+    double untuned_ms = 0;
+    if (measure_latency(mod, options, samples[0], iterations, untuned_ms) != 0) {
+        return -1;
+    }
+
+    // Step 2. tune the tasks and persist the records to the JSON database
+    options.meta_schedule_dir = work_dir;
+
+    TuningOptions tuning;
+    tuning.max_trials_global = max_trials;
+
+    std::vector<TaskTuningReport> reports;
+    ret = tune_irmodule(mod, options, tuning, reports);
+    if (!ret.is_ok()) {
+        std::cerr << "tune failed: " << ret << std::endl;
+        return -1;
+    }
+
+    print_tuning_reports(reports);
+
+    // Step 3. the latency with the tuning records applied
+    double tuned_ms = 0;
+    if (measure_latency(mod, options, samples[0], iterations, tuned_ms) != 0) {
+        return -1;
+    }
+
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(12) << "schedule" << std::setw(14) << "latency(ms)" << std::endl;
+    std::cout << std::left << std::setw(12) << "default" << std::setw(14) << untuned_ms << std::endl;
+    std::cout << std::left << std::setw(12) << "tuned" << std::setw(14) << tuned_ms << std::endl;
+    std::cout << "speedup: " << untuned_ms / tuned_ms << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include <tvm/ir/module.h>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "compiler/meta_schedule_tuner.h"
+#include "compiler/tuning_record_store.h"
+#include "onnx.proto3.pb.h"
+#include "utils/onnx_utils.h"
+#include "utils/relay_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::onnx_utils;
+using namespace tvm_cpp::relay_utils;
+using namespace tvm_cpp::compiler;
+
+void print_usage(const char* name) {
+    std::cerr << "Usage: " << name << " tune store_dir max_trials model.onnx [model.onnx ...]" << std::endl;
+    std::cerr << "       " << name << " merge dst_store_dir src_store_dir [src_store_dir ...]" << std::endl;
+}
+
+// tune the models one by one, the later models reuse the records of the shared workloads
+int tune_models(const std::string& store_dir, int max_trials, const std::vector<std::string>& model_files) {
+    BuildOptions options;
+    options.tuning_store_dir = store_dir;
+
+    TuningOptions tuning;
+    tuning.max_trials_global = max_trials;
+
+    struct ModelRow {
+        std::string name;
+        TuningCoverage before;
+        TuningCoverage after;
+        int trials{0};
+    };
+    std::vector<ModelRow> rows;
+
+    for (const auto& file_name : model_files) {
+        onnx::ModelProto onnx_model;
+        auto ret = load_onnx_model(file_name, onnx_model);
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+
+        tvm::IRModule mod;
+        ret = parse_graph_to_irmodule(onnx_model.graph(), mod);
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+
+        ModelRow row;
+        row.name = file_name;
+
+        // the first query runs in a cold process, before any build or tuning has prepared the lowering
+
+        ret = query_tuning_coverage(mod, options, row.before);
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+        if (row.before.total_tasks == 0) {
+            std::cerr << "no tuning task extracted from " << file_name << std::endl;
+            return -1;
+        }
+
+        std::vector<TaskTuningReport> reports;
+        ret = tune_irmodule(mod, options, tuning, reports);
+        if (!ret.is_ok()) {
+            std::cerr << "tune failed: " << ret << std::endl;
+            return -1;
+        }
+
+        for (const auto& report : reports) {
+            row.trials += report.trials;
+        }
+
+        ret = query_tuning_coverage(mod, options, row.after);
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+
+        for (const auto& task_name : row.after.uncovered_tasks) {
+            std::cout << "uncovered task: " << task_name << std::endl;
+        }
+
+        rows.emplace_back(row);
+    }
+
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(40) << "model" << std::setw(8) << "tasks" << std::setw(16) << "covered before"
+              << std::setw(16) << "covered after" << std::setw(8) << "trials" << std::endl;
+    for (const auto& row : rows) {
+        std::cout << std::left << std::setw(40) << row.name << std::setw(8) << row.before.total_tasks << std::setw(16)
+                  << row.before.covered_tasks << std::setw(16) << row.after.covered_tasks << std::setw(8)
+                  << row.trials << std::endl;
+    }
+
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 3) {
+        print_usage(argv[0]);
+        return -1;
+    }
+
+    std::string mode(argv[1]);
+    if (mode == "tune") {
+        if (argc <= 4) {
+            print_usage(argv[0]);
+            return -1;
+        }
+
+        std::vector<std::string> model_files(argv + 4, argv + argc);
+        return tune_models(argv[2], std::stoi(argv[3]), model_files);
+    }
+
+    if (mode == "merge") {
+        std::vector<std::string> src_dirs(argv + 3, argv + argc);
+
+        MergeStats stats;
+        auto ret = merge_tuning_stores(src_dirs, argv[2], stats);
+        if (!ret.is_ok()) {
+            std::cerr << "merge failed: " << ret << std::endl;
+            return -1;
+        }
+
+        std::cout << "merged targets: " << stats.targets << ", new workloads: " << stats.new_workloads
+                  << ", new records: " << stats.new_records << ", skipped records: " << stats.skipped_records
+                  << std::endl;
+        return 0;
+    }
+
+    print_usage(argv[0]);
+    return -1;
+}
@@ -0,0 +1,124 @@
+#include <tvm/ir/module.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "compiler/model_builder.h"
+#include "onnx.proto3.pb.h"
+#include "utils/onnx_utils.h"
+#include "utils/relay_utils.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::onnx_utils;
+using namespace tvm_cpp::relay_utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+
+struct ExecutorCase {
+    std::string name;
+    ExecutorKind executor;
+    bool usmp;
+};
+
+int main(int argc, char** argv) {
+    if (argc <= 1) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx [iterations] [target] [usmp_algorithm]" << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    int iterations = argc > 2 ? std::stoi(argv[2]) : 100;
+    std::string target = argc > 3 ? argv[3] : "llvm";
+    std::string usmp_algorithm = argc > 4 ? argv[4] : "greedy_by_conflicts";
+
+    onnx::ModelProto onnx_model;
+    auto ret = load_onnx_model(file_name, onnx_model);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    tvm::IRModule mod;
+    ret = parse_graph_to_irmodule(onnx_model.graph(), mod);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    // the dynamic dims are set to 1
+    std::unordered_map<std::string, std::vector<int64_t>> input_shapes;
+    get_graph_input_shapes(onnx_model.graph(), 1, input_shapes);
+    std::vector<TensorMap> samples;
+    create_random_samples(input_shapes, 1, 0, samples);
+
+    const std::vector<ExecutorCase> cases{{"graph", ExecutorKind::Graph, false},
+                                          {"aot", ExecutorKind::AOT, false},
+                                          {"aot+usmp", ExecutorKind::AOT, true}};
+
+    std::cout << std::left << std::setw(12) << "executor" << std::setw(14) << "build(ms)" << std::setw(14)
+              << "latency(ms)" << std::setw(16) << "workspace(B)" << std::setw(16) << "constant(B)" << std::endl;
+
+    // every case is reported, a broken executor path fails the test at the end
+    bool failed = false;
+    for (const auto& executor_case : cases) {
+        BuildOptions options;
+        options.target = target;
+        options.executor = executor_case.executor;
+        options.usmp = executor_case.usmp;
+        options.usmp_algorithm = usmp_algorithm;
+
+        auto build_start = std::chrono::steady_clock::now();
+        BuildResult result;
+        ret = build_irmodule(mod, options, result);
+        auto build_end = std::chrono::steady_clock::now();
+        if (!ret.is_ok()) {
+            std::cerr << executor_case.name << " build failed: " << ret << std::endl;
+            failed = true;
+            continue;
+        }
+
+        tvm::runtime::Module executor;
+        ret = create_executor(result, executor);
+        if (!ret.is_ok()) {
+            std::cerr << executor_case.name << " create executor failed: " << ret << std::endl;
+            failed = true;
+            continue;
+        }
+
+        tvm::runtime::PackedFunc set_input = executor.GetFunction("set_input");
+        for (const auto& kv : samples[0]) {
+            set_input(kv.first, kv.second);
+        }
+        tvm::runtime::PackedFunc run = executor.GetFunction("run");
+
+        // warm up
+        for (int i = 0; i < 10; ++i) {
+            run();
+        }
+
+        auto run_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            run();
+        }
+        auto run_end = std::chrono::steady_clock::now();
+
+        double build_ms = std::chrono::duration<double, std::milli>(build_end - build_start).count();
+        double latency_ms = std::chrono::duration<double, std::milli>(run_end - run_start).count() / iterations;
+
+        std::cout << std::left << std::setw(12) << executor_case.name << std::setw(14) << build_ms << std::setw(14)
+                  << latency_ms << std::setw(16) << result.workspace_size << std::setw(16) << result.constant_size
+                  << std::endl;
+    }
+
+    return failed ? -1 : 0;
+}
@@ -0,0 +1,182 @@
+#include <tvm/ir/module.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "compiler/model_builder.h"
+#include "compiler/vm_builder.h"
+#include "onnx.proto3.pb.h"
+#include "utils/onnx_utils.h"
+#include "utils/relay_utils.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::onnx_utils;
+using namespace tvm_cpp::relay_utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+
+// the mean latency of the function in milli seconds
+template <typename Func>
+double measure_latency(Func&& func, int iterations) {
+    // warm up
+    for (int i = 0; i < 10; ++i) {
+        func();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        func();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx work_dir [batch_sizes] [iterations] [target]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx /tmp/vm 1,2,4,8,16 100 llvm" << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string work_dir(argv[2]);
+    std::string batch_str = argc > 3 ? argv[3] : "1,2,4,8,16";
+    int iterations = argc > 4 ? std::stoi(argv[4]) : 100;
+    std::string target = argc > 5 ? argv[5] : "llvm";
+
+    std::vector<int64_t> batch_sizes;
+    std::istringstream batch_iss(batch_str);
+    for (std::string item; std::getline(batch_iss, item, ',');) {
+        batch_sizes.emplace_back(std::stoll(item));
+    }
+
+    onnx::ModelProto onnx_model;
+    auto ret = load_onnx_model(file_name, onnx_model);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    tvm::IRModule mod;
+    ret = parse_graph_to_irmodule(onnx_model.graph(), mod);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    BuildOptions options;
+    options.target = target;
+
+    // Step 1. compile the dynamic module once, save and load the executable
+    tvm::runtime::Module executable;
+    ret = build_vm_executable(mod, options, executable);
+    if (!ret.is_ok()) {
+        std::cerr << "vm build failed: " << ret << std::endl;
+        return -1;
+    }
+
+    std::filesystem::create_directories(work_dir);
+    std::string code_path = (std::filesystem::path(work_dir) / "model.ro").string();
+    std::string lib_path = (std::filesystem::path(work_dir) / "model.so").string();
+    ret = save_vm_executable(executable, code_path, lib_path);
+    if (!ret.is_ok()) {
+        std::cerr << "vm save failed: " << ret << std::endl;
+        return -1;
+    }
+
+    tvm::runtime::Module loaded_executable;
+    ret = load_vm_executable(code_path, lib_path, loaded_executable);
+    if (!ret.is_ok()) {
+        std::cerr << "vm load failed: " << ret << std::endl;
+        return -1;
+    }
+
+    tvm::runtime::Module vm;
+    ret = create_virtual_machine(loaded_executable, vm);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    tvm::runtime::PackedFunc vm_set_one_input = vm.GetFunction("set_one_input");
+    tvm::runtime::PackedFunc vm_invoke = vm.GetFunction("invoke");
+
+    // Step 2. run the same executable with each batch size, and compare with the specialized graph executor
+    std::cout << std::left << std::setw(8) << "batch" << std::setw(14) << "vm(ms)" << std::setw(14) << "graph(ms)"
+              << std::setw(14) << "vm overhead" << std::endl;
+
+    bool failed = false;
+    for (int64_t batch : batch_sizes) {
+        std::unordered_map<std::string, std::vector<int64_t>> shapes;
+        get_graph_input_shapes(onnx_model.graph(), batch, shapes);
+        std::vector<TensorMap> samples;
+        create_random_samples(shapes, 1, 0, samples);
+        const TensorMap& inputs = samples[0];
+
+        double vm_ms = 0.0;
+        try {
+            for (const auto& kv : inputs) {
+                vm_set_one_input("main", kv.first, kv.second);
+            }
+            vm_ms = measure_latency([&]() { vm_invoke("main"); }, iterations);
+        } catch (const tvm::runtime::Error& e) {
+            std::cerr << "batch " << batch << " vm run failed: " << e.what() << std::endl;
+            failed = true;
+            continue;
+        }
+
+        tvm::IRModule static_mod = mod;
+        ret = specialize_input_shapes(shapes, static_mod);
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+
+        BuildResult result;
+        ret = build_irmodule(static_mod, options, result);
+        if (!ret.is_ok()) {
+            std::cerr << "batch " << batch << " graph build failed: " << ret << std::endl;
+            failed = true;
+            continue;
+        }
+
+        tvm::runtime::Module executor;
+        ret = create_graph_executor(result, executor);
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+
+        double graph_ms = 0.0;
+        try {
+            tvm::runtime::PackedFunc set_input = executor.GetFunction("set_input");
+            for (const auto& kv : inputs) {
+                set_input(kv.first, kv.second);
+            }
+            tvm::runtime::PackedFunc run = executor.GetFunction("run");
+            graph_ms = measure_latency([&]() { run(); }, iterations);
+        } catch (const tvm::runtime::Error& e) {
+            std::cerr << "batch " << batch << " graph run failed: " << e.what() << std::endl;
+            failed = true;
+            continue;
+        }
+
+        std::cout << std::left << std::setw(8) << batch << std::setw(14) << vm_ms << std::setw(14) << graph_ms
+                  << std::setw(14) << vm_ms / graph_ms << std::endl;
+    }
+
+    return failed ? -1 : 0;
+}
@@ -0,0 +1,162 @@
+#include <tvm/ir/module.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/registry.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "compiler/model_artifact.h"
+#include "compiler/model_builder.h"
+#include "onnx.proto3.pb.h"
+#include "utils/onnx_utils.h"
+#include "utils/relay_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::onnx_utils;
+using namespace tvm_cpp::relay_utils;
+using namespace tvm_cpp::compiler;
+
+// read a field of /proc/self/status in kB, e.g. "RssAnon"
+int64_t read_status_kb(const std::string& field) {
+    std::ifstream ifs("/proc/self/status");
+    std::string line;
+    while (std::getline(ifs, line)) {
+        if (line.compare(0, field.size() + 1, field + ":") == 0) {
+            return std::stoll(line.substr(field.size() + 1));
+        }
+    }
+
+    return -1;
+}
+
+// load the artifact in a fresh process and print "load_ms first_run_ms rss_anon_kb rss_file_kb"
+int load_artifact(const std::string& dir) {
+    auto load_start = std::chrono::steady_clock::now();
+    BuildResult result;
+    auto ret = load_model_artifact(dir, result);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    tvm::runtime::Module executor;
+    ret = create_executor(result, executor);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+    auto load_end = std::chrono::steady_clock::now();
+
+    // the first run touches all the weights, the lazily faulted pages are counted after it
+    auto run_start = std::chrono::steady_clock::now();
+    executor.GetFunction("run")();
+    auto run_end = std::chrono::steady_clock::now();
+
+    std::cout << std::chrono::duration<double, std::milli>(load_end - load_start).count() << " "
+              << std::chrono::duration<double, std::milli>(run_end - run_start).count() << " "
+              << read_status_kb("RssAnon") << " " << read_status_kb("RssFile") << std::endl;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 2 && std::string(argv[1]) == "--load") {
+        return load_artifact(argv[2]);
+    }
+
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx work_dir [target]" << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string work_dir(argv[2]);
+    std::string target = argc > 3 ? argv[3] : "llvm";
+
+    onnx::ModelProto onnx_model;
+    auto ret = load_onnx_model(file_name, onnx_model);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    tvm::IRModule mod;
+    ret = parse_graph_to_irmodule(onnx_model.graph(), mod);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::cout << std::left << std::setw(14) << "params" << std::setw(12) << "so(KB)" << std::setw(14) << "blob(KB)"
+              << std::setw(12) << "load(ms)" << std::setw(14) << "1st run(ms)" << std::setw(14) << "RssAnon(KB)"
+              << std::setw(14) << "RssFile(KB)" << std::endl;
+
+    bool failed = false;
+    for (bool link_params : {false, true}) {
+        std::string mode = link_params ? "linked" : "blob";
+        std::string dir = (std::filesystem::path(work_dir) / mode).string();
+
+        BuildOptions options;
+        options.target = target;
+        options.link_params = link_params;
+
+        BuildResult result;
+        ret = build_irmodule(mod, options, result);
+        if (!ret.is_ok()) {
+            std::cerr << mode << " build failed: " << ret << std::endl;
+            failed = true;
+            continue;
+        }
+
+        ret = export_model_artifact(result, dir);
+        if (!ret.is_ok()) {
+            std::cerr << mode << " export failed: " << ret << std::endl;
+            failed = true;
+            continue;
+        }
+
+        // load in a child process, so the RSS only contains the loaded model
+        std::string cmd = shell_quote(argv[0]) + " --load " + shell_quote(dir);
+        FILE* pipe = popen(cmd.c_str(), "r");
+        if (!pipe) {
+            std::cerr << "run " << cmd << " failed" << std::endl;
+            return -1;
+        }
+
+        char buffer[256] = {0};
+        std::string output;
+        while (fgets(buffer, sizeof(buffer), pipe)) {
+            output += buffer;
+        }
+        if (pclose(pipe) != 0) {
+            std::cerr << mode << " load failed" << std::endl;
+            failed = true;
+            continue;
+        }
+
+        double load_ms = 0;
+        double run_ms = 0;
+        int64_t rss_anon_kb = 0;
+        int64_t rss_file_kb = 0;
+        std::istringstream iss(output);
+        iss >> load_ms >> run_ms >> rss_anon_kb >> rss_file_kb;
+
+        std::filesystem::path params_path = std::filesystem::path(dir) / kArtifactParamsFile;
+        uintmax_t so_kb = std::filesystem::file_size(std::filesystem::path(dir) / kArtifactLibraryFile) / 1024;
+        uintmax_t blob_kb = std::filesystem::exists(params_path) ? std::filesystem::file_size(params_path) / 1024 : 0;
+
+        std::cout << std::left << std::setw(14) << mode << std::setw(12) << so_kb << std::setw(14) << blob_kb
+                  << std::setw(12) << load_ms << std::setw(14) << run_ms << std::setw(14) << rss_anon_kb
+                  << std::setw(14) << rss_file_kb << std::endl;
+    }
+
+    return failed ? -1 : 0;
+}
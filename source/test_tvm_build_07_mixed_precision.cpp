@@ -0,0 +1,140 @@
+#include <tvm/ir/module.h>
+#include <tvm/runtime/module.h>
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "compiler/model_builder.h"
+#include "compiler/model_evaluator.h"
+#include "onnx.proto3.pb.h"
+#include "utils/onnx_utils.h"
+#include "utils/relay_utils.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::onnx_utils;
+using namespace tvm_cpp::relay_utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+
+// split the comma separated list
+std::vector<std::string> split_list(const std::string& str) {
+    std::vector<std::string> items;
+    std::istringstream iss(str);
+    for (std::string item; std::getline(iss, item, ',');) {
+        trim(item);
+        if (!item.empty()) {
+            items.emplace_back(item);
+        }
+    }
+
+    return items;
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 1) {
+        std::cerr << "Usage: " << argv[0]
+                  << " model.onnx [bfloat16|float16] [samples_dir|-] [iterations] [target] [deny_ops]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx bfloat16 ./samples 100 \"llvm -mcpu=sapphirerapids\" nn.softmax"
+                  << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string precision = argc > 2 ? argv[2] : "bfloat16";
+    std::string samples_dir = argc > 3 ? argv[3] : "-";
+    int iterations = argc > 4 ? std::stoi(argv[4]) : 100;
+    std::string target = argc > 5 ? argv[5] : "llvm";
+    std::vector<std::string> deny_ops = argc > 6 ? split_list(argv[6]) : std::vector<std::string>();
+
+    onnx::ModelProto onnx_model;
+    auto ret = load_onnx_model(file_name, onnx_model);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    tvm::IRModule mod;
+    ret = parse_graph_to_irmodule(onnx_model.graph(), mod);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    // the user samples, or random samples if no directory is given
+    std::vector<TensorMap> samples;
+    if (samples_dir != "-") {
+        ret = load_samples(samples_dir, onnx_model.graph(), samples);
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+    } else {
+        std::unordered_map<std::string, std::vector<int64_t>> shapes;
+        get_graph_input_shapes(onnx_model.graph(), 1, shapes);
+        create_random_samples(shapes, 8, 0, samples);
+    }
+
+    BuildOptions fp32_options;
+    fp32_options.target = target;
+
+    BuildOptions mixed_options = fp32_options;
+    mixed_options.mixed_precision = precision;
+    mixed_options.mixed_precision_deny_ops = deny_ops;
+
+    tvm::runtime::Module fp32_executor;
+    tvm::runtime::Module mixed_executor;
+    for (auto* item : {&fp32_options, &mixed_options}) {
+        BuildResult result;
+        ret = build_irmodule(mod, *item, result);
+        if (!ret.is_ok()) {
+            std::cerr << (item->mixed_precision.empty() ? "float32" : precision) << " build failed: " << ret
+                      << std::endl;
+            return -1;
+        }
+
+        tvm::runtime::Module& executor = item->mixed_precision.empty() ? fp32_executor : mixed_executor;
+        ret = create_executor(result, executor);
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+    }
+
+    AccuracyReport report;
+    ret = compare_executors(fp32_executor, mixed_executor, samples, report);
+    if (!ret.is_ok()) {
+        std::cerr << "compare failed: " << ret << std::endl;
+        return -1;
+    }
+
+    double fp32_ms = 0;
+    double mixed_ms = 0;
+    ret = measure_executor_latency(fp32_executor, samples[0], 10, iterations, fp32_ms);
+    if (ret.is_ok()) {
+        ret = measure_executor_latency(mixed_executor, samples[0], 10, iterations, mixed_ms);
+    }
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::cout << "samples: " << report.samples << std::endl;
+    std::cout << "max abs diff: " << report.max_abs_diff << ", mean abs diff: " << report.mean_abs_diff << std::endl;
+    std::cout << "cosine min: " << report.min_cosine << ", mean: " << report.mean_cosine << std::endl;
+    std::cout << "top1 agreement: " << report.top1_agreement << std::endl;
+    std::cout << std::endl;
+
+    std::cout << std::left << std::setw(12) << "precision" << std::setw(14) << "latency(ms)" << std::endl;
+    std::cout << std::left << std::setw(12) << "float32" << std::setw(14) << fp32_ms << std::endl;
+    std::cout << std::left << std::setw(12) << precision << std::setw(14) << mixed_ms << std::endl;
+    std::cout << "speedup: " << fp32_ms / mixed_ms << std::endl;
+
+    return 0;
+}
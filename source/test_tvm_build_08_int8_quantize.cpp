@@ -0,0 +1,150 @@
+#include <tvm/ir/module.h>
+#include <tvm/runtime/module.h>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "compiler/model_builder.h"
+#include "compiler/model_evaluator.h"
+#include "compiler/quantization.h"
+#include "onnx.proto3.pb.h"
+#include "utils/onnx_utils.h"
+#include "utils/relay_utils.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::onnx_utils;
+using namespace tvm_cpp::relay_utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " model.onnx calib_dir [kl|percentile|max] [eval_dir|-] [iterations] [target]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx ./calib kl ./eval 100 \"llvm -mcpu=cascadelake\"" << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string calib_dir(argv[2]);
+    std::string mode = argc > 3 ? argv[3] : "kl";
+    std::string eval_dir = argc > 4 ? argv[4] : "-";
+    int iterations = argc > 5 ? std::stoi(argv[5]) : 100;
+    std::string target = argc > 6 ? argv[6] : "llvm";
+
+    QuantizeOptions quantize_options;
+    if (mode == "kl") {
+        quantize_options.mode = CalibrationMode::KL;
+    } else if (mode == "percentile") {
+        quantize_options.mode = CalibrationMode::Percentile;
+    } else if (mode == "max") {
+        quantize_options.mode = CalibrationMode::Max;
+    } else {
+        std::cerr << "Unknown calibration mode: " << mode << std::endl;
+        return -1;
+    }
+
+    onnx::ModelProto onnx_model;
+    auto ret = load_onnx_model(file_name, onnx_model);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    tvm::IRModule mod;
+    ret = parse_graph_to_irmodule(onnx_model.graph(), mod);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::vector<TensorMap> calib_samples;
+    ret = load_samples(calib_dir, onnx_model.graph(), calib_samples);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    // the accuracy is evaluated on the held out samples if given, otherwise on the calibration samples
+    std::vector<TensorMap> eval_samples;
+    if (eval_dir != "-") {
+        ret = load_samples(eval_dir, onnx_model.graph(), eval_samples);
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+    } else {
+        eval_samples = calib_samples;
+    }
+
+    BuildOptions build_options;
+    build_options.target = target;
+
+    tvm::IRModule quantized_mod;
+    QuantizeStats stats;
+    ret = quantize_irmodule(mod, calib_samples, build_options, quantize_options, quantized_mod, stats);
+    if (!ret.is_ok()) {
+        std::cerr << "quantize failed: " << ret << std::endl;
+        return -1;
+    }
+
+    tvm::runtime::Module fp32_executor;
+    tvm::runtime::Module int8_executor;
+    for (const auto& item : {std::make_pair(&mod, &fp32_executor), std::make_pair(&quantized_mod, &int8_executor)}) {
+        BuildResult result;
+        ret = build_irmodule(*item.first, build_options, result);
+        if (!ret.is_ok()) {
+            std::cerr << (item.first == &mod ? "float32" : "int8") << " build failed: " << ret << std::endl;
+            return -1;
+        }
+
+        ret = create_executor(result, *item.second);
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+    }
+
+    AccuracyReport report;
+    ret = compare_executors(fp32_executor, int8_executor, eval_samples, report);
+    if (!ret.is_ok()) {
+        std::cerr << "compare failed: " << ret << std::endl;
+        return -1;
+    }
+
+    double fp32_ms = 0;
+    double int8_ms = 0;
+    ret = measure_executor_latency(fp32_executor, eval_samples[0], 10, iterations, fp32_ms);
+    if (ret.is_ok()) {
+        ret = measure_executor_latency(int8_executor, eval_samples[0], 10, iterations, int8_ms);
+    }
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::cout << "calibration: " << calibration_mode_to_string(quantize_options.mode) << ", "
+              << calib_samples.size() << " samples" << std::endl;
+    std::cout << "quantized conv2d: " << stats.quantized_convs << ", dense: " << stats.quantized_denses
+              << ", kept float32: " << stats.skipped_ops << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "samples: " << report.samples << std::endl;
+    std::cout << "max abs diff: " << report.max_abs_diff << ", mean abs diff: " << report.mean_abs_diff << std::endl;
+    std::cout << "cosine min: " << report.min_cosine << ", mean: " << report.mean_cosine << std::endl;
+    std::cout << "top1 agreement: " << report.top1_agreement << std::endl;
+    std::cout << std::endl;
+
+    std::cout << std::left << std::setw(12) << "precision" << std::setw(14) << "latency(ms)" << std::endl;
+    std::cout << std::left << std::setw(12) << "float32" << std::setw(14) << fp32_ms << std::endl;
+    std::cout << std::left << std::setw(12) << "int8" << std::setw(14) << int8_ms << std::endl;
+    std::cout << "speedup: " << fp32_ms / int8_ms << std::endl;
+
+    return 0;
+}
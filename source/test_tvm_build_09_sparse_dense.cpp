@@ -0,0 +1,131 @@
+#include <tvm/ir/module.h>
+#include <tvm/runtime/module.h>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "compiler/model_builder.h"
+#include "compiler/model_evaluator.h"
+#include "compiler/sparse_dense.h"
+#include "onnx.proto3.pb.h"
+#include "utils/onnx_utils.h"
+#include "utils/relay_utils.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::onnx_utils;
+using namespace tvm_cpp::relay_utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+
+int main(int argc, char** argv) {
+    if (argc <= 1) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx [sparse_threshold] [iterations] [target]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx 0.8 100 \"llvm -mcpu=skylake-avx512\"" << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    double threshold = argc > 2 ? std::stod(argv[2]) : 0.8;
+    int iterations = argc > 3 ? std::stoi(argv[3]) : 100;
+    std::string target = argc > 4 ? argv[4] : "llvm";
+
+    onnx::ModelProto onnx_model;
+    auto ret = load_onnx_model(file_name, onnx_model);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    tvm::IRModule mod;
+    ret = parse_graph_to_irmodule(onnx_model.graph(), mod);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::unordered_map<std::string, std::vector<int64_t>> shapes;
+    get_graph_input_shapes(onnx_model.graph(), 1, shapes);
+    std::vector<TensorMap> samples;
+    create_random_samples(shapes, 4, 0, samples);
+
+    // the dense baseline, the automatic block size, then every block size
+    std::vector<int> block_sizes{0};
+    block_sizes.insert(block_sizes.end(), get_default_sparse_block_sizes().begin(),
+                       get_default_sparse_block_sizes().end());
+
+    BuildOptions dense_options;
+    dense_options.target = target;
+
+    tvm::runtime::Module dense_executor;
+    double dense_ms = 0;
+
+    std::cout << std::left << std::setw(10) << "block" << std::setw(8) << "sparse" << std::setw(8) << "dense"
+              << std::setw(10) << "density" << std::setw(14) << "max abs diff" << std::setw(14) << "latency(ms)"
+              << std::setw(10) << "speedup" << std::endl;
+
+    for (int i = -1; i < static_cast<int>(block_sizes.size()); ++i) {
+        BuildOptions options = dense_options;
+        if (i >= 0) {
+            options.sparse_threshold = threshold;
+            options.sparse_block_size = block_sizes[i];
+        }
+
+        tvm::IRModule optimized = mod;
+        ret = optimize_irmodule(optimized, options);
+        SparseDenseStats stats;
+        if (ret.is_ok()) {
+            ret = count_sparse_denses(optimized, stats);
+        }
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+
+        BuildResult result;
+        tvm::runtime::Module executor;
+        ret = build_irmodule(mod, options, result);
+        if (ret.is_ok()) {
+            ret = create_executor(result, executor);
+        }
+        if (!ret.is_ok()) {
+            std::cerr << "build failed, block size " << options.sparse_block_size << ": " << ret << std::endl;
+            if (i < 0) {
+                return -1;
+            }
+            continue;
+        }
+
+        double latency_ms = 0;
+        ret = measure_executor_latency(executor, samples[0], 10, iterations, latency_ms);
+        AccuracyReport report;
+        if (ret.is_ok() && i >= 0) {
+            ret = compare_executors(dense_executor, executor, samples, report);
+        }
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+
+        if (i < 0) {
+            dense_executor = executor;
+            dense_ms = latency_ms;
+        }
+
+        std::string block = "dense";
+        if (i >= 0) {
+            block = options.sparse_block_size == 0 ? "auto" : std::to_string(options.sparse_block_size);
+        }
+        double density = stats.total_blocks > 0 ? static_cast<double>(stats.nonzero_blocks) / stats.total_blocks : 1.0;
+        std::cout << std::left << std::setw(10) << block << std::setw(8) << stats.sparse_denses << std::setw(8)
+                  << stats.denses << std::setw(10) << density << std::setw(14) << report.max_abs_diff << std::setw(14)
+                  << latency_ms << std::setw(10) << dense_ms / latency_ms << std::endl;
+    }
+
+    return 0;
+}
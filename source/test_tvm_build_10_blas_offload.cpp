@@ -0,0 +1,144 @@
+#include <tvm/ir/module.h>
+#include <tvm/runtime/module.h>
+
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/blas_offload.h"
+#include "compiler/build_options.h"
+#include "compiler/model_builder.h"
+#include "compiler/model_evaluator.h"
+#include "onnx.proto3.pb.h"
+#include "utils/onnx_utils.h"
+#include "utils/relay_utils.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::onnx_utils;
+using namespace tvm_cpp::relay_utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+
+std::string shape_to_string(const MatmulShape& shape) {
+    std::ostringstream oss;
+    if (shape.batch > 0) {
+        oss << shape.batch << "x";
+    }
+    oss << shape.m << "x" << shape.n << "x" << shape.k;
+    return oss.str();
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 1) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx [iterations] [target]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx 50 \"llvm -mcpu=skylake-avx512\"" << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    int iterations = argc > 2 ? std::stoi(argv[2]) : 50;
+    std::string target = argc > 3 ? argv[3] : "llvm";
+
+    onnx::ModelProto onnx_model;
+    auto ret = load_onnx_model(file_name, onnx_model);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    tvm::IRModule mod;
+    ret = parse_graph_to_irmodule(onnx_model.graph(), mod);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    BuildOptions options;
+    options.target = target;
+
+    // Step 1. benchmark every matmul shape of the model with and without CBLAS
+    std::vector<MatmulShape> shapes;
+    ret = get_matmul_shapes(mod, shapes);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::vector<BlasBenchmark> benchmarks;
+    ret = benchmark_blas_offload(options, shapes, iterations, benchmarks);
+    if (!ret.is_ok()) {
+        std::cerr << "benchmark failed: " << ret << std::endl;
+        return -1;
+    }
+
+    std::cout << std::left << std::setw(24) << "shape" << std::setw(14) << "mflops" << std::setw(12) << "tvm(ms)"
+              << std::setw(12) << "cblas(ms)" << std::endl;
+    for (const auto& benchmark : benchmarks) {
+        std::cout << std::left << std::setw(24) << shape_to_string(benchmark.shape) << std::setw(14)
+                  << benchmark.shape.flops() / 1e6 << std::setw(12) << benchmark.tvm_ms << std::setw(12)
+                  << benchmark.blas_ms << std::endl;
+    }
+
+    // Step 2. build the model with the chosen threshold
+    int64_t min_flops = choose_blas_min_flops(benchmarks);
+    std::cout << std::endl << "blas min flops: ";
+    if (min_flops == std::numeric_limits<int64_t>::max()) {
+        std::cout << "never" << std::endl;
+    } else {
+        std::cout << min_flops << std::endl;
+    }
+
+    BuildOptions offload_options = options;
+    offload_options.blas_offload = true;
+    offload_options.blas_min_flops = min_flops;
+
+    tvm::runtime::Module tvm_executor;
+    tvm::runtime::Module offload_executor;
+    for (const auto& item : {std::make_pair(&options, &tvm_executor),
+                             std::make_pair(&offload_options, &offload_executor)}) {
+        BuildResult result;
+        ret = build_irmodule(mod, *item.first, result);
+        if (ret.is_ok()) {
+            ret = create_executor(result, *item.second);
+        }
+        if (!ret.is_ok()) {
+            std::cerr << "build failed: " << ret << std::endl;
+            return -1;
+        }
+    }
+
+    std::unordered_map<std::string, std::vector<int64_t>> input_shapes;
+    get_graph_input_shapes(onnx_model.graph(), 1, input_shapes);
+    std::vector<TensorMap> samples;
+    create_random_samples(input_shapes, 4, 0, samples);
+
+    AccuracyReport report;
+    ret = compare_executors(tvm_executor, offload_executor, samples, report);
+    if (!ret.is_ok()) {
+        std::cerr << "compare failed: " << ret << std::endl;
+        return -1;
+    }
+
+    double tvm_ms = 0;
+    double offload_ms = 0;
+    ret = measure_executor_latency(tvm_executor, samples[0], 10, iterations, tvm_ms);
+    if (ret.is_ok()) {
+        ret = measure_executor_latency(offload_executor, samples[0], 10, iterations, offload_ms);
+    }
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::cout << "max abs diff: " << report.max_abs_diff << std::endl;
+    std::cout << "tvm: " << tvm_ms << " ms, offload: " << offload_ms << " ms, speedup: " << tvm_ms / offload_ms
+              << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "compiler/batch_compiler.h"
+
+using namespace tvm_cpp::compiler;
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0] << " manifest.json cache_dir [workers|0] [worker_memory_mb]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " ./models.json ./artifact_cache 0 4096" << std::endl;
+        return -1;
+    }
+
+    std::string manifest_path(argv[1]);
+    std::string cache_dir(argv[2]);
+    int workers = argc > 3 ? std::stoi(argv[3]) : 0;
+    int64_t worker_memory_mb = argc > 4 ? std::stoll(argv[4]) : 4096;
+
+    std::vector<BatchCompileJob> jobs;
+    auto ret = load_batch_manifest(manifest_path, jobs);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    // 0 means sizing the workers to the cores and the available memory
+    if (workers <= 0) {
+        workers = get_batch_compile_workers(jobs.size(), worker_memory_mb);
+    }
+    std::cout << "models: " << jobs.size() << ", workers: " << workers << std::endl << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<BatchCompileResult> results;
+    ret = run_batch_compile(jobs, cache_dir, workers, results);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+    double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << std::left << std::setw(24) << "model" << std::setw(8) << "status" << std::setw(12) << "time(s)"
+              << std::setw(14) << "max rss(MB)" << "artifact" << std::endl;
+
+    double total_seconds = 0;
+    int failures = 0;
+    for (const auto& result : results) {
+        std::string status = result.success ? (result.cache_hit ? "cached" : "built") : "failed";
+        std::cout << std::left << std::setw(24) << result.name << std::setw(8) << status << std::setw(12)
+                  << result.seconds << std::setw(14) << result.max_rss_kb / 1024 << result.artifact_dir << std::endl;
+        if (!result.success) {
+            std::cout << "    " << result.error << std::endl;
+            ++failures;
+        }
+        total_seconds += result.seconds;
+    }
+
+    std::cout << std::endl;
+    std::cout << "wall time: " << wall_seconds << " s, sum of compile times: " << total_seconds
+              << " s, speedup: " << total_seconds / wall_seconds << std::endl;
+
+    return failures == 0 ? 0 : -1;
+}
@@ -0,0 +1,61 @@
+#include <iostream>
+#include <string>
+
+#include "compiler/artifact_cache.h"
+#include "compiler/build_options.h"
+#include "compiler/cross_compiler.h"
+
+using namespace tvm_cpp::compiler;
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " model.onnx cache_dir [neon|sve] [mcpu|-] [toolchain_prefix] [tuning_store]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx ./artifact_cache sve neoverse-v1 aarch64-linux-gnu- ./store"
+                  << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string cache_dir(argv[2]);
+
+    CrossCompileOptions cross_options;
+    cross_options.sve = argc > 3 && std::string(argv[3]) == "sve";
+    if (argc > 4 && std::string(argv[4]) != "-") {
+        cross_options.mcpu = argv[4];
+    }
+    if (argc > 5) {
+        cross_options.toolchain_prefix = argv[5];
+    }
+
+    // compile only, the records tuned for the aarch64 target in the store are applied
+    BuildOptions options;
+    options.target = get_cross_target(cross_options);
+    if (argc > 6) {
+        options.tuning_store_dir = argv[6];
+    }
+
+    std::cout << "target: " << options.target << std::endl;
+    std::cout << "linker: " << get_cross_export_options(cross_options).cc << std::endl;
+
+    std::string artifact_dir;
+    bool cache_hit = false;
+    auto ret = compile_cached_artifact(file_name, options, cache_dir, get_cross_export_options(cross_options),
+                                       artifact_dir, cache_hit);
+    if (!ret.is_ok()) {
+        std::cerr << "cross compile failed: " << ret << std::endl;
+        return -1;
+    }
+
+    ret = verify_cross_artifact(artifact_dir, cross_options);
+    if (!ret.is_ok()) {
+        std::cerr << "verify failed: " << ret << std::endl;
+        return -1;
+    }
+
+    std::cout << "artifact: " << artifact_dir << (cache_hit ? " (cached)" : "") << std::endl;
+    std::cout << "verified ELF machine: " << get_triple_elf_machine(cross_options.triple) << " ("
+              << cross_options.triple << ")" << std::endl;
+
+    return 0;
+}
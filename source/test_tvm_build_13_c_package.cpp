@@ -0,0 +1,116 @@
+#include <tvm/ir/module.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "compiler/build_options.h"
+#include "compiler/c_source_package.h"
+#include "onnx.proto3.pb.h"
+#include "utils/onnx_utils.h"
+#include "utils/relay_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::onnx_utils;
+using namespace tvm_cpp::relay_utils;
+using namespace tvm_cpp::compiler;
+
+// a C program which runs the packaged model with zero inputs, it links only the static library and libm
+std::string generate_demo_main(const CPackageInfo& info, const std::string& prefix, int iterations) {
+    std::ostringstream oss;
+    oss << "#define _POSIX_C_SOURCE 199309L\n#include <stdio.h>\n#include <stdlib.h>\n#include <time.h>\n";
+    oss << "#include \"" << std::filesystem::path(info.header).filename().string() << "\"\n\n";
+    oss << "static double now_ms(void) {\n    struct timespec ts;\n    clock_gettime(CLOCK_MONOTONIC, &ts);\n"
+        << "    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;\n}\n\n";
+    oss << "int main(void) {\n    struct " << prefix << "_inputs inputs;\n    struct " << prefix
+        << "_outputs outputs;\n";
+    for (size_t i = 0; i < info.inputs.size(); ++i) {
+        oss << "    inputs." << info.inputs[i] << " = calloc(1, " << info.input_bytes[i] << ");\n";
+    }
+    for (size_t i = 0; i < info.outputs.size(); ++i) {
+        oss << "    outputs." << info.outputs[i] << " = calloc(1, " << info.output_bytes[i] << ");\n";
+    }
+    oss << "    double start = now_ms();\n";
+    oss << "    if (" << prefix << "_run(&inputs, &outputs) != 0) {\n        return 1;\n    }\n";
+    oss << "    double first = now_ms() - start;\n    start = now_ms();\n";
+    oss << "    for (int i = 0; i < " << iterations << "; ++i) {\n        " << prefix
+        << "_run(&inputs, &outputs);\n    }\n";
+    oss << "    printf(\"first run: %.3f ms, average: %.3f ms\\n\", first, (now_ms() - start) / " << iterations
+        << ");\n    return 0;\n}\n";
+    return oss.str();
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx package_dir [tvm_home] [cc] [iterations]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx ./model_c third_party/tvm gcc 100" << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string package_dir(argv[2]);
+    CPackageOptions package_options;
+    if (argc > 3) {
+        package_options.tvm_home = argv[3];
+    }
+    if (argc > 4) {
+        package_options.cc = argv[4];
+    }
+    int iterations = argc > 5 ? std::stoi(argv[5]) : 100;
+
+    onnx::ModelProto onnx_model;
+    auto ret = load_onnx_model(file_name, onnx_model);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    tvm::IRModule mod;
+    ret = parse_graph_to_irmodule(onnx_model.graph(), mod);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    BuildOptions options;
+    options.target = "c";
+
+    CPackageInfo info;
+    ret = export_c_package(mod, options, package_dir, package_options, info);
+    if (!ret.is_ok()) {
+        std::cerr << "export failed: " << ret << std::endl;
+        return -1;
+    }
+
+    std::cout << "header: " << info.header << std::endl;
+    for (const auto& source : info.sources) {
+        std::cout << "source: " << source << ", " << std::filesystem::file_size(source) << " bytes" << std::endl;
+    }
+    if (info.static_library.empty()) {
+        return 0;
+    }
+    std::cout << "static library: " << info.static_library << ", " << std::filesystem::file_size(info.static_library)
+              << " bytes" << std::endl;
+
+    // link a demo program against the static library only, then run it
+    std::string prefix = std::filesystem::path(info.header).stem().string();
+    std::filesystem::path demo_source = std::filesystem::path(package_dir) / "demo_main.c";
+    std::filesystem::path demo = std::filesystem::path(package_dir) / "demo";
+    std::ofstream(demo_source) << generate_demo_main(info, prefix, iterations);
+
+    std::string include_dir = (std::filesystem::path(package_dir) / "include").string();
+    std::ostringstream cmd;
+    cmd << shell_quote(package_options.cc) << " -O2 -I" << shell_quote(include_dir) << " "
+        << shell_quote(demo_source.string()) << " " << shell_quote(info.static_library) << " -lm -o "
+        << shell_quote(demo.string()) << " && " << shell_quote(demo.string());
+    if (std::system(cmd.str().c_str()) != 0) {
+        std::cerr << "the demo program failed: " << cmd.str() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
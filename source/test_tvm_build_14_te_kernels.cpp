@@ -0,0 +1,170 @@
+#include <tvm/ir/module.h>
+#include <tvm/relay/expr.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/registry.h>
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "compiler/model_builder.h"
+#include "compiler/model_evaluator.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+
+/**
+ * @brief The hot shape of a single op benchmark. the dense is [m, k] x [n, k], the conv is [1, c, h, w] x [o, c, 3, 3]
+ * with padding 1
+ *
+ */
+struct KernelShape {
+    bool conv;
+    int64_t m_or_c;
+    int64_t n_or_o;
+    int64_t k_or_hw;
+};
+
+std::string shape_to_string(const KernelShape& shape) {
+    std::ostringstream oss;
+    if (shape.conv) {
+        oss << "conv 1x" << shape.m_or_c << "x" << shape.k_or_hw << "x" << shape.k_or_hw << " o" << shape.n_or_o;
+    } else {
+        oss << "dense " << shape.m_or_c << "x" << shape.n_or_o << "x" << shape.k_or_hw;
+    }
+    return oss.str();
+}
+
+tvm::relay::Var create_var(const std::string& name, const std::vector<int64_t>& shape) {
+    static const tvm::runtime::PackedFunc* var_gen = tvm::runtime::Registry::Get("relay.ir.Var");
+    tvm::runtime::Array<tvm::PrimExpr> var_shape;
+    for (int64_t dim : shape) {
+        var_shape.push_back(tvm::Integer(dim));
+    }
+    return (*var_gen)(name, tvm::relay::TensorType(var_shape, tvm::DataType::Float(32)), tvm::relay::Span());
+}
+
+/**
+ * @brief Create the single op module of the shape with a constant weight and a relu, like the parser output
+ *
+ */
+tvm_cpp::Status create_kernel_module(const KernelShape& shape, tvm::IRModule& module, TensorMap& inputs) {
+    const tvm::runtime::PackedFunc* function = tvm::runtime::Registry::Get("relay.ir.Function");
+    const tvm::runtime::PackedFunc* dense = tvm::runtime::Registry::Get("relay.op.nn._make.dense");
+    const tvm::runtime::PackedFunc* conv2d = tvm::runtime::Registry::Get("relay.op.nn._make.conv2d");
+    const tvm::runtime::PackedFunc* relu = tvm::runtime::Registry::Get("relay.op.nn._make.relu");
+    if (!function || !dense || !conv2d || !relu) {
+        return tvm_cpp::Status(tvm_cpp::StatusCode::RUNTIME_ERROR, "the relay function or op generators are not found");
+    }
+
+    std::unordered_map<std::string, std::vector<int64_t>> shapes;
+    if (shape.conv) {
+        shapes.emplace("data", std::vector<int64_t>{1, shape.m_or_c, shape.k_or_hw, shape.k_or_hw});
+        shapes.emplace("weight", std::vector<int64_t>{shape.n_or_o, shape.m_or_c, 3, 3});
+    } else {
+        shapes.emplace("data", std::vector<int64_t>{shape.m_or_c, shape.k_or_hw});
+        shapes.emplace("weight", std::vector<int64_t>{shape.n_or_o, shape.k_or_hw});
+    }
+
+    std::vector<TensorMap> samples;
+    create_random_samples(shapes, 1, 0, samples);
+    inputs.clear();
+    inputs.emplace("data", samples[0]["data"]);
+
+    tvm::relay::Var data = create_var("data", shapes["data"]);
+    tvm::relay::Constant weight(samples[0]["weight"]);
+    tvm::relay::Expr body;
+    if (shape.conv) {
+        tvm::runtime::Array<tvm::PrimExpr> ones{1, 1};
+        tvm::runtime::Array<tvm::PrimExpr> padding{1, 1, 1, 1};
+        tvm::runtime::Array<tvm::PrimExpr> kernel_size{3, 3};
+        body = (*conv2d)(data, weight, ones, padding, ones, 1, tvm::Integer(shape.n_or_o), kernel_size, "NCHW", "OIHW",
+                         "", tvm::DataType());
+    } else {
+        body = (*dense)(data, weight, tvm::Integer(shape.n_or_o), tvm::DataType());
+    }
+    body = (*relu)(body);
+
+    tvm::relay::Expr func =
+        (*function)(tvm::runtime::Array<tvm::relay::Var>{data}, body, tvm::relay::Type(),
+                    tvm::runtime::Array<tvm::relay::TypeVar>(), tvm::DictAttrs(), tvm::relay::Span());
+    module = tvm::IRModule::FromExpr(func);
+    return tvm_cpp::Status::ok();
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::stoi(argv[1]) : 50;
+    std::string target = argc > 2 ? argv[2] : "llvm";
+    if (iterations <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [iterations] [target]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " 50 \"llvm -mcpu=skylake-avx512\"" << std::endl;
+        return -1;
+    }
+
+    // the hot shapes of the typical CNN and transformer models
+    std::vector<KernelShape> shapes{{false, 1, 1000, 2048}, {false, 128, 768, 768}, {false, 128, 3072, 768},
+                                    {true, 64, 64, 56},     {true, 128, 128, 28},   {true, 256, 256, 14}};
+
+    BuildOptions topi_options;
+    topi_options.target = target;
+    BuildOptions kernel_options = topi_options;
+    kernel_options.te_kernels = true;
+
+    std::cout << std::left << std::setw(28) << "shape" << std::setw(12) << "topi(ms)" << std::setw(12) << "te(ms)"
+              << std::setw(10) << "speedup" << std::setw(14) << "max abs diff" << std::endl;
+    for (const auto& shape : shapes) {
+        tvm::IRModule mod;
+        TensorMap inputs;
+        auto ret = create_kernel_module(shape, mod, inputs);
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+
+        tvm::runtime::Module topi_executor;
+        tvm::runtime::Module kernel_executor;
+        for (const auto& item : {std::make_pair(&topi_options, &topi_executor),
+                                 std::make_pair(&kernel_options, &kernel_executor)}) {
+            BuildResult result;
+            ret = build_irmodule(mod, *item.first, result);
+            if (ret.is_ok()) {
+                ret = create_executor(result, *item.second);
+            }
+            if (!ret.is_ok()) {
+                std::cerr << shape_to_string(shape) << " build failed: " << ret << std::endl;
+                return -1;
+            }
+        }
+
+        AccuracyReport report;
+        ret = compare_executors(topi_executor, kernel_executor, {inputs}, report);
+        if (!ret.is_ok()) {
+            std::cerr << "compare failed: " << ret << std::endl;
+            return -1;
+        }
+
+        double topi_ms = 0;
+        double kernel_ms = 0;
+        ret = measure_executor_latency(topi_executor, inputs, 10, iterations, topi_ms);
+        if (ret.is_ok()) {
+            ret = measure_executor_latency(kernel_executor, inputs, 10, iterations, kernel_ms);
+        }
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+
+        std::cout << std::left << std::setw(28) << shape_to_string(shape) << std::setw(12) << topi_ms << std::setw(12)
+                  << kernel_ms << std::setw(10) << topi_ms / kernel_ms << std::setw(14) << report.max_abs_diff
+                  << std::endl;
+    }
+
+    return 0;
+}
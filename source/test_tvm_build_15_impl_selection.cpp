@@ -0,0 +1,131 @@
+#include <tvm/ir/module.h>
+#include <tvm/runtime/module.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "compiler/impl_selection.h"
+#include "compiler/model_builder.h"
+#include "compiler/model_evaluator.h"
+#include "onnx.proto3.pb.h"
+#include "utils/onnx_utils.h"
+#include "utils/relay_utils.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::onnx_utils;
+using namespace tvm_cpp::relay_utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx selection.json [iterations] [target]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx impl_selection.json 50 \"llvm -mcpu=skylake-avx512\""
+                  << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string selection_file(argv[2]);
+    int iterations = argc > 3 ? std::stoi(argv[3]) : 50;
+    std::string target = argc > 4 ? argv[4] : "llvm";
+
+    onnx::ModelProto onnx_model;
+    auto ret = load_onnx_model(file_name, onnx_model);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    tvm::IRModule mod;
+    ret = parse_graph_to_irmodule(onnx_model.graph(), mod);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    BuildOptions default_options;
+    default_options.target = target;
+    BuildOptions selection_options = default_options;
+    selection_options.impl_selection_file = selection_file;
+
+    // Step 1. the first selection build benchmarks the new workloads, the second one reuses the recorded choices
+    tvm::runtime::Module default_executor;
+    tvm::runtime::Module selection_executor;
+    std::vector<std::pair<const BuildOptions*, tvm::runtime::Module*>> builds{
+        {&default_options, &default_executor},
+        {&selection_options, &selection_executor},
+        {&selection_options, &selection_executor}};
+    std::vector<double> build_seconds;
+    for (const auto& item : builds) {
+        auto start = std::chrono::steady_clock::now();
+        BuildResult result;
+        ret = build_irmodule(mod, *item.first, result);
+        if (ret.is_ok()) {
+            ret = create_executor(result, *item.second);
+        }
+        if (!ret.is_ok()) {
+            std::cerr << "build failed: " << ret << std::endl;
+            return -1;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        build_seconds.emplace_back(elapsed.count());
+    }
+
+    std::cout << "build seconds, default: " << build_seconds[0] << ", selection: " << build_seconds[1]
+              << ", recorded selection: " << build_seconds[2] << std::endl;
+
+    // Step 2. the recorded choices
+    std::vector<ImplSelectionRecord> records;
+    ret = load_impl_selection_records(selection_file, records);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::cout << std::endl << std::left << std::setw(64) << "workload" << "implementation (ms)" << std::endl;
+    for (const auto& record : records) {
+        std::cout << std::left << std::setw(64) << record.workload << record.impl << std::endl;
+        for (const auto& timing : record.timings) {
+            std::cout << std::left << std::setw(64) << "" << "  " << timing.first << ": " << timing.second
+                      << std::endl;
+        }
+    }
+
+    // Step 3. the accuracy and the latency of the selected implementations
+    std::unordered_map<std::string, std::vector<int64_t>> input_shapes;
+    get_graph_input_shapes(onnx_model.graph(), 1, input_shapes);
+    std::vector<TensorMap> samples;
+    create_random_samples(input_shapes, 4, 0, samples);
+
+    AccuracyReport report;
+    ret = compare_executors(default_executor, selection_executor, samples, report);
+    if (!ret.is_ok()) {
+        std::cerr << "compare failed: " << ret << std::endl;
+        return -1;
+    }
+
+    double default_ms = 0;
+    double selection_ms = 0;
+    ret = measure_executor_latency(default_executor, samples[0], 10, iterations, default_ms);
+    if (ret.is_ok()) {
+        ret = measure_executor_latency(selection_executor, samples[0], 10, iterations, selection_ms);
+    }
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::cout << std::endl << "max abs diff: " << report.max_abs_diff << std::endl;
+    std::cout << "default: " << default_ms << " ms, selection: " << selection_ms
+              << " ms, speedup: " << default_ms / selection_ms << std::endl;
+
+    return 0;
+}
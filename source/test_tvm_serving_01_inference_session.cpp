@@ -0,0 +1,150 @@
+#include <tvm/runtime/ndarray.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/artifact_cache.h"
+#include "compiler/build_options.h"
+#include "compiler/model_evaluator.h"
+#include "onnx.proto3.pb.h"
+#include "serving/inference_session.h"
+#include "utils/onnx_utils.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::onnx_utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+using namespace tvm_cpp::serving;
+
+std::string shape_to_string(const std::vector<int64_t>& shape) {
+    std::string str = "[";
+    for (size_t i = 0; i < shape.size(); ++i) {
+        str += (i > 0 ? ", " : "") + std::to_string(shape[i]);
+    }
+    return str + "]";
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx cache_dir [iterations] [target]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx ./artifact_cache 1000 \"llvm -mcpu=skylake-avx512\""
+                  << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string cache_dir(argv[2]);
+    int iterations = argc > 3 ? std::stoi(argv[3]) : 1000;
+
+    // Step 1. compile the model into the artifact cache, it is reused by the later runs
+    BuildOptions options;
+    options.target = argc > 4 ? argv[4] : "llvm";
+    std::string artifact_dir;
+    bool cache_hit = false;
+    auto ret = compile_cached_artifact(file_name, options, cache_dir, ExportOptions(), artifact_dir, cache_hit);
+    if (!ret.is_ok()) {
+        std::cerr << "compile failed: " << ret << std::endl;
+        return -1;
+    }
+    std::cout << "artifact: " << artifact_dir << (cache_hit ? " (cached)" : "") << std::endl;
+
+    // Step 2. load the session, the inputs and outputs are resolved once
+    auto start = std::chrono::steady_clock::now();
+    InferenceSession session;
+    ret = session.load(artifact_dir);
+    if (!ret.is_ok()) {
+        std::cerr << "load failed: " << ret << std::endl;
+        return -1;
+    }
+    std::chrono::duration<double, std::milli> load_ms = std::chrono::steady_clock::now() - start;
+    std::cout << "load: " << load_ms.count() << " ms" << std::endl;
+
+    std::unordered_map<std::string, std::vector<int64_t>> input_shapes;
+    for (const auto& input : session.get_inputs()) {
+        std::cout << "input  " << std::left << std::setw(24) << input.name << input.dtype << " "
+                  << shape_to_string(input.shape) << std::endl;
+        input_shapes.emplace(input.name, input.shape);
+    }
+    for (const auto& output : session.get_outputs()) {
+        std::cout << "output " << std::left << std::setw(24) << output.name << output.dtype << " "
+                  << shape_to_string(output.shape) << std::endl;
+    }
+
+    std::vector<TensorMap> samples;
+    create_random_samples(input_shapes, 1, 0, samples);
+
+    // a mismatched input is rejected before it reaches the executor
+    if (!session.get_inputs().empty()) {
+        const TensorInfo& input = session.get_inputs()[0];
+        std::vector<int64_t> wrong_shape = input.shape;
+        wrong_shape.emplace_back(1);
+        tvm::runtime::NDArray wrong = tvm::runtime::NDArray::Empty(wrong_shape, input.dtype, {kDLCPU, 0});
+        std::cout << "mismatched input: " << session.set_input(input.name, wrong) << std::endl;
+    }
+
+    // Step 3. the per-call overhead of the session over the bare executor run
+    double executor_ms = 0;
+    ret = measure_executor_latency(session.get_executor(), samples[0], 10, iterations, executor_ms);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::vector<int> input_indices;
+    for (const auto& input : session.get_inputs()) {
+        int index = 0;
+        session.get_input_index(input.name, index);
+        input_indices.emplace_back(index);
+    }
+
+    auto call = [&](bool with_run) -> tvm_cpp::Status {
+        for (size_t i = 0; i < input_indices.size(); ++i) {
+            auto status = session.set_input(input_indices[i], samples[0][session.get_inputs()[i].name]);
+            if (!status.is_ok()) {
+                return status;
+            }
+        }
+        if (with_run) {
+            auto status = session.run();
+            if (!status.is_ok()) {
+                return status;
+            }
+        }
+
+        tvm::runtime::NDArray output;
+        for (size_t i = 0; i < session.get_outputs().size(); ++i) {
+            auto status = session.get_output(static_cast<int>(i), output);
+            if (!status.is_ok()) {
+                return status;
+            }
+        }
+        return tvm_cpp::Status::ok();
+    };
+
+    std::vector<double> call_ms;
+    for (bool with_run : {true, false}) {
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            ret = call(with_run);
+            if (!ret.is_ok()) {
+                std::cerr << ret << std::endl;
+                return -1;
+            }
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        call_ms.emplace_back(elapsed.count() / iterations);
+    }
+
+    std::cout << "executor run: " << executor_ms << " ms" << std::endl;
+    std::cout << "session set_input + run + get_output: " << call_ms[0] << " ms" << std::endl;
+    std::cout << "session overhead: " << (call_ms[0] - executor_ms) * 1e3 << " us, set_input + get_output only: "
+              << call_ms[1] * 1e3 << " us" << std::endl;
+
+    return 0;
+}
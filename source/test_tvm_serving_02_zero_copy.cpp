@@ -0,0 +1,215 @@
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/artifact_cache.h"
+#include "compiler/build_options.h"
+#include "serving/inference_session.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+using namespace tvm_cpp::serving;
+
+// the caller-owned buffers, `offset` bytes after an aligned address
+struct CallerBuffers {
+    std::vector<std::unique_ptr<char, decltype(&std::free)>> storage;
+    std::vector<void*> inputs;
+    std::vector<void*> outputs;
+};
+
+void allocate_buffers(const InferenceSession& session, size_t offset, CallerBuffers& buffers) {
+    auto allocate = [&](const TensorInfo& info) {
+        size_t alignment = tvm::runtime::kAllocAlignment;
+        size_t size = (info.bytes() + offset + alignment - 1) / alignment * alignment;
+        char* data = static_cast<char*>(std::aligned_alloc(alignment, size));
+        std::memset(data, 0, size);
+        buffers.storage.emplace_back(data, &std::free);
+        return static_cast<void*>(data + offset);
+    };
+
+    for (const auto& input : session.get_inputs()) {
+        buffers.inputs.emplace_back(allocate(input));
+    }
+    for (const auto& output : session.get_outputs()) {
+        buffers.outputs.emplace_back(allocate(output));
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx cache_dir [iterations] [target]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx ./artifact_cache 1000" << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string cache_dir(argv[2]);
+    int iterations = argc > 3 ? std::stoi(argv[3]) : 1000;
+
+    BuildOptions options;
+    options.target = argc > 4 ? argv[4] : "llvm";
+    std::string artifact_dir;
+    bool cache_hit = false;
+    auto ret = compile_cached_artifact(file_name, options, cache_dir, ExportOptions(), artifact_dir, cache_hit);
+    if (!ret.is_ok()) {
+        std::cerr << "compile failed: " << ret << std::endl;
+        return -1;
+    }
+
+    InferenceSession session;
+    ret = session.load(artifact_dir);
+    if (!ret.is_ok()) {
+        std::cerr << "load failed: " << ret << std::endl;
+        return -1;
+    }
+
+    std::unordered_map<std::string, std::vector<int64_t>> input_shapes;
+    for (const auto& input : session.get_inputs()) {
+        input_shapes.emplace(input.name, input.shape);
+    }
+    std::vector<TensorMap> samples;
+    create_random_samples(input_shapes, 1, 0, samples);
+
+    // the request handler owns the buffers, the copy path copies them in and out of the executor each call
+    CallerBuffers aligned;
+    CallerBuffers misaligned;
+    allocate_buffers(session, 0, aligned);
+    allocate_buffers(session, 4, misaligned);
+    for (auto* buffers : {&aligned, &misaligned}) {
+        for (size_t i = 0; i < session.get_inputs().size(); ++i) {
+            const TensorInfo& input = session.get_inputs()[i];
+            samples[0][input.name].CopyToBytes(buffers->inputs[i], input.bytes());
+        }
+    }
+
+    auto copy_call = [&]() -> tvm_cpp::Status {
+        for (size_t i = 0; i < session.get_inputs().size(); ++i) {
+            const TensorInfo& input = session.get_inputs()[i];
+            tvm::runtime::NDArray data = tvm::runtime::NDArray::Empty(input.shape, input.dtype, {kDLCPU, 0});
+            data.CopyFromBytes(aligned.inputs[i], input.bytes());
+            auto status = session.set_input(static_cast<int>(i), data);
+            if (!status.is_ok()) {
+                return status;
+            }
+        }
+
+        auto status = session.run();
+        for (size_t i = 0; status.is_ok() && i < session.get_outputs().size(); ++i) {
+            tvm::runtime::NDArray output;
+            status = session.get_output(static_cast<int>(i), output);
+            if (status.is_ok()) {
+                output.CopyToBytes(aligned.outputs[i], session.get_outputs()[i].bytes());
+            }
+        }
+        return status;
+    };
+
+    auto bind = [&](CallerBuffers& buffers) -> tvm_cpp::Status {
+        for (size_t i = 0; i < buffers.inputs.size(); ++i) {
+            auto status = session.set_input_zero_copy(static_cast<int>(i), buffers.inputs[i]);
+            if (!status.is_ok()) {
+                return status;
+            }
+        }
+        for (size_t i = 0; i < buffers.outputs.size(); ++i) {
+            auto status = session.set_output_zero_copy(static_cast<int>(i), buffers.outputs[i]);
+            if (!status.is_ok()) {
+                return status;
+            }
+        }
+        return tvm_cpp::Status::ok();
+    };
+
+    auto measure = [&](const std::function<tvm_cpp::Status()>& call, double& latency_ms) -> tvm_cpp::Status {
+        for (int i = 0; i < 10; ++i) {
+            auto status = call();
+            if (!status.is_ok()) {
+                return status;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            call();
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        latency_ms = elapsed.count() / iterations;
+        return tvm_cpp::Status::ok();
+    };
+
+    // Step 1. copy the inputs in and the outputs out each call
+    double copy_ms = 0;
+    ret = measure(copy_call, copy_ms);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::vector<std::vector<char>> expected;
+    for (size_t i = 0; i < session.get_outputs().size(); ++i) {
+        const char* data = static_cast<const char*>(aligned.outputs[i]);
+        expected.emplace_back(data, data + session.get_outputs()[i].bytes());
+        std::memset(aligned.outputs[i], 0, session.get_outputs()[i].bytes());
+    }
+
+    // Step 2. bind the aligned buffers once, each call only runs
+    double zero_copy_ms = 0;
+    ret = bind(aligned);
+    if (ret.is_ok()) {
+        ret = measure([&]() { return session.run(); }, zero_copy_ms);
+    }
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+    ZeroCopyStats aligned_stats = session.get_zero_copy_stats();
+
+    // Step 3. the misaligned buffers fall back to copy
+    double fallback_ms = 0;
+    ret = bind(misaligned);
+    if (ret.is_ok()) {
+        ret = measure([&]() { return session.run(); }, fallback_ms);
+    }
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+    ZeroCopyStats stats = session.get_zero_copy_stats();
+
+    for (auto* buffers : {&aligned, &misaligned}) {
+        for (size_t i = 0; i < expected.size(); ++i) {
+            if (std::memcmp(buffers->outputs[i], expected[i].data(), expected[i].size()) != 0) {
+                std::cerr << "the output " << i << " of the " << (buffers == &aligned ? "aligned" : "misaligned")
+                          << " buffers differs from the copy path" << std::endl;
+                return -1;
+            }
+        }
+    }
+
+    ret = session.clear_zero_copy();
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::cout << "aligned bindings, zero-copy inputs: " << aligned_stats.zero_copy_inputs
+              << ", zero-copy outputs: " << aligned_stats.zero_copy_outputs << std::endl;
+    std::cout << "misaligned bindings, copied inputs: " << stats.copied_inputs
+              << ", copied outputs: " << stats.copied_outputs << std::endl;
+    std::cout << "copy: " << copy_ms << " ms, zero-copy: " << zero_copy_ms << " ms, misaligned fallback: "
+              << fallback_ms << " ms, saved per call: " << (copy_ms - zero_copy_ms) * 1e3 << " us" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include <tvm/runtime/ndarray.h>
+
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/artifact_cache.h"
+#include "compiler/build_options.h"
+#include "serving/inference_session.h"
+#include "serving/tensor_pool.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+using namespace tvm_cpp::serving;
+
+/**
+ * @brief Serve `iterations` requests on the session, the responses of the last `in_flight` requests are kept alive
+ * like the responses which are still being sent
+ *
+ */
+tvm_cpp::Status serve(InferenceSession& session, const TensorMap& inputs, bool pooled, int iterations,
+                      int in_flight) {
+    auto status = session.set_inputs(inputs);
+    if (!status.is_ok()) {
+        return status;
+    }
+
+    std::deque<std::vector<tvm::runtime::NDArray>> fresh_responses;
+    std::deque<std::vector<PooledTensor>> pooled_responses;
+    for (int i = 0; i < iterations; ++i) {
+        if (pooled) {
+            std::vector<PooledTensor> outputs;
+            status = session.run(outputs);
+            pooled_responses.emplace_back(std::move(outputs));
+            if (static_cast<int>(pooled_responses.size()) > in_flight) {
+                pooled_responses.pop_front();
+            }
+        } else {
+            // a fresh allocation and a copy of each output
+            status = session.run();
+            std::vector<tvm::runtime::NDArray> outputs;
+            for (size_t j = 0; status.is_ok() && j < session.get_outputs().size(); ++j) {
+                tvm::runtime::NDArray output;
+                status = session.get_output(static_cast<int>(j), output);
+                if (status.is_ok()) {
+                    const TensorInfo& info = session.get_outputs()[j];
+                    outputs.emplace_back(tvm::runtime::NDArray::Empty(info.shape, info.dtype, {kDLCPU, 0}));
+                    outputs.back().CopyFrom(output);
+                }
+            }
+            fresh_responses.emplace_back(std::move(outputs));
+            if (static_cast<int>(fresh_responses.size()) > in_flight) {
+                fresh_responses.pop_front();
+            }
+        }
+
+        if (!status.is_ok()) {
+            return status;
+        }
+    }
+
+    return tvm_cpp::Status::ok();
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx cache_dir [threads] [iterations] [in_flight]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx ./artifact_cache 4 1000 8" << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string cache_dir(argv[2]);
+    int threads = argc > 3 ? std::stoi(argv[3]) : 4;
+    int iterations = argc > 4 ? std::stoi(argv[4]) : 1000;
+    int in_flight = argc > 5 ? std::stoi(argv[5]) : 8;
+
+    BuildOptions options;
+    std::string artifact_dir;
+    bool cache_hit = false;
+    auto ret = compile_cached_artifact(file_name, options, cache_dir, ExportOptions(), artifact_dir, cache_hit);
+    if (!ret.is_ok()) {
+        std::cerr << "compile failed: " << ret << std::endl;
+        return -1;
+    }
+
+    // a session and an output pool per thread, the cap covers the responses in flight and the running one
+    std::vector<std::unique_ptr<InferenceSession>> sessions;
+    for (int i = 0; i < threads; ++i) {
+        sessions.emplace_back(std::make_unique<InferenceSession>());
+        ret = sessions.back()->load(artifact_dir);
+        if (ret.is_ok()) {
+            ret = sessions.back()->create_output_pool(in_flight + 1);
+        }
+        if (!ret.is_ok()) {
+            std::cerr << "load failed: " << ret << std::endl;
+            return -1;
+        }
+    }
+
+    std::unordered_map<std::string, std::vector<int64_t>> input_shapes;
+    for (const auto& input : sessions[0]->get_inputs()) {
+        input_shapes.emplace(input.name, input.shape);
+    }
+    std::vector<TensorMap> samples;
+    create_random_samples(input_shapes, 1, 0, samples);
+
+    for (bool pooled : {false, true}) {
+        std::vector<tvm_cpp::Status> statuses(threads);
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threads; ++i) {
+            workers.emplace_back([&, i]() {
+                statuses[i] = serve(*sessions[i], samples[0], pooled, iterations, in_flight);
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        for (const auto& status : statuses) {
+            if (!status.is_ok()) {
+                std::cerr << status << std::endl;
+                return -1;
+            }
+        }
+
+        std::cout << (pooled ? "pooled" : "fresh") << " outputs: " << threads * iterations / elapsed.count()
+                  << " requests/s" << std::endl;
+    }
+
+    TensorPoolStats total;
+    for (const auto& session : sessions) {
+        TensorPoolStats stats = session->get_output_pool()->get_stats();
+        total.allocated += stats.allocated;
+        total.allocated_bytes += stats.allocated_bytes;
+        total.in_use += stats.in_use;
+        total.high_water_mark += stats.high_water_mark;
+        total.reused += stats.reused;
+        total.overflow += stats.overflow;
+    }
+
+    std::cout << "pool allocated: " << total.allocated << " (" << total.allocated_bytes / 1024.0
+              << " KB), high water mark: " << total.high_water_mark << ", reused: " << total.reused
+              << ", overflow: " << total.overflow << ", in use: " << total.in_use << std::endl;
+
+    return 0;
+}
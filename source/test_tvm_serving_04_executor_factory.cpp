@@ -0,0 +1,168 @@
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/artifact_cache.h"
+#include "compiler/build_options.h"
+#include "serving/executor_factory.h"
+#include "serving/inference_session.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+using namespace tvm_cpp::serving;
+
+/**
+ * @brief The resident set size of the process in MB
+ *
+ */
+double get_rss_mb() {
+    std::ifstream ifs("/proc/self/statm");
+    int64_t size = 0;
+    int64_t resident = 0;
+    ifs >> size >> resident;
+    return static_cast<double>(resident) * sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+}
+
+/**
+ * @brief Load `instances` sessions, by a shared factory or each from the artifact, and print the memory they take
+ *
+ */
+tvm_cpp::Status load_sessions(const std::string& artifact_dir, int instances, bool shared,
+                              std::vector<std::unique_ptr<InferenceSession>>& sessions) {
+    sessions.clear();
+    double base_rss = get_rss_mb();
+    ExecutorFactory factory;
+    if (shared) {
+        auto status = factory.load(artifact_dir);
+        if (!status.is_ok()) {
+            return status;
+        }
+    }
+
+    for (int i = 0; i < instances; ++i) {
+        sessions.emplace_back(std::make_unique<InferenceSession>());
+        auto status = shared ? sessions.back()->load(factory) : sessions.back()->load(artifact_dir);
+        if (!status.is_ok()) {
+            return status;
+        }
+    }
+
+    double rss = get_rss_mb() - base_rss;
+    std::cout << (shared ? "shared params" : "private params") << ": " << instances << " instances take " << rss
+              << " MB, " << rss / instances << " MB per instance" << std::endl;
+    if (shared) {
+        std::cout << "params: " << factory.get_params_bytes() / (1024.0 * 1024.0)
+                  << " MB once, planned storage: " << factory.get_executor_storage_bytes() / (1024.0 * 1024.0)
+                  << " MB per instance" << std::endl;
+    }
+
+    return tvm_cpp::Status::ok();
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx cache_dir [instances] [iterations]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx ./artifact_cache 32 100" << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string cache_dir(argv[2]);
+    int instances = argc > 3 ? std::stoi(argv[3]) : 32;
+    int iterations = argc > 4 ? std::stoi(argv[4]) : 100;
+
+    BuildOptions options;
+    std::string artifact_dir;
+    bool cache_hit = false;
+    auto ret = compile_cached_artifact(file_name, options, cache_dir, ExportOptions(), artifact_dir, cache_hit);
+    if (!ret.is_ok()) {
+        std::cerr << "compile failed: " << ret << std::endl;
+        return -1;
+    }
+
+    // the reference outputs of a session with its own params
+    InferenceSession reference;
+    ret = reference.load(artifact_dir);
+    if (!ret.is_ok()) {
+        std::cerr << "load failed: " << ret << std::endl;
+        return -1;
+    }
+
+    std::unordered_map<std::string, std::vector<int64_t>> input_shapes;
+    for (const auto& input : reference.get_inputs()) {
+        input_shapes.emplace(input.name, input.shape);
+    }
+    std::vector<TensorMap> samples;
+    create_random_samples(input_shapes, 1, 0, samples);
+
+    ret = reference.set_inputs(samples[0]);
+    if (ret.is_ok()) {
+        ret = reference.run();
+    }
+    if (!ret.is_ok()) {
+        std::cerr << "run failed: " << ret << std::endl;
+        return -1;
+    }
+
+    std::vector<std::unique_ptr<InferenceSession>> sessions;
+    for (bool shared : {false, true}) {
+        ret = load_sessions(artifact_dir, instances, shared, sessions);
+        if (!ret.is_ok()) {
+            std::cerr << "load failed: " << ret << std::endl;
+            return -1;
+        }
+    }
+
+    // run all the instances of the shared params concurrently
+    std::vector<tvm_cpp::Status> statuses(instances);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < instances; ++i) {
+        workers.emplace_back([&, i]() {
+            InferenceSession& session = *sessions[i];
+            statuses[i] = session.set_inputs(samples[0]);
+            for (int j = 0; statuses[i].is_ok() && j < iterations; ++j) {
+                statuses[i] = session.run();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    for (int i = 0; i < instances; ++i) {
+        if (!statuses[i].is_ok()) {
+            std::cerr << statuses[i] << std::endl;
+            return -1;
+        }
+
+        for (size_t j = 0; j < reference.get_outputs().size(); ++j) {
+            tvm::runtime::NDArray expected;
+            tvm::runtime::NDArray actual;
+            reference.get_output(static_cast<int>(j), expected);
+            sessions[i]->get_output(static_cast<int>(j), actual);
+            size_t bytes = reference.get_outputs()[j].bytes();
+            if (std::memcmp(expected->data, actual->data, bytes) != 0) {
+                std::cerr << "the output " << j << " of instance " << i << " differs from the reference" << std::endl;
+                return -1;
+            }
+        }
+    }
+
+    std::cout << instances << " instances: " << instances * iterations / elapsed.count() << " requests/s"
+              << std::endl;
+
+    return 0;
+}
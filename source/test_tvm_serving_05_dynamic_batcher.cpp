@@ -0,0 +1,220 @@
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/artifact_cache.h"
+#include "compiler/build_options.h"
+#include "compiler/model_artifact.h"
+#include "compiler/model_builder.h"
+#include "onnx.proto3.pb.h"
+#include "serving/dynamic_batcher.h"
+#include "serving/inference_session.h"
+#include "utils/onnx_utils.h"
+#include "utils/relay_utils.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::onnx_utils;
+using namespace tvm_cpp::relay_utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+using namespace tvm_cpp::serving;
+
+/**
+ * @brief Compile the model with the dynamic dims bound to the batch size and load a session of it. The artifact is
+ * kept in the cache directory by the batch size
+ *
+ */
+tvm_cpp::Status load_batch_session(const onnx::ModelProto& onnx_model, const std::string& cache_dir, int64_t batch,
+                                   std::unique_ptr<InferenceSession>& session) {
+    std::string artifact_dir = (std::filesystem::path(cache_dir) / ("batch_" + std::to_string(batch))).string();
+    if (!has_cached_artifact(artifact_dir)) {
+        tvm::IRModule module;
+        auto status = parse_graph_to_irmodule(onnx_model.graph(), module);
+        if (!status.is_ok()) {
+            return status;
+        }
+
+        std::unordered_map<std::string, std::vector<int64_t>> shapes;
+        get_graph_input_shapes(onnx_model.graph(), batch, shapes);
+        status = specialize_input_shapes(shapes, module);
+        if (!status.is_ok()) {
+            return status;
+        }
+
+        BuildResult result;
+        status = build_irmodule(module, BuildOptions(), result);
+        if (!status.is_ok()) {
+            return status;
+        }
+
+        status = export_model_artifact(result, artifact_dir);
+        if (!status.is_ok()) {
+            return status;
+        }
+    }
+
+    session = std::make_unique<InferenceSession>();
+    return session->load(artifact_dir);
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx cache_dir [max_batch] [clients] [requests] [max_delay_us]"
+                  << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx ./artifact_cache 8 16 200 2000" << std::endl;
+        std::cerr << "the dim 0 of the model inputs must be the dynamic batch" << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string cache_dir(argv[2]);
+    int max_batch = argc > 3 ? std::stoi(argv[3]) : 8;
+    int clients = argc > 4 ? std::stoi(argv[4]) : 16;
+    int requests = argc > 5 ? std::stoi(argv[5]) : 200;
+    int64_t max_delay_us = argc > 6 ? std::stoll(argv[6]) : 2000;
+
+    onnx::ModelProto onnx_model;
+    auto ret = load_onnx_model(file_name, onnx_model);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::string model_cache_dir =
+        (std::filesystem::path(cache_dir) / std::filesystem::path(file_name).stem()).string();
+
+    // Step 1. the sessions of the batch sizes 1, 2, 4, ... max_batch
+    std::vector<std::unique_ptr<InferenceSession>> sessions;
+    std::vector<int64_t> batch_sizes;
+    for (int64_t batch = 1; batch < max_batch; batch *= 2) {
+        batch_sizes.emplace_back(batch);
+    }
+    batch_sizes.emplace_back(max_batch);
+    for (int64_t batch : batch_sizes) {
+        std::unique_ptr<InferenceSession> session;
+        ret = load_batch_session(onnx_model, model_cache_dir, batch, session);
+        if (!ret.is_ok()) {
+            std::cerr << "batch " << batch << " failed: " << ret << std::endl;
+            return -1;
+        }
+        sessions.emplace_back(std::move(session));
+    }
+
+    // the unbatched reference
+    std::unique_ptr<InferenceSession> single;
+    ret = load_batch_session(onnx_model, model_cache_dir, 1, single);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::unordered_map<std::string, std::vector<int64_t>> input_shapes;
+    for (const auto& input : single->get_inputs()) {
+        input_shapes.emplace(input.name, input.shape);
+    }
+    std::vector<TensorMap> samples;
+    create_random_samples(input_shapes, clients, 0, samples);
+
+    auto run_clients = [&](const std::function<tvm_cpp::Status(int)>& request) -> double {
+        std::vector<tvm_cpp::Status> statuses(clients);
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (int i = 0; i < clients; ++i) {
+            workers.emplace_back([&, i]() {
+                for (int j = 0; j < requests && statuses[i].is_ok(); ++j) {
+                    statuses[i] = request(i);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        for (const auto& status : statuses) {
+            if (!status.is_ok()) {
+                std::cerr << status << std::endl;
+                return -1;
+            }
+        }
+        return clients * requests / elapsed.count();
+    };
+
+    // Step 2. the single-sample requests serialized on one unbatched session
+    std::mutex single_mutex;
+    double single_throughput = run_clients([&](int client) {
+        std::lock_guard<std::mutex> lock(single_mutex);
+        auto status = single->set_inputs(samples[client]);
+        return status.is_ok() ? single->run() : status;
+    });
+    if (single_throughput < 0) {
+        return -1;
+    }
+
+    // Step 3. the same requests coalesced by the dynamic batcher
+    BatcherOptions options;
+    options.max_batch_size = max_batch;
+    options.max_delay_us = max_delay_us;
+    std::unique_ptr<DynamicBatcher> batcher;
+    ret = DynamicBatcher::create(std::move(sessions), options, batcher);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    // the unbatched outputs of each client's sample
+    std::vector<std::vector<std::vector<char>>> expected(clients);
+    for (int i = 0; i < clients; ++i) {
+        single->set_inputs(samples[i]);
+        single->run();
+        for (size_t j = 0; j < single->get_outputs().size(); ++j) {
+            tvm::runtime::NDArray output;
+            single->get_output(static_cast<int>(j), output);
+            const char* data = static_cast<const char*>(output->data);
+            expected[i].emplace_back(data, data + single->get_outputs()[j].bytes());
+        }
+    }
+
+    std::vector<int> mismatches(clients, 0);
+    double batched_throughput = run_clients([&](int client) {
+        std::vector<tvm::runtime::NDArray> outputs;
+        auto status = batcher->infer(samples[client], outputs);
+        for (size_t j = 0; status.is_ok() && j < outputs.size(); ++j) {
+            // the batched kernels may accumulate in another order, the differences are counted but not fatal
+            if (std::memcmp(outputs[j]->data, expected[client][j].data(), expected[client][j].size()) != 0) {
+                ++mismatches[client];
+            }
+        }
+        return status;
+    });
+    if (batched_throughput < 0) {
+        return -1;
+    }
+
+    int total_mismatches = 0;
+    for (int count : mismatches) {
+        total_mismatches += count;
+    }
+
+    BatcherStats stats = batcher->get_stats();
+    std::cout << "unbatched: " << single_throughput << " requests/s" << std::endl;
+    std::cout << "batched: " << batched_throughput << " requests/s, " << stats.batches << " batches, "
+              << stats.padded_samples << " padded samples, " << total_mismatches << " outputs not bitwise equal"
+              << std::endl;
+    std::cout << "batch size: mean " << stats.batch_size.mean() << ", " << stats.batch_size << std::endl;
+    std::cout << "queue time(us): mean " << stats.queue_time_us.mean() << ", p50 "
+              << stats.queue_time_us.percentile(0.5) << ", p99 " << stats.queue_time_us.percentile(0.99) << ", "
+              << stats.queue_time_us << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "onnx.proto3.pb.h"
+#include "serving/shape_buckets.h"
+#include "utils/onnx_utils.h"
+#include "utils/relay_utils.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::onnx_utils;
+using namespace tvm_cpp::relay_utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+using namespace tvm_cpp::serving;
+
+std::string shapes_to_string(const ShapeMap& shapes) {
+    std::ostringstream oss;
+    for (const auto& kv : shapes) {
+        oss << kv.first << "[";
+        for (size_t i = 0; i < kv.second.size(); ++i) {
+            oss << (i > 0 ? "," : "") << kv.second[i];
+        }
+        oss << "] ";
+    }
+    return oss.str();
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx cache_dir [max_buckets] [requests] [min_dim] [max_dim]"
+                  << std::endl;
+        std::cerr << "e.g. " << argv[0] << " bert.onnx ./artifact_cache 4 1000 8 128" << std::endl;
+        std::cerr << "the dynamic dims of the model inputs, e.g. the sequence length, vary in [min_dim, max_dim]"
+                  << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string cache_dir(argv[2]);
+    int max_buckets = argc > 3 ? std::stoi(argv[3]) : 4;
+    int requests = argc > 4 ? std::stoi(argv[4]) : 1000;
+    int64_t min_dim = argc > 5 ? std::stoll(argv[5]) : 8;
+    int64_t max_dim = argc > 6 ? std::stoll(argv[6]) : 128;
+
+    onnx::ModelProto onnx_model;
+    auto ret = load_onnx_model(file_name, onnx_model);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    // Step 1. record the shapes of the traffic, the short requests are the most frequent
+    std::mt19937 engine(0);
+    std::geometric_distribution<int64_t> distribution(4.0 / static_cast<double>(max_dim - min_dim + 1));
+    std::vector<ShapeMap> request_shapes;
+    ShapeHistogram recorded;
+    for (int i = 0; i < requests; ++i) {
+        int64_t dim = std::min(max_dim, min_dim + distribution(engine));
+        ShapeMap shapes;
+        get_graph_input_shapes(onnx_model.graph(), dim, shapes);
+        request_shapes.emplace_back(shapes);
+        recorded.record(shapes);
+    }
+
+    std::string model_cache_dir =
+        (std::filesystem::path(cache_dir) / std::filesystem::path(file_name).stem()).string();
+    std::filesystem::create_directories(model_cache_dir);
+    std::string histogram_path = (std::filesystem::path(model_cache_dir) / "shape_histogram.json").string();
+    ret = recorded.save(histogram_path);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    ShapeHistogram histogram;
+    ret = histogram.load(histogram_path);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+    std::cout << histogram.entries().size() << " distinct shapes of " << histogram.total() << " requests" << std::endl;
+
+    // Step 2. the buckets chosen from the histogram against the evenly spaced ones
+    std::vector<ShapeMap> buckets;
+    int64_t padded_elements = 0;
+    ret = choose_shape_buckets(histogram, max_buckets, buckets, padded_elements);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::vector<ShapeMap> even_buckets;
+    for (int i = 1; i <= max_buckets; ++i) {
+        ShapeMap shapes;
+        get_graph_input_shapes(onnx_model.graph(), min_dim + (max_dim - min_dim) * i / max_buckets, shapes);
+        even_buckets.emplace_back(shapes);
+    }
+
+    int64_t elements = 0;
+    for (const auto& entry : histogram.entries()) {
+        elements += entry.second * get_shape_elements(entry.first);
+    }
+    std::cout << "padding of the chosen buckets: " << 100.0 * padded_elements / elements << "%, of the even buckets: "
+              << 100.0 * get_padded_elements(histogram, even_buckets) / elements << "%" << std::endl;
+    for (const auto& bucket : buckets) {
+        std::cout << "  bucket " << shapes_to_string(bucket) << std::endl;
+    }
+
+    // Step 3. compile the buckets ahead of time and serve the requests
+    tvm::IRModule module;
+    ret = parse_graph_to_irmodule(onnx_model.graph(), module);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::vector<std::string> artifact_dirs;
+    ret = compile_shape_buckets(module, buckets, BuildOptions(), model_cache_dir, artifact_dirs);
+    if (!ret.is_ok()) {
+        std::cerr << "compile failed: " << ret << std::endl;
+        return -1;
+    }
+
+    BucketedSession session;
+    ret = session.load(artifact_dirs);
+    if (!ret.is_ok()) {
+        std::cerr << "load failed: " << ret << std::endl;
+        return -1;
+    }
+
+    std::vector<TensorMap> samples;
+    std::vector<std::vector<tvm::runtime::NDArray>> outputs(request_shapes.size());
+    for (const auto& shapes : request_shapes) {
+        std::vector<TensorMap> sample;
+        create_random_samples(shapes, 1, 0, sample);
+        samples.emplace_back(sample[0]);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < samples.size(); ++i) {
+        ret = session.run(samples[i], outputs[i]);
+        if (!ret.is_ok()) {
+            std::cerr << "run failed: " << ret << std::endl;
+            return -1;
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const BucketStats& stats = session.get_stats();
+    std::cout << "served " << samples.size() / elapsed.count() << " requests/s, padding "
+              << 100.0 * stats.padded_elements / stats.elements << "%" << std::endl;
+    for (size_t i = 0; i < stats.requests.size(); ++i) {
+        std::cout << "  " << get_bucket_name(session.get_buckets()[i]) << ": " << stats.requests[i] << " requests"
+                  << std::endl;
+    }
+
+    // the outputs of the first and the last requests are cropped to them
+    for (size_t i : {size_t(0), samples.size() - 1}) {
+        std::cout << "request " << shapes_to_string(request_shapes[i]) << "-> outputs";
+        for (const auto& output : outputs[i]) {
+            std::cout << " [";
+            for (int d = 0; d < output->ndim; ++d) {
+                std::cout << (d > 0 ? "," : "") << output->shape[d];
+            }
+            std::cout << "]";
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
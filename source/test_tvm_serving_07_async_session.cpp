@@ -0,0 +1,183 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/artifact_cache.h"
+#include "compiler/build_options.h"
+#include "serving/async_session.h"
+#include "serving/executor_factory.h"
+#include "serving/mpmc_queue.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+using namespace tvm_cpp::serving;
+
+/**
+ * @brief Push and pop the numbers 1..n from several threads, the sum must be exact
+ *
+ */
+bool check_mpmc_queue(int producers, int consumers, int64_t n) {
+    MpmcQueue<int64_t> queue(64);
+    std::atomic<int64_t> popped{0};
+    std::atomic<int64_t> sum{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            for (int64_t value = p + 1; value <= n; value += producers) {
+                int64_t item = value;
+                while (!queue.try_push(std::move(item))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&]() {
+            int64_t value = 0;
+            while (popped < n) {
+                if (queue.try_pop(value)) {
+                    sum += value;
+                    ++popped;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return sum == n * (n + 1) / 2;
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx cache_dir [workers] [requests] [clients]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx ./artifact_cache 4 2000 2" << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string cache_dir(argv[2]);
+    int workers = argc > 3 ? std::stoi(argv[3]) : 4;
+    int requests = argc > 4 ? std::stoi(argv[4]) : 2000;
+    int clients = argc > 5 ? std::stoi(argv[5]) : 2;
+
+    // Step 1. the lock-free queue keeps every value under contention
+    if (!check_mpmc_queue(4, 4, 1000000)) {
+        std::cerr << "the MPMC queue lost or duplicated values" << std::endl;
+        return -1;
+    }
+    std::cout << "MPMC queue: OK" << std::endl;
+
+    BuildOptions options;
+    std::string artifact_dir;
+    bool cache_hit = false;
+    auto ret = compile_cached_artifact(file_name, options, cache_dir, ExportOptions(), artifact_dir, cache_hit);
+    if (!ret.is_ok()) {
+        std::cerr << "compile failed: " << ret << std::endl;
+        return -1;
+    }
+
+    ExecutorFactory factory;
+    ret = factory.load(artifact_dir);
+    if (!ret.is_ok()) {
+        std::cerr << "load failed: " << ret << std::endl;
+        return -1;
+    }
+
+    AsyncOptions async_options;
+    async_options.workers = workers;
+    async_options.queue_capacity = requests;
+    std::unique_ptr<AsyncSession> session;
+    ret = AsyncSession::create(factory, async_options, session);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::unordered_map<std::string, std::vector<int64_t>> input_shapes;
+    for (const auto& input : session->get_inputs()) {
+        input_shapes.emplace(input.name, input.shape);
+    }
+    std::vector<TensorMap> samples;
+    create_random_samples(input_shapes, 1, 0, samples);
+
+    // Step 2. a few client threads submit all the requests with callbacks and never wait for the inference
+    std::atomic<int64_t> completed{0};
+    std::atomic<int64_t> failed{0};
+    std::promise<void> all_done;
+    int64_t total = static_cast<int64_t>(requests) * clients;
+    auto callback = [&](InferResult&& result) {
+        if (!result.status.is_ok()) {
+            ++failed;
+        }
+        if (++completed == total) {
+            all_done.set_value();
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    std::atomic<int64_t> rejected{0};
+    for (int c = 0; c < clients; ++c) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < requests; ++i) {
+                // the queue is full, a real service would answer busy, here the request is retried
+                while (!session->submit(samples[0], callback).is_ok()) {
+                    ++rejected;
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> submit_elapsed = std::chrono::steady_clock::now() - start;
+    all_done.get_future().wait();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (failed > 0) {
+        std::cerr << failed << " requests failed" << std::endl;
+        return -1;
+    }
+
+    AsyncStats stats = session->get_stats();
+    std::cout << clients << " clients, " << workers << " workers: " << total / elapsed.count() << " requests/s, "
+              << "submission took " << submit_elapsed.count() * 1000 << " ms, " << rejected << " retries"
+              << std::endl;
+    std::cout << "queue time(us): p50 " << stats.queue_time_us.percentile(0.5) << ", p99 "
+              << stats.queue_time_us.percentile(0.99) << std::endl;
+    std::cout << "latency(us): p50 " << stats.latency_us.percentile(0.5) << ", p99 "
+              << stats.latency_us.percentile(0.99) << std::endl;
+
+    // Step 3. the future API
+    std::future<InferResult> future;
+    ret = session->submit(samples[0], future);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+    InferResult result = future.get();
+    if (!result.status.is_ok() || result.outputs.size() != session->get_outputs().size()) {
+        std::cerr << "future request failed: " << result.status << std::endl;
+        return -1;
+    }
+    std::cout << "future request: " << result.outputs.size() << " outputs" << std::endl;
+
+    session->stop();
+    std::cout << "after stop: " << session->submit(samples[0], future) << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/artifact_cache.h"
+#include "compiler/build_options.h"
+#include "serving/executor_factory.h"
+#include "serving/histogram.h"
+#include "serving/inference_session.h"
+#include "serving/thread_config.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+using namespace tvm_cpp::serving;
+
+std::string cores_to_string(const std::vector<int>& cores) {
+    std::string text;
+    for (size_t i = 0; i < cores.size(); ++i) {
+        text += (i > 0 ? "," : "") + std::to_string(cores[i]);
+    }
+    return text.empty() ? "default" : text;
+}
+
+/**
+ * @brief Run the session on a new thread with the thread config and record the latency of each run
+ *
+ */
+std::thread run_session(InferenceSession& session, const TensorMap& sample, const ThreadConfig& config,
+                        int iterations, Histogram& latency_us, tvm_cpp::Status& status) {
+    return std::thread([&session, &sample, config, iterations, &latency_us, &status]() {
+        status = apply_thread_config(config);
+        if (!status.is_ok()) {
+            return;
+        }
+        status = session.set_inputs(sample);
+        for (int i = 0; status.is_ok() && i < iterations; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            status = session.run();
+            auto end = std::chrono::steady_clock::now();
+            latency_us.record(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+        }
+    });
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 4) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx cache_dir cores_a cores_b [iterations]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx ./artifact_cache 0-7 8-15 200" << std::endl;
+        std::cerr << "two sessions of the model run side by side, on the TVM default cores and then pinned"
+                  << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string cache_dir(argv[2]);
+    int iterations = argc > 5 ? std::stoi(argv[5]) : 200;
+
+    std::vector<int> cores_a;
+    std::vector<int> cores_b;
+    auto ret = parse_core_list(argv[3], cores_a);
+    if (ret.is_ok()) {
+        ret = parse_core_list(argv[4], cores_b);
+    }
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    // Step 1. the cores of a session are split among its threads
+    ThreadConfig config_a;
+    config_a.cores = cores_a;
+    std::vector<ThreadConfig> parts;
+    ret = split_thread_config(config_a, 2, parts);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+    std::cout << "cores " << cores_to_string(cores_a) << " split to 2 workers: " << cores_to_string(parts[0].cores)
+              << " | " << cores_to_string(parts[1].cores) << std::endl;
+
+    BuildOptions options;
+    std::string artifact_dir;
+    bool cache_hit = false;
+    ret = compile_cached_artifact(file_name, options, cache_dir, ExportOptions(), artifact_dir, cache_hit);
+    if (!ret.is_ok()) {
+        std::cerr << "compile failed: " << ret << std::endl;
+        return -1;
+    }
+
+    ExecutorFactory factory;
+    ret = factory.load(artifact_dir);
+    if (!ret.is_ok()) {
+        std::cerr << "load failed: " << ret << std::endl;
+        return -1;
+    }
+
+    InferenceSession session_a;
+    InferenceSession session_b;
+    ret = session_a.load(factory);
+    if (ret.is_ok()) {
+        ret = session_b.load(factory);
+    }
+    if (!ret.is_ok()) {
+        std::cerr << "load failed: " << ret << std::endl;
+        return -1;
+    }
+
+    std::unordered_map<std::string, std::vector<int64_t>> input_shapes;
+    for (const auto& input : session_a.get_inputs()) {
+        input_shapes.emplace(input.name, input.shape);
+    }
+    std::vector<TensorMap> samples;
+    create_random_samples(input_shapes, 1, 0, samples);
+
+    // Step 2. the same thread counts, first bound by TVM to the same default cores, then pinned to disjoint cores
+    ThreadConfig shared_a;
+    shared_a.threads = static_cast<int>(cores_a.size());
+    ThreadConfig shared_b;
+    shared_b.threads = static_cast<int>(cores_b.size());
+    ThreadConfig pinned_b;
+    pinned_b.cores = cores_b;
+
+    struct Scenario {
+        std::string name;
+        ThreadConfig config_a;
+        ThreadConfig config_b;
+    };
+    std::vector<Scenario> scenarios{{"default cores", shared_a, shared_b}, {"pinned", config_a, pinned_b}};
+    for (const auto& scenario : scenarios) {
+        Histogram latency_a = Histogram::exponential(1, 10 * 1000 * 1000);
+        Histogram latency_b = Histogram::exponential(1, 10 * 1000 * 1000);
+        tvm_cpp::Status status_a;
+        tvm_cpp::Status status_b;
+        std::thread thread_a = run_session(session_a, samples[0], scenario.config_a, iterations, latency_a, status_a);
+        std::thread thread_b = run_session(session_b, samples[0], scenario.config_b, iterations, latency_b, status_b);
+        thread_a.join();
+        thread_b.join();
+        if (!status_a.is_ok() || !status_b.is_ok()) {
+            std::cerr << scenario.name << " failed: " << status_a << ", " << status_b << std::endl;
+            return -1;
+        }
+
+        std::cout << scenario.name << ": A " << cores_to_string(scenario.config_a.cores) << " p50 "
+                  << latency_a.percentile(0.5) << " us, p99 " << latency_a.percentile(0.99) << " us; B "
+                  << cores_to_string(scenario.config_b.cores) << " p50 " << latency_b.percentile(0.5) << " us, p99 "
+                  << latency_b.percentile(0.99) << " us" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,203 @@
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/artifact_cache.h"
+#include "compiler/build_options.h"
+#include "serving/async_session.h"
+#include "serving/executor_factory.h"
+#include "serving/histogram.h"
+#include "serving/inference_session.h"
+#include "serving/numa.h"
+#include "serving/thread_config.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+using namespace tvm_cpp::serving;
+
+/**
+ * @brief Load a session of the factory on a thread pinned to the cores with the memory bound to the node, and run it
+ *
+ */
+tvm_cpp::Status run_placed(const ExecutorFactory& factory, const std::vector<int>& cores, int memory_node,
+                           const TensorMap& sample, int iterations, Histogram& latency_us, double& elapsed) {
+    tvm_cpp::Status status;
+    std::thread thread([&]() {
+        status = bind_thread_memory(memory_node);
+        ThreadConfig config;
+        config.cores = cores;
+        if (status.is_ok()) {
+            status = apply_thread_config(config);
+        }
+
+        InferenceSession session;
+        if (status.is_ok()) {
+            status = session.load(factory);
+        }
+        if (status.is_ok()) {
+            status = session.set_inputs(sample);
+        }
+        // the first run touches the workspace
+        if (status.is_ok()) {
+            status = session.run();
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; status.is_ok() && i < iterations; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            status = session.run();
+            auto end = std::chrono::steady_clock::now();
+            latency_us.record(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+        }
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - begin;
+        elapsed = duration.count();
+    });
+    thread.join();
+    return status;
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx cache_dir [iterations]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx ./artifact_cache 200" << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string cache_dir(argv[2]);
+    int iterations = argc > 3 ? std::stoi(argv[3]) : 200;
+
+    std::vector<NumaNode> nodes;
+    auto ret = get_numa_nodes(nodes);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::vector<NumaNode> cpu_nodes;
+    for (const auto& node : nodes) {
+        std::cout << "NUMA node " << node.id << ": " << node.cores.size() << " cores" << std::endl;
+        if (!node.cores.empty()) {
+            cpu_nodes.emplace_back(node);
+        }
+    }
+
+    BuildOptions options;
+    std::string artifact_dir;
+    bool cache_hit = false;
+    ret = compile_cached_artifact(file_name, options, cache_dir, ExportOptions(), artifact_dir, cache_hit);
+    if (!ret.is_ok()) {
+        std::cerr << "compile failed: " << ret << std::endl;
+        return -1;
+    }
+
+    ExecutorFactory factory;
+    ret = factory.load(artifact_dir);
+    if (!ret.is_ok()) {
+        std::cerr << "load failed: " << ret << std::endl;
+        return -1;
+    }
+
+    std::unordered_map<std::string, std::vector<int64_t>> input_shapes;
+    {
+        InferenceSession session;
+        ret = session.load(factory);
+        if (!ret.is_ok()) {
+            std::cerr << "load failed: " << ret << std::endl;
+            return -1;
+        }
+        for (const auto& input : session.get_inputs()) {
+            input_shapes.emplace(input.name, input.shape);
+        }
+    }
+    std::vector<TensorMap> samples;
+    create_random_samples(input_shapes, 1, 0, samples);
+
+    // Step 1. the session runs on the cores of the last node, its params and workspace are on the local node and
+    // then on a remote node
+    const NumaNode& run_node = cpu_nodes.back();
+    std::vector<int> memory_nodes{run_node.id};
+    if (nodes.size() > 1) {
+        memory_nodes.push_back(nodes.front().id == run_node.id ? nodes.back().id : nodes.front().id);
+    } else {
+        std::cout << "a single NUMA node, the remote placement is skipped" << std::endl;
+    }
+
+    for (int memory_node : memory_nodes) {
+        ExecutorFactory replica;
+        ret = factory.replicate_to_numa_node(memory_node, replica);
+        if (!ret.is_ok()) {
+            std::cerr << "replicate failed: " << ret << std::endl;
+            return -1;
+        }
+
+        // the pages of the params are where they are bound to
+        for (const auto& kv : replica.get_params()) {
+            int node = -1;
+            ret = get_memory_numa_node(kv.second->data, node);
+            if (!ret.is_ok() || node != memory_node) {
+                std::cerr << "param " << kv.first << " is on node " << node << " instead of " << memory_node << " "
+                          << ret << std::endl;
+                return -1;
+            }
+            break;
+        }
+
+        Histogram latency_us = Histogram::exponential(1, 10 * 1000 * 1000);
+        double elapsed = 0;
+        ret = run_placed(replica, run_node.cores, memory_node, samples[0], iterations, latency_us, elapsed);
+        if (!ret.is_ok()) {
+            std::cerr << "run failed: " << ret << std::endl;
+            return -1;
+        }
+        std::cout << (memory_node == run_node.id ? "local" : "remote") << " memory (node " << memory_node
+                  << "), cores of node " << run_node.id << ": " << iterations / elapsed << " runs/s, p50 "
+                  << latency_us.percentile(0.5) << " us, p99 " << latency_us.percentile(0.99) << " us" << std::endl;
+    }
+
+    // Step 2. an async session with a worker per node, each one with the local workspace and params
+    AsyncOptions async_options;
+    async_options.workers = static_cast<int>(cpu_nodes.size());
+    for (const auto& node : cpu_nodes) {
+        async_options.thread_config.cores.insert(async_options.thread_config.cores.end(), node.cores.begin(),
+                                                 node.cores.end());
+    }
+    async_options.numa_local = true;
+    async_options.numa_replicate_params = true;
+    std::unique_ptr<AsyncSession> session;
+    ret = AsyncSession::create(factory, async_options, session);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::vector<std::future<InferResult>> futures(iterations);
+    auto start = std::chrono::steady_clock::now();
+    for (auto& future : futures) {
+        ret = session->submit(samples[0], future);
+        if (!ret.is_ok()) {
+            std::cerr << ret << std::endl;
+            return -1;
+        }
+    }
+    for (auto& future : futures) {
+        InferResult result = future.get();
+        if (!result.status.is_ok()) {
+            std::cerr << "async request failed: " << result.status << std::endl;
+            return -1;
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "async session, " << async_options.workers << " NUMA local workers: " << iterations / elapsed.count()
+              << " requests/s" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler/build_options.h"
+#include "onnx.proto3.pb.h"
+#include "serving/pipeline.h"
+#include "serving/thread_config.h"
+#include "utils/onnx_utils.h"
+#include "utils/relay_utils.h"
+#include "utils/sample_utils.h"
+#include "utils/utils.h"
+
+using namespace tvm_cpp::utils;
+using namespace tvm_cpp::onnx_utils;
+using namespace tvm_cpp::relay_utils;
+using namespace tvm_cpp::sample_utils;
+using namespace tvm_cpp::compiler;
+using namespace tvm_cpp::serving;
+
+/**
+ * @brief The max absolute difference of two float32 tensors, the splitting only changes the fusion at the cuts
+ *
+ */
+double get_max_difference(const tvm::runtime::NDArray& a, const tvm::runtime::NDArray& b) {
+    int64_t size = 1;
+    for (int d = 0; d < a->ndim; ++d) {
+        size *= a->shape[d];
+    }
+
+    const float* a_data = static_cast<const float*>(a->data);
+    const float* b_data = static_cast<const float*>(b->data);
+    double difference = 0;
+    for (int64_t i = 0; i < size; ++i) {
+        difference = std::max(difference, static_cast<double>(std::fabs(a_data[i] - b_data[i])));
+    }
+    return difference;
+}
+
+/**
+ * @brief Submit all the requests to the pipeline and wait for them
+ *
+ */
+tvm_cpp::Status run_requests(PipelineSession& session, const TensorMap& sample, int requests) {
+    std::vector<std::future<InferResult>> futures(requests);
+    for (auto& future : futures) {
+        auto status = session.submit(sample, future);
+        if (!status.is_ok()) {
+            return status;
+        }
+    }
+    for (auto& future : futures) {
+        InferResult result = future.get();
+        if (!result.status.is_ok()) {
+            return result.status;
+        }
+    }
+    return tvm_cpp::Status::ok();
+}
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cerr << "Usage: " << argv[0] << " model.onnx cache_dir [stages] [requests]" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " model.onnx ./artifact_cache 4 200" << std::endl;
+        std::cerr << "the cores are split evenly among the stages" << std::endl;
+        return -1;
+    }
+
+    std::string file_name(argv[1]);
+    std::string cache_dir(argv[2]);
+    int stages = argc > 3 ? std::stoi(argv[3]) : 4;
+    int requests = argc > 4 ? std::stoi(argv[4]) : 200;
+
+    onnx::ModelProto onnx_model;
+    auto ret = load_onnx_model(file_name, onnx_model);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    tvm::IRModule module;
+    ret = parse_graph_to_irmodule(onnx_model.graph(), module);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    // the stages are compiled for static shapes, the dynamic dims are 1
+    std::unordered_map<std::string, std::vector<int64_t>> input_shapes;
+    get_graph_input_shapes(onnx_model.graph(), 1, input_shapes);
+    ret = specialize_input_shapes(input_shapes, module);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    // Step 1. choose the cuts and split the model
+    std::vector<PipelineCut> cuts;
+    ret = get_pipeline_cuts(module, cuts);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::vector<int> call_indices;
+    ret = choose_pipeline_cuts(module, stages, call_indices);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::cout << cuts.size() << " valid cuts, chosen:" << std::endl;
+    for (int index : call_indices) {
+        auto iter = std::find_if(cuts.begin(), cuts.end(),
+                                 [index](const PipelineCut& cut) { return cut.call_index == index; });
+        std::cout << "  after call " << index << " " << iter->op_name << ": " << iter->live_tensors << " tensors, "
+                  << iter->live_bytes << " bytes" << std::endl;
+    }
+
+    std::string model_cache_dir =
+        (std::filesystem::path(cache_dir) / std::filesystem::path(file_name).stem()).string();
+    std::string single_dir;
+    std::string pipeline_dir;
+    ret = compile_pipeline_stages(module, {}, BuildOptions(), model_cache_dir, single_dir);
+    if (ret.is_ok()) {
+        ret = compile_pipeline_stages(module, call_indices, BuildOptions(), model_cache_dir, pipeline_dir);
+    }
+    if (!ret.is_ok()) {
+        std::cerr << "compile failed: " << ret << std::endl;
+        return -1;
+    }
+
+    // Step 2. the whole model on all the cores against the stages on disjoint core groups
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    PipelineOptions single_options;
+    ThreadConfig all_cores;
+    for (int core = 0; core < cores; ++core) {
+        all_cores.cores.push_back(core);
+    }
+    single_options.stage_threads.emplace_back(all_cores);
+
+    PipelineOptions pipeline_options;
+    ret = split_thread_config(all_cores, static_cast<int>(call_indices.size()) + 1, pipeline_options.stage_threads);
+    if (!ret.is_ok()) {
+        std::cerr << ret << std::endl;
+        return -1;
+    }
+
+    std::unique_ptr<PipelineSession> single;
+    std::unique_ptr<PipelineSession> pipeline;
+    ret = PipelineSession::create(single_dir, single_options, single);
+    if (ret.is_ok()) {
+        ret = PipelineSession::create(pipeline_dir, pipeline_options, pipeline);
+    }
+    if (!ret.is_ok()) {
+        std::cerr << "load failed: " << ret << std::endl;
+        return -1;
+    }
+
+    std::vector<TensorMap> samples;
+    create_random_samples(input_shapes, 1, 0, samples);
+
+    ret = run_requests(*single, samples[0], requests);
+    if (ret.is_ok()) {
+        ret = run_requests(*pipeline, samples[0], requests);
+    }
+    if (!ret.is_ok()) {
+        std::cerr << "run failed: " << ret << std::endl;
+        return -1;
+    }
+
+    for (const auto& session : {single.get(), pipeline.get()}) {
+        PipelineStats stats = session->get_stats();
+        std::cout << session->get_stage_count() << " stages: " << stats.throughput << " requests/s, latency p50 "
+                  << stats.latency_us.percentile(0.5) << " us, p99 " << stats.latency_us.percentile(0.99) << " us"
+                  << std::endl;
+        for (size_t i = 0; i < stats.stages.size(); ++i) {
+            std::cout << "  stage " << i << ": run p50 " << stats.stages[i].run_time_us.percentile(0.5)
+                      << " us, wait p50 " << stats.stages[i].wait_time_us.percentile(0.5) << " us" << std::endl;
+        }
+    }
+
+    // Step 3. the outputs of the stages match the whole model
+    std::vector<tvm::runtime::NDArray> expected;
+    std::vector<tvm::runtime::NDArray> outputs;
+    ret = single->run(samples[0], expected);
+    if (ret.is_ok()) {
+        ret = pipeline->run(samples[0], outputs);
+    }
+    if (!ret.is_ok() || expected.size() != outputs.size()) {
+        std::cerr << "run failed: " << ret << std::endl;
+        return -1;
+    }
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        if (outputs[i]->dtype.code != kDLFloat || outputs[i]->dtype.bits != 32) {
+            continue;
+        }
+        double difference = get_max_difference(expected[i], outputs[i]);
+        std::cout << "output " << i << " max difference: " << difference << std::endl;
+        if (difference > 1e-3) {
+            std::cerr << "the pipeline outputs mismatch the whole model" << std::endl;
+            return -1;
+        }
+    }
+
+    return 0;
+}
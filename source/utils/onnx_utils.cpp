@@ -1,8 +1,13 @@
 #include "onnx_utils.h"
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+
 #include <algorithm>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 
 #include "utils.h"
 
@@ -70,5 +75,40 @@ void retrieve_onnx_node_types(const onnx::ModelProto& model, std::unordered_map<
     }
 }
 
+Status load_onnx_model(const std::string& file_path, onnx::ModelProto& model) {
+    std::string file_name(file_path);
+    tvm_cpp::utils::trim(file_name);
+    if (!tvm_cpp::utils::file_exist(file_name)) {
+        std::ostringstream oss;
+        oss << "The onnx file does NOT exist: " << file_name;
+        return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+    }
+
+    std::ifstream ifs(file_name, std::ios::in | std::ios::binary);
+    if (!ifs.is_open()) {
+        std::ostringstream oss;
+        oss << "Open file failed: " << file_name;
+        return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+    }
+
+    google::protobuf::io::IstreamInputStream input_stream(&ifs);
+    google::protobuf::io::CodedInputStream coded_input(&input_stream);
+    bool parsed = model.ParseFromCodedStream(&coded_input);
+    ifs.close();
+    if (!parsed) {
+        std::ostringstream oss;
+        oss << "Parse onnx model failed: " << file_name;
+        return Status(StatusCode::INVALID_MODEL, oss.str());
+    }
+
+    if (!validate_onnx_proto(model)) {
+        std::ostringstream oss;
+        oss << "Invalid onnx model: " << file_name;
+        return Status(StatusCode::INVALID_MODEL, oss.str());
+    }
+
+    return Status::ok();
+}
+
 }    // namespace onnx_utils
 }    // namespace tvm_cpp
\ No newline at end of file
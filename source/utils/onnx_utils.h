@@ -34,6 +34,15 @@ void print_onnx_model_info(const onnx::ModelProto& model);
  */
 void retrieve_onnx_node_types(const onnx::ModelProto& model, std::unordered_map<std::string, int>& types_map);
 
+/**
+ * @brief Load the onnx proto model from file
+ *
+ * @param file_path the onnx model file path
+ * @param model output parameter. the onnx proto model
+ * @return Status
+ */
+Status load_onnx_model(const std::string& file_path, onnx::ModelProto& model);
+
 /**
  * @brief Get a single attribute
  *
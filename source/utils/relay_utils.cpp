@@ -1,5 +1,7 @@
 #include "relay_utils.h"
 
+#include <tvm/tir/expr.h>
+
 #include <vector>
 
 #include "onnx_op/op_parser.h"
@@ -182,7 +184,8 @@ Status parse_graph_inputs_to_relays(const onnx::GraphProto& onnx_graph,
                         int64_t dim_val = dim.dim_value();
                         shape.push_back((int32_t)dim_val);
                     } else {
-                        shape.push_back(-1);
+                        // the dynamic dim, e.g. the batch or the sequence length
+                        shape.push_back(tvm::relay::Any());
                     }
                 }
 
@@ -241,15 +244,20 @@ Status infer_relay_shape_dtype(const tvm::relay::Expr& expr, std::vector<int64_t
         dtype = data_type;
         const tvm::runtime::Array<tvm::PrimExpr>& expr_shape = tensor_type->shape;
 
+        std::vector<int64_t> dims;
         for (int i = 0; i < expr_shape.size(); ++i) {
             const tvm::PrimExpr& exp = expr_shape[i];
             const tvm::IntImmNode* node = exp.as<tvm::IntImmNode>();
             if (node) {
-                shape.emplace_back(node->value);
+                dims.emplace_back(node->value);
+            } else if (exp.as<tvm::tir::AnyNode>()) {
+                // the dynamic dim, e.g. the batch of the graph inputs
+                dims.emplace_back(-1);
             } else {
                 return Status(StatusCode::RUNTIME_ERROR, "Invalid shape");
             }
         }
+        shape = std::move(dims);
     }
 
     return Status::ok();
@@ -389,5 +397,86 @@ Status parse_graph_to_irmodule(const onnx::GraphProto& onnx_graph, tvm::IRModule
     return Status::ok();
 }
 
+Status specialize_input_shapes(const std::unordered_map<std::string, std::vector<int64_t>>& shapes,
+                               tvm::IRModule& module) {
+    // var generate function
+    const tvm::runtime::PackedFunc* var_gen = tvm::runtime::Registry::Get("relay.ir.Var");
+    if (!var_gen) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay.ir.Var expression not found");
+    }
+
+    // bind function
+    const tvm::runtime::PackedFunc* bind = tvm::runtime::Registry::Get("relay.ir.Bind");
+    if (!bind) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay.ir.Bind expression not found");
+    }
+
+    // get the function relay
+    const tvm::runtime::PackedFunc* function = tvm::runtime::Registry::Get("relay.ir.Function");
+    if (!function) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay.ir.Function expression not found");
+    }
+
+    // type infer
+    const tvm::runtime::PackedFunc* type_infer = tvm::runtime::Registry::Get("relay._transform.InferType");
+    if (!type_infer) {
+        return Status(StatusCode::RUNTIME_ERROR, "relay._transform.InferType expression not found");
+    }
+
+    // pass run
+    const tvm::runtime::PackedFunc* pass_run = tvm::runtime::Registry::Get("transform.RunPass");
+    if (!pass_run) {
+        return Status(StatusCode::RUNTIME_ERROR, "transform.pass_run expression not found");
+    }
+
+    const auto* main_func = module->Lookup("main").as<tvm::relay::FunctionNode>();
+    if (!main_func) {
+        return Status(StatusCode::INVALID_PARAM, "the module has no relay main function");
+    }
+
+    // replace the inputs with the static shape vars
+    tvm::runtime::Array<tvm::relay::Var> params;
+    tvm::runtime::Map<tvm::relay::Var, tvm::relay::Expr> binds;
+    for (const auto& param : main_func->params) {
+        auto iter = shapes.find(param->name_hint());
+        if (iter == shapes.end()) {
+            params.push_back(param);
+            continue;
+        }
+
+        const auto* tensor_type = param->type_annotation.as<tvm::relay::TensorTypeNode>();
+        if (!tensor_type || tensor_type->shape.size() != iter->second.size()) {
+            std::ostringstream oss;
+            oss << "Input [" << iter->first << "] rank mismatches with the specialized shape";
+            return Status(StatusCode::INVALID_PARAM, oss.str());
+        }
+
+        tvm::runtime::Array<tvm::PrimExpr> shape;
+        for (int64_t dim : iter->second) {
+            shape.push_back(tvm::Integer(dim));
+        }
+
+        tvm::relay::TensorType var_type{shape, tensor_type->dtype};
+        tvm::relay::Var var = (*var_gen)(param->name_hint(), var_type, tvm::relay::Span());
+        params.push_back(var);
+        binds.Set(param, var);
+    }
+
+    try {
+        tvm::relay::Expr body = (*bind)(main_func->body, binds);
+        tvm::relay::Expr func = (*function)(params, body, tvm::relay::Type(), main_func->type_params,
+                                            main_func->attrs, tvm::relay::Span());
+        tvm::IRModule new_module = tvm::IRModule::FromExpr(func);
+
+        // the types of the specialized module
+        tvm::relay::transform::Pass infer_type_pass = (*type_infer)();
+        module = (*pass_run)(infer_type_pass, new_module);
+    } catch (const tvm::runtime::Error& e) {
+        return Status(StatusCode::RUNTIME_ERROR, e.what());
+    }
+
+    return Status::ok();
+}
+
 }    // namespace relay_utils
-}    // namespace tvm_cpp
\ No newline at end of file
+}    // namespace tvm_cpp
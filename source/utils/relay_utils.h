@@ -10,6 +10,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "onnx.proto3.pb.h"
 #include "status.h"
@@ -70,7 +71,7 @@ Status parse_graph_to_irmodule(const onnx::GraphProto& onnx_graph, tvm::IRModule
  * @brief infer relay expr shape and data type
  *
  * @param expr the relay expression
- * @param shape  output parameter. the relay expression shape
+ * @param shape  output parameter. the relay expression shape, the dynamic (relay Any) dims are -1
  * @param dtype the data type
  * @return Status
  */
@@ -85,6 +86,17 @@ Status infer_relay_shape_dtype(const tvm::relay::Expr& expr, std::vector<int64_t
  */
 Status infer_relay_shape(const tvm::relay::Expr& expr, tvm::relay::Expr& relay);
 
+/**
+ * @brief specialize the main function inputs to static shapes, e.g. bind the dynamic batch to a fixed batch size.
+ * the inputs not in the map keep their shapes
+ *
+ * @param shapes the input shapes. key: the input name, value: the static shape
+ * @param module input/output parameter. the ir module
+ * @return Status
+ */
+Status specialize_input_shapes(const std::unordered_map<std::string, std::vector<int64_t>>& shapes,
+                               tvm::IRModule& module);
+
 }    // namespace relay_utils
 }    // namespace tvm_cpp
 
@@ -0,0 +1,201 @@
+#include "sample_utils.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <unordered_set>
+
+#include "utils.h"
+
+namespace tvm_cpp {
+namespace sample_utils {
+
+namespace {
+
+/**
+ * @brief The graph input which is not an initializer
+ *
+ */
+struct GraphInput {
+    std::string name;
+    // the dynamic dims are -1
+    std::vector<int64_t> shape;
+};
+
+void get_graph_inputs(const onnx::GraphProto& onnx_graph, std::vector<GraphInput>& inputs) {
+    std::unordered_set<std::string> initializers;
+    for (const auto& initializer : onnx_graph.initializer()) {
+        initializers.insert(initializer.name());
+    }
+
+    for (const auto& input : onnx_graph.input()) {
+        if (initializers.count(input.name())) {
+            continue;
+        }
+
+        GraphInput graph_input;
+        graph_input.name = input.name();
+        for (const auto& dim : input.type().tensor_type().shape().dim()) {
+            graph_input.shape.emplace_back(dim.has_dim_value() ? dim.dim_value() : -1);
+        }
+        inputs.emplace_back(graph_input);
+    }
+}
+
+/**
+ * @brief Load a raw float32 tensor file of the graph input
+ *
+ */
+Status load_raw_tensor(const std::filesystem::path& path, const GraphInput& input, tvm::runtime::NDArray& tensor) {
+    if (!std::filesystem::exists(path)) {
+        std::ostringstream oss;
+        oss << "Sample tensor file does NOT exist: " << path.string();
+        return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+    }
+
+    int64_t element_num = static_cast<int64_t>(std::filesystem::file_size(path) / sizeof(float));
+
+    // the static element number and the dynamic dim index
+    int64_t static_num = 1;
+    int dynamic_index = -1;
+    for (size_t i = 0; i < input.shape.size(); ++i) {
+        if (input.shape[i] >= 0) {
+            static_num *= input.shape[i];
+        } else if (dynamic_index < 0) {
+            dynamic_index = static_cast<int>(i);
+        } else {
+            std::ostringstream oss;
+            oss << "Input [" << input.name << "] has more than one dynamic dim, the sample shape is ambiguous";
+            return Status(StatusCode::NOT_IMPLEMENTED, oss.str());
+        }
+    }
+
+    std::vector<int64_t> shape = input.shape;
+    if (dynamic_index >= 0 && static_num > 0) {
+        shape[dynamic_index] = element_num / static_num;
+        static_num *= shape[dynamic_index];
+    }
+
+    if (static_num != element_num || element_num == 0) {
+        std::ostringstream oss;
+        oss << "The size of " << path.string() << " mismatches with the shape of input [" << input.name << "]";
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    tensor = tvm::runtime::NDArray::Empty(tvm::runtime::ShapeTuple(shape), {DLDataTypeCode::kDLFloat, 32, 1},
+                                          {DLDeviceType::kDLCPU, 0});
+
+    std::ifstream ifs(path, std::ios::binary);
+    ifs.read(static_cast<char*>(tensor->data), static_cast<std::streamsize>(element_num * sizeof(float)));
+    if (!ifs) {
+        std::ostringstream oss;
+        oss << "Read sample tensor file failed: " << path.string();
+        return Status(StatusCode::RUNTIME_ERROR, oss.str());
+    }
+
+    return Status::ok();
+}
+
+}    // namespace
+
+void get_graph_input_shapes(const onnx::GraphProto& onnx_graph, int64_t dynamic_dim,
+                            std::unordered_map<std::string, std::vector<int64_t>>& shapes) {
+    std::vector<GraphInput> inputs;
+    get_graph_inputs(onnx_graph, inputs);
+
+    shapes.clear();
+    for (auto& input : inputs) {
+        for (auto& dim : input.shape) {
+            dim = dim >= 0 ? dim : dynamic_dim;
+        }
+        shapes.emplace(input.name, input.shape);
+    }
+}
+
+void create_random_samples(const std::unordered_map<std::string, std::vector<int64_t>>& shapes, int count,
+                           uint32_t seed, std::vector<TensorMap>& samples) {
+    std::mt19937 engine(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    samples.clear();
+    for (int n = 0; n < count; ++n) {
+        TensorMap sample;
+        for (const auto& kv : shapes) {
+            tvm::runtime::NDArray data = tvm::runtime::NDArray::Empty(
+                tvm::runtime::ShapeTuple(kv.second), {DLDataTypeCode::kDLFloat, 32, 1}, {DLDeviceType::kDLCPU, 0});
+            size_t element_num = tvm::runtime::GetDataSize(*data.operator->()) / sizeof(float);
+            for (size_t i = 0; i < element_num; ++i) {
+                static_cast<float*>(data->data)[i] = dist(engine);
+            }
+            sample.emplace(kv.first, data);
+        }
+        samples.emplace_back(sample);
+    }
+}
+
+Status load_samples(const std::string& dir, const onnx::GraphProto& onnx_graph, std::vector<TensorMap>& samples) {
+    std::filesystem::path dir_path(dir);
+    if (!std::filesystem::is_directory(dir_path)) {
+        std::ostringstream oss;
+        oss << "Sample directory does NOT exist: " << dir;
+        return Status(StatusCode::FILE_NOT_FOUND, oss.str());
+    }
+
+    std::vector<GraphInput> inputs;
+    get_graph_inputs(onnx_graph, inputs);
+    if (inputs.empty()) {
+        return Status(StatusCode::INVALID_MODEL, "the graph has no input");
+    }
+
+    std::vector<std::filesystem::path> sample_dirs;
+    std::vector<std::filesystem::path> sample_files;
+    for (const auto& entry : std::filesystem::directory_iterator(dir_path)) {
+        if (entry.is_directory()) {
+            sample_dirs.emplace_back(entry.path());
+        } else if (tvm_cpp::utils::ends_with(entry.path().string(), ".bin")) {
+            sample_files.emplace_back(entry.path());
+        }
+    }
+    std::sort(sample_dirs.begin(), sample_dirs.end());
+    std::sort(sample_files.begin(), sample_files.end());
+
+    samples.clear();
+    if (!sample_dirs.empty()) {
+        for (const auto& sample_dir : sample_dirs) {
+            TensorMap sample;
+            for (const auto& input : inputs) {
+                tvm::runtime::NDArray tensor;
+                auto status = load_raw_tensor(sample_dir / (input.name + ".bin"), input, tensor);
+                if (!status.is_ok()) {
+                    return status;
+                }
+                sample.emplace(input.name, tensor);
+            }
+            samples.emplace_back(sample);
+        }
+    } else if (inputs.size() == 1) {
+        for (const auto& file : sample_files) {
+            tvm::runtime::NDArray tensor;
+            auto status = load_raw_tensor(file, inputs[0], tensor);
+            if (!status.is_ok()) {
+                return status;
+            }
+            samples.emplace_back(TensorMap{{inputs[0].name, tensor}});
+        }
+    } else {
+        return Status(StatusCode::INVALID_PARAM, "the samples of a multi-input graph must be in sub directories");
+    }
+
+    if (samples.empty()) {
+        std::ostringstream oss;
+        oss << "No sample found in " << dir;
+        return Status(StatusCode::INVALID_PARAM, oss.str());
+    }
+
+    return Status::ok();
+}
+
+}    // namespace sample_utils
+}    // namespace tvm_cpp
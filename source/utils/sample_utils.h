@@ -0,0 +1,60 @@
+#ifndef _H_TVM_CPP_UTILS_SAMPLE_UTILS_H_
+#define _H_TVM_CPP_UTILS_SAMPLE_UTILS_H_
+
+#include <tvm/runtime/ndarray.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "onnx.proto3.pb.h"
+#include "status.h"
+
+namespace tvm_cpp {
+namespace sample_utils {
+
+/**
+ * @brief The input tensors of a sample. key: the graph input name, value: the tensor
+ *
+ */
+using TensorMap = std::unordered_map<std::string, tvm::runtime::NDArray>;
+
+/**
+ * @brief Get the shapes of the graph inputs which are not initializers
+ *
+ * @param onnx_graph the onnx graph proto
+ * @param dynamic_dim the value of the dynamic dims
+ * @param shapes output parameter. key: the input name, value: the input shape
+ */
+void get_graph_input_shapes(const onnx::GraphProto& onnx_graph, int64_t dynamic_dim,
+                            std::unordered_map<std::string, std::vector<int64_t>>& shapes);
+
+/**
+ * @brief Create the samples with uniform random float32 data in [-1, 1)
+ *
+ * @param shapes the input shapes
+ * @param count the number of samples
+ * @param seed the random seed
+ * @param samples output parameter. the samples
+ */
+void create_random_samples(const std::unordered_map<std::string, std::vector<int64_t>>& shapes, int count,
+                           uint32_t seed, std::vector<TensorMap>& samples);
+
+/**
+ * @brief Load the samples from a directory of raw float32 tensors. Each sub directory is a sample holding
+ * `<input name>.bin` of every graph input. If the graph has a single input, the `*.bin` files in the directory are
+ * the samples of it. A dynamic dim is inferred from the file size when it is the only dynamic dim of the input.
+ * The samples are sorted by the file names
+ *
+ * @param dir the sample directory
+ * @param onnx_graph the onnx graph proto
+ * @param samples output parameter. the samples
+ * @return Status
+ */
+Status load_samples(const std::string& dir, const onnx::GraphProto& onnx_graph, std::vector<TensorMap>& samples);
+
+}    // namespace sample_utils
+}    // namespace tvm_cpp
+
+#endif
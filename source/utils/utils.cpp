@@ -35,5 +35,28 @@ bool file_exist(const std::string& file_path) {
     return std::filesystem::exists(path);
 }
 
+uint64_t fnv1a_hash(const std::string& str) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : str) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+std::string shell_quote(const std::string& arg) {
+    std::string quoted = "'";
+    for (char c : arg) {
+        if (c == '\'') {
+            quoted += "'\\''";
+        } else {
+            quoted += c;
+        }
+    }
+    quoted += "'";
+    return quoted;
+}
+
 }    // namespace utils
 }    // namespace tvm_cpp
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef _H_TVM_CPP_UTILS_UTILS_H_
 #define _H_TVM_CPP_UTILS_UTILS_H_
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 
@@ -49,6 +50,22 @@ bool ends_with(const std::string& str, const std::string& suffix);
  */
 bool file_exist(const std::string& file_path);
 
+/**
+ * @brief the 64-bit FNV-1a hash of the string, it is stable across standard libraries unlike std::hash
+ *
+ * @param str the string
+ * @return uint64_t
+ */
+uint64_t fnv1a_hash(const std::string& str);
+
+/**
+ * @brief quote the command line argument for the shell
+ *
+ * @param arg the argument
+ * @return std::string the single quoted argument
+ */
+std::string shell_quote(const std::string& arg);
+
 }    // namespace utils
 }    // namespace tvm_cpp
 